@@ -0,0 +1,247 @@
+/**
+ * Host benchmark: loading of sound assets.
+ *
+ * Loads every WAV from assets/sound through AssetStorage, as Resources
+ * does at startup, and keeps them resident. Compares the former loader,
+ * which copies PCM after 44-byte header into heap buffer, with WAVSound
+ * playing samples right from AssetStorage::map() view. Each loader runs
+ * in a forked process, so its peak RSS is not affected by the other one;
+ * peak RSS and anonymous (private, not reclaimable) RSS are taken right
+ * after loading and again after every sample has been touched, as mixing
+ * would do during the game. Mapped samples are checked to be exactly the
+ * "data" chunk of each file, unless WAVSound has converted them into
+ * format of Mixer; the former loader also took trailing chunks and
+ * headers longer than 44 bytes as samples.
+ *
+ * Usage: bench_assets [rounds] [assets_dir]
+ */
+
+#include <dirent.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AssetDirectory.h"
+#include "AssetStorage.h"
+#include "AssetView.h"
+#include "Mixer.h"
+#include "SoundBuffer.h"
+
+#ifndef ARKANOID_ASSETS_DIR
+#define ARKANOID_ASSETS_DIR "../assets"
+#endif
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+std::vector<std::string> listFiles(const std::string& path, const char* extension) {
+  std::vector<std::string> names;
+  DIR* dir = opendir(path.c_str());
+  if (dir == nullptr) {
+    return names;
+  }
+  while (dirent* entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    if (name.size() > 4 && name.compare(name.size() - 4, 4, extension) == 0) {
+      names.push_back(name);
+    }
+  }
+  closedir(dir);
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+long peakRssKb() {
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+long anonymousRssKb() {
+  long kb = 0;
+  if (FILE* status = std::fopen("/proc/self/status", "r")) {
+    char line[256];
+    while (std::fgets(line, sizeof(line), status) != nullptr) {
+      if (std::sscanf(line, "RssAnon: %ld", &kb) == 1) {
+        break;
+      }
+    }
+    std::fclose(status);
+  }
+  return kb;
+}
+
+/// @brief Sound loaded the former way: copy of everything after header.
+struct CopiedSound {
+  std::unique_ptr<uint8_t[]> data;
+  off_t length;
+};
+
+bool loadCopy(AssetStorage* assets, const std::string& name, CopiedSound* sound) {
+  const off_t header_size = 44;
+  uint8_t header[header_size];
+  if (!assets->open(name.c_str())) {
+    return false;
+  }
+  sound->length = assets->length() - header_size;
+  sound->data.reset(new uint8_t[sound->length]);
+  bool success = assets->read(header, header_size) && assets->read(sound->data.get(), sound->length);
+  assets->close();
+  return success;
+}
+
+/// @brief Whether samples are the content of some "data" chunk of file.
+bool isDataChunk(const std::string& path, const uint8_t* samples, off_t length) {
+  std::vector<uint8_t> content;
+  if (FILE* file = std::fopen(path.c_str(), "rb")) {
+    uint8_t buffer[4096];
+    size_t count = 0;
+    while ((count = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+      content.insert(content.end(), buffer, buffer + count);
+    }
+    std::fclose(file);
+  }
+  const uint8_t tag[] = {'d', 'a', 't', 'a'};
+  for (auto it = content.begin(); (it = std::search(it, content.end(), tag, tag + 4)) != content.end(); ++it) {
+    size_t offset = it - content.begin() + 8;
+    if (offset + length <= content.size() &&
+        (content[offset - 4] | content[offset - 3] << 8 | content[offset - 2] << 16 | content[offset - 1] << 24) == length &&
+        std::equal(samples, samples + length, content.begin() + offset)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+struct Result {
+  double load_ms;
+  long baseline_kb;
+  long loaded_kb;
+  long touched_kb;
+  long anonymous_baseline_kb;
+  long anonymous_loaded_kb;
+  long long bytes;
+  bool success;
+};
+
+/// @brief Loads all sounds in either way, run inside child process.
+Result run(bool mapped, const std::vector<std::string>& names) {
+  Result result {0, peakRssKb(), 0, 0, anonymousRssKb(), 0, 0, true};
+  AssetStorage assets(nullptr, nullptr);
+  std::vector<std::unique_ptr<native::SoundBuffer>> sounds;
+  std::vector<CopiedSound> copies(names.size());
+
+  auto start = Clock::now();
+  for (size_t i = 0; i < names.size(); ++i) {
+    if (mapped) {
+      sounds.emplace_back(new native::WAVSound(&assets, names[i].c_str()));
+      result.success = sounds.back()->load() && result.success;
+    } else {
+      result.success = loadCopy(&assets, names[i], &copies[i]) && result.success;
+    }
+  }
+  result.load_ms = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count() / 1000.0;
+  result.loaded_kb = peakRssKb();
+  result.anonymous_loaded_kb = anonymousRssKb();
+
+  volatile uint8_t sum = 0;
+  for (size_t i = 0; i < names.size(); ++i) {
+    const uint8_t* data = mapped ? sounds[i]->getData() : copies[i].data.get();
+    off_t length = mapped ? sounds[i]->getLength() : copies[i].length;
+    for (off_t b = 0; b < length; b += 64) {
+      sum += data[b];
+    }
+    result.bytes += length;
+  }
+  result.touched_kb = peakRssKb();
+  return result;
+}
+
+bool runForked(bool mapped, const std::vector<std::string>& names, Result* result) {
+  int channel[2];
+  if (pipe(channel) != 0) {
+    return false;
+  }
+  pid_t child = fork();
+  if (child == 0) {
+    close(channel[0]);
+    Result child_result = run(mapped, names);
+    ssize_t written = write(channel[1], &child_result, sizeof(child_result));
+    _exit(written == sizeof(child_result) ? 0 : 1);
+  }
+  close(channel[1]);
+  ssize_t received = read(channel[0], result, sizeof(*result));
+  close(channel[0]);
+  int status = 0;
+  waitpid(child, &status, 0);
+  return child > 0 && received == sizeof(*result) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int rounds = argc > 1 ? std::atoi(argv[1]) : 5;
+  std::string assets = argc > 2 ? argv[2] : ARKANOID_ASSETS_DIR;
+
+  std::vector<std::string> names = listFiles(assets + "/sound", ".wav");
+  if (names.empty()) {
+    fprintf(stderr, "No sounds found in %s/sound\n", assets.c_str());
+    return 1;
+  }
+  for (std::string& name : names) {
+    name = "sound/" + name;
+  }
+  host::setAssetDirectory(assets.c_str());
+
+  for (int mapped = 0; mapped < 2; ++mapped) {
+    std::vector<double> times;
+    Result result;
+    for (int r = 0; r < rounds; ++r) {
+      if (!runForked(mapped, names, &result) || !result.success) {
+        fprintf(stderr, "Failed to load sounds\n");
+        return 1;
+      }
+      times.push_back(result.load_ms);
+    }
+    std::sort(times.begin(), times.end());
+    printf("%-4s sounds=%zu pcm_kb=%lld load_ms=%.3f peak_rss_kb: loaded=+%ld touched=+%ld anon_rss_kb=+%ld\n",
+        mapped ? "map" : "copy", names.size(), result.bytes / 1024, times[times.size() / 2],
+        result.loaded_kb - result.baseline_kb, result.touched_kb - result.baseline_kb,
+        result.anonymous_loaded_kb - result.anonymous_baseline_kb);
+  }
+
+  // correctness: samples in format of mixer are exactly "data" chunks,
+  // the others are converted into it keeping their duration
+  bool valid = true;
+  int converted = 0;
+  AssetStorage storage(nullptr, nullptr);
+  for (const std::string& name : names) {
+    native::WAVSound sound(&storage, name.c_str());
+    AssetView view = AssetView::mapFile((assets + "/" + name).c_str());
+    native::WAVSound::WAVFormat format;
+    const uint8_t* samples = nullptr;
+    size_t length = 0;
+    valid = sound.load() && native::WAVSound::parse(view.data(), view.size(), &format, &samples, &length) == 0 && valid;
+    if (!valid) {
+      continue;
+    }
+    if (format.channels == native::sound::Mixer::channels && format.sample_rate == native::sound::Mixer::sampleRate) {
+      valid = isDataChunk(assets + "/" + name, sound.getData(), sound.getLength()) && valid;
+    } else {
+      uint64_t frames = static_cast<uint64_t>(length / format.block_align) * native::sound::Mixer::sampleRate / format.sample_rate;
+      valid = sound.getLength() == static_cast<off_t>(frames * native::sound::Mixer::channels * sizeof(int16_t)) && valid;
+      ++converted;
+    }
+  }
+  printf("data chunks: %s (%i sounds converted into format of mixer)\n", valid ? "yes" : "no", converted);
+  return valid ? 0 : 1;
+}
@@ -0,0 +1,241 @@
+/**
+ * Host benchmark: texture atlas.
+ *
+ * Decodes every PNG from assets/texture and uploads it either standalone,
+ * texture per image as before, or packed by TextureAtlas into few pages.
+ * Reports packing time, pages, occupancy and uploaded bytes, then texture
+ * binds of a typical frame: background, explosions, laser, several prizes
+ * falling and prize catch, each binding its texture unless it is bound
+ * already, as AsyncContext::applySprite() does. GL is replaced by host
+ * mock (GLContext.h). Uploaded pages are read back: every sprite must be
+ * exactly its image, padding must repeat its edges, texture coordinates
+ * must hit its pixels. Loading the same textures again must replace the
+ * pages rather than add to them.
+ *
+ * Usage: bench_atlas [rounds] [prizes] [assets_dir]
+ */
+
+#include <dirent.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AssetDirectory.h"
+#include "AssetStorage.h"
+#include "GLContext.h"
+#include "TextureAtlas.h"
+
+#ifndef ARKANOID_ASSETS_DIR
+#define ARKANOID_ASSETS_DIR "../assets"
+#endif
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+typedef std::vector<std::unique_ptr<native::Texture>> Textures;
+
+std::vector<std::string> listFiles(const std::string& path, const char* extension) {
+  std::vector<std::string> names;
+  DIR* dir = opendir(path.c_str());
+  if (dir == nullptr) {
+    return names;
+  }
+  while (dirent* entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    if (name.size() > 4 && name.compare(name.size() - 4, 4, extension) == 0) {
+      names.push_back(name);
+    }
+  }
+  closedir(dir);
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+double millis(Clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count() / 1000.0;
+}
+
+Textures decodeAll(AssetStorage* storage, const std::vector<std::string>& names) {
+  Textures textures;
+  for (const std::string& name : names) {
+    textures.emplace_back(new native::PNGTexture(storage, ("texture/" + name).c_str()));
+    if (!textures.back()->decode()) {
+      fprintf(stderr, "Failed to decode %s\n", name.c_str());
+    }
+  }
+  return textures;
+}
+
+/// @brief Names of sprites drawn in a typical frame, in order of drawing.
+std::vector<std::string> frameSprites(const std::vector<std::string>& names, int prizes) {
+  std::vector<std::string> sprites = {"bg_blueov.png", "smoke.png", "ef_laser.png"};
+  for (const std::string& name : names) {
+    if (prizes > 0 && name.compare(0, 3, "pr_") == 0) {
+      sprites.push_back(name);
+      --prizes;
+    }
+  }
+  sprites.push_back("spark.png");
+  return sprites;
+}
+
+/// @brief Texture binds made by drawing textures in order, skipping bound ones.
+int countBinds(const std::vector<const native::Texture*>& textures) {
+  int binds = host::getGLStatistics().binds;
+  const native::Texture* applied = nullptr;
+  for (const native::Texture* texture : textures) {
+    if (texture != applied) {
+      texture->apply();
+      applied = texture;
+    }
+  }
+  glBindTexture(GL_TEXTURE_2D, 0);
+  return host::getGLStatistics().binds - binds - 1;
+}
+
+/// @brief Whether uploaded sprite matches decoded image and repeats its edges over padding.
+bool isExactSprite(const native::Sprite& sprite, const native::Texture& reference, int padding) {
+  const native::Texture* page = sprite.texture;
+  std::vector<unsigned char> pixels = host::getTexturePixels(page->getID());
+  const int32_t page_width = page->getWidth();
+  const int32_t page_height = page->getHeight();
+  if (pixels.size() != static_cast<size_t>(page_width) * page_height * 4 ||
+      sprite.width != reference.getWidth() || sprite.height != reference.getHeight()) {
+    return false;
+  }
+  // texture coordinates are exact edges of sprite's pixels
+  if (std::lround(sprite.uv[0] * page_width) != sprite.x || std::lround(sprite.uv[1] * page_height) != sprite.y ||
+      std::lround(sprite.uv[2] * page_width) != sprite.x + sprite.width ||
+      std::lround(sprite.uv[3] * page_height) != sprite.y + sprite.height) {
+    return false;
+  }
+  const int channels = reference.getFormat() == GL_RGBA ? 4 : 3;
+  const uint8_t* image = reference.getPixels();
+  for (int32_t row = -padding; row < sprite.height + padding; ++row) {
+    for (int32_t col = -padding; col < sprite.width + padding; ++col) {
+      int32_t r = std::min(std::max(row, 0), sprite.height - 1);
+      int32_t c = std::min(std::max(col, 0), sprite.width - 1);
+      const uint8_t* expected = image + (r * sprite.width + c) * channels;
+      const unsigned char* actual = &pixels[((sprite.y + row) * page_width + sprite.x + col) * 4];
+      if (actual[0] != expected[0] || actual[1] != expected[1] || actual[2] != expected[2] ||
+          actual[3] != (channels == 4 ? expected[3] : 255)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int rounds = argc > 1 ? std::atoi(argv[1]) : 5;
+  int prizes = argc > 2 ? std::atoi(argv[2]) : 8;
+  std::string directory = argc > 3 ? argv[3] : ARKANOID_ASSETS_DIR;
+
+  std::vector<std::string> names = listFiles(directory + "/texture", ".png");
+  if (names.empty()) {
+    fprintf(stderr, "No textures found in %s/texture\n", directory.c_str());
+    return 1;
+  }
+  host::setAssetDirectory(directory.c_str());
+  AssetStorage storage(nullptr, nullptr);
+  host::makeContextCurrent();
+
+  // standalone: texture per image
+  std::vector<double> times;
+  host::GLStatistics standalone_gl {0, 0, 0, 0};
+  int standalone_binds = 0;
+  for (int r = 0; r < rounds; ++r) {
+    Textures textures = decodeAll(&storage, names);
+    host::makeContextCurrent();
+    auto start = Clock::now();
+    for (auto& texture : textures) {
+      texture->upload();
+    }
+    times.push_back(millis(start));
+    standalone_gl = host::getGLStatistics();
+
+    std::vector<const native::Texture*> frame;
+    for (const std::string& sprite : frameSprites(names, prizes)) {
+      for (auto& texture : textures) {
+        if (sprite == texture->getName()) {
+          frame.push_back(texture.get());
+        }
+      }
+    }
+    standalone_binds = countBinds(frame);
+  }
+  std::sort(times.begin(), times.end());
+  printf("standalone textures=%d upload_ms=%.2f uploaded_kb=%lld frame_binds=%d\n",
+      standalone_gl.textures, times[times.size() / 2], standalone_gl.uploaded_bytes / 1024, standalone_binds);
+
+  // atlas: images packed into pages
+  times.clear();
+  bool valid = true;
+  host::GLStatistics atlas_gl {0, 0, 0, 0};
+  int atlas_binds = 0;
+  std::string pages;
+  double occupancy = 0;
+  for (int r = 0; r < rounds; ++r) {
+    Textures textures = decodeAll(&storage, names);
+    Textures references = decodeAll(&storage, names);
+    host::makeContextCurrent();
+    native::TextureAtlas atlas;
+    auto start = Clock::now();
+    for (auto& texture : textures) {
+      valid = atlas.add(texture.get()) && valid;
+    }
+    valid = atlas.upload() && valid;
+    times.push_back(millis(start));
+    atlas_gl = host::getGLStatistics();
+
+    long long page_area = 0;
+    pages.clear();
+    for (size_t i = 0; i < atlas.getPageCount(); ++i) {
+      const native::Texture* page = atlas.getPage(i);
+      page_area += static_cast<long long>(page->getWidth()) * page->getHeight();
+      pages += (i > 0 ? "," : "") + std::to_string(page->getWidth()) + "x" + std::to_string(page->getHeight());
+    }
+    occupancy = page_area > 0 ? 100.0 * atlas.getPackedArea() / page_area : 0;
+
+    std::vector<const native::Texture*> frame;
+    for (const std::string& sprite : frameSprites(names, prizes)) {
+      frame.push_back(atlas.getSprite(sprite)->texture);
+    }
+    atlas_binds = countBinds(frame);
+
+    int standalone = 0;
+    for (size_t i = 0; i < names.size(); ++i) {
+      const native::Sprite* sprite = atlas.getSprite(names[i]);
+      if (sprite->texture == textures[i].get()) {
+        ++standalone;
+        valid = valid && sprite->uv[0] == 0 && sprite->uv[1] == 0 && sprite->uv[2] == 1 && sprite->uv[3] == 1;
+      } else {
+        valid = valid && isExactSprite(*sprite, *references[i], native::TextureAtlas::defaultPadding);
+      }
+    }
+    valid = valid && atlas_gl.textures == static_cast<int>(atlas.getPageCount()) + standalone;
+
+    // reload: sprites move to new pages, former ones are deleted
+    size_t page_count = atlas.getPageCount();
+    Textures reloaded = decodeAll(&storage, names);
+    for (auto& texture : reloaded) {
+      valid = atlas.add(texture.get()) && valid;
+    }
+    valid = atlas.upload() && valid;
+    valid = valid && atlas.getPageCount() == page_count &&
+        host::getGLStatistics().textures == static_cast<int>(page_count) + 2 * standalone;  // former standalone kept by their textures
+  }
+  std::sort(times.begin(), times.end());
+  printf("atlas      textures=%d pack_upload_ms=%.2f uploaded_kb=%lld frame_binds=%d pages=%s occupancy=%.1f%%\n",
+      atlas_gl.textures, times[times.size() / 2], atlas_gl.uploaded_bytes / 1024, atlas_binds, pages.c_str(), occupancy);
+  printf("prizes=%d sprites exact, reload replaces pages: %s\n", prizes, valid ? "yes" : "no");
+  return valid ? 0 : 1;
+}
@@ -0,0 +1,182 @@
+/**
+ * Host benchmark: swept ball-vs-block collision.
+ *
+ * Casts random ball steps of several lengths through a level's grid with
+ * sweepBlocks() and reports sweeps and collisions per second. Results are
+ * verified against brute-force reference, which samples the step densely
+ * and finds the first moment when ball's box overlaps a non-empty block:
+ * no hit may be missed or reported late, and every hit must touch its block
+ * (grazing contacts shorter than sampling interval are found by sweep only).
+ * Hits which a probe at the end of the step alone would miss (ball tunnels
+ * through the block) are counted as well.
+ *
+ * Usage: bench_collision [sweeps_per_speed] [seed]
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Level.h"
+#include "LevelDimens.h"
+#include "Params.h"
+#include "Sweep.h"
+#include "utils.h"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+constexpr float aspect = 0.6f;
+constexpr int referenceSamples = 4096;
+
+const std::vector<std::string> layout = {
+  "", "",
+  "SSSSSSSSSS",
+  "S  B  B  S",
+  "S BBB BB S",
+  "  B    B  ",
+  "   FF  C  ",
+  " E    RR  ",
+  "S S S S S ",
+  " T T T T T",
+  "", "",
+  "BB  CC  FF",
+  ""};
+
+struct Box {
+  int first_row, last_row, first_col, last_col;
+};
+
+Box cover(float x, float y, float hw, float hh, const game::LevelDimens& dimens, float tolerance = 0.0f) {
+  float gx = x + 1.0f, gy = 1.0f - y;
+  hw += tolerance;
+  hh += tolerance;
+  Box box;
+  box.first_col = static_cast<int>(std::floor((gx - hw) / dimens.getBlockWidth()));
+  box.last_col = static_cast<int>(std::ceil((gx + hw) / dimens.getBlockWidth())) - 1;
+  box.first_row = static_cast<int>(std::floor((gy - hh) / dimens.getBlockHeight()));
+  box.last_row = static_cast<int>(std::ceil((gy + hh) / dimens.getBlockHeight())) - 1;
+  return box;
+}
+
+bool solid(const game::Level& level, int row, int col) {
+  return row >= 0 && row < level.numRows() && col >= 0 && col < level.numCols() &&
+         level.getBlock(row, col) != game::Block::NONE;
+}
+
+bool inside(const Box& box, int row, int col) {
+  return row >= box.first_row && row <= box.last_row && col >= box.first_col && col <= box.last_col;
+}
+
+bool overlapsAny(const game::Level& level, const Box& box, const Box* except) {
+  for (int row = box.first_row; row <= box.last_row; ++row) {
+    for (int col = box.first_col; col <= box.last_col; ++col) {
+      if (solid(level, row, col) && (except == nullptr || !inside(*except, row, col))) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/// @brief Finds fraction of the step when box first overlaps a block
+/// which hasn't been overlapped at the start, or 2 if there is no such moment.
+float referenceTime(const game::Level& level, const game::LevelDimens& dimens, float hw, float hh,
+                    float x0, float y0, float x1, float y1) {
+  Box start = cover(x0, y0, hw, hh, dimens);
+  for (int i = 1; i <= referenceSamples; ++i) {
+    float t = static_cast<float>(i) / referenceSamples;
+    Box box = cover(x0 + (x1 - x0) * t, y0 + (y1 - y0) * t, hw, hh, dimens);
+    if (overlapsAny(level, box, &start)) {
+      return t;
+    }
+  }
+  return 2.0f;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int sweeps = argc > 1 ? std::atoi(argv[1]) : 200000;
+  unsigned int seed = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1;
+
+  game::Level::Ptr level = game::Level::fromStringArray(layout, layout.size());
+  game::LevelDimens dimens(
+      level->numRows(),
+      level->numCols(),
+      level->numCols() * game::LevelDimens::blockWidth,
+      level->numRows() * game::LevelDimens::blockHeight * aspect,
+      game::LevelDimens::blockWidth,
+      game::LevelDimens::blockHeight * aspect);
+  const float hw = game::BallParams::ballHalfSize;
+  const float hh = game::BallParams::ballHalfSize * aspect;
+
+  std::default_random_engine generator(seed);
+  std::uniform_real_distribution<float> x_distribution(-1.0f + hw, 1.0f - hw);
+  std::uniform_real_distribution<float> y_distribution(1.0f - dimens.getHeight(), 1.0f - hh);
+  std::uniform_real_distribution<float> angle_distribution(0.0f, util::_2PI);
+
+  const float steps[] = {
+    game::BallParams::ballSpeed,
+    game::BallParams::ballFastSpeed,
+    game::BallParams::ballSpeed * 16,
+    game::LevelDimens::blockWidth,
+    game::LevelDimens::blockWidth * 4};
+
+  bool mismatch = false;
+  for (float step : steps) {
+    std::vector<float> segments;  // x0, y0, x1, y1
+    segments.reserve(sweeps * 4);
+    while (static_cast<int>(segments.size()) < sweeps * 4) {
+      float x = x_distribution(generator), y = y_distribution(generator);
+      if (overlapsAny(*level, cover(x, y, hw, hh, dimens), nullptr)) {
+        continue;  // ball never starts inside a block
+      }
+      float angle = angle_distribution(generator);
+      segments.insert(segments.end(), {x, y, x + step * std::cos(angle), y + step * std::sin(angle)});
+    }
+
+    std::vector<game::Impact> impacts(sweeps);
+    std::vector<char> hits(sweeps);
+    long long collisions = 0;
+    auto start = Clock::now();
+    for (int i = 0; i < sweeps; ++i) {
+      const float* s = &segments[i * 4];
+      hits[i] = game::sweepBlocks(*level, dimens, hw, hh, s[0], s[1], s[2], s[3], &impacts[i]);
+      collisions += hits[i];
+    }
+    double seconds = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count() / 1e9;
+
+    // verification against brute force
+    int verify = std::min(sweeps, 20000);
+    long long wrong = 0, tunnels = 0;
+    for (int i = 0; i < verify; ++i) {
+      const float* s = &segments[i * 4];
+      float t = referenceTime(*level, dimens, hw, hh, s[0], s[1], s[2], s[3]);
+      if (!hits[i]) {
+        wrong += t <= 1.0f ? 1 : 0;
+        continue;
+      }
+      const game::Impact& impact = impacts[i];
+      Box contact = cover(s[0] + (s[2] - s[0]) * impact.time, s[1] + (s[3] - s[1]) * impact.time,
+                          hw, hh, dimens, 1e-4f);
+      bool valid = solid(*level, impact.row, impact.col) &&
+                   inside(contact, impact.row, impact.col) &&
+                   !inside(cover(s[0], s[1], hw, hh, dimens), impact.row, impact.col) &&
+                   impact.time <= t + 1.0f / referenceSamples;
+      wrong += valid ? 0 : 1;
+      tunnels += overlapsAny(*level, cover(s[2], s[3], hw, hh, dimens), nullptr) ? 0 : 1;
+    }
+    mismatch = mismatch || wrong > 0;
+
+    printf("step=%.4f sweeps/sec=%.0f collisions/sec=%.0f hit_ratio=%.3f verified=%d wrong=%lld tunnels=%lld\n",
+        step, sweeps / seconds, collisions / seconds, static_cast<double>(collisions) / sweeps,
+        verify, wrong, tunnels);
+  }
+  return mismatch ? 1 : 0;
+}
@@ -0,0 +1,164 @@
+/**
+ * Host microbenchmark: dispatch of Event to listeners.
+ *
+ * Compares legacy Event (std::list of shared ListenerBinder, each calling
+ * std::function made by std::bind, event passed by value) against Event
+ * keeping listeners contiguously and calling Delegate with const reference.
+ * Every scheme notifies 1, 4 and 16 listeners with small (bool), large
+ * (Ball, as move_ball_event would) and reference counted (Level::Ptr)
+ * payload. Reports nanoseconds per notification and per listener call,
+ * and heap allocations made while notifying.
+ *
+ * Usage: bench_event [notifications]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AllocationCounter.h"
+#include "Ball.h"
+#include "Event.h"
+#include "Level.h"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+/* Legacy scheme */
+// ----------------------------------------------------------------------------
+template <typename E>
+class LegacyEvent {
+public:
+  struct Binder {
+    Binder(std::function<void (E)> f) : f(f), bound(true) {}
+
+    void callListenerSafe(E e) {
+      if (bound) {
+        f(e);
+      }
+    }
+
+    std::function<void (E)> f;
+    bool bound;
+  };
+
+  template <typename P, typename Func>
+  std::shared_ptr<Binder> createListener(Func f, P p) {
+    std::function<void (E)> func = std::bind(f, p, std::placeholders::_1);
+    std::shared_ptr<Binder> binder = std::make_shared<Binder>(func);
+    listeners.emplace_back(binder);
+    return binder;
+  }
+
+  void notifyListeners(E e) {
+    for (auto& l : listeners) {
+      l->callListenerSafe(e);
+    }
+  }
+
+private:
+  std::list<std::shared_ptr<Binder>> listeners;
+};
+
+/* Listeners */
+// ----------------------------------------------------------------------------
+/// @brief Listener taking event by value, as callbacks used to.
+template <typename E>
+struct ValueSink {
+  ValueSink() : calls(0) {}
+  void callback(E /* e */) { ++calls; }
+  long long calls;
+};
+
+/// @brief Listener taking event by reference, as callbacks do now.
+template <typename E>
+struct ReferenceSink {
+  ReferenceSink() : calls(0) {}
+  void callback(const E& /* e */) { ++calls; }
+  long long calls;
+};
+
+struct Result {
+  double nanos;
+  long long allocations;
+  long long calls;
+};
+
+template <typename E>
+Result runLegacy(const E& payload, int listeners, long long notifications) {
+  LegacyEvent<E> event;
+  std::vector<ValueSink<E>> sinks(listeners);
+  std::vector<std::shared_ptr<typename LegacyEvent<E>::Binder>> binders;
+  for (ValueSink<E>& sink : sinks) {
+    binders.push_back(event.createListener(&ValueSink<E>::callback, &sink));
+  }
+  long long before = util::threadAllocations();
+  auto start = Clock::now();
+  for (long long i = 0; i < notifications; ++i) {
+    event.notifyListeners(payload);
+  }
+  double elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+  Result result {elapsed / notifications, util::threadAllocations() - before, 0};
+  for (const ValueSink<E>& sink : sinks) {
+    result.calls += sink.calls;
+  }
+  return result;
+}
+
+template <typename E>
+Result runDelegate(const E& payload, int listeners, long long notifications) {
+  Event<E> event;
+  std::vector<ReferenceSink<E>> sinks(listeners);
+  std::vector<std::unique_ptr<EventListener<E>>> bound;
+  for (ReferenceSink<E>& sink : sinks) {
+    bound.emplace_back(new EventListener<E>());
+    *bound.back() = event.createListener(&ReferenceSink<E>::callback, &sink);
+  }
+  long long before = util::threadAllocations();
+  auto start = Clock::now();
+  for (long long i = 0; i < notifications; ++i) {
+    event.notifyListeners(payload);
+  }
+  double elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+  Result result {elapsed / notifications, util::threadAllocations() - before, 0};
+  for (const ReferenceSink<E>& sink : sinks) {
+    result.calls += sink.calls;
+  }
+  return result;
+}
+
+template <typename E>
+bool measure(const char* name, const E& payload, long long notifications) {
+  bool valid = true;
+  for (int listeners : {1, 4, 16}) {
+    Result legacy = runLegacy(payload, listeners, notifications);
+    Result delegate = runDelegate(payload, listeners, notifications);
+    valid = valid && legacy.calls == delegate.calls && legacy.calls == notifications * listeners;
+    printf("%-10s listeners=%2i legacy ns/notify=%7.2f ns/call=%5.2f allocs=%lld | delegate ns/notify=%7.2f ns/call=%5.2f allocs=%lld (%.1fx)\n",
+        name, listeners, legacy.nanos, legacy.nanos / listeners, legacy.allocations,
+        delegate.nanos, delegate.nanos / listeners, delegate.allocations, legacy.nanos / delegate.nanos);
+  }
+  return valid;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  long long notifications = argc > 1 ? std::atoll(argv[1]) : 2000000;
+
+  game::Ball ball(0.1f, 0.06f);
+  game::Level::Ptr level = game::Level::fromStringArray({"BBBBBBBBBB", "SSSSSSSSSS"}, 2);
+
+  bool valid = measure("bool", true, notifications);
+  valid = measure("Ball", ball, notifications) && valid;
+  valid = measure("Level::Ptr", level, notifications) && valid;
+  printf("every listener called on every notification: %s\n", valid ? "yes" : "no");
+  return valid ? 0 : 1;
+}
@@ -0,0 +1,167 @@
+/**
+ * Host microbenchmark: delivery of events into ActiveObject.
+ *
+ * Compares legacy mailbox scheme (std::mutex + std::atomic_bool + payload
+ * overwritten by each callback) against QueuedActiveObject fed by lock-free
+ * EventQueue. Reports delivered / lost events, events per second and
+ * p50 / p99 latency between callback and processing. Every producer count
+ * is measured twice: saturated (back-to-back callbacks) and paced (one
+ * callback per 'interval' microseconds, close to in-game event rates).
+ * Samples are not coalescable, so queue which stays full for longer than
+ * QueuedActiveObject::maxPostWait spills them into overflow list instead
+ * of losing them.
+ *
+ * Usage: bench_event_queue [events_per_producer] [producers] [interval_us]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ActiveObject.h"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+inline long long nowNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      Clock::now().time_since_epoch()).count();
+}
+
+struct Sample {
+  Sample(long long timestamp = 0) : timestamp(timestamp) {}
+  long long timestamp;
+};
+
+/// @brief Consumer-side statistics, touched only by ActiveObject thread.
+struct Stats {
+  Stats() : delivered(0) { latencies.reserve(1 << 20); }
+
+  void record(long long timestamp) {
+    latencies.push_back(nowNanos() - timestamp);
+    delivered.fetch_add(1);
+  }
+
+  std::vector<long long> latencies;
+  std::atomic<long long> delivered;
+};
+
+/* Legacy scheme */
+// ----------------------------------------------------------------------------
+class MailboxConsumer : public ActiveObject {
+public:
+  MailboxConsumer() : m_payload() { m_received.store(false); }
+
+  void callback(Sample sample) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_received.store(true);
+    m_payload = sample;  // previous payload is overwritten
+    interrupt();
+  }
+
+  Stats stats;
+
+private:
+  std::mutex m_mutex;
+  std::atomic_bool m_received;
+  Sample m_payload;
+
+  bool checkForWakeUp() override final {
+    return m_received.load();
+  }
+
+  void eventHandler() override final {
+    if (m_received.load()) {
+      m_received.store(false);
+      std::unique_lock<std::mutex> lock(m_mutex);
+      stats.record(m_payload.timestamp);
+    }
+  }
+};
+
+/* Queued scheme */
+// ----------------------------------------------------------------------------
+class QueuedConsumer : public QueuedActiveObject<Sample> {
+public:
+  void callback(Sample sample) {
+    post(std::move(sample));
+  }
+
+  Stats stats;
+
+private:
+  void dispatch(Sample& sample) override final {
+    stats.record(sample.timestamp);
+  }
+};
+
+// ----------------------------------------------------------------------------
+template <typename Consumer>
+void run(const char* name, long long events_per_producer, int producers, int interval_us) {
+  Consumer consumer;
+  consumer.launch();
+
+  long long start = nowNanos();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < producers; ++i) {
+    threads.emplace_back([&consumer, events_per_producer, interval_us]() {
+      for (long long e = 0; e < events_per_producer; ++e) {
+        consumer.callback(Sample(nowNanos()));
+        if (interval_us > 0) {
+          std::this_thread::sleep_for(std::chrono::microseconds(interval_us));
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // let consumer process what is still pending
+  long long produced = events_per_producer * producers;
+  long long last = -1;
+  while (consumer.stats.delivered.load() != produced && consumer.stats.delivered.load() != last) {
+    last = consumer.stats.delivered.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  long long elapsed = nowNanos() - start;
+  consumer.stop();
+
+  auto& latencies = consumer.stats.latencies;
+  std::sort(latencies.begin(), latencies.end());
+  long long delivered = latencies.size();
+  long long p50 = delivered > 0 ? latencies[delivered / 2] : 0;
+  long long p99 = delivered > 0 ? latencies[std::min(delivered - 1, delivered * 99 / 100)] : 0;
+
+  printf("%-8s %s producers=%d produced=%lld delivered=%lld lost=%lld events/sec=%.0f p50=%.2fus p99=%.2fus\n",
+      name, interval_us > 0 ? "paced" : "burst", producers, produced, delivered, produced - delivered,
+      delivered * 1e9 / elapsed, p50 / 1e3, p99 / 1e3);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  long long events = argc > 1 ? std::atoll(argv[1]) : 200000;
+  int producers = argc > 2 ? std::atoi(argv[2]) : 0;
+  int interval_us = argc > 3 ? std::atoi(argv[3]) : 100;
+
+  std::vector<int> producer_counts;
+  if (producers > 0) {
+    producer_counts.push_back(producers);
+  } else {
+    producer_counts = {1, 2, 4};
+  }
+  for (int count : producer_counts) {
+    run<MailboxConsumer>("mailbox", events, count, 0);
+    run<QueuedConsumer>("queue", events, count, 0);
+    run<MailboxConsumer>("mailbox", events / 100, count, interval_us);
+    run<QueuedConsumer>("queue", events / 100, count, interval_us);
+  }
+  return 0;
+}
@@ -0,0 +1,218 @@
+/**
+ * Host benchmark: ball kinematics.
+ *
+ * Compares legacy ball moving at angle, with cosine and sine taken on
+ * every step and reflections done by angle arithmetic with fmod, against
+ * Ball moving along unit direction vector and reflected off surface
+ * normals. Balls bounce in a box off borders and horizontal surfaces,
+ * the way GameProcessor handles walls and blocks, with position clamped
+ * onto surface at impact. Reports steps per second of every scheme.
+ *
+ * Trajectories are compared over windows of steps, legacy ball being
+ * synchronized to vector one at the start of every window: maximum
+ * distance between them must stay within tolerance. Legacy angle drifts
+ * by about 3e-4 radian per reflection off left or right border, as
+ * util::_3PI is that far from 3 * PI, so trajectories are also compared
+ * without synchronization for information.
+ *
+ * Usage: bench_kinematics [steps] [balls] [window] [seed]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "Ball.h"
+#include "Params.h"
+#include "utils.h"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+constexpr float aspect = 0.6f;
+/// @brief Impact with either of two surfaces at corner may be detected
+/// a step earlier or later by one of schemes, so trajectories may part
+/// by up to two steps until both balls are clamped onto surface.
+constexpr float tolerance = 2 * game::BallParams::ballFastSpeed;
+
+struct Box {
+  float left, right, bottom, top;
+};
+
+/* Legacy scheme */
+// ----------------------------------------------------------------------------
+/// @brief Ball moving at angle, as it used to.
+struct LegacyBall {
+  float x, y, angle, velocity;
+};
+
+void normalize(LegacyBall* ball) {
+  float sign = ball->angle >= 0.0f ? 1.0f : -1.0f;
+  ball->angle = sign * std::fmod(std::fabs(ball->angle), util::_2PI);
+}
+
+void collideLeftBorder(LegacyBall* ball) {
+  if (ball->angle >= util::PI) {
+    ball->angle = util::_3PI - ball->angle;
+  } else if (ball->angle >= util::PI2) {
+    ball->angle = util::PI - ball->angle;
+  }
+  normalize(ball);
+}
+
+void collideRightBorder(LegacyBall* ball) {
+  if (ball->angle <= util::PI2) {
+    ball->angle = util::PI - ball->angle;
+  } else if (ball->angle >= util::_3PI2) {
+    ball->angle = util::_3PI - ball->angle;
+  }
+  normalize(ball);
+}
+
+void collideHorizontalSurface(LegacyBall* ball) {
+  ball->angle = util::_2PI - ball->angle;
+  normalize(ball);
+}
+
+void stepLegacy(LegacyBall* ball, const Box& box) {
+  float new_x = ball->x + ball->velocity * std::cos(ball->angle);
+  float new_y = ball->y + ball->velocity * std::sin(ball->angle);
+  bool corrected = false;
+  if (new_x >= box.right) {
+    collideRightBorder(ball);
+    new_x = box.right;
+    corrected = true;
+  } else if (new_x <= box.left) {
+    collideLeftBorder(ball);
+    new_x = box.left;
+    corrected = true;
+  }
+  if (new_y >= box.top || new_y <= box.bottom) {
+    collideHorizontalSurface(ball);
+    new_y = std::max(box.bottom, std::min(box.top, new_y));
+    corrected = true;
+  }
+  if (!corrected) {
+    new_x = ball->x + ball->velocity * std::cos(ball->angle);
+    new_y = ball->y + ball->velocity * std::sin(ball->angle);
+  }
+  ball->x = new_x;
+  ball->y = new_y;
+}
+
+/* Vector scheme */
+// ----------------------------------------------------------------------------
+void stepVector(game::Ball* ball, const Box& box) {
+  float step = ball->getVelocity();
+  float new_x = ball->getPose().getX() + step * ball->getDirectionX();
+  float new_y = ball->getPose().getY() + step * ball->getDirectionY();
+  bool corrected = false;
+  if (new_x >= box.right) {
+    if (ball->getDirectionX() > 0.0f) {
+      ball->reflect(-1.0f, 0.0f);
+    }
+    new_x = box.right;
+    corrected = true;
+  } else if (new_x <= box.left) {
+    if (ball->getDirectionX() < 0.0f) {
+      ball->reflect(1.0f, 0.0f);
+    }
+    new_x = box.left;
+    corrected = true;
+  }
+  if (new_y >= box.top || new_y <= box.bottom) {
+    ball->reflect(0.0f, 1.0f);
+    new_y = std::max(box.bottom, std::min(box.top, new_y));
+    corrected = true;
+  }
+  if (!corrected) {
+    new_x = ball->getPose().getX() + step * ball->getDirectionX();
+    new_y = ball->getPose().getY() + step * ball->getDirectionY();
+  }
+  ball->setXPose(new_x);
+  ball->setYPose(new_y);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  long long steps = argc > 1 ? std::atoll(argv[1]) : 200000;
+  int balls = argc > 2 ? std::atoi(argv[2]) : 64;
+  long long window = argc > 3 ? std::atoll(argv[3]) : 500;
+  unsigned int seed = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 1;
+
+  const float half_width = game::BallParams::ballSize * 0.5f;
+  const float half_height = game::BallParams::ballSize * aspect * 0.5f;
+  const Box box {-1.0f + half_width, 1.0f - half_width, -0.8f + half_height, 1.0f - half_height};
+
+  std::default_random_engine generator(seed);
+  std::uniform_real_distribution<float> x_distribution(box.left, box.right);
+  std::uniform_real_distribution<float> y_distribution(box.bottom, box.top);
+  std::uniform_real_distribution<float> angle_distribution(0.0f, util::_2PI);
+  std::vector<LegacyBall> legacy;
+  std::vector<game::Ball> vector;
+  for (int i = 0; i < balls; ++i) {
+    game::Ball ball(game::BallParams::ballSize, game::BallParams::ballSize * aspect);
+    ball.setXPose(x_distribution(generator));
+    ball.setYPose(y_distribution(generator));
+    ball.setAngle(angle_distribution(generator));
+    ball.setVelocity(game::BallParams::ballFastSpeed);
+    vector.push_back(ball);
+    legacy.push_back(LegacyBall {ball.getPose().getX(), ball.getPose().getY(), ball.getAngle(), ball.getVelocity()});
+  }
+
+  // timing runs, every ball stepped in turn as GameProcessor would
+  std::vector<LegacyBall> legacy_timed(legacy);
+  auto start = Clock::now();
+  for (long long s = 0; s < steps; ++s) {
+    for (LegacyBall& ball : legacy_timed) {
+      stepLegacy(&ball, box);
+    }
+  }
+  double legacy_seconds = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count() / 1e9;
+
+  std::vector<game::Ball> vector_timed(vector);
+  start = Clock::now();
+  for (long long s = 0; s < steps; ++s) {
+    for (game::Ball& ball : vector_timed) {
+      stepVector(&ball, box);
+    }
+  }
+  double vector_seconds = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count() / 1e9;
+
+  // trajectories compared at every step
+  float deviation = 0.0f, drift = 0.0f;
+  for (int i = 0; i < balls; ++i) {
+    LegacyBall a = legacy[i], free = legacy[i];
+    game::Ball b = vector[i];
+    for (long long s = 0; s < steps; ++s) {
+      if (s % window == 0) {
+        a = LegacyBall {b.getPose().getX(), b.getPose().getY(), b.getAngle(), b.getVelocity()};
+      }
+      stepLegacy(&a, box);
+      stepLegacy(&free, box);
+      stepVector(&b, box);
+      deviation = std::max(deviation, std::hypot(a.x - b.getPose().getX(), a.y - b.getPose().getY()));
+      drift = std::max(drift, std::hypot(free.x - b.getPose().getX(), free.y - b.getPose().getY()));
+    }
+  }
+  // keep timed results alive
+  float sink = 0.0f;
+  for (int i = 0; i < balls; ++i) {
+    sink += legacy_timed[i].x + vector_timed[i].getPose().getX();
+  }
+
+  double total = static_cast<double>(steps) * balls;
+  bool valid = deviation <= tolerance;
+  printf("balls=%i steps=%lld legacy steps/sec=%.0f | vector steps/sec=%.0f (%.1fx) [%.1f]\n",
+      balls, steps, total / legacy_seconds, total / vector_seconds, legacy_seconds / vector_seconds, sink);
+  printf("max trajectory deviation=%.2e within window=%lld, tolerance=%.0e: %s\n",
+      deviation, window, tolerance, valid ? "yes" : "no");
+  printf("max trajectory deviation=%.2e without synchronization\n", drift);
+  return valid ? 0 : 1;
+}
@@ -0,0 +1,154 @@
+/**
+ * Host benchmark: compressed textures.
+ *
+ * Loads every texture converted by png2ktx (build target ktx_textures)
+ * both as PNG and as KTX, and reports per texture decode and upload time
+ * and video memory, as Texture accounts them, and PSNR of compressed
+ * image against PNG one. GL is replaced by host mock (GLContext.h), which
+ * takes ETC1 and ETC2 formats. Then formats are withdrawn from the mock,
+ * and the KTX file is hidden: in both cases KTXTexture must fall back to PNG
+ * and upload exactly the same bytes as PNGTexture.
+ *
+ * Usage: bench_ktx [rounds] [assets_dir] [ktx_dir]
+ */
+
+#include <dirent.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "EtcCodec.h"
+#include "GLContext.h"
+#include "Texture.h"
+
+#ifndef ARKANOID_ASSETS_DIR
+#define ARKANOID_ASSETS_DIR "../assets"
+#endif
+#ifndef ARKANOID_KTX_DIR
+#define ARKANOID_KTX_DIR "../assets/texture_ktx"
+#endif
+
+namespace {
+
+std::vector<std::string> listFiles(const std::string& path, const char* extension) {
+  std::vector<std::string> names;
+  DIR* dir = opendir(path.c_str());
+  if (dir == nullptr) {
+    return names;
+  }
+  while (dirent* entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    if (name.size() > 4 && name.compare(name.size() - 4, 4, extension) == 0) {
+      names.push_back(name);
+    }
+  }
+  closedir(dir);
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+/// @brief Median of load statistics of texture over rounds.
+struct Timing {
+  std::vector<long long> decode;
+  std::vector<long long> upload;
+
+  void add(const native::Texture& texture) {
+    decode.push_back(texture.getDecodeMicros());
+    upload.push_back(texture.getUploadMicros());
+  }
+
+  static double median(std::vector<long long> values) {
+    std::sort(values.begin(), values.end());
+    return values.empty() ? 0 : values[values.size() / 2] / 1000.0;
+  }
+};
+
+/// @brief PSNR of RGB channels of compressed image against uploaded PNG, dB.
+double psnr(const std::vector<unsigned char>& png, int channels, const std::vector<uint8_t>& rgba) {
+  double sum = 0;
+  size_t pixels = rgba.size() / 4;
+  if (png.size() != pixels * channels) {
+    return 0;
+  }
+  for (size_t i = 0; i < pixels; ++i) {
+    for (int c = 0; c < 3; ++c) {
+      double delta = static_cast<double>(png[i * channels + c]) - rgba[i * 4 + c];
+      sum += delta * delta;
+    }
+  }
+  return sum == 0 ? INFINITY : 10.0 * std::log10(255.0 * 255.0 / (sum / (pixels * 3)));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int rounds = argc > 1 ? std::atoi(argv[1]) : 5;
+  std::string directory = argc > 2 ? argv[2] : ARKANOID_ASSETS_DIR;
+  std::string ktx_directory = argc > 3 ? argv[3] : ARKANOID_KTX_DIR;
+
+  std::vector<std::string> names = listFiles(ktx_directory, ".ktx");
+  if (names.empty()) {
+    fprintf(stderr, "No KTX files found in %s, build target ktx_textures first\n", ktx_directory.c_str());
+    return 1;
+  }
+  const std::vector<GLenum> etc_formats = {GL_ETC1_RGB8_OES, GL_COMPRESSED_RGB8_ETC2, GL_COMPRESSED_RGBA8_ETC2_EAC};
+  host::makeContextCurrent();
+
+  bool valid = true;
+  size_t png_total = 0, ktx_total = 0;
+  for (const std::string& ktx_name : names) {
+    std::string base = ktx_name.substr(0, ktx_name.size() - 4);
+    std::string png_path = directory + "/texture/" + base + ".png";
+    std::string ktx_path = ktx_directory + "/" + ktx_name;
+
+    Timing png_timing, ktx_timing;
+    size_t png_memory = 0, ktx_memory = 0;
+    std::vector<unsigned char> png_pixels;
+    int channels = 0;
+    double quality = 0;
+    for (int r = 0; r < rounds; ++r) {
+      native::PNGTexture png(png_path.c_str());
+      valid = png.load() && valid;
+      png_timing.add(png);
+      png_memory = png.getVideoMemory();
+      channels = png.getFormat() == GL_RGBA ? 4 : 3;
+      png_pixels = host::getTexturePixels(png.getID());
+
+      host::setCompressedTextureFormats(etc_formats);
+      native::KTXTexture ktx(png_path.c_str(), ktx_path.c_str());
+      valid = ktx.load() && ktx.isCompressed() && valid;
+      ktx_timing.add(ktx);
+      ktx_memory = ktx.getVideoMemory();
+      std::vector<unsigned char> blocks = host::getTexturePixels(ktx.getID());
+      valid = valid && blocks.size() == etc::compressedSize(ktx.getWidth(), ktx.getHeight(), ktx.getFormat());
+      if (valid) {
+        quality = psnr(png_pixels, channels, etc::decompress(&blocks[0], ktx.getWidth(), ktx.getHeight(), ktx.getFormat()));
+      }
+
+      // no compressed formats: PNG decoded on upload
+      host::setCompressedTextureFormats({});
+      native::KTXTexture unsupported(png_path.c_str(), ktx_path.c_str());
+      valid = unsupported.load() && !unsupported.isCompressed() && valid;
+      valid = valid && host::getTexturePixels(unsupported.getID()) == png_pixels;
+
+      // no KTX file: PNG decoded right away
+      host::setCompressedTextureFormats(etc_formats);
+      native::KTXTexture missing(png_path.c_str(), (ktx_path + ".missing").c_str());
+      valid = missing.load() && !missing.isCompressed() && valid;
+      valid = valid && host::getTexturePixels(missing.getID()) == png_pixels;
+    }
+    png_total += png_memory;
+    ktx_total += ktx_memory;
+    printf("%-20s png decode_ms=%7.2f upload_ms=%6.2f vram_kb=%5zu | ktx decode_ms=%6.2f upload_ms=%6.2f vram_kb=%5zu psnr=%.2fdB\n",
+        (base + ".png").c_str(), Timing::median(png_timing.decode), Timing::median(png_timing.upload), png_memory / 1024,
+        Timing::median(ktx_timing.decode), Timing::median(ktx_timing.upload), ktx_memory / 1024, quality);
+  }
+  printf("textures=%zu vram_kb png=%zu ktx=%zu (%.1fx less)\n",
+      names.size(), png_total / 1024, ktx_total / 1024, ktx_total > 0 ? static_cast<double>(png_total) / ktx_total : 0);
+  printf("compressed uploads, fallback to PNG uploads same bytes: %s\n", valid ? "yes" : "no");
+  return valid ? 0 : 1;
+}
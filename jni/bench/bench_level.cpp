@@ -0,0 +1,177 @@
+/**
+ * Host benchmark: block storage of large synthetic levels.
+ *
+ * Builds a seeded random level and measures full grid scan through
+ * getBlock(), lookups by type (findBlocks, findBlocksBackward) against
+ * equivalent scans, generatePresentBlock(), impacts of random blocks and
+ * effects changing blocks around (as ELECTRO, MAGIC and KNOCK blocks do).
+ * Lookups by type are verified against scans in row-major order, counts of
+ * blocks and cardinality are verified by Level::verify() and against
+ * cardinality recounted here after all the changes.
+ *
+ * Usage: bench_level [rows] [cols] [iterations] [seed]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Block.h"
+#include "Level.h"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+template <typename Func>
+double measure(int iterations, Func func) {
+  auto start = Clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    func(i);
+  }
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count() /
+      static_cast<double>(iterations);
+}
+
+void scanBlocks(const game::Level& level, game::Block type, std::vector<game::RowCol>* output) {
+  for (int r = 0; r < level.numRows(); ++r) {
+    for (int c = 0; c < level.numCols(); ++c) {
+      if (level.getBlock(r, c) == type) {
+        output->emplace_back(r, c);
+      }
+    }
+  }
+}
+
+/// @brief Whether both arrays hold the same cells in the same order.
+bool same(const std::vector<game::RowCol>& lhs, const std::vector<game::RowCol>& rhs) {
+  return lhs.size() == rhs.size() &&
+      std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](const game::RowCol& a, const game::RowCol& b) {
+        return a.row == b.row && a.col == b.col;
+      });
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int rows = argc > 1 ? std::atoi(argv[1]) : 256;
+  int cols = argc > 2 ? std::atoi(argv[2]) : 256;
+  int iterations = argc > 3 ? std::atoi(argv[3]) : 200;
+  unsigned int seed = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 1;
+
+  // mostly empty level of ordinary blocks with rare action blocks
+  const std::string common = "     ABCFGIJLPRSW";
+  const std::string rare = "EHKMNOQUYZ";
+  std::default_random_engine generator(seed);
+  std::uniform_int_distribution<int> rare_distribution(0, 999);
+  std::vector<std::string> layout(rows, std::string(cols, ' '));
+  for (auto& line : layout) {
+    for (auto& ch : line) {
+      ch = rare_distribution(generator) == 0 ?
+          rare[generator() % rare.size()] : common[generator() % common.size()];
+    }
+  }
+
+  game::Level::Ptr level;
+  double build = measure(std::max(iterations / 10, 1), [&](int) {
+    level = game::Level::fromStringArray(layout, layout.size());
+  });
+  level->getGenerator().seed(seed);
+
+  long long checksum = 0;
+  double scan = measure(iterations, [&](int) {
+    for (int r = 0; r < rows; ++r) {
+      for (int c = 0; c < cols; ++c) {
+        checksum += static_cast<int>(level->getBlock(r, c));
+      }
+    }
+  });
+
+  std::vector<game::RowCol> found, expected;
+  found.reserve(rows * cols);
+  expected.reserve(rows * cols);
+  double find_scan = measure(iterations, [&](int) {
+    expected.clear();
+    scanBlocks(*level, game::Block::NETWORK, &expected);
+  });
+  double find_rare = measure(iterations, [&](int) {
+    found.clear();
+    level->findBlocks(game::Block::NETWORK, &found);
+  });
+  bool valid = same(found, expected);
+  double find_common = measure(iterations, [&](int) {
+    found.clear();
+    level->findBlocks(game::Block::SIMPLE, &found);
+  });
+  expected.clear();
+  scanBlocks(*level, game::Block::SIMPLE, &expected);
+  valid = valid && same(found, expected);
+  int rare_count = level->countBlocks(game::Block::NETWORK);
+  int common_count = level->countBlocks(game::Block::SIMPLE);
+  std::vector<game::RowCol> backward;
+  level->findBlocksBackward(game::Block::SIMPLE, &backward);
+  std::reverse(backward.begin(), backward.end());
+  valid = valid && same(backward, found);
+
+  game::Block present = game::Block::NONE;
+  double generate = measure(iterations * 100, [&](int) {
+    present = level->generatePresentBlock();
+  });
+  valid = valid && level->countBlocks(present) > 0;
+
+  std::uniform_int_distribution<int> row_distribution(0, rows - 1);
+  std::uniform_int_distribution<int> col_distribution(0, cols - 1);
+  double impact = measure(iterations * 1000, [&](int) {
+    level->setBlockImpacted(row_distribution(generator), col_distribution(generator));
+  });
+  std::vector<game::RowCol> affected;
+  affected.reserve(rows + cols);
+  double effect = measure(iterations * 100, [&](int i) {
+    int row = row_distribution(generator), col = col_distribution(generator);
+    affected.clear();
+    switch (i % 3) {
+      case 0:
+        level->destroyBlocksAround(row, col, &affected);
+        break;
+      case 1:
+        level->changeBlocksAround(row, col, i % 2 ? game::Mode::UPGRADE : game::Mode::DEGRADE, &affected);
+        break;
+      default:
+        level->modifyBlocksAround(row, col, level->getGenerator().generateBlock(), false, &affected);
+        break;
+    }
+  });
+  expected.clear();
+  scanBlocks(*level, game::Block::NONE, &expected);
+  double find_none_scan = measure(iterations, [&](int) {
+    expected.clear();
+    scanBlocks(*level, game::Block::NONE, &expected);
+  });
+  double find_none = measure(iterations, [&](int) {
+    found.clear();
+    level->findBlocksBackwardAllowNone(game::Block::NONE, &found);
+  });
+  std::reverse(expected.begin(), expected.end());
+  valid = valid && same(found, expected);
+  int cardinality = 0;
+  for (int r = 0; r < rows; ++r) {
+    for (int c = 0; c < cols; ++c) {
+      cardinality += game::BlockUtils::getCardinalityCost(level->getBlock(r, c));
+    }
+  }
+  valid = valid && level->verify() && cardinality == level->getCardinality();
+
+  printf("level=%dx%d build_us=%.1f scan_ns/cell=%.3f checksum=%lld\n",
+      rows, cols, build / 1000, scan / (rows * cols), checksum);
+  printf("find_rare_us=%.2f (%d blocks) scan_us=%.2f find_common_us=%.2f (%d blocks)\n",
+      find_rare / 1000, rare_count, find_scan / 1000, find_common / 1000, common_count);
+  printf("find_none_us=%.2f (%d blocks) scan_us=%.2f cardinality=%d\n",
+      find_none / 1000, level->countBlocks(game::Block::NONE), find_none_scan / 1000, level->getCardinality());
+  printf("generate_present_ns=%.1f impact_ns=%.1f effect_around_ns=%.1f valid=%s\n",
+      generate, impact, effect, valid ? "yes" : "no");
+  return valid ? 0 : 1;
+}
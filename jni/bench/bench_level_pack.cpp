@@ -0,0 +1,178 @@
+/**
+ * Host benchmark: loading levels from level pack.
+ *
+ * Opens pack shipped in assets/level (made by levels2pack) and turns
+ * every level back into rows of text, as they come from Levels.java. Compares loading of level as JNI used to do it,
+ * every row copied out of Java string and parsed by fromStringArray(),
+ * against LevelPack::load() from the mapped pack and against taking its
+ * grid in place. Whole pack is timed from mapping of file to the last
+ * level built, against all levels parsed from text. Saved state of level
+ * is timed as string array against single string (toString(),
+ * fromString()). Reports time and heap allocations per level, and checks
+ * that every way gives the same blocks and cardinality.
+ *
+ * Usage: bench_level_pack [rounds] [pack]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "AllocationCounter.h"
+#include "AssetView.h"
+#include "Level.h"
+#include "LevelPack.h"
+
+#ifndef ARKANOID_LEVEL_PACK
+#define ARKANOID_LEVEL_PACK "../assets/level/levels.arkl"
+#endif
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+typedef std::vector<std::string> Rows;
+
+/// @brief Time and heap allocations per call of body, averaged over rounds.
+struct Cost {
+  double nanos;
+  double allocations;
+};
+
+template <typename Body>
+Cost measure(int rounds, int calls, Body body) {
+  long long before = util::threadAllocations();
+  auto start = Clock::now();
+  for (int round = 0; round < rounds; ++round) {
+    body();
+  }
+  double elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+  double total = static_cast<double>(rounds) * calls;
+  return Cost {elapsed / total, (util::threadAllocations() - before) / total};
+}
+
+bool same(const game::Level& lhs, const game::Level& rhs) {
+  if (lhs.numRows() != rhs.numRows() || lhs.numCols() != rhs.numCols() ||
+      lhs.getCardinality() != rhs.getCardinality()) {
+    return false;
+  }
+  for (int r = 0; r < lhs.numRows(); ++r) {
+    for (int c = 0; c < lhs.numCols(); ++c) {
+      if (lhs.getBlock(r, c) != rhs.getBlock(r, c)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/* Legacy scheme */
+// ----------------------------------------------------------------------------
+/// @brief Copies every row out of Java strings, as loadLevel() did.
+game::Level::Ptr loadFromText(const Rows& java_rows) {
+  Rows array;
+  array.reserve(java_rows.size());
+  for (const std::string& row : java_rows) {
+    array.emplace_back(row.c_str());  // copy chars
+  }
+  return game::Level::fromStringArray(array, array.size());
+}
+
+/// @brief Rows of state as saveLevel() gave them to Java and the way
+/// Java joined and split them back.
+game::Level::Ptr saveAndLoadRows(const game::Level& level) {
+  Rows array;
+  array.reserve(level.numRows());
+  level.toStringArray(&array);
+  std::string state;
+  for (size_t i = 0; i < array.size(); ++i) {
+    state += (i > 0 ? "!" : "") + array[i];
+  }
+  Rows split;
+  for (size_t begin = 0, end = 0; begin < state.size(); begin = end + 1) {
+    end = state.find('!', begin);
+    end = end == std::string::npos ? state.size() : end;
+    if (end > begin) {
+      split.emplace_back(state, begin, end - begin);
+    }
+  }
+  return loadFromText(split);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int rounds = argc > 1 ? std::atoi(argv[1]) : 200;
+  const char* path = argc > 2 ? argv[2] : ARKANOID_LEVEL_PACK;
+
+  game::LevelPack pack;
+  if (!pack.open(AssetView::mapFile(path)) || pack.empty()) {
+    fprintf(stderr, "Failed to open level pack %s\n", path);
+    return 1;
+  }
+  const int total = pack.size();
+  std::vector<Rows> texts(total);
+  size_t text_size = 0, cells = 0;
+  for (int i = 0; i < total; ++i) {
+    game::Level::Ptr level = pack.load(i);
+    level->toStringArray(&texts[i]);
+    for (const std::string& row : texts[i]) {
+      text_size += row.size();
+    }
+    cells += level->numRows() * level->numCols();
+  }
+
+  bool valid = true;
+  for (int i = 0; i < total; ++i) {
+    game::Level::Ptr level = pack.load(i);
+    game::LevelGrid grid = pack.getGrid(i);
+    valid = valid && same(*level, *loadFromText(texts[i])) && grid.cardinality == level->getCardinality();
+    valid = valid && same(*level, *game::Level::fromString(level->toString('!').c_str(), '!'));
+    valid = valid && same(*level, *saveAndLoadRows(*level));
+  }
+
+  volatile int sink = 0;
+  Cost text = measure(rounds, total, [&]() {
+    for (int i = 0; i < total; ++i) {
+      sink += loadFromText(texts[i])->getCardinality();
+    }
+  });
+  Cost packed = measure(rounds, total, [&]() {
+    for (int i = 0; i < total; ++i) {
+      sink += pack.load(i)->getCardinality();
+    }
+  });
+  Cost view = measure(rounds, total, [&]() {
+    for (int i = 0; i < total; ++i) {
+      sink += pack.getGrid(i).blocks[0];
+    }
+  });
+  Cost open = measure(rounds, 1, [&]() {
+    game::LevelPack opened;
+    opened.open(AssetView::mapFile(path));
+    for (int i = 0; i < opened.size(); ++i) {
+      sink += opened.load(i)->getCardinality();
+    }
+  });
+
+  game::Level::Ptr sample = pack.load(0);
+  Cost state_rows = measure(rounds, 1, [&]() {
+    sink += saveAndLoadRows(*sample)->getCardinality();
+  });
+  Cost state_string = measure(rounds, 1, [&]() {
+    sink += game::Level::fromString(sample->toString('!').c_str(), '!')->getCardinality();
+  });
+
+  printf("pack=%s levels=%i cells=%zu text_chars=%zu pack_bytes=%zu\n",
+      path, total, cells, text_size, AssetView::mapFile(path).size());
+  printf("per level: text ns=%.0f allocs=%.1f | pack load ns=%.0f allocs=%.1f (%.1fx) | grid view ns=%.1f\n",
+      text.nanos, text.allocations, packed.nanos, packed.allocations, text.nanos / packed.nanos, view.nanos);
+  printf("whole pack: text us=%.1f | map, validate and load us=%.1f allocs=%.0f\n",
+      text.nanos * total / 1000, open.nanos / 1000, open.allocations);
+  printf("state: rows ns=%.0f allocs=%.1f | string ns=%.0f allocs=%.1f\n",
+      state_rows.nanos, state_rows.allocations, state_string.nanos, state_string.allocations);
+  printf("same blocks and cardinality: %s\n", valid ? "yes" : "no");
+  return valid ? 0 : 1;
+}
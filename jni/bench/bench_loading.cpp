@@ -0,0 +1,224 @@
+/**
+ * Host benchmark: cold start loading of all textures and sounds.
+ *
+ * Compares the former serial loading, where the render thread decoded and
+ * uploaded every PNG while the sound thread loaded every WAV, with
+ * ResourceLoader decoding on a pool of workers and a mock context thread
+ * uploading decoded textures. GL is replaced by host mock (GLContext.h),
+ * which copies pixels as a driver would and rejects calls made outside of
+ * the context thread. Both ways must upload the same bytes. Reports
+ * whether the default pool is actually faster than serial loading: on a
+ * single core it is not, the hop of every texture between the worker and
+ * the context thread costs more than decoding gains there.
+ *
+ * Usage: bench_loading [rounds] [assets_dir]
+ */
+
+#include <dirent.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ActiveObject.h"
+#include "AssetDirectory.h"
+#include "AssetStorage.h"
+#include "GLContext.h"
+#include "ResourceLoader.h"
+
+#ifndef ARKANOID_ASSETS_DIR
+#define ARKANOID_ASSETS_DIR "../assets"
+#endif
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+using native::LoadProgress;
+using native::ResourceLoader;
+
+std::vector<std::string> listFiles(const std::string& path, const char* extension) {
+  std::vector<std::string> names;
+  DIR* dir = opendir(path.c_str());
+  if (dir == nullptr) {
+    return names;
+  }
+  while (dirent* entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    if (name.size() > 4 && name.compare(name.size() - 4, 4, extension) == 0) {
+      names.push_back(name);
+    }
+  }
+  closedir(dir);
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+/// @brief Fresh resources, nothing decoded yet.
+struct Assets {
+  std::vector<std::unique_ptr<native::Texture>> textures;
+  std::vector<std::unique_ptr<native::SoundBuffer>> sounds;
+
+  Assets(AssetStorage* storage, const std::vector<std::string>& textures, const std::vector<std::string>& sounds) {
+    for (const std::string& name : textures) {
+      this->textures.emplace_back(new native::PNGTexture(storage, ("texture/" + name).c_str()));
+    }
+    for (const std::string& name : sounds) {
+      this->sounds.emplace_back(new native::WAVSound(storage, ("sound/" + name).c_str()));
+    }
+  }
+
+  template <typename T>
+  static std::vector<T*> pointers(const std::vector<std::unique_ptr<T>>& items) {
+    std::vector<T*> result;
+    for (auto& item : items) {
+      result.push_back(item.get());
+    }
+    return result;
+  }
+};
+
+/// @brief Thread owning mock GL context, uploads textures like AsyncContext.
+class MockContext : public QueuedActiveObject<native::Texture*> {
+public:
+  void callback_textureDecoded(native::Texture* texture) {
+    post(std::move(texture));
+  }
+
+  EventListener<native::Texture*> texture_decoded_listener;
+  Event<bool> texture_uploaded_event;
+
+protected:
+  void onStart() override {
+    host::makeContextCurrent();
+    QueuedActiveObject<native::Texture*>::onStart();
+  }
+
+  void dispatch(native::Texture*& texture) override {
+    texture_uploaded_event.notifyListeners(texture->upload());
+  }
+};
+
+struct Outcome {
+  double ms;
+  LoadProgress progress;
+  host::GLStatistics gl;
+  int progress_events;
+};
+
+/// @brief Textures on render thread, sounds on sound thread, one by one.
+Outcome loadSerial(Assets& assets) {
+  Outcome outcome {0, LoadProgress(0, 0, assets.textures.size() + assets.sounds.size()), {0, 0, 0, 0}, 0};
+  int loaded[2] = {0, 0};
+  auto start = Clock::now();
+  std::thread render([&assets, &outcome, &loaded]() {
+    host::makeContextCurrent();
+    for (auto& texture : assets.textures) {
+      loaded[0] += texture->load();
+    }
+    outcome.gl = host::getGLStatistics();
+  });
+  std::thread sound([&assets, &loaded]() {
+    for (auto& sound : assets.sounds) {
+      loaded[1] += sound->load();
+    }
+  });
+  render.join();
+  sound.join();
+  outcome.ms = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count() / 1000.0;
+  outcome.progress.loaded = loaded[0] + loaded[1];
+  outcome.progress.failed = outcome.progress.total - outcome.progress.loaded;
+  return outcome;
+}
+
+/// @brief Decoding on ResourceLoader workers, uploads on mock context thread.
+Outcome loadPipeline(Assets& assets, int workers) {
+  Outcome outcome {0, LoadProgress(), {0, 0, 0, 0}, 0};
+  std::mutex mutex;
+  std::condition_variable complete;
+
+  EventListener<LoadProgress> progress_listener;  // outlives workers notifying it
+
+  auto start = Clock::now();
+  MockContext context;
+  ResourceLoader loader(workers);
+  context.texture_decoded_listener = loader.texture_decoded_event.createListener(&MockContext::callback_textureDecoded, &context);
+  loader.texture_uploaded_listener = context.texture_uploaded_event.createListener(&ResourceLoader::callback_textureUploaded, &loader);
+  progress_listener = loader.progress_event.createListener([&](LoadProgress progress) {
+    std::lock_guard<std::mutex> lock(mutex);
+    outcome.progress = progress;
+    ++outcome.progress_events;
+    if (progress.isComplete()) {
+      complete.notify_one();
+    }
+  });
+  context.launch();
+  loader.load(Assets::pointers(assets.textures), Assets::pointers(assets.sounds));
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    complete.wait(lock, [&outcome]() { return outcome.progress.total > 0 && outcome.progress.isComplete(); });
+  }
+  outcome.ms = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count() / 1000.0;
+  outcome.gl = host::getGLStatistics();
+  context.stop();
+  return outcome;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int rounds = argc > 1 ? std::atoi(argv[1]) : 5;
+  std::string directory = argc > 2 ? argv[2] : ARKANOID_ASSETS_DIR;
+
+  std::vector<std::string> textures = listFiles(directory + "/texture", ".png");
+  std::vector<std::string> sounds = listFiles(directory + "/sound", ".wav");
+  if (textures.empty() || sounds.empty()) {
+    fprintf(stderr, "No assets found in %s\n", directory.c_str());
+    return 1;
+  }
+  host::setAssetDirectory(directory.c_str());
+  AssetStorage storage(nullptr, nullptr);
+
+  bool valid = true;
+  long long serial_bytes = 0;
+  double serial_ms = 0;
+  double default_ms = 0;
+  std::vector<int> pool_sizes = {0, 1, 2, 4, ResourceLoader::defaultWorkers()};
+  for (int workers : pool_sizes) {
+    std::vector<double> times;
+    Outcome outcome;
+    for (int r = 0; r < rounds; ++r) {
+      Assets assets(&storage, textures, sounds);
+      outcome = workers == 0 ? loadSerial(assets) : loadPipeline(assets, workers);
+      times.push_back(outcome.ms);
+    }
+    std::sort(times.begin(), times.end());
+    double ms = times[times.size() / 2];
+    default_ms = ms;  // default pool goes last
+    if (workers == 0) {
+      serial_ms = ms;
+      serial_bytes = outcome.gl.uploaded_bytes;
+      printf("serial       textures=%zu sounds=%zu cold_start_ms=%.2f uploaded_kb=%lld\n",
+          textures.size(), sounds.size(), ms, outcome.gl.uploaded_bytes / 1024);
+    } else {
+      printf("workers=%-4d textures=%zu sounds=%zu cold_start_ms=%.2f speedup=%.2fx progress_events=%d\n",
+          workers, textures.size(), sounds.size(), ms, serial_ms / ms, outcome.progress_events);
+      valid = valid && outcome.progress_events == outcome.progress.total &&
+          outcome.gl.uploaded_bytes == serial_bytes;
+    }
+    valid = valid && outcome.progress.failed == 0 &&
+        outcome.progress.loaded == static_cast<int>(textures.size() + sounds.size()) &&
+        outcome.gl.foreign_calls == 0 && outcome.gl.textures == static_cast<int>(textures.size());
+  }
+  printf("cores=%u default workers=%d %s than serial loading (%.2fx)\n",
+      std::thread::hardware_concurrency(), ResourceLoader::defaultWorkers(),
+      default_ms < serial_ms ? "faster" : "no faster", serial_ms / default_ms);
+  printf("uploads on context thread only, same size: %s\n", valid ? "yes" : "no");
+  return valid ? 0 : 1;
+}
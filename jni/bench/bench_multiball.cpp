@@ -0,0 +1,260 @@
+/**
+ * Host benchmark: many balls in play at once.
+ *
+ * First compares stepping of balls kept as vector of structures, with sine
+ * and cosine of angle taken per ball per tick, against BallPool, which
+ * steps four lanes at once from cached direction and leaves only balls
+ * near walls for scalar collision handling. Both bounce balls off walls
+ * of the same free flight region. Reports nanoseconds per ball step and
+ * fraction of steps left to be resolved.
+ *
+ * Then plays GameProcessor with ZYGOTE prize caught repeatedly up to
+ * BallParams::maxBalls balls, on level of indestructible blocks and bite covering whole
+ * width, so that no ball is lost. Reports ticks and ball steps per
+ * second, heap allocations while ticking, and checks that two runs with
+ * the same seed end in the same state.
+ *
+ * Usage: bench_multiball [ticks] [seed]
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "AllocationCounter.h"
+#include "Ball.h"
+#include "BallPool.h"
+#include "Bite.h"
+#include "GameProcessor.h"
+#include "JniSink.h"
+#include "Level.h"
+#include "LevelDimens.h"
+#include "Params.h"
+#include "PrizePackage.h"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+constexpr float aspect = 0.6f;
+
+jmethodID const lostBallID = reinterpret_cast<jmethodID>(1);
+jmethodID const levelFinishedID = reinterpret_cast<jmethodID>(2);
+
+const std::vector<std::string> layout = {
+  "", "",
+  "TTTTTTTTTT",
+  "T VV  VV T",
+  "T        T",
+  "TTTTTTTTTT"};
+
+const game::FreeFlight region {-0.95f, 0.95f, -0.8f, 0.4f};
+
+/* Legacy scheme */
+// ----------------------------------------------------------------------------
+/// @brief Ball moving at angle, as it used to.
+struct LegacyBall {
+  float x, y, angle, velocity;
+};
+
+/// @brief Steps every ball on its own, as GameProcessor did for the only ball.
+int stepLegacy(std::vector<LegacyBall>* balls, float scale) {
+  int resolved = 0;
+  for (LegacyBall& ball : *balls) {
+    float step = ball.velocity * scale;
+    float new_x = ball.x + step * std::cos(ball.angle);
+    float new_y = ball.y + step * std::sin(ball.angle);
+    if (new_x > region.left && new_x < region.right && new_y > region.bottom && new_y < region.top) {
+      ball.x = new_x;
+      ball.y = new_y;
+      continue;
+    }
+    ++resolved;
+    if (new_x <= region.left || new_x >= region.right) {
+      ball.angle = std::fmod(util::_3PI - ball.angle, util::_2PI);
+    }
+    if (new_y <= region.bottom || new_y >= region.top) {
+      ball.angle = util::_2PI - ball.angle;
+    }
+  }
+  return resolved;
+}
+
+/* BallPool scheme */
+// ----------------------------------------------------------------------------
+int stepPool(game::BallPool* pool, float scale) {
+  int resolved = pool->step(scale, region);
+  for (int i = 0; resolved > 0 && i < pool->size(); ++i) {
+    if (!pool->needsResolve(i)) {
+      continue;
+    }
+    game::Ball ball = pool->get(i);
+    float new_x = pool->getNextX(i), new_y = pool->getNextY(i);
+    if (new_x <= region.left || new_x >= region.right) {
+      ball.reflect(1.0f, 0.0f);
+    }
+    if (new_y <= region.bottom || new_y >= region.top) {
+      ball.reflect(0.0f, 1.0f);
+    }
+    pool->set(i, ball);
+  }
+  return resolved;
+}
+
+struct Result {
+  double nanos;  // per ball step
+  double resolved;  // fraction of ball steps
+};
+
+Result measureLegacy(const std::vector<game::Ball>& initial, int ticks) {
+  std::vector<LegacyBall> balls;
+  for (const game::Ball& ball : initial) {
+    balls.push_back(LegacyBall {ball.getPose().getX(), ball.getPose().getY(), ball.getAngle(), ball.getVelocity()});
+  }
+  long long resolved = 0;
+  auto start = Clock::now();
+  for (int t = 0; t < ticks; ++t) {
+    resolved += stepLegacy(&balls, 1.0f);
+  }
+  double elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+  double steps = static_cast<double>(ticks) * initial.size();
+  return Result {elapsed / steps, resolved / steps};
+}
+
+Result measurePool(const std::vector<game::Ball>& initial, int ticks) {
+  game::BallPool pool;
+  pool.reset(initial[0]);
+  for (size_t i = 1; i < initial.size(); ++i) {
+    pool.spawn(0, 1.0f, 0.0f);
+    pool.set(static_cast<int>(i), initial[i]);
+  }
+  long long resolved = 0;
+  auto start = Clock::now();
+  for (int t = 0; t < ticks; ++t) {
+    resolved += stepPool(&pool, 1.0f);
+  }
+  double elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+  double steps = static_cast<double>(ticks) * initial.size();
+  return Result {elapsed / steps, resolved / steps};
+}
+
+/* Game processor */
+// ----------------------------------------------------------------------------
+/// @brief Counts lost balls and finished levels.
+class Sink : public host::JniSink {
+public:
+  Sink() : lost_balls(0), levels_finished(0) {}
+
+  void callVoidMethod(jobject /* object */, jmethodID method, va_list /* args */) override final {
+    if (method == lostBallID) {
+      ++lost_balls;
+    } else if (method == levelFinishedID) {
+      ++levels_finished;
+    }
+  }
+
+  int lost_balls;
+  int levels_finished;
+};
+
+struct Game {
+  int balls;
+  long long ticks;
+  long long allocations;
+  double seconds;
+  uint64_t state_hash;
+};
+
+Game playGame(int target_balls, int ticks, unsigned int seed) {
+  Sink sink;
+  host::setJniSink(&sink);
+  game::GameProcessor processor(host::getJavaVM());
+  processor.setOnLostBallMethodID(lostBallID);
+  processor.setOnLevelFinishedMethodID(levelFinishedID);
+  processor.setSeed(seed);
+
+  game::Level::Ptr level = game::Level::fromStringArray(layout, layout.size());
+  level->getGenerator().seed(seed);
+  level->getPrizeGenerator().seed(seed);
+  game::LevelDimens dimens(
+      level->numRows(),
+      level->numCols(),
+      level->numCols() * game::LevelDimens::blockWidth,
+      level->numRows() * game::LevelDimens::blockHeight * aspect,
+      game::LevelDimens::blockWidth,
+      game::LevelDimens::blockHeight * aspect);
+  game::Bite bite(2.0f, game::BiteParams::biteHeight * aspect);  // whole width
+  game::Ball ball(game::BallParams::ballSize, game::BallParams::ballSize * aspect);
+  ball.setXPose(0.1f);
+  ball.setYPose(-game::BiteParams::neg_biteElevation + ball.getDimens().halfHeight());
+
+  processor.callback_aspectMeasured(aspect);
+  processor.callback_loadLevel(level);
+  processor.callback_levelDimens(dimens);
+  processor.callback_initBite(bite);
+  processor.callback_initBall(ball);
+  processor.callback_throwBall(util::PI * 0.4f);
+  processor.advance(1);
+  while (processor.getBallCount() < target_balls && processor.isBallFlying()) {
+    processor.callback_prizeCaught(game::PrizePackage(0.0f, 0.0f, game::Prize::ZYGOTE));
+    processor.advance(50);  // let offspring spread
+  }
+
+  Game result {processor.getBallCount(), 0, 0, 0.0, 0};
+  long long before = util::threadAllocations();
+  auto start = Clock::now();
+  result.ticks = processor.advance(ticks);
+  result.seconds = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count() / 1e9;
+  result.allocations = util::threadAllocations() - before;
+  result.state_hash = processor.getStateHash();
+  host::setJniSink(nullptr);
+  if (sink.lost_balls > 0 || sink.levels_finished > 0) {
+    result.balls = -1;  // setup is broken, every ball should stay in play
+  }
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int ticks = argc > 1 ? std::atoi(argv[1]) : 2000;
+  unsigned int seed = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1;
+
+  std::default_random_engine generator(seed);
+  std::uniform_real_distribution<float> x_distribution(region.left, region.right);
+  std::uniform_real_distribution<float> y_distribution(region.bottom, region.top);
+  std::uniform_real_distribution<float> angle_distribution(0.0f, util::_2PI);
+  for (int count : {1, 4, 16, game::BallParams::maxBalls}) {
+    std::vector<game::Ball> balls;
+    for (int i = 0; i < count; ++i) {
+      game::Ball ball(game::BallParams::ballSize, game::BallParams::ballSize * aspect);
+      ball.setXPose(x_distribution(generator));
+      ball.setYPose(y_distribution(generator));
+      ball.setAngle(angle_distribution(generator));
+      balls.push_back(ball);
+    }
+    int pool_ticks = ticks * game::BallParams::maxBalls / count;
+    Result legacy = measureLegacy(balls, pool_ticks);
+    Result pool = measurePool(balls, pool_ticks);
+    printf("step  balls=%4i legacy ns/ball=%6.2f resolved=%.3f | pool ns/ball=%6.2f resolved=%.3f (%.1fx)\n",
+        count, legacy.nanos, legacy.resolved, pool.nanos, pool.resolved, legacy.nanos / pool.nanos);
+  }
+
+  bool valid = true;
+  for (int target : {1, 3, 9, 27, game::BallParams::maxBalls}) {
+    Game first = playGame(target, ticks, seed);
+    Game second = playGame(target, ticks, seed);
+    bool deterministic = first.state_hash == second.state_hash && first.balls == second.balls;
+    valid = valid && deterministic && first.balls > 0 && first.ticks == ticks;
+    printf("game  balls=%4i ticks=%lld ticks/sec=%9.0f ball-steps/sec=%10.0f allocs=%lld hash=%016llx deterministic=%s\n",
+        first.balls, first.ticks, first.ticks / first.seconds, first.ticks * first.balls / first.seconds,
+        first.allocations, static_cast<unsigned long long>(first.state_hash), deterministic ? "yes" : "no");
+  }
+  printf("all balls in play and runs deterministic: %s\n", valid ? "yes" : "no");
+  return valid ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+/**
+ * Host benchmark: particle pool of concurrent explosions.
+ *
+ * Keeps given number of explosions running at once by spawning them
+ * evenly over their lifetime at 60 frames per second, as renderer would
+ * do, and measures CPU cost of pool per frame together with particles
+ * drawn, draw calls and bytes uploaded per frame. Cost is compared with
+ * the former scheme, where every explosion was a separate draw of 1000
+ * particles from client arrays. Verifies that number of live explosions
+ * holds and that explosions spawned at the same point differ.
+ *
+ * Usage: bench_particles [frames] [explosions]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "ExplosionPackage.h"
+#include "ParticlePool.h"
+#include "rgbstruct.h"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+using game::ParticlePool;
+
+constexpr float frameDelta = 1.0f / 60;
+constexpr int legacyParticles = 1000;  //!< Particles per explosion drawn formerly.
+constexpr int legacyParticleSize = 5;  //!< Floats per particle drawn formerly.
+
+game::ExplosionPackage makeExplosion(int index) {
+  util::BGRA<GLfloat> color(0.2f * (index % 5), 0.5f, 1.0f - 0.1f * (index % 10), 1.0f);
+  game::Kind kind = index % 3 == 0 ? game::Kind::CONVERGE : game::Kind::DIVERGE;
+  return game::ExplosionPackage(-0.9f + 0.036f * (index % 50), 0.5f, color, kind);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int frames = argc > 1 ? std::atoi(argv[1]) : 10000;
+  int explosions = argc > 2 ? std::atoi(argv[2]) : 50;
+  explosions = std::max(1, std::min(explosions, ParticlePool::maxExplosions));
+
+  ParticlePool pool;
+  pool.setAspect(1.6f);
+  int offset = 0, count = 0;
+  pool.takeDirtyRange(&offset, &count);  // initial upload of the whole pool
+
+  // explosions spawned evenly, so that 'explosions' of them overlap
+  float spawn_period = ParticlePool::duration / explosions;
+  float spawn_timer = spawn_period;
+  int spawned = 0;
+  bool valid = true;
+
+  long long particles = 0;
+  long long uploaded = 0;
+  long long steady_frames = 0;
+  int warmup = static_cast<int>(2 * ParticlePool::duration / frameDelta);
+  auto start = Clock::now();
+  for (int f = 0; f < warmup + frames; ++f) {
+    if (f == warmup) {
+      start = Clock::now();
+    }
+    pool.advance(frameDelta);
+    spawn_timer += frameDelta;
+    while (spawn_timer >= spawn_period) {
+      spawn_timer -= spawn_period;
+      pool.spawn(makeExplosion(spawned++));
+    }
+    if (pool.takeDirtyRange(&offset, &count) && f >= warmup) {
+      uploaded += count * sizeof(GLfloat);
+    }
+    if (f >= warmup) {
+      particles += pool.getDrawCount();
+      ++steady_frames;
+      // spawn and expiry are quantized by frames
+      valid = valid && std::abs(pool.getLiveExplosions() - explosions) <= explosions / 10 + 2;
+    }
+  }
+  double elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+  // two explosions at the same point get different layouts
+  ParticlePool twins;
+  int first = twins.spawn(makeExplosion(0));
+  int second = twins.spawn(makeExplosion(50));
+  const GLfloat* vertices = twins.getVertices();
+  size_t slot_bytes = ParticlePool::particlesPerExplosion * ParticlePool::vertexSize * sizeof(GLfloat);
+  valid = valid && first != second &&
+      std::memcmp(vertices + first * slot_bytes / sizeof(GLfloat),
+                  vertices + second * slot_bytes / sizeof(GLfloat), slot_bytes) != 0;
+
+  double legacy_bytes = static_cast<double>(explosions) * legacyParticles * legacyParticleSize * sizeof(GLfloat);
+  printf("explosions=%d frames=%lld live=%d\n", explosions, steady_frames, pool.getLiveExplosions());
+  printf("pool:   particles/frame=%.0f draw_calls/frame=1 uploaded_bytes/frame=%.0f cpu_us/frame=%.3f\n",
+      static_cast<double>(particles) / steady_frames, static_cast<double>(uploaded) / steady_frames,
+      elapsed / steady_frames / 1000);
+  printf("legacy: particles/frame=%d draw_calls/frame=%d submitted_bytes/frame=%.0f\n",
+      explosions * legacyParticles, explosions, legacy_bytes);
+  printf("valid=%s\n", valid ? "yes" : "no");
+  return valid ? 0 : 1;
+}
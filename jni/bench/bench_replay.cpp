@@ -0,0 +1,245 @@
+/**
+ * Host benchmark: record and replay of game logic.
+ *
+ * Records a session of GameProcessor driven synchronously by the same
+ * autopilot as bench_simulation: levels played one after another, with
+ * InputRecorder attached, so seeds, bite moves, throws, initial balls,
+ * levels and bonus blocks flag go to replay file. Then replays the file
+ * on fresh processors as fast as possible, reports simulated ticks per
+ * second and checks that state hash at the end matches the recorded one.
+ * Replay file of a device session may be given instead of recording.
+ *
+ * Usage: bench_replay [rounds] [seed] [replay_file]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "GameProcessor.h"
+#include "GameStateSnapshot.h"
+#include "JniSink.h"
+#include "Level.h"
+#include "LevelDimens.h"
+#include "Params.h"
+#include "Replay.h"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+constexpr int totalLives = 3;
+constexpr int maxTicksPerLevel = 100000;
+constexpr float aspect = 0.6f;
+
+jmethodID const lostBallID = reinterpret_cast<jmethodID>(1);
+jmethodID const levelFinishedID = reinterpret_cast<jmethodID>(2);
+
+const std::vector<std::vector<std::string>> levels = {
+  {"", "", "", "",
+   "  BBBBBB  ",
+   "  BSSSSB  ",
+   "  BSSSSB  ",
+   "  BSSSSB  ",
+   "  BSSSSB  ",
+   "  BBBBBB  "},
+  {"", "", "", "", "", "",
+   "FFFFFFFFFF",
+   "FFFFFFFFFF",
+   "FFFFFCFFFF",
+   "FFFFCCFFFF",
+   "FFFCCCCFFF",
+   "FFCCCCCCFF",
+   "FCCCCCCCCF",
+   "CCCCCCCCCC",
+   "BBBBBBBBBB"},
+  {" S    SS  ",
+   "S   SS    ",
+   " S S      ",
+   "  S    SS ",
+   "   S  S  S",
+   "    ES    ",
+   "   SR S   ",
+   "  S R  S  ",
+   "   SR   S ",
+   "    R     "}
+};
+
+/// @brief Counts lost balls and finished levels.
+class Sink : public host::JniSink {
+public:
+  Sink() : lost_balls(0), levels_finished(0) {}
+
+  void callVoidMethod(jobject /* object */, jmethodID method, va_list /* args */) override final {
+    if (method == lostBallID) {
+      ++lost_balls;
+    } else if (method == levelFinishedID) {
+      ++levels_finished;
+    }
+  }
+
+  int lost_balls;
+  int levels_finished;
+};
+
+/// @brief Moves bite under the ball with seeded error, as user would.
+class Autopilot {
+public:
+  Autopilot(game::GameProcessor* processor, unsigned int seed)
+    : m_processor(processor)
+    , m_bite(game::BiteParams::biteWidth, game::BiteParams::biteHeight * aspect)
+    , m_generator(seed)
+    , m_error_distribution(-0.3f, 0.3f)
+    , m_error(0.0f) {
+  }
+
+  void follow(const game::GameStateSnapshot& state) {
+    const float limit = 1.0f - game::BiteParams::biteWidth * 0.5f;
+    float x = std::max(-limit, std::min(limit, state.ball.getPose().getX() + m_error));
+    if (x != m_bite.getXPose()) {
+      m_bite.setXPose(x);
+      m_processor->callback_biteMoved(m_bite);
+    }
+  }
+
+  void callback_biteImpact(bool /* dummy */) { m_error = m_error_distribution(m_generator); }
+
+  void throwBall() {
+    game::Ball ball(game::BallParams::ballSize, game::BallParams::ballSize * aspect);
+    ball.setXPose(m_bite.getXPose());
+    ball.setYPose(-game::BiteParams::neg_biteElevation + ball.getDimens().halfHeight());
+    m_processor->callback_initBall(ball);
+    m_processor->callback_throwBall(std::uniform_real_distribution<float>(util::PI / 6, util::PI * 5 / 6)(m_generator));
+  }
+
+  inline const game::Bite& getBite() const { return m_bite; }
+
+private:
+  game::GameProcessor* m_processor;
+  game::Bite m_bite;
+  std::default_random_engine m_generator;
+  std::uniform_real_distribution<float> m_error_distribution;
+  float m_error;
+};
+
+struct Recording {
+  long long ticks;
+  long long inputs;
+  uint64_t state_hash;
+  double seconds;
+};
+
+/// @brief Plays all levels in a row with recorder attached.
+Recording record(const std::string& path, unsigned int seed) {
+  Sink sink;
+  host::setJniSink(&sink);
+  game::GameProcessor processor(host::getJavaVM());
+  processor.setOnLostBallMethodID(lostBallID);
+  processor.setOnLevelFinishedMethodID(levelFinishedID);
+
+  game::ReplaySeeds seeds {seed, seed * 31 + 1, seed * 37 + 2, seed * 41 + 3};
+  auto recorder = std::make_shared<game::InputRecorder>(path.c_str(), seeds);
+  processor.setRecorder(recorder);
+
+  Autopilot autopilot(&processor, seed);
+  EventListener<bool> bite_impact_listener;
+  bite_impact_listener = processor.bite_impact_event.createListener(&Autopilot::callback_biteImpact, &autopilot);
+
+  auto start = Clock::now();
+  processor.callback_aspectMeasured(aspect);
+  for (const std::vector<std::string>& layout : levels) {
+    game::Level::Ptr level = game::Level::fromStringArray(layout, layout.size());
+    game::LevelDimens dimens(
+        level->numRows(),
+        level->numCols(),
+        level->numCols() * game::LevelDimens::blockWidth,
+        level->numRows() * game::LevelDimens::blockHeight * aspect,
+        game::LevelDimens::blockWidth,
+        game::LevelDimens::blockHeight * aspect);
+    processor.callback_loadLevel(level);
+    processor.setBonusBlocks(true);
+    processor.callback_levelDimens(dimens);
+    processor.callback_initBite(autopilot.getBite());
+    autopilot.throwBall();
+
+    sink.lost_balls = 0;
+    sink.levels_finished = 0;
+    long long ticks = 0;
+    game::GameStateSnapshot state;
+    while (ticks < maxTicksPerLevel) {
+      ticks += processor.advance(1);
+      if (processor.getGameState()->read(&state)) {
+        autopilot.follow(state);
+      }
+      if (processor.isBallFlying()) {
+        continue;
+      }
+      if (sink.levels_finished > 0 || sink.lost_balls >= totalLives) {
+        break;
+      }
+      autopilot.throwBall();
+    }
+  }
+  processor.setRecorder(nullptr);
+  processor.advance(0);
+  double seconds = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count() / 1e9;
+  host::setJniSink(nullptr);
+  return Recording {processor.getTickCount(), recorder->getRecords(), processor.getStateHash(), seconds};
+}
+
+long fileSize(const std::string& path) {
+  FILE* file = std::fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return -1;
+  }
+  std::fseek(file, 0, SEEK_END);
+  long size = std::ftell(file);
+  std::fclose(file);
+  return size;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int rounds = argc > 1 ? std::atoi(argv[1]) : 10;
+  unsigned int seed = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1;
+  std::string path = argc > 3 ? argv[3] : "bench_replay_" + std::to_string(seed) + ".arkr";
+
+  bool valid = true;
+  if (argc <= 3) {
+    Recording recording = record(path, seed);
+    printf("record  ticks=%lld inputs=%lld file_bytes=%ld ticks/sec=%.0f (with autopilot) hash=%016llx\n",
+        recording.ticks, recording.inputs, fileSize(path), recording.ticks / recording.seconds,
+        static_cast<unsigned long long>(recording.state_hash));
+  }
+
+  game::ReplayLog log;
+  if (!log.load(path.c_str())) {
+    fprintf(stderr, "Failed to load replay %s\n", path.c_str());
+    return 1;
+  }
+
+  std::vector<double> rates;
+  game::ReplayResult result {0, 0, false};
+  for (int r = 0; r < rounds; ++r) {
+    game::GameProcessor processor(host::getJavaVM());
+    auto start = Clock::now();
+    result = game::replay(log, &processor);
+    double seconds = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count() / 1e9;
+    rates.push_back(result.ticks / seconds);
+    valid = valid && !result.diverged && (!log.isComplete() || result.state_hash == log.getStateHash());
+  }
+  std::sort(rates.begin(), rates.end());
+  printf("replay  rounds=%d inputs=%zu ticks=%lld ticks/sec=%.0f (median) min=%.0f max=%.0f hash=%016llx\n",
+      rounds, log.getRecords().size(), result.ticks, rates[rates.size() / 2], rates.front(), rates.back(),
+      static_cast<unsigned long long>(result.state_hash));
+  printf("recorded hash=%016llx%s, replays match: %s\n", static_cast<unsigned long long>(log.getStateHash()),
+      log.isComplete() ? "" : " (missing)", valid ? "yes" : "no");
+  return valid ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+/**
+ * Host benchmark: random pick of resources by name prefix.
+ *
+ * Takes names of real texture and sound assets and measures latency of
+ * Resources::getRandom*() lookups through PrefixIndex, compared with the
+ * former approach: walk of unordered_map iterator to std::rand() position,
+ * retried until the name starts with prefix.
+ *
+ * Usage: bench_resources [iterations] [assets_dir]
+ */
+
+#include <dirent.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "PrefixIndex.h"
+
+#ifndef ARKANOID_ASSETS_DIR
+#define ARKANOID_ASSETS_DIR "../assets"
+#endif
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct Resource {
+  std::string name;
+};
+
+std::vector<std::string> listFiles(const std::string& path) {
+  std::vector<std::string> names;
+  DIR* dir = opendir(path.c_str());
+  if (dir == nullptr) {
+    return names;
+  }
+  while (dirent* entry = readdir(dir)) {
+    if (entry->d_name[0] != '.') {
+      names.emplace_back(entry->d_name);
+    }
+  }
+  closedir(dir);
+  return names;
+}
+
+const Resource* legacyRandom(const std::unordered_map<std::string, Resource*>& resources, const std::string& prefix) {
+  Resource* resource = nullptr;
+  bool success = false;
+  do {
+    size_t random_index = std::rand() % resources.size();
+    auto shift = resources.begin();
+    for (size_t i = 0; i < random_index; ++i) {
+      ++shift;
+    }
+    success = (shift->first.find(prefix) == 0);
+    resource = shift->second;
+  } while (!success);
+  return resource;
+}
+
+/// @brief Average nanoseconds per lookup, lookups are checked for prefix.
+template <typename Lookup>
+double measure(int iterations, const std::string& prefix, Lookup lookup, bool* valid) {
+  auto start = Clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    const Resource* resource = lookup(prefix);
+    if (resource == nullptr || resource->name.compare(0, prefix.length(), prefix) != 0) {
+      *valid = false;
+    }
+  }
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count() /
+      static_cast<double>(iterations);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int iterations = argc > 1 ? std::atoi(argv[1]) : 100000;
+  std::string assets = argc > 2 ? argv[2] : ARKANOID_ASSETS_DIR;
+
+  struct Group {
+    const char* directory;
+    std::vector<const char*> prefixes;
+  } groups[] = {
+    {"/texture", {"bg", "pr_"}},
+    {"/sound", {"bite_", "lose_", "win_", "laser_", "block_", "ultra_", "zygote_"}}};
+
+  bool valid = true;
+  for (auto& group : groups) {
+    std::vector<std::string> names = listFiles(assets + group.directory);
+    if (names.empty()) {
+      fprintf(stderr, "No assets found in %s%s\n", assets.c_str(), group.directory);
+      return 1;
+    }
+    std::vector<Resource> storage(names.size());
+    std::unordered_map<std::string, Resource*> resources;
+    util::PrefixIndex<Resource> index;
+    for (size_t i = 0; i < names.size(); ++i) {
+      storage[i].name = names[i];
+      resources[names[i]] = &storage[i];
+      index.add(names[i], &storage[i]);
+    }
+
+    for (const char* prefix : group.prefixes) {
+      if (index.count(prefix) == 0) {
+        continue;
+      }
+      double legacy = measure(iterations, prefix, [&resources](const std::string& p) {
+        return legacyRandom(resources, p);
+      }, &valid);
+      double indexed = measure(iterations, prefix, [&index](const std::string& p) {
+        return index.getRandom(p);
+      }, &valid);
+      printf("%-8s %-8s items=%zu/%zu legacy_ns=%.1f indexed_ns=%.1f speedup=%.1fx\n",
+          group.directory + 1, prefix, index.count(prefix), names.size(), legacy, indexed, legacy / indexed);
+    }
+  }
+  printf("valid=%s\n", valid ? "yes" : "no");
+  return valid ? 0 : 1;
+}
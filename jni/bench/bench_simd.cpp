@@ -0,0 +1,142 @@
+/**
+ * Host benchmark: SIMD kernels of particle and geometry generation.
+ *
+ * Compares kernels built on util::simd (SSE2 on host, NEON on device)
+ * against the scalar code they have replaced: uniform random floats from
+ * std::uniform_real_distribution, per-component fill of explosion's
+ * particles and scalar octagon grid. Geometry is checked
+ * against scalar output, random floats are checked for range and mean.
+ *
+ * Usage: bench_simd [iterations]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "Simd.h"
+#include "utils.h"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+template <typename Func>
+double measure(int iterations, Func func) {
+  auto start = Clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    func(i);
+  }
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count() /
+      static_cast<double>(iterations);
+}
+
+void report(const char* name, double scalar_ns, double simd_ns) {
+  printf("%-10s scalar_ns=%10.1f simd_ns=%10.1f speedup=%.2fx\n", name, scalar_ns, simd_ns, scalar_ns / simd_ns);
+}
+
+/* Scalar code replaced by kernels */
+// ----------------------------------------------
+void scalarParticles(GLfloat* vertices, int count, std::default_random_engine& generator, GLfloat aspect) {
+  std::uniform_real_distribution<GLfloat> distribution(0.0f, 1.0f);
+  for (int i = 0; i < count; ++i, vertices += 12) {
+    vertices[0] = distribution(generator);
+    vertices[1] = distribution(generator) * 0.25f - 0.125f;
+    vertices[2] = (distribution(generator) * 0.25f - 0.125f) * aspect;
+    vertices[3] = distribution(generator) * 2.0f - 1.0f;
+    vertices[4] = (distribution(generator) * 2.0f - 1.0f) * aspect;
+    vertices[5] = 0.1f;  vertices[6] = 0.2f;  vertices[7] = 0.0f;
+    vertices[8] = 1.0f;  vertices[9] = 0.5f;  vertices[10] = 0.25f;  vertices[11] = 0.5f;
+  }
+}
+
+void scalarOctagons(GLfloat* array, GLfloat width, GLfloat height, GLfloat x_offset, GLfloat y_offset, size_t cols, size_t rows) {
+  GLfloat w2 = width * 0.5f, h2 = height * 0.5f, w4 = width * 0.25f, h4 = height * 0.25f;
+  for (size_t r = 0; r < rows; ++r) {
+    for (size_t c = 0; c < cols; ++c) {
+      GLfloat* v = array + (c * 36) + (r * cols * 36);
+      GLfloat xy[18] = {
+          x_offset + w2, y_offset - h2,
+          x_offset + width * c, y_offset - height * r - h4,
+          x_offset + width * c + w4, y_offset - height * r,
+          x_offset + width * (c + 1) - w4, y_offset - height * r,
+          x_offset + width * (c + 1), y_offset - height * r - h4,
+          x_offset + width * (c + 1), y_offset - height * (r + 1) + h4,
+          x_offset + width * (c + 1) - w4, y_offset - height * (r + 1),
+          x_offset + width * c + w4, y_offset - height * (r + 1),
+          x_offset + width * c, y_offset - height * (r + 1) + h4};
+      for (int k = 0; k < 9; ++k) {
+        v[4 * k + 0] = xy[2 * k];  v[4 * k + 1] = xy[2 * k + 1];  v[4 * k + 2] = 0.0f;  v[4 * k + 3] = 1.0f;
+      }
+    }
+  }
+}
+
+float maxDifference(const std::vector<GLfloat>& a, const std::vector<GLfloat>& b) {
+  float result = 0.0f;
+  for (size_t i = 0; i < a.size(); ++i) {
+    result = std::max(result, std::fabs(a[i] - b[i]));
+  }
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int iterations = argc > 1 ? std::atoi(argv[1]) : 2000;
+  bool valid = true;
+  printf("instruction_set=%s\n", util::simd::instructionSet());
+
+  // uniform random floats
+  const int floats = 4096;
+  std::vector<GLfloat> random(floats);
+  std::default_random_engine generator(1);
+  std::uniform_real_distribution<GLfloat> distribution(0.0f, 1.0f);
+  util::simd::UniformLanes lanes(1);
+  double scalar_ns = measure(iterations, [&](int) {
+    for (int i = 0; i < floats; ++i) random[i] = distribution(generator);
+  });
+  double simd_ns = measure(iterations, [&](int) { lanes.fill(&random[0], floats); });
+  report("random", scalar_ns, simd_ns);
+  double sum = 0.0;
+  for (GLfloat value : random) {
+    valid = valid && value >= 0.0f && value < 1.0f;
+    sum += value;
+  }
+  valid = valid && std::fabs(sum / floats - 0.5) < 0.02;
+
+  // particles of explosion: 500 vertices of 12 floats
+  const int particles = 500;
+  const GLfloat aspect = 1.6f;
+  std::vector<GLfloat> vertices(particles * 12);
+  const GLfloat scale[8] = {1.0f, 0.25f, 0.25f * aspect, 2.0f, 2.0f * aspect, 0.0f, 0.0f, 0.0f};
+  const GLfloat bias[8] = {0.0f, -0.125f, -0.125f * aspect, -1.0f, -aspect, 0.1f, 0.2f, 0.0f};
+  const GLfloat tail[4] = {1.0f, 0.5f, 0.25f, 0.5f};
+  scalar_ns = measure(iterations, [&](int) { scalarParticles(&vertices[0], particles, generator, aspect); });
+  simd_ns = measure(iterations, [&](int i) {
+    lanes.seed(i);
+    util::simd::randomAffineVertices(&vertices[0], particles, &lanes, scale, bias, tail);
+  });
+  report("particles", scalar_ns, simd_ns);
+  for (int i = 0; i < particles; ++i) {
+    const GLfloat* v = &vertices[i * 12];
+    valid = valid && v[0] >= 0.0f && v[0] < 1.0f && std::fabs(v[1]) <= 0.125f && std::fabs(v[3]) <= 1.0f &&
+        v[5] == 0.1f && v[6] == 0.2f && v[8] == 1.0f && v[11] == 0.5f;
+  }
+
+  // geometry: grid of level's blocks and ball, rectangles of blocks stay
+  // scalar since vector stores gave them nothing
+  const size_t cols = 16, rows = 24;
+  std::vector<GLfloat> expected(cols * rows * 36), actual(cols * rows * 36);
+  scalar_ns = measure(iterations, [&](int) { scalarOctagons(&expected[0], 0.07f, 0.11f, -0.3f, 0.4f, cols, rows); });
+  simd_ns = measure(iterations, [&](int) { util::setOctagonVertices(&actual[0], 0.07f, 0.11f, -0.3f, 0.4f, cols, rows); });
+  report("octagon", scalar_ns, simd_ns);
+  valid = valid && maxDifference(expected, actual) < 1e-6f;
+
+  printf("valid=%s\n", valid ? "yes" : "no");
+  return valid ? 0 : 1;
+}
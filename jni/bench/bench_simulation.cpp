@@ -0,0 +1,270 @@
+/**
+ * Host benchmark: deterministic simulation of game logic.
+ *
+ * Plays many seeded games with GameProcessor driven synchronously
+ * (no thread, no real time) by an autopilot which reads the state
+ * published after every tick and moves bite under the ball with some
+ * seeded error, so balls are lost from time to time.
+ * Each game lasts until level is finished, all lives are lost or tick
+ * budget is exhausted. Reports simulated ticks per second, collisions
+ * per second and heap allocations made while simulating. Checksum of
+ * outcomes is printed to verify that runs with the same seed match.
+ * Heap allocations are counted by global operator new replaced in
+ * AllocationCounter.cpp (COUNT_ALLOCATIONS).
+ *
+ * Usage: bench_simulation [games] [seed] [max_ticks_per_game]
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "AllocationCounter.h"
+#include "GameProcessor.h"
+#include "GameStateSnapshot.h"
+#include "JniSink.h"
+#include "Level.h"
+#include "LevelDimens.h"
+#include "Params.h"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+constexpr int totalLives = 3;
+constexpr float aspect = 0.6f;
+
+// fake method IDs to tell Java callbacks apart
+jmethodID const lostBallID = reinterpret_cast<jmethodID>(1);
+jmethodID const levelFinishedID = reinterpret_cast<jmethodID>(2);
+jmethodID const scoreUpdatedID = reinterpret_cast<jmethodID>(3);
+jmethodID const angleChangedID = reinterpret_cast<jmethodID>(4);
+jmethodID const cardinalityChangedID = reinterpret_cast<jmethodID>(5);
+jmethodID const debugMessageID = reinterpret_cast<jmethodID>(6);
+
+const std::vector<std::vector<std::string>> levels = {
+  {"", "", "", "",
+   "  BBBBBB  ",
+   "  BSSSSB  ",
+   "  BSSSSB  ",
+   "  BSSSSB  ",
+   "  BSSSSB  ",
+   "  BBBBBB  "},
+  {"", "", "", "", "", "",
+   "FFFFFFFFFF",
+   "FFFFFFFFFF",
+   "FFFFFCFFFF",
+   "FFFFCCFFFF",
+   "FFFCCCCFFF",
+   "FFCCCCCCFF",
+   "FCCCCCCCCF",
+   "CCCCCCCCCC",
+   "BBBBBBBBBB"},
+  {"", "",
+   "S   TB   S",
+   "S   TB   S",
+   "S   TB   S",
+   "S   TB   S",
+   "S   TB   S",
+   "S   TB   S",
+   "S   TB   S",
+   "S   TB   S"},
+  {" S    SS  ",
+   "S   SS    ",
+   " S S      ",
+   "  S    SS ",
+   "   S  S  S",
+   "    ES    ",
+   "   SR S   ",
+   "  S R  S  ",
+   "   SR   S ",
+   "    R     "}
+};
+
+/// @brief Collects calls to Java layer.
+class Sink : public host::JniSink {
+public:
+  Sink() : lost_balls(0), levels_finished(0), score(0), cardinality(0) {}
+
+  void callVoidMethod(jobject /* object */, jmethodID method, va_list args) override final {
+    if (method == lostBallID) {
+      ++lost_balls;
+    } else if (method == levelFinishedID) {
+      ++levels_finished;
+    } else if (method == scoreUpdatedID) {
+      score += va_arg(args, jint);
+    } else if (method == cardinalityChangedID) {
+      cardinality = va_arg(args, jint);
+    }
+  }
+
+  long long lost_balls;
+  long long levels_finished;
+  long long score;
+  int cardinality;
+};
+
+/// @brief Moves bite under the ball and counts collisions.
+class Autopilot {
+public:
+  Autopilot(game::GameProcessor* processor, unsigned int seed)
+    : collisions(0)
+    , m_processor(processor)
+    , m_bite(game::BiteParams::biteWidth, game::BiteParams::biteHeight * aspect)
+    , m_generator(seed)
+    , m_error_distribution(-0.3f, 0.3f)
+    , m_error(0.0f) {
+  }
+
+  /// @brief Follows the ball published by processor, as renderer would.
+  void follow(const game::GameStateSnapshot& state) {
+    const float limit = 1.0f - game::BiteParams::biteWidth * 0.5f;
+    float x = std::max(-limit, std::min(limit, state.ball.getPose().getX() + m_error));
+    m_bite.setXPose(x);
+    m_processor->callback_biteMoved(m_bite);
+  }
+
+  void callback_biteImpact(bool /* dummy */) {
+    ++collisions;
+    m_error = m_error_distribution(m_generator);
+  }
+
+  void callback_blockImpact(const game::RowCol& /* block */) { ++collisions; }
+  void callback_wallImpact(bool /* dummy */) { ++collisions; }
+
+  inline const game::Bite& getBite() const { return m_bite; }
+  inline float throwAngle() { return std::uniform_real_distribution<float>(util::PI / 6, util::PI * 5 / 6)(m_generator); }
+
+  long long collisions;
+
+private:
+  game::GameProcessor* m_processor;
+  game::Bite m_bite;
+  std::default_random_engine m_generator;
+  std::uniform_real_distribution<float> m_error_distribution;
+  float m_error;
+};
+
+struct Totals {
+  Totals() : games(0), ticks(0), collisions(0), allocations(0), wins(0), checksum(0), elapsed(0) {}
+
+  long long games;
+  long long ticks;
+  long long collisions;
+  long long allocations;
+  long long wins;
+  uint64_t checksum;
+  long long elapsed;  // nanoseconds spent in simulation
+};
+
+game::Ball initialBall(const game::Bite& bite) {
+  game::Ball ball(game::BallParams::ballSize, game::BallParams::ballSize * aspect);
+  ball.setXPose(bite.getXPose());
+  ball.setYPose(-game::BiteParams::neg_biteElevation + ball.getDimens().halfHeight());
+  return ball;
+}
+
+void playGame(unsigned int seed, int max_ticks, Totals* totals) {
+  std::srand(seed);
+  Sink sink;
+  host::setJniSink(&sink);
+
+  game::GameProcessor processor(host::getJavaVM());
+  processor.setOnLostBallMethodID(lostBallID);
+  processor.setOnLevelFinishedMethodID(levelFinishedID);
+  processor.setOnScoreUpdatedMethodID(scoreUpdatedID);
+  processor.setOnAngleChangedMethodID(angleChangedID);
+  processor.setOnCardinalityChangedMethodID(cardinalityChangedID);
+  processor.setOnDebugMessageMethodID(debugMessageID);
+  processor.setSeed(seed);
+
+  Autopilot autopilot(&processor, seed);
+  EventListener<bool> bite_impact_listener;
+  EventListener<game::RowCol> block_impact_listener;
+  EventListener<bool> wall_impact_listener;
+  bite_impact_listener = processor.bite_impact_event.createListener(&Autopilot::callback_biteImpact, &autopilot);
+  block_impact_listener = processor.block_impact_event.createListener(&Autopilot::callback_blockImpact, &autopilot);
+  wall_impact_listener = processor.wall_impact_event.createListener(&Autopilot::callback_wallImpact, &autopilot);
+
+  const std::vector<std::string>& layout = levels[seed % levels.size()];
+  game::Level::Ptr level = game::Level::fromStringArray(layout, layout.size());
+  level->getGenerator().seed(seed);
+  level->getPrizeGenerator().seed(seed);
+  game::LevelDimens dimens(
+      level->numRows(),
+      level->numCols(),
+      level->numCols() * game::LevelDimens::blockWidth,
+      level->numRows() * game::LevelDimens::blockHeight * aspect,
+      game::LevelDimens::blockWidth,
+      game::LevelDimens::blockHeight * aspect);
+
+  processor.callback_aspectMeasured(aspect);
+  processor.callback_loadLevel(level);
+  processor.callback_levelDimens(dimens);
+  processor.callback_initBite(autopilot.getBite());
+  processor.callback_initBall(initialBall(autopilot.getBite()));
+  processor.callback_throwBall(autopilot.throwAngle());
+
+  long long ticks = 0;
+  long long allocations = 0;
+  game::GameStateSnapshot state;
+  auto start = Clock::now();
+  while (ticks < max_ticks) {
+    long long before = util::threadAllocations();
+    ticks += processor.advance(1);
+    allocations += util::threadAllocations() - before;
+    if (processor.getGameState()->read(&state)) {
+      autopilot.follow(state);
+    }
+    if (processor.isBallFlying()) {
+      continue;  // tick budget exhausted
+    }
+    if (sink.levels_finished > 0 || sink.lost_balls >= totalLives) {
+      break;
+    }
+    processor.callback_initBall(initialBall(autopilot.getBite()));
+    processor.callback_throwBall(autopilot.throwAngle());
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+  host::setJniSink(nullptr);
+
+  ++totals->games;
+  totals->ticks += ticks;
+  totals->collisions += autopilot.collisions;
+  totals->allocations += allocations;
+  totals->wins += sink.levels_finished > 0 ? 1 : 0;
+  totals->elapsed += elapsed;
+  uint64_t outcome[] = {static_cast<uint64_t>(ticks), static_cast<uint64_t>(sink.score),
+                        static_cast<uint64_t>(sink.cardinality), static_cast<uint64_t>(sink.lost_balls)};
+  for (uint64_t value : outcome) {
+    totals->checksum = (totals->checksum ^ value) * 1099511628211ULL;  // FNV-1a
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int games = argc > 1 ? std::atoi(argv[1]) : 2000;
+  unsigned int seed = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1;
+  int max_ticks = argc > 3 ? std::atoi(argv[3]) : 100000;
+
+  Totals totals;
+  totals.checksum = 14695981039346656037ULL;
+  for (int i = 0; i < games; ++i) {
+    playGame(seed + i, max_ticks, &totals);
+  }
+
+  double seconds = totals.elapsed / 1e9;
+  printf("games=%lld wins=%lld ticks=%lld collisions=%lld seconds=%.3f\n",
+      totals.games, totals.wins, totals.ticks, totals.collisions, seconds);
+  printf("ticks/sec=%.0f collisions/sec=%.0f allocations=%lld allocations/tick=%.4f\n",
+      totals.ticks / seconds, totals.collisions / seconds, totals.allocations,
+      totals.ticks > 0 ? static_cast<double>(totals.allocations) / totals.ticks : 0.0);
+  printf("checksum=%016llx\n", static_cast<unsigned long long>(totals.checksum));
+  return 0;
+}
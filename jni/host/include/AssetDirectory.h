@@ -0,0 +1,19 @@
+/**
+ * AssetDirectory.h
+ *
+ *  Description: Location of assets for host builds of game core, which
+ *  read them through host replacement of NDK asset manager.
+ */
+
+#ifndef __ARKANOID_HOST_ASSET_DIRECTORY__H__
+#define __ARKANOID_HOST_ASSET_DIRECTORY__H__
+
+namespace host {
+
+/// @brief Sets directory which asset names are relative to, the same
+/// as 'assets/' folder of APK. Must be called before assets are opened.
+void setAssetDirectory(const char* path);
+
+}  // namespace host
+
+#endif  // __ARKANOID_HOST_ASSET_DIRECTORY__H__
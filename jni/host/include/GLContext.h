@@ -0,0 +1,42 @@
+/**
+ * GLContext.h
+ *
+ *  Description: Host-side replacement of OpenGL ES texture calls, used by
+ *  headless builds of game core instead of a driver. Uploaded pixels are
+ *  copied as a driver would do, and calls are checked to come from the
+ *  thread which owns the context.
+ */
+
+#ifndef __ARKANOID_HOST_GL_CONTEXT__H__
+#define __ARKANOID_HOST_GL_CONTEXT__H__
+
+#include <vector>
+
+#include <GLES/gl.h>
+
+namespace host {
+
+/// @brief Counters of GL calls since the context has been made current.
+struct GLStatistics {
+  int textures;  //!< Live texture objects.
+  long long uploaded_bytes;  //!< Pixels passed to glTexImage2D() and glCompressedTexImage2D().
+  int foreign_calls;  //!< Calls from threads not owning the context.
+  int binds;  //!< glBindTexture() calls, which changed bound texture.
+};
+
+/// @brief Makes calling thread own GL context and resets statistics.
+/// GL calls from other threads fail with GL_INVALID_OPERATION.
+void makeContextCurrent();
+
+GLStatistics getGLStatistics();
+
+/// @brief Copy of pixels last uploaded into texture, empty if none.
+std::vector<unsigned char> getTexturePixels(GLuint texture);
+
+/// @brief Compressed formats the mock takes, as glGetIntegerv() reports
+/// them. ETC1 only by default, as on most GLES 2 devices.
+void setCompressedTextureFormats(const std::vector<GLenum>& formats);
+
+}  // namespace host
+
+#endif  // __ARKANOID_HOST_GL_CONTEXT__H__
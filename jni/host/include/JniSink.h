@@ -0,0 +1,41 @@
+/**
+ * JniSink.h
+ *
+ *  Description: Receiver of calls made by game core into Java layer
+ *  when core is built for host without JVM.
+ */
+
+#ifndef __ARKANOID_HOST_JNI_SINK__H__
+#define __ARKANOID_HOST_JNI_SINK__H__
+
+#include <cstdarg>
+
+#include <jni.h>
+
+namespace host {
+
+/// @class JniSink JniSink.h "host/include/JniSink.h"
+/// @brief Gets notified instead of Java methods being called.
+/// @details Methods are called on the thread which made JNI call,
+/// so implementations must be thread-safe if several processors run.
+class JniSink {
+public:
+  virtual ~JniSink() {}
+
+  /// @brief Called for JNIEnv::CallVoidMethod().
+  /// @param object Master object core has been given.
+  /// @param method Method ID core has been given, clients usually
+  /// pass some distinct fake pointers to tell methods apart.
+  /// @param args Arguments of Java method.
+  virtual void callVoidMethod(jobject /* object */, jmethodID /* method */, va_list /* args */) {}
+};
+
+/// @brief Installs sink for all subsequent JNI calls, nullptr drops them.
+void setJniSink(JniSink* sink);
+
+/// @brief Gets stub virtual machine to pass into processors' ctors.
+JavaVM* getJavaVM();
+
+}
+
+#endif  // __ARKANOID_HOST_JNI_SINK__H__
@@ -0,0 +1,32 @@
+/**
+ * android/asset_manager.h
+ *
+ *  Description: Minimal host-side replacement of NDK asset manager,
+ *  assets are plain files under directory set by host::setAssetDirectory()
+ *  (see AssetDirectory.h). Only the part which core calls is declared.
+ */
+
+#ifndef __ARKANOID_HOST_ASSET_MANAGER__H__
+#define __ARKANOID_HOST_ASSET_MANAGER__H__
+
+#include <sys/types.h>
+#include <cstddef>
+
+struct AAssetManager;
+struct AAsset;
+
+enum {
+  AASSET_MODE_UNKNOWN   = 0,
+  AASSET_MODE_RANDOM    = 1,
+  AASSET_MODE_STREAMING = 2,
+  AASSET_MODE_BUFFER    = 3
+};
+
+AAsset* AAssetManager_open(AAssetManager* manager, const char* filename, int mode);
+off_t AAsset_getLength(AAsset* asset);
+int AAsset_read(AAsset* asset, void* buffer, size_t count);
+/// @brief Whole content of asset, mapped on the first call.
+const void* AAsset_getBuffer(AAsset* asset);
+void AAsset_close(AAsset* asset);
+
+#endif  // __ARKANOID_HOST_ASSET_MANAGER__H__
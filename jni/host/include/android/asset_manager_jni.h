@@ -0,0 +1,17 @@
+/**
+ * android/asset_manager_jni.h
+ *
+ *  Description: Minimal host-side replacement of NDK asset manager JNI
+ *  accessor, any Java object gives the single host asset manager.
+ */
+
+#ifndef __ARKANOID_HOST_ASSET_MANAGER_JNI__H__
+#define __ARKANOID_HOST_ASSET_MANAGER_JNI__H__
+
+#include <jni.h>
+
+#include "android/asset_manager.h"
+
+AAssetManager* AAssetManager_fromJava(JNIEnv* env, jobject assetManager);
+
+#endif  // __ARKANOID_HOST_ASSET_MANAGER_JNI__H__
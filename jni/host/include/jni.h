@@ -0,0 +1,64 @@
+/**
+ * jni.h
+ *
+ *  Description: Minimal host-side replacement of JNI interface, used
+ *  by headless builds of game core. Only the part of JNI which core
+ *  actually calls is declared here. Every call is forwarded to
+ *  host::JniSink installed by the client (see JniSink.h).
+ */
+
+#ifndef __ARKANOID_HOST_JNI__H__
+#define __ARKANOID_HOST_JNI__H__
+
+#include <cstdarg>
+#include <cstdint>
+
+typedef uint8_t  jboolean;
+typedef int8_t   jbyte;
+typedef uint16_t jchar;
+typedef int16_t  jshort;
+typedef int32_t  jint;
+typedef int64_t  jlong;
+typedef float    jfloat;
+typedef double   jdouble;
+typedef jint     jsize;
+
+class _jobject {};
+class _jclass : public _jobject {};
+class _jstring : public _jobject {};
+typedef _jobject* jobject;
+typedef _jclass*  jclass;
+typedef _jstring* jstring;
+
+struct _jmethodID;
+typedef struct _jmethodID* jmethodID;
+
+#define JNI_FALSE 0
+#define JNI_TRUE 1
+
+#define JNI_OK 0
+#define JNI_ERR (-1)
+
+#define JNI_VERSION_1_6 0x00010006
+
+#define JNIEXPORT __attribute__ ((visibility ("default")))
+#define JNICALL
+
+struct _JNIEnv {
+  void CallVoidMethod(jobject object, jmethodID method, ...);
+  jstring NewStringUTF(const char* bytes);
+  void DeleteLocalRef(jobject object);
+  void ExceptionDescribe();
+  jint ThrowNew(jclass clazz, const char* message);
+};
+
+struct _JavaVM {
+  jint AttachCurrentThread(_JNIEnv** p_env, void* thr_args);
+  jint DetachCurrentThread();
+  jint GetEnv(void** p_env, jint version);
+};
+
+typedef _JNIEnv JNIEnv;
+typedef _JavaVM JavaVM;
+
+#endif  // __ARKANOID_HOST_JNI__H__
@@ -0,0 +1,64 @@
+#include <cstdio>
+#include <string>
+
+#include "android/asset_manager.h"
+#include "android/asset_manager_jni.h"
+#include "AssetDirectory.h"
+#include "AssetView.h"
+
+struct AAssetManager {
+  std::string directory;
+};
+
+struct AAsset {
+  FILE* file;
+  off_t length;
+  std::string path;
+  AssetView view;
+};
+
+namespace host {
+
+static AAssetManager s_manager;
+
+void setAssetDirectory(const char* path) {
+  s_manager.directory = path;
+}
+
+}  // namespace host
+
+AAssetManager* AAssetManager_fromJava(JNIEnv* /* env */, jobject /* assetManager */) {
+  return &host::s_manager;
+}
+
+AAsset* AAssetManager_open(AAssetManager* manager, const char* filename, int /* mode */) {
+  std::string path = manager->directory + "/" + filename;
+  FILE* file = std::fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return nullptr;
+  }
+  std::fseek(file, 0, SEEK_END);
+  off_t length = std::ftell(file);
+  std::rewind(file);
+  return new AAsset {file, length, path, AssetView()};
+}
+
+off_t AAsset_getLength(AAsset* asset) {
+  return asset->length;
+}
+
+int AAsset_read(AAsset* asset, void* buffer, size_t count) {
+  return static_cast<int>(std::fread(buffer, 1, count, asset->file));
+}
+
+const void* AAsset_getBuffer(AAsset* asset) {
+  if (asset->view.empty()) {
+    asset->view = AssetView::mapFile(asset->path.c_str());
+  }
+  return asset->view.data();
+}
+
+void AAsset_close(AAsset* asset) {
+  std::fclose(asset->file);
+  delete asset;
+}
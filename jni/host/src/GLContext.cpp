@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <GLES/gl.h>
+#include <GLES/glext.h>
+
+#include "GLContext.h"
+
+namespace host {
+
+static std::mutex s_mutex;
+static std::thread::id s_owner;
+static GLenum s_error = GL_NO_ERROR;
+static GLuint s_next_id = 1;
+static GLuint s_bound = 0;
+static std::unordered_map<GLuint, std::vector<unsigned char>> s_textures;
+static GLStatistics s_statistics = {0, 0, 0, 0};
+static std::vector<GLenum> s_compressed_formats = {GL_ETC1_RGB8_OES};
+
+void makeContextCurrent() {
+  std::lock_guard<std::mutex> lock(s_mutex);
+  s_owner = std::this_thread::get_id();
+  s_error = GL_NO_ERROR;
+  s_bound = 0;
+  s_textures.clear();
+  s_statistics = GLStatistics {0, 0, 0, 0};
+}
+
+GLStatistics getGLStatistics() {
+  std::lock_guard<std::mutex> lock(s_mutex);
+  s_statistics.textures = s_textures.size();
+  return s_statistics;
+}
+
+std::vector<unsigned char> getTexturePixels(GLuint texture) {
+  std::lock_guard<std::mutex> lock(s_mutex);
+  auto it = s_textures.find(texture);
+  return it != s_textures.end() ? it->second : std::vector<unsigned char>();
+}
+
+void setCompressedTextureFormats(const std::vector<GLenum>& formats) {
+  std::lock_guard<std::mutex> lock(s_mutex);
+  s_compressed_formats = formats;
+}
+
+/// @brief Whether calling thread may issue GL calls, s_mutex must be held.
+static bool isCurrent() {
+  if (std::this_thread::get_id() != s_owner) {
+    ++s_statistics.foreign_calls;
+    return false;
+  }
+  return true;
+}
+
+static void setError(GLenum error) {
+  if (s_error == GL_NO_ERROR) {
+    s_error = error;
+  }
+}
+
+static int components(GLenum format) {
+  switch (format) {
+    case GL_ALPHA:
+    case GL_LUMINANCE:
+      return 1;
+    case GL_LUMINANCE_ALPHA:
+      return 2;
+    case GL_RGB:
+      return 3;
+    case GL_RGBA:
+    default:
+      return 4;
+  }
+}
+
+}  // namespace host
+
+using namespace host;
+
+void glActiveTexture(GLenum /* texture */) {
+  std::lock_guard<std::mutex> lock(s_mutex);
+  if (!isCurrent()) { setError(GL_INVALID_OPERATION); }
+}
+
+void glBindTexture(GLenum /* target */, GLuint texture) {
+  std::lock_guard<std::mutex> lock(s_mutex);
+  if (!isCurrent()) { setError(GL_INVALID_OPERATION); return; }
+  if (s_bound != texture) {
+    ++s_statistics.binds;
+  }
+  s_bound = texture;
+}
+
+void glCompressedTexImage2D(GLenum /* target */, GLint /* level */, GLenum internalformat, GLsizei /* width */,
+                            GLsizei /* height */, GLint /* border */, GLsizei imageSize, const void* data) {
+  std::lock_guard<std::mutex> lock(s_mutex);
+  if (!isCurrent()) { setError(GL_INVALID_OPERATION); return; }
+  if (std::find(s_compressed_formats.begin(), s_compressed_formats.end(), internalformat) == s_compressed_formats.end()) {
+    setError(GL_INVALID_ENUM);
+    return;
+  }
+  auto it = s_textures.find(s_bound);
+  if (it == s_textures.end()) { setError(GL_INVALID_OPERATION); return; }
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  it->second.assign(bytes, bytes + imageSize);
+  s_statistics.uploaded_bytes += imageSize;
+}
+
+void glDeleteTextures(GLsizei n, const GLuint* textures) {
+  std::lock_guard<std::mutex> lock(s_mutex);
+  if (!isCurrent()) { setError(GL_INVALID_OPERATION); return; }
+  for (GLsizei i = 0; i < n; ++i) {
+    s_textures.erase(textures[i]);
+  }
+}
+
+void glGenTextures(GLsizei n, GLuint* textures) {
+  std::lock_guard<std::mutex> lock(s_mutex);
+  if (!isCurrent()) { setError(GL_INVALID_OPERATION); return; }
+  for (GLsizei i = 0; i < n; ++i) {
+    textures[i] = s_next_id++;
+    s_textures[textures[i]];
+  }
+}
+
+void glGetIntegerv(GLenum pname, GLint* data) {
+  std::lock_guard<std::mutex> lock(s_mutex);
+  if (!isCurrent()) { setError(GL_INVALID_OPERATION); return; }
+  switch (pname) {
+    case GL_NUM_COMPRESSED_TEXTURE_FORMATS:
+      *data = s_compressed_formats.size();
+      break;
+    case GL_COMPRESSED_TEXTURE_FORMATS:
+      std::copy(s_compressed_formats.begin(), s_compressed_formats.end(), data);
+      break;
+    default:
+      setError(GL_INVALID_ENUM);
+      break;
+  }
+}
+
+GLenum glGetError() {
+  std::lock_guard<std::mutex> lock(s_mutex);
+  if (!isCurrent()) { return GL_INVALID_OPERATION; }
+  GLenum error = s_error;
+  s_error = GL_NO_ERROR;
+  return error;
+}
+
+void glTexImage2D(GLenum /* target */, GLint /* level */, GLint /* internalformat */, GLsizei width, GLsizei height,
+                  GLint /* border */, GLenum format, GLenum /* type */, const void* pixels) {
+  std::lock_guard<std::mutex> lock(s_mutex);
+  if (!isCurrent()) { setError(GL_INVALID_OPERATION); return; }
+  auto it = s_textures.find(s_bound);
+  if (it == s_textures.end()) { setError(GL_INVALID_OPERATION); return; }
+  size_t size = static_cast<size_t>(width) * height * components(format);
+  const unsigned char* bytes = static_cast<const unsigned char*>(pixels);
+  it->second.assign(bytes, bytes + size);  // driver keeps its own copy
+  s_statistics.uploaded_bytes += size;
+}
+
+void glTexParameteri(GLenum /* target */, GLenum /* pname */, GLint /* param */) {
+  std::lock_guard<std::mutex> lock(s_mutex);
+  if (!isCurrent()) { setError(GL_INVALID_OPERATION); }
+}
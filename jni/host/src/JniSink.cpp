@@ -0,0 +1,67 @@
+#include <atomic>
+
+#include "JniSink.h"
+#include "logger.h"
+
+namespace host {
+
+static std::atomic<JniSink*> s_sink(nullptr);
+static JavaVM s_jvm;
+static JNIEnv s_jenv;
+static _jstring s_string;
+
+void setJniSink(JniSink* sink) {
+  s_sink.store(sink);
+}
+
+JavaVM* getJavaVM() {
+  return &s_jvm;
+}
+
+}
+
+/* JNIEnv */
+// ----------------------------------------------------------------------------
+void _JNIEnv::CallVoidMethod(jobject object, jmethodID method, ...) {
+  host::JniSink* sink = host::s_sink.load();
+  if (sink != nullptr) {
+    va_list args;
+    va_start(args, method);
+    sink->callVoidMethod(object, method, args);
+    va_end(args);
+  }
+}
+
+jstring _JNIEnv::NewStringUTF(const char* /* bytes */) {
+  return &host::s_string;  // content is dropped
+}
+
+void _JNIEnv::DeleteLocalRef(jobject /* object */) {
+  // no-op
+}
+
+void _JNIEnv::ExceptionDescribe() {
+  ERR("Java exception has been raised by native code");
+}
+
+jint _JNIEnv::ThrowNew(jclass /* clazz */, const char* message) {
+  (void) message;  // unused when logging is disabled
+  ERR("Throw: %s", message);
+  return JNI_OK;
+}
+
+/* JavaVM */
+// ----------------------------------------------------------------------------
+jint _JavaVM::AttachCurrentThread(JNIEnv** p_env, void* /* thr_args */) {
+  *p_env = &host::s_jenv;
+  return JNI_OK;
+}
+
+jint _JavaVM::DetachCurrentThread() {
+  return JNI_OK;
+}
+
+jint _JavaVM::GetEnv(void** p_env, jint /* version */) {
+  *p_env = &host::s_jenv;
+  return JNI_OK;
+}
@@ -32,11 +32,14 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <thread>
 
 #include "Event.h"
+#include "EventQueue.h"
+#include "logger.h"
 
 
 class ActiveObject {
@@ -44,7 +47,8 @@ public:
 	ActiveObject()
 		: m_is_detached(false)
 		, m_is_runnning(false)
-		, m_continue_running(false) {
+		, m_continue_running(false)
+		, m_is_sleeping(false) {
 		m_main_thread = nullptr;
 	}
 
@@ -71,6 +75,15 @@ public:
 		m_wake_up_condition.notify_one();
 	}
 
+	//@brief lock-free counterpart of interrupt(), takes the lock only when
+	// ActiveObject is actually blocked on wait()
+	void wakeUp() {
+	  std::atomic_thread_fence(std::memory_order_seq_cst);
+	  if (m_is_sleeping.load()) {
+	    interrupt();
+	  }
+	}
+
 	void sleep(int milliseconds) {
 	  std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
 	}
@@ -83,6 +96,7 @@ protected:
 	std::mutex m_wake_up_mutex;
 	std::condition_variable m_wake_up_condition;
 	std::atomic_bool m_continue_running;
+	std::atomic_bool m_is_sleeping;
 	bool m_is_runnning;
 	bool m_is_detached;
 
@@ -156,7 +170,10 @@ protected:
     while (m_continue_running) {
       {
         std::unique_lock<std::mutex> lock(m_wake_up_mutex);
+        m_is_sleeping.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
         m_wake_up_condition.wait(lock, [this](){ return this->checkForWakeUp() | !this->m_continue_running; });
+        m_is_sleeping.store(false);
       }
       while (checkForWakeUp() & this->m_continue_running) {
         eventHandler();
@@ -178,4 +195,137 @@ protected:
 	virtual void eventHandler() = 0;
 };
 
+/// @class QueuedActiveObject ActiveObject.h "include/ActiveObject.h"
+/// @brief ActiveObject fed by a lock-free queue of tagged messages.
+///
+/// Callbacks running on producer threads wrap their payload into a Message
+/// and post() it, so no payload is ever overwritten by the next one.
+/// ActiveObject thread drains the queue in order of arrival and passes
+/// each message to dispatch(). Producer never blocks for long: if the
+/// queue stays full for maxPostWait, coalescable message (e.g. move of
+/// bite, superseded by the next one) is dropped and counted, any other
+/// message is spilled into overflow list, drained right after the queue.
+template <typename Message>
+class QueuedActiveObject : public ActiveObject {
+public:
+  constexpr static size_t defaultQueueCapacity = 1024;
+  /// @brief How long producer waits for room in full queue, milliseconds.
+  constexpr static int maxPostWait = 2;
+
+  explicit QueuedActiveObject(size_t capacity = defaultQueueCapacity)
+    : m_event_queue(capacity)
+    , m_has_overflow(false)
+    , m_dropped_messages(0) {
+  }
+
+  virtual ~QueuedActiveObject() {}
+
+  /// @brief Coalescable messages dropped so far since queue was full.
+  inline long long getDroppedMessages() const { return m_dropped_messages.load(); }
+
+protected:
+  /// @brief Enqueues message from any thread and wakes ActiveObject up.
+  /// Producer yields while queue is full, but no longer than maxPostWait:
+  /// UI thread must not stall, and two ActiveObjects posting to each
+  /// other must not wait for each other forever. Then message is dropped
+  /// if it is coalescable, otherwise it goes to overflow list, as well as
+  /// every next message until the list is drained, to keep their order.
+  /// @return false if message has been dropped.
+  bool post(Message&& message) {
+    if (m_has_overflow.load() || !m_event_queue.push(std::move(message))) {
+      auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(maxPostWait);
+      while (m_has_overflow.load() || !m_event_queue.push(std::move(message))) {
+        if (m_has_overflow.load() || std::chrono::steady_clock::now() >= deadline) {
+          if (isCoalescable(message)) {
+            m_dropped_messages.fetch_add(1);
+            WRN("Queue of %zu messages is full, %lli dropped so far", m_event_queue.capacity(), m_dropped_messages.load());
+            return false;
+          }
+          std::lock_guard<std::mutex> lock(m_overflow_mutex);
+          m_overflow.push_back(std::move(message));
+          m_has_overflow.store(true);
+          break;
+        }
+        interrupt();
+        std::this_thread::yield();
+      }
+    }
+    wakeUp();
+    return true;
+  }
+
+  /// @brief Whether message may be dropped when queue is full, since
+  /// the next one of the same kind supersedes it.
+  virtual bool isCoalescable(const Message& /* message */) const {
+    return false;
+  }
+
+  /// @brief Messages are waiting in the queue or in overflow list.
+  inline bool hasPendingEvents() const {
+    return !m_event_queue.empty() || m_has_overflow.load();
+  }
+
+  bool checkForWakeUp() override {
+    return hasPendingEvents();
+  }
+
+  void eventHandler() override {
+    Message message;
+    while (m_event_queue.pop(message)) {
+      dispatch(message);
+    }
+    if (m_has_overflow.load()) {
+      std::deque<Message> pending;
+      {
+        std::lock_guard<std::mutex> lock(m_overflow_mutex);
+        // messages which made it into the queue before spill go first
+        while (m_event_queue.pop(message)) {
+          pending.push_back(std::move(message));
+        }
+        for (Message& spilled : m_overflow) {
+          pending.push_back(std::move(spilled));
+        }
+        m_overflow.clear();
+        m_has_overflow.store(false);
+      }
+      for (Message& next : pending) {
+        dispatch(next);
+      }
+    }
+  }
+
+  /// @brief Blocks until deadline, incoming message or stop request.
+  /// Used by ActiveObjects which also have periodic work to do.
+  template <typename TimePoint>
+  void waitForEvents(const TimePoint& deadline) {
+    std::unique_lock<std::mutex> lock(m_wake_up_mutex);
+    m_is_sleeping.store(true);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    m_wake_up_condition.wait_until(lock, deadline, [this](){ return this->hasPendingEvents() || !this->m_continue_running; });
+    m_is_sleeping.store(false);
+  }
+
+  /// @brief Blocks until deadline or stop request, incoming messages
+  /// stay in the queue meanwhile. Used to pace periodic work.
+  template <typename TimePoint>
+  void sleepUntil(const TimePoint& deadline) {
+    std::unique_lock<std::mutex> lock(m_wake_up_mutex);
+    m_wake_up_condition.wait_until(lock, deadline, [this](){ return !this->m_continue_running; });
+  }
+
+  /// @brief Processes single message taken from the queue.
+  virtual void dispatch(Message& message) = 0;
+
+  EventQueue<Message> m_event_queue;
+  std::mutex m_overflow_mutex;
+  std::deque<Message> m_overflow;  //!< Spilled messages, after the queue.
+  std::atomic_bool m_has_overflow;
+  std::atomic<long long> m_dropped_messages;
+};
+
+template <typename Message>
+constexpr size_t QueuedActiveObject<Message>::defaultQueueCapacity;
+template <typename Message>
+constexpr int QueuedActiveObject<Message>::maxPostWait;
+
 #endif  //  SURFACE3D_ACTIVE_OBJECT__H__
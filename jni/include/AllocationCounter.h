@@ -0,0 +1,16 @@
+#ifndef __ARKANOID_ALLOCATION_COUNTER__H__
+#define __ARKANOID_ALLOCATION_COUNTER__H__
+
+#include "Macro.h"
+
+namespace util {
+
+/// @brief Gets number of heap allocations (operator new) made by calling
+/// thread since it has started.
+/// @note Global operator new is replaced and counts only if built with
+/// COUNT_ALLOCATIONS, otherwise always returns 0.
+long long threadAllocations();
+
+}
+
+#endif  // __ARKANOID_ALLOCATION_COUNTER__H__
@@ -33,6 +33,7 @@
 #include <jni.h>
 #include "android/asset_manager.h"
 #include "android/asset_manager_jni.h"
+#include "AssetView.h"
 
 class AssetStorage {
 public:
@@ -46,9 +47,17 @@ public:
   void setInternalFileStorage(const char* path);
 
   bool open(const char* asset_filename);
+  /// @brief Whether asset can be opened, quietly.
+  bool exists(const char* asset_filename) const;
   void close();
   bool read(void* buffer);
   bool read(void* buffer, size_t size);
+  /// @brief Opens asset and gives read-only view of its whole content
+  /// without copying, asset stays open until the view is released.
+  /// @details Assets stored uncompressed in APK (default for .wav and .png)
+  /// are viewed right in mapped APK, compressed ones get inflated by system.
+  /// @return Empty view if asset could not be opened or its buffer obtained.
+  AssetView map(const char* asset_filename) const;
   inline off_t length() const {
     return m_length;
   }
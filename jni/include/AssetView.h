@@ -0,0 +1,49 @@
+#ifndef __ARKANOID_ASSET_VIEW__H__
+#define __ARKANOID_ASSET_VIEW__H__
+
+#include <cstddef>
+#include <cstdint>
+
+/// @class AssetView AssetView.h "include/AssetView.h"
+/// @brief Read-only view of the whole content of an asset or a file.
+/// @details Memory belongs to the source the view was obtained from:
+/// buffer of AAsset kept open (see AssetStorage::map()) or mmap() of a file
+/// (see AssetView::mapFile()). It is released along with the view, so
+/// pointers into data() must not outlive it. Views are movable only.
+class AssetView {
+public:
+  AssetView();
+  AssetView(AssetView&& other);
+  AssetView& operator = (AssetView&& other);
+  ~AssetView();
+
+  AssetView(const AssetView&) = delete;
+  AssetView& operator = (const AssetView&) = delete;
+
+  /// @brief Maps whole file read-only into memory.
+  /// @return Empty view if file could not be opened or mapped.
+  static AssetView mapFile(const char* filepath);
+
+  inline const uint8_t* data() const { return m_data; }
+  inline size_t size() const { return m_size; }
+  inline bool empty() const { return m_data == nullptr; }
+  inline explicit operator bool() const { return m_data != nullptr; }
+
+  /// @brief Gives memory back to its source, view becomes empty.
+  void release();
+
+private:
+  friend class AssetStorage;
+
+  /// @brief Releases memory obtained from some source.
+  typedef void (*Releaser)(void* handle, const uint8_t* data, size_t size);
+
+  AssetView(const uint8_t* data, size_t size, Releaser releaser, void* handle);
+
+  const uint8_t* m_data;
+  size_t m_size;
+  Releaser m_releaser;
+  void* m_handle;
+};
+
+#endif  // __ARKANOID_ASSET_VIEW__H__
@@ -2,10 +2,9 @@
 #define __ARKANOID_ASYNC_CONTEXT__H__
 
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <mutex>
-#include <queue>
-#include <random>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -23,24 +22,81 @@
 #include "Ball.h"
 #include "Bite.h"
 #include "ExplosionPackage.h"
+#include "FrameClock.h"
+#include "FrameStats.h"
+#include "GameStateSnapshot.h"
 #include "LaserPackage.h"
 #include "Level.h"
 #include "LevelDimens.h"
+#include "ParticlePool.h"
 #include "Prize.h"
 #include "PrizePackage.h"
+#include "ResourceLoader.h"
 #include "Resources.h"
 #include "rgbstruct.h"
 #include "RowCol.h"
 #include "Shader.h"
+#include "TextureAtlas.h"
 
 namespace game {
 
+/// @brief Tagged incoming event for AsyncContext, only payload
+/// matching the kind is meaningful.
+struct AsyncContextMessage {
+  enum class Kind : int {
+    NONE = 0,
+    SET_WINDOW = 1,
+    RESOURCES_PROGRESS = 2,
+    SHIFT_GAMEPAD = 3,
+    THROW_BALL = 4,
+    LOAD_LEVEL = 5,
+    LOST_BALL = 7,
+    STOP_BALL = 8,
+    BLOCK_IMPACT = 9,
+    LEVEL_FINISHED = 10,
+    EXPLOSION = 11,
+    PRIZE_RECEIVED = 12,
+    PRIZE_CAUGHT = 13,
+    DROP_BALL_APPEARANCE = 14,
+    BITE_WIDTH_CHANGED = 15,
+    LASER_BEAM_VISIBILITY = 16,
+    LASER_BLOCK_IMPACT = 17,
+    UPLOAD_TEXTURE = 18
+  };
+
+  AsyncContextMessage(Kind kind = Kind::NONE)
+    : kind(kind)
+    , window(nullptr)
+    , position(0.0f)
+    , flag(false)
+    , level(nullptr)
+    , block()
+    , explosion()
+    , prize()
+    , bite_effect(BiteEffect::NONE)
+    , texture(nullptr)
+    , progress() {
+  }
+
+  Kind kind;
+  ANativeWindow* window;  //!< SET_WINDOW
+  GLfloat position;  //!< SHIFT_GAMEPAD
+  bool flag;  //!< LASER_BEAM_VISIBILITY
+  Level::Ptr level;  //!< LOAD_LEVEL
+  RowCol block;  //!< BLOCK_IMPACT
+  ExplosionPackage explosion;  //!< EXPLOSION
+  PrizePackage prize;  //!< PRIZE_RECEIVED, PRIZE_CAUGHT
+  BiteEffect bite_effect;  //!< BITE_WIDTH_CHANGED
+  native::Texture* texture;  //!< UPLOAD_TEXTURE
+  native::LoadProgress progress;  //!< RESOURCES_PROGRESS
+};
+
 /**
  * @class AsyncContext AsyncContext.h "include/AsyncContext.h"
  * @brief Represents a render thread and provides an interface to interact
  * with User layer: input commands, gestures, graphic output and events to GUI.
  */
-class AsyncContext : public ActiveObject {
+class AsyncContext : public QueuedActiveObject<AsyncContextMessage> {
 public:
   typedef AsyncContext* Ptr;
 
@@ -55,31 +111,31 @@ public:
   /// and hence corresponding event has occurred.
   /// @param window Pointer to a window associated with the rendering surface.
   void callback_setWindow(ANativeWindow* window);
-  /// @brief Called when load resources requested.
-  void callback_loadResources(bool /* dummy */);
+  /// @brief Called when texture has been decoded and waits for upload.
+  void callback_textureDecoded(native::Texture* texture);
+  /// @brief Called when one more resource has been loaded or failed.
+  void callback_resourcesProgress(const native::LoadProgress& progress);
   /// @brief Called when user makes a motion gesture within the surface.
   /// @param distance Distance the user's pointer has passed.
   void callback_shiftGamepad(float distance);
   /// @brief Called when user sends a command to throw a ball.
   void callback_throwBall(float angle /* dummy */);
   /// @brief Called when user requests a level to be loaded
-  void callback_loadLevel(Level::Ptr level);
-  /// @brief Called when ball has moved to a new position.
-  void callback_moveBall(Ball moved_ball);
+  void callback_loadLevel(const Level::Ptr& level);
   /// @brief Called when ball has been lost.
   void callback_lostBall(float is_lost);
   /// @brief Called when ball has been stopped.
   void callback_stopBall(bool /* dummy */);
   /// @brief Called when block has been impacted.
-  void callback_blockImpact(RowCol block);
+  void callback_blockImpact(const RowCol& block);
   /// @brief Called when level has been successfully finished.
   void callback_levelFinished(bool is_finished);
   /// @brief Called when requested to draw particle system explosion.
-  void callback_explosion(ExplosionPackage package);
+  void callback_explosion(const ExplosionPackage& package);
   /// @brief Called when prize has been generated.
-  void callback_prizeReceived(PrizePackage package);
+  void callback_prizeReceived(const PrizePackage& package);
   /// @brief Called when prize has been caught.
-  void callback_prizeCaught(PrizePackage package);
+  void callback_prizeCaught(const PrizePackage& package);
   /// @brief Called when drop ball's appearance to standard has been requested.
   void callback_dropBallAppearance(bool /* dummy */);
   /// @brief Called when bite's width has changed.
@@ -95,13 +151,30 @@ public:
    */
   /// @brief Gets current state of last loaded level.
   Level::Ptr getCurrentLevelState();
+  /// @brief Gets rendering statistics: draw calls, shader location lookups,
+  /// heap allocations and CPU time per frame.
+  inline const FrameStats& getFrameStats() const { return m_frame_stats; }
+  /// @brief Makes every frame advance animations by the same step in seconds,
+  /// so they are reproducible; zero step returns to real time.
+  inline void setFixedFrameStep(float step) { m_frame_clock.setFixedStep(step); }
   /** @} */  // end of GameStat group
 
+  /** @defgroup FramePacing Rate of rendered frames.
+   * @{
+   */
+  /// @brief Sets target rate of frames and whether buffers swap waits for
+  /// vertical sync. Frames are rendered only while something changes.
+  void setFramePacing(int frame_rate, bool vsync);
+  /** @} */  // end of FramePacing group
+
   /** @defgroup Resources Bind with external resources.
    * @{
    */
   /// @brief Sets the pointer to external resources.
   void setResourcesPtr(Resources* resources);
+  /// @brief Sets the pointer to state published by game processor,
+  /// read once at the start of each frame.
+  void setGameStatePtr(GameStateBuffer* game_state);
   /** @} */  // end of Resources group
 
 // ----------------------------------------------
@@ -122,7 +195,7 @@ public:
    * @{
    */
   inline void setMasterObject(jobject object) { master_object = object; }
-  inline void setOnErrorTextureLoadMethodID(jmethodID id) { fireJavaEvent_errorTextureLoad_id = id; }
+  inline void setOnResourcesProgressMethodID(jmethodID id) { fireJavaEvent_resourcesProgress_id = id; }
   /** @} */  // end of JNIEnvironment group
 
 // ----------------------------------------------
@@ -133,16 +206,16 @@ public:
    */
   /// @brief Listens for event which occurs when surface will be prepared.
   EventListener<ANativeWindow*> surface_received_listener;
-  /// @brief Listens for load resources request.
-  EventListener<bool> load_resources_listener;
+  /// @brief Listens for decoded textures to be uploaded.
+  EventListener<native::Texture*> texture_decoded_listener;
+  /// @brief Listens for progress of loading resources.
+  EventListener<native::LoadProgress> resources_progress_listener;
   /// @brief Listens for event which occurs when user performs a motion gesture.
   EventListener<float> shift_gesture_listener;
   /// @brief Listens for event which occurs when user sends throw ball command.
   EventListener<float> throw_ball_listener;
   /// @brief Listens for event which occurs when user requests a level to be loaded.
   EventListener<Level::Ptr> load_level_listener;
-  /// @brief Listens for event which occurs when ball has moved to a new position.
-  EventListener<Ball> move_ball_listener;
   /// @brief Listens for event which occurs when ball has been lost.
   EventListener<bool> lost_ball_listener;
   /// @brief Listens for event which occurs when ball has been stopped.
@@ -166,6 +239,8 @@ public:
   /// @brief Listens for laser block impact.
   EventListener<bool> laser_block_impact_listener;
 
+  /// @brief Notifies decoded texture has been uploaded, or failed to.
+  Event<bool> texture_uploaded_event;
   /// @brief Notifies for measured aspect ratio.
   Event<float> aspect_ratio_event;
   /// @brief Notifies ball has been placed to it's initial position.
@@ -195,7 +270,7 @@ private:
   JavaVM* m_jvm;  //!< Pointer to Java Virtual Machine in current session.
   JNIEnv* m_jenv;  //!< Pointer to environment local within this thread.
   jobject master_object;
-  jmethodID fireJavaEvent_errorTextureLoad_id;
+  jmethodID fireJavaEvent_resourcesProgress_id;
   /** @} */  // end of JNIEnvironment group
 
   /** @defgroup WindowSurface Rendering surface stuff.
@@ -217,9 +292,6 @@ private:
   /** @defgroup LogicData Game logic related data members.
    * @{
    */
-  constexpr static int particleSize = 5;
-  constexpr static int particleSystemSize = 1000;
-
   constexpr static int particleSpiralSize = 4;
   constexpr static int particeSpiralSystemBranches = 4;
   constexpr static int particleSpiralSystemBranchSize = 100;
@@ -229,48 +301,61 @@ private:
   Bite m_bite;  //!< Physical bite's representation.
   BiteEffect m_bite_effect;  //!< Changed width of bite due to prize.
   Ball m_ball;  //!< Physical ball's representation.
-  std::queue<RowCol> m_impact_queue;  //!< Queue of impacted blocks' indices.
+  bool m_ball_is_flying;  //!< Whether ball's position is driven by game processor.
+  int m_ball_count;  //!< Balls in play, drawn in a single batch.
+  int m_ball_colors_count;  //!< Balls whose colors have been filled.
 
   GLfloat* m_bite_vertex_buffer;  //!< Re-usable buffer for vertices of bite.
   GLfloat* m_bite_color_buffer;   //!< Re-usable buffer for colors of bite.
-  GLfloat* m_ball_vertex_buffer;  //!< Re-usable buffer for vertices of ball.
-  GLfloat* m_ball_color_buffer;   //!< Re-usable buffer for color of ball.
+  GLfloat* m_ball_vertex_buffer;  //!< Re-usable buffer for vertices of balls.
+  GLfloat* m_ball_color_buffer;   //!< Re-usable buffer for color of balls.
   GLfloat* m_bg_vertex_buffer;    //!< Re-usable buffer for background vertices.
-  GLfloat* m_particle_diverge_buffer;    //!< Re-usable buffer for diverging particle system.
-  GLfloat* m_particle_converge_buffer;   //!< Re-usable buffer for converging particle system.
   GLfloat* m_particle_spiral_buffer;     //!< Re-usable buffer for particle spiral system.
   GLushort* m_rectangle_index_buffer;    //!< Re-usable buffer for indices of rectangle.
-  GLushort* m_octagon_index_buffer;      //!< Re-usable buffer for indices of octagon.
-  GLfloat* m_rectangle_texCoord_buffer;  //!< Re-usable buffer for texture coords of rectangle.
+  GLushort* m_octagon_index_buffer;      //!< Re-usable buffer for indices of octagons, one per ball.
 
   Level::Ptr m_level;  //!< Last loaded game level.
   GLfloat* m_level_vertex_buffer;  //!< Re-usable buffer for vertices of level.
   GLfloat* m_level_color_buffer;   //!< Re-usable buffer for colors of level.
   GLushort* m_level_index_buffer;  //!< Re-usable buffer for indices of level's blocks.
+  GLuint m_level_vertex_vbo;  //!< GPU copy of level's vertices.
+  GLuint m_level_color_vbo;   //!< GPU copy of level's colors, updated per impacted block.
+  GLuint m_level_index_ibo;   //!< GPU copy of indices of level's blocks.
+  GLuint m_particle_vbo;      //!< GPU copy of particle pool, updated per spawned explosion.
+
+  FrameClock m_frame_clock;  //!< Time source of all animations.
 
-  std::default_random_engine m_generator;
-  std::uniform_real_distribution<float> m_particle_distribution;
-  clock_t m_last_time;
-  float m_particle_time;
-  bool m_render_explosion;
-  std::vector<ExplosionPackage> m_explosion_packages;
+  ParticlePool m_particle_pool;  //!< Particles of all running explosions.
 
   std::unordered_map<int, PrizePackage> m_prize_packages;
-  std::unordered_map<int, clock_t> m_prize_last_timers;
   std::unordered_map<int, float> m_prize_timers;
   std::unordered_set<int> m_removed_prizes;
 
-  clock_t m_prize_catch_last_time;
   float m_prize_catch_time;
   bool m_render_prize_catch;
   std::vector<GLfloat> m_caught_prizes_x_coords;
 
-  clock_t m_laser_last_time;
   float m_laser_time;
   bool m_render_laser;
   bool m_laser_interruption;
   /** @} */  // end of LogicData group
 
+  /** @addtogroup GameStat
+   * @{
+   */
+  FrameStats m_frame_stats;
+  /** @} */  // end of GameStat group
+
+  /** @addtogroup FramePacing
+   * @{
+   */
+  std::atomic<int> m_frame_rate;  //!< Target frames per second.
+  std::atomic_bool m_vsync;  //!< Whether buffers swap waits for vertical sync.
+  int m_swap_interval;  //!< Swap interval applied to current display, -1 if none yet.
+  std::chrono::steady_clock::time_point m_next_frame_time;  //!< Deadline of the next frame.
+  bool m_continuous_frames;  //!< Whether the next frame is due right after the last one.
+  /** @} */  // end of FramePacing group
+
   /** @defgroup Shaders Shaders for rendering game components.
    * @{
    */
@@ -288,53 +373,34 @@ private:
    * @{
    */
   std::mutex m_jnienvironment_mutex;  //!< Sentinel for thread attach to JVM.
-  std::mutex m_surface_mutex;  //!< Sentinel for window setting.
-  std::mutex m_load_resources_mutex;  //!< Sentinel for load resources.
-  std::mutex m_shift_gamepad_mutex;  //!< Sentinel for shifting gesture event.
-  std::mutex m_throw_ball_mutex;  //!< Sentinel for throw ball user command.
-  std::mutex m_load_level_mutex;  //!< Sentinel for load level user request.
-  std::mutex m_move_ball_mutex;  //!< Sentinel for move ball to a new position.
-  std::mutex m_lost_ball_mutex;  //!< Sentinel for lost ball flag.
-  std::mutex m_stop_ball_mutex;
-  std::mutex m_block_impact_mutex;  //!< Sentinel for block impact event.
-  std::mutex m_level_finished_mutex;  //!< Sentinel for level has been successfully finished.
-  std::mutex m_explosion_mutex;  //!< Sentinel for particle system explosion.
-  std::mutex m_prize_mutex;  //!< Sentinel for prize receiving.
-  std::mutex m_prize_caught_mutex;  //!< Sentinel for prize has been caught.
-  std::mutex m_drop_ball_appearance_mutex;
-  std::mutex m_bite_width_changed_mutex;
-  std::mutex m_laser_beam_visibility_mutex;
-  std::mutex m_laser_block_impact_mutex;
-  std::atomic_bool m_surface_received;  //!< Window has been set.
-  std::atomic_bool m_load_resources_received;  //!< Load resources requested.
-  std::atomic_bool m_shift_gamepad_received;  //!< Shift gesture has occurred.
-  std::atomic_bool m_throw_ball_received;  //!< Throw ball command has been received.
-  std::atomic_bool m_load_level_received;  //!< Load level request has been received.
-  std::atomic_bool m_move_ball_received;  //!< Move ball event has been received.
-  std::atomic_bool m_lost_ball_received;  //!< Ball has been lost received.
-  std::atomic_bool m_stop_ball_received;
-  std::atomic_bool m_block_impact_received;  //!< Block impact has been received.
-  std::atomic_bool m_level_finished_received;  //!< Level has been successfully finished.
-  std::atomic_bool m_explosion_received;  //!< Request for explosion received.
-  std::atomic_bool m_prize_received;  //!< Prize has been received.
-  std::atomic_bool m_prize_caught_received;  //!< Prize has been caught received.
-  std::atomic_bool m_drop_ball_appearance_received;
-  std::atomic_bool m_bite_width_changed_received;
-  std::atomic_bool m_laser_beam_visibility_received;
-  std::atomic_bool m_laser_block_impact_received;
+  std::mutex m_load_level_mutex;  //!< Sentinel for current level shared with JNI layer.
   /** @} */  // end of Mutex group
 
   /** @defgroup SafetyFlag Logic-safety variables
    * @{
    */
   bool m_window_set;
+  /// Events received before rendering surface has been set, replayed afterwards.
+  std::vector<AsyncContextMessage> m_deferred_messages;
   /** @} */  // end of SafetyFlag group
 
   /** @addtogroup Resources
    * @{
    */
   Resources* m_resources;
-  const native::Texture* m_bg_texture;
+  GameStateBuffer* m_game_state;
+  GameStateSnapshot m_game_state_snapshot;  //!< Latest state read from game processor.
+  const native::Sprite* m_bg_texture;
+  /// Sprites used every frame, looked up once resources are loaded.
+  const native::Sprite* m_smoke_texture;
+  const native::Sprite* m_spark_texture;
+  const native::Sprite* m_laser_texture;
+  const native::Sprite* m_prize_textures[PrizeUtils::totalPrizes + 1];  //!< Indexed by Prize, WIN included.
+  const native::Sprite* m_block_textures[BlockUtils::totalBlocks];  //!< Indexed by Block, nullptr if not textured.
+  /// Sprites above have been looked up, no frame is rendered before.
+  bool m_resources_ready;
+  /// Texture bound in current frame, sprites of the same atlas page don't rebind it.
+  const native::Texture* m_applied_texture;
   /** @} */  // end of Resources group
 
 // ----------------------------------------------
@@ -347,11 +413,15 @@ private:
   void onStop() override final;   //!< Right before thread has been stopped.
   /// @brief Automatic check whether this thread should continue to operate.
   /// @return Whether this thread should continue sleeping (false)
-  /// or working (true).
+  /// or working (true), i.e. whether events or animations are pending.
   bool checkForWakeUp() override final;
-  /// @brief Operate the data or do some job as a response of incoming
-  /// outer event.
+  /// @brief Waits for the next frame boundary, drains incoming events
+  /// and then renders a frame, unless nothing has changed.
   void eventHandler() override final;
+  /// @brief Routes incoming message to corresponding processor.
+  void dispatch(AsyncContextMessage& message) override final;
+  /// @brief Moves of bite may be dropped, the next one supersedes them.
+  bool isCoalescable(const AsyncContextMessage& message) const override final;
   /** @} */  // end of ActiveObject group
 
   /** @defgroup Processors Actions being performed by AsyncContext when
@@ -360,37 +430,38 @@ private:
    */
   /// @brief Given a rendering surface in Java, performs setting of native
   /// window to interact with during actual rendering.
-  void process_setWindow();
-  /// @brief Loads external resources into Graphic memory.
-  void process_loadResources();
+  void process_setWindow(ANativeWindow* window);
+  /// @brief Packs decoded texture into atlas, or uploads it into Graphic memory.
+  void process_uploadTexture(native::Texture* texture);
+  /// @brief Reports progress of loading resources to Java layer, looks up
+  /// textures used every frame once all resources are loaded.
+  void process_resourcesProgress(const native::LoadProgress& progress);
   /// @brief Performs visual translation of the gamepad by given distance.
-  void process_shiftGamepad();
+  void process_shiftGamepad(GLfloat position);
   /// @brief Performs visual ball throwing.
   void process_throwBall();
   /// @brief Performs visual refreshing of current level.
-  void process_loadLevel();
-  /// @brief Performs visual displacement of the ball to a new position.
-  void process_moveBall();
+  void process_loadLevel(Level::Ptr level);
   /// @brief Processing when ball has been lost.
   void process_lostBall();
   /// @brief Processing when ball has been stopped.
   void process_stopBall();
   /// @brief Performs visual block impact.
-  void process_blockImpact();
+  void process_blockImpact(const RowCol& impact);
   /// @brief Performs visual level finalization.
   void process_levelFinished();
   /// @brief Performs visual particle system explosion.
-  void process_explosion();
+  void process_explosion(const ExplosionPackage& package);
   /// @brief Performs visual prize generation.
-  void process_prizeReceived();
+  void process_prizeReceived(const PrizePackage& package);
   /// @brief Performs visual prize catching.
-  void process_prizeCaught();
+  void process_prizeCaught(const PrizePackage& package);
   /// @brief Drops ball's appearance to standard.
   void process_dropBallAppearance();
   /// @brief Performs visual change of bite's width.
-  void process_biteWidthChanged();
+  void process_biteWidthChanged(BiteEffect effect);
   /// @brief Performs laser beam visibility changes.
-  void process_laserBeamVisibility();
+  void process_laserBeamVisibility(bool is_visible);
   /// @brief Processing laser block impact.
   void process_laserBlockImpact();
   /** @} */  // end of Processors group
@@ -410,12 +481,21 @@ private:
   /// @param y_position Normalized position along Y axis the ball should move at.
   /// @note Positions should both be within [-1, 1] segment.
   void moveBall(float x_position, float y_position);
+  /// @brief Places vertices of ball at index, leaving the count of balls intact.
+  void placeBall(int index, float x_position, float y_position);
+  /// @brief Takes the latest state published by game processor and
+  /// places the flying ball accordingly.
+  /// @return TRUE if state has changed since previous frame.
+  bool readGameState();
   /// @brief Adds prize to be removed later.
   void addPrizeToRemoved(int prize_id);
   /// @brief Clears removed prizes.
   void clearRemovedPrizes();
   /// @brief Clean-up prize structures and counters.
   void clearPrizeStructures();
+  /// @brief Advances timers of running animations by frame's delta
+  /// and finishes expired ones.
+  void advanceAnimations(float delta);
   /// @brief Checks whether specified block is present in current level.
   /// @return TRUE is block is present in newly loaded level, FALSE otherwise.
   /// @detail This allows to avoid crash when load level event is followed by
@@ -424,6 +504,8 @@ private:
   bool checkBlockPresense(int row, int col);
   /// @brief Sets bite's and ball's appearance according to current ball's effect.
   void setBiteBallAppearance(BallEffect effect);
+  /// @brief Whether any animation is running, so frames must keep coming.
+  bool isAnimating() const;
   /** @} */  // end of LogicFunc group
 
 private:
@@ -440,9 +522,22 @@ private:
   void destroyDisplay();
   /// @brief Render a frame.
   void render();
+  /// @brief Uploads level's vertices, colors and indices into GPU buffers,
+  /// creating them at first call within current context.
+  void uploadLevelBuffers();
+  /// @brief Uploads colors of the specified block only into GPU buffer.
+  void uploadLevelColorsAtBlock(int row, int col);
+  /// @brief Uploads changed slots of particle pool into GPU buffer,
+  /// creating it at first call within current context.
+  void uploadParticleBuffer();
   /// @brief Initializes particle system.
   void initParticleSystem();
-  /// @brief Continue rendering for specified delay in ms.
+  /// @brief Sleeps till the deadline of the next frame and schedules
+  /// the following one, accounting frames missed meanwhile.
+  void waitForFrame();
+  /// @brief Applies vertical sync setting to current display, if changed.
+  void applySwapInterval();
+  /// @brief Continue rendering paced frames for specified delay in ms.
   /// @param ms Time in ms.
   void delay(int ms);
   /** @} */  // end of GraphicsContext group
@@ -450,18 +545,20 @@ private:
   /** @defgroup Drawings Draw routines.
    * @{
    */
-  /// @brief Draws current level's state.
+  /// @brief Draws current level's state with single draw call.
   void drawLevel();
   /// @brief Draws block of current level.
   void drawBlock(int row, int col);
-  /// @brief Draws textured block of current level,
-  void drawTexturedBlock(int row, int col, const std::string& texture);
+  /// @brief Draws textured block of current level.
+  void drawTexturedBlock(int row, int col, const native::Sprite* sprite);
+  /// @brief Binds texture of sprite, unless it has been bound in this frame.
+  void applySprite(const native::Sprite* sprite);
   /// @brief Draws bite at it's current position.m_load_resources_received
   void drawBite();
-  /// @brief Draws ball at it's current position.
+  /// @brief Draws all balls at their current positions in one call.
   void drawBall();
-  /// @brief Draws particle system explosion.
-  void drawExplosion(GLfloat x, GLfloat y, const util::BGRA<GLfloat>& bgra, Kind kind);
+  /// @brief Draws particles of all running explosions with single draw call.
+  void drawExplosions();
   /// @brief Draws textured background.
   void drawBackground();
   /// @brief Draws prize of specified type at given location.
@@ -97,12 +97,28 @@ JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_throwBall
 JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_loadLevel
   (JNIEnv *, jobject, jlong, jobjectArray);
 
+/*
+ * Class:     com_orcchg_arkanoid_surface_AsyncContext
+ * Method:    loadPackedLevel
+ * Signature: (JI)Z
+ */
+JNIEXPORT jboolean JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_loadPackedLevel
+  (JNIEnv *, jobject, jlong, jint);
+
+/*
+ * Class:     com_orcchg_arkanoid_surface_AsyncContext
+ * Method:    loadLevelState
+ * Signature: (JLjava/lang/String;)V
+ */
+JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_loadLevelState
+  (JNIEnv *, jobject, jlong, jstring);
+
 /*
  * Class:     com_orcchg_arkanoid_surface_AsyncContext
  * Method:    saveLevel
- * Signature: (J)[Ljava/lang/String;
+ * Signature: (J)Ljava/lang/String;
  */
-JNIEXPORT jobjectArray JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_saveLevel
+JNIEXPORT jstring JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_saveLevel
   (JNIEnv *, jobject, jlong);
 
 /*
@@ -113,6 +129,22 @@ JNIEXPORT jobjectArray JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_sav
 JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_setBonusBlocks
   (JNIEnv *, jobject, jlong, jboolean);
 
+/*
+ * Class:     com_orcchg_arkanoid_surface_AsyncContext
+ * Method:    startRecording
+ * Signature: (JLjava/lang/String;)Z
+ */
+JNIEXPORT jboolean JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_startRecording
+  (JNIEnv *, jobject, jlong, jstring);
+
+/*
+ * Class:     com_orcchg_arkanoid_surface_AsyncContext
+ * Method:    stopRecording
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_stopRecording
+  (JNIEnv *, jobject, jlong);
+
 /*
  * Class:     com_orcchg_arkanoid_surface_AsyncContext
  * Method:    drop
@@ -129,6 +161,46 @@ JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_drop
 JNIEXPORT jint JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_getScore
   (JNIEnv *, jobject, jlong);
 
+/*
+ * Class:     com_orcchg_arkanoid_surface_AsyncContext
+ * Method:    getFrameTimeStats
+ * Signature: (J)[F
+ */
+JNIEXPORT jfloatArray JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_getFrameTimeStats
+  (JNIEnv *, jobject, jlong);
+
+/*
+ * Class:     com_orcchg_arkanoid_surface_AsyncContext
+ * Method:    setFixedFrameStep
+ * Signature: (JF)V
+ */
+JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_setFixedFrameStep
+  (JNIEnv *, jobject, jlong, jfloat);
+
+/*
+ * Class:     com_orcchg_arkanoid_surface_AsyncContext
+ * Method:    getAchievedFps
+ * Signature: (J)F
+ */
+JNIEXPORT jfloat JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_getAchievedFps
+  (JNIEnv *, jobject, jlong);
+
+/*
+ * Class:     com_orcchg_arkanoid_surface_AsyncContext
+ * Method:    getDroppedFrames
+ * Signature: (J)J
+ */
+JNIEXPORT jlong JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_getDroppedFrames
+  (JNIEnv *, jobject, jlong);
+
+/*
+ * Class:     com_orcchg_arkanoid_surface_AsyncContext
+ * Method:    setFramePacing
+ * Signature: (JIZ)V
+ */
+JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_setFramePacing
+  (JNIEnv *, jobject, jlong, jint, jboolean);
+
 #ifdef __cplusplus
 }
 #endif
@@ -139,6 +211,8 @@ JNIEXPORT jint JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_getScore
 #include "AsyncContext.h"
 #include "GameProcessor.h"
 #include "PrizeProcessor.h"
+#include "ResourceLoader.h"
+#include "Resources.h"
 #include "SoundProcessor.h"
 
 /**
@@ -150,8 +224,6 @@ struct AsyncContextHelper {
   JNIEnv* jenv;
   /// @brief Pointer to current object.
   jobject global_object;
-  /// @brief Global reference to java.lang.tring class.
-  jclass String_clazz;
 
   /// @brief Pointer to a windows associated with the rendering surface.
   ANativeWindow* window;
@@ -168,11 +240,16 @@ struct AsyncContextHelper {
   /// @brief Shared pointer to an instance of sound processor thread.
   native::sound::SoundProcessor::Ptr sound_processor;
 
+  /// @brief Pointer to an instance of pool of resource decoding threads.
+  native::ResourceLoader::Ptr resource_loader;
+
+  /// @brief Pointer to external resources.
+  game::Resources* resources;
+
   /** @defgroup AsyncContextEvent Events coming to render thread from outside.
    * @{
    */
   Event<ANativeWindow*> surface_received_event;  //!< When surface has been prepared.
-  Event<bool> load_resources_event;  //!< Requested load resources.
   Event<float> shift_gesture_event;  //!< When user does a motion gesture.
   Event<float> throw_ball_event;  //<! When user sends a throw ball command.
   Event<game::Level::Ptr> load_level_event;  //<! When user's requested to load level.
@@ -184,8 +261,7 @@ struct AsyncContextHelper {
   jmethodID fireJavaEvent_angleChanged_id;
   jmethodID fireJavaEvent_cardinalityChanged_id;
   jmethodID fireJavaEvent_prizeCatch_id;
-  jmethodID fireJavaEvent_errorTextureLoad_id;
-  jmethodID fireJavaEvent_errorSoundLoad_id;
+  jmethodID fireJavaEvent_resourcesProgress_id;
   jmethodID fireJavaEvent_debugMessage_id;
 
   AsyncContextHelper(JNIEnv* jenv, jobject master_object);
@@ -0,0 +1,91 @@
+#ifndef __ARKANOID_AUDIO_SINK__H__
+#define __ARKANOID_AUDIO_SINK__H__
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "Mixer.h"
+
+namespace native {
+namespace sound {
+
+/// @class AudioSink AudioSink.h "include/AudioSink.h"
+/// @brief Output device which pulls blocks of samples from Mixer.
+class AudioSink {
+public:
+  virtual ~AudioSink() {}
+
+  /// @brief Starts pulling samples from mixer, which must outlive the sink.
+  /// @return FALSE on failure, see getErrorCode().
+  virtual bool start(Mixer* mixer) = 0;
+  /// @brief Stops pulling samples, mixer is not accessed afterwards.
+  virtual void stop() = 0;
+
+  inline int getErrorCode() const { return m_error_code; }
+
+protected:
+  AudioSink() : m_error_code(0) {}
+
+  int m_error_code;
+};
+
+// ----------------------------------------------------------------------------
+/// @class NullSink AudioSink.h "include/AudioSink.h"
+/// @brief Sink without device: blocks are rendered on demand and discarded.
+/// Runs mixer on host, where there is no audio clock to pull samples.
+class NullSink : public AudioSink {
+public:
+  NullSink();
+  virtual ~NullSink();
+
+  bool start(Mixer* mixer) override;
+  void stop() override;
+
+  /// @brief Renders given number of blocks of Mixer::blockFrames frames.
+  /// @return Number of blocks rendered, less than requested on failure.
+  int pump(int blocks);
+
+protected:
+  /// @brief Consumes rendered block of interleaved samples.
+  virtual bool write(const int16_t* samples, int count);
+
+  Mixer* m_mixer;
+  std::vector<int16_t> m_block;
+};
+
+// ----------------------------------------------------------------------------
+/// @class WAVFileSink AudioSink.h "include/AudioSink.h"
+/// @brief Writes rendered blocks into 16-bit PCM WAV file.
+/// @details Header is rewritten with actual length at stop().
+class WAVFileSink : public NullSink {
+public:
+  WAVFileSink(const char* filepath);
+  virtual ~WAVFileSink();
+
+  bool start(Mixer* mixer) override;
+  void stop() override;
+
+protected:
+  bool write(const int16_t* samples, int count) override;
+
+private:
+  /// @brief Writes 44-byte RIFF header for given length of data in bytes.
+  bool writeHeader(uint32_t data_length);
+
+  const char* m_filepath;
+  FILE* m_file;
+  uint32_t m_data_length;
+};
+
+/**
+ * Error codes (AudioSink)
+ *
+ * 2031 - fopen() failed
+ * 2032 - fwrite() failed
+ */
+
+}  // namespace sound
+}  // namespace native
+
+#endif  // __ARKANOID_AUDIO_SINK__H__
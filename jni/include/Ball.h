@@ -1,9 +1,12 @@
 #ifndef __ARKANOID_BALL__H__
 #define __ARKANOID_BALL__H__
 
+#include <cmath>
+
 #include "BallDimens.h"
 #include "BallPosition.h"
 #include "Params.h"
+#include "utils.h"
 
 namespace game {
 
@@ -23,34 +26,67 @@ enum class BallEffect : int {
   ZYGOTE = 12
 };
 
+/// @class Ball Ball.h "include/Ball.h"
+/// @brief Ball moves along unit direction vector with scalar speed,
+/// so a step takes no trigonometry and collisions reflect the vector.
+/// Angle is derived from direction on demand.
 class Ball {
 public:
   Ball(GLfloat width = 0.f, GLfloat height = 0.f)
     : m_dimens(width, height)
     , m_pose()
-    , m_angle(0.0f)
+    , m_direction_x(1.0f)
+    , m_direction_y(0.0f)
     , m_velocity(BallParams::ballSpeed)
     , m_effect(BallEffect::NONE) {
   }
 
   inline const BallDimens& getDimens() const { return m_dimens; }
   inline const BallPosition& getPose() const { return m_pose; }
-  inline GLfloat getAngle() const { return m_angle; }
+  /// @brief Angle (radian) between velocity and positive X axis, within [0, 2PI).
+  inline GLfloat getAngle() const {
+    GLfloat angle = std::atan2(m_direction_y, m_direction_x);
+    return angle < 0.0f ? angle + util::_2PI : angle;
+  }
+  inline GLfloat getDirectionX() const { return m_direction_x; }
+  inline GLfloat getDirectionY() const { return m_direction_y; }
   inline GLfloat getVelocity() const { return m_velocity; }
   inline BallEffect getEffect() const { return m_effect; }
 
   inline void setXPose(GLfloat x_pose) { m_pose.setX(x_pose); }
   inline void setYPose(GLfloat y_pose) { m_pose.setY(y_pose); }
-  inline void setAngle(GLfloat angle) { m_angle = angle; }
+  inline void setAngle(GLfloat angle) {
+    m_direction_x = std::cos(angle);
+    m_direction_y = std::sin(angle);
+  }
+  /// @brief Sets direction of velocity, which must be unit vector.
+  inline void setDirection(GLfloat x, GLfloat y) {
+    m_direction_x = x;
+    m_direction_y = y;
+  }
+  /// @brief Reflects velocity off surface with given unit normal.
+  inline void reflect(GLfloat normal_x, GLfloat normal_y) {
+    GLfloat projection = 2.0f * (m_direction_x * normal_x + m_direction_y * normal_y);
+    m_direction_x -= projection * normal_x;
+    m_direction_y -= projection * normal_y;
+  }
+  /// @brief Rotates velocity counter-clockwise by given cosine and sine of angle.
+  inline void rotate(GLfloat cos_angle, GLfloat sin_angle) {
+    GLfloat x = m_direction_x * cos_angle - m_direction_y * sin_angle;
+    m_direction_y = m_direction_x * sin_angle + m_direction_y * cos_angle;
+    m_direction_x = x;
+  }
   inline void fastSpeed() { m_velocity = BallParams::ballFastSpeed; }
   inline void normalSpeed() { m_velocity = BallParams::ballSpeed; }
   inline void slowSpeed() { m_velocity = BallParams::ballSlowSpeed; }
+  inline void setVelocity(GLfloat velocity) { m_velocity = velocity; }
   inline void setEffect(BallEffect effect) { m_effect = effect; }
 
  private:
   BallDimens m_dimens;
   BallPosition m_pose;  //!< Location of ball's center.
-  GLfloat m_angle;  //!< Angle (radian) between velocity and positive X axis.
+  GLfloat m_direction_x;  //!< Unit vector along velocity, X component.
+  GLfloat m_direction_y;  //!< Unit vector along velocity, Y component.
   GLfloat m_velocity;
   BallEffect m_effect;
 };
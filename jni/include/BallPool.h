@@ -0,0 +1,123 @@
+#ifndef __ARKANOID_BALL_POOL__H__
+#define __ARKANOID_BALL_POOL__H__
+
+#include <cstdint>
+#include <vector>
+
+#include <GLES/gl.h>
+
+#include "Ball.h"
+#include "Params.h"
+
+namespace game {
+
+/// @brief Bounds of ball's center within which the ball can't reach
+/// any wall, the bite or a block of level during a step.
+struct FreeFlight {
+  GLfloat left, right;  //!< Along X axis, exclusive.
+  GLfloat bottom, top;  //!< Along Y axis, exclusive.
+};
+
+/// @class BallPool BallPool.h "include/BallPool.h"
+/// @brief Balls in play kept as structure of arrays: positions,
+/// directions of velocity, speeds, effects and flags.
+/// All balls have the same dimensions.
+/// @details step() moves all balls by one tick in a single pass over four
+/// lanes. A ball which stays in free flight during the step is committed
+/// at once, the others are left for GameProcessor to resolve collisions
+/// one by one through get() / set(), in index order, which keeps block
+/// hits deterministic. Removed balls are dropped by compact() after the
+/// pass, spawned ones are appended and move since the next step. Storage
+/// for BallParams::maxBalls is allocated up front.
+class BallPool {
+public:
+  BallPool();
+
+  /// @brief Number of balls, including removed ones until compact().
+  inline int size() const { return m_size; }
+  /// @brief Number of balls which have not been removed.
+  inline int alive() const { return m_size - m_removed; }
+
+  /// @brief Leaves the only given ball in pool.
+  void reset(const Ball& ball);
+  /// @brief Appends copy of ball at index, its direction turned
+  /// counter-clockwise by angle with given cosine and sine.
+  /// @return FALSE if pool is full.
+  bool spawn(int index, GLfloat cos_turn, GLfloat sin_turn);
+  /// @brief Marks ball to be dropped by compact().
+  void remove(int index);
+  /// @brief Marks all balls but the given one to be dropped by compact().
+  void keepOnly(int index);
+  /// @brief Drops removed balls, order of the rest is kept.
+  void compact();
+
+  /// @brief Ball at index as standalone object.
+  Ball get(int index) const;
+  /// @brief Stores ball at index.
+  void set(int index, const Ball& ball);
+
+  inline GLfloat getX(int index) const { return m_x[index]; }
+  inline GLfloat getY(int index) const { return m_y[index]; }
+  inline GLfloat getDirectionX(int index) const { return m_direction_x[index]; }
+  inline GLfloat getDirectionY(int index) const { return m_direction_y[index]; }
+  inline GLfloat getVelocity(int index) const { return m_velocity[index]; }
+  inline BallEffect getEffect(int index) const { return m_effect[index]; }
+  inline void setEffect(int index, BallEffect effect) { m_effect[index] = effect; }
+  /// @brief Sets effect of all balls.
+  void setEffect(BallEffect effect);
+  /// @brief Sets speed of all balls.
+  void setVelocity(GLfloat velocity);
+
+  /** @defgroup BallFlags Per ball flags of GameProcessor.
+   * @{
+   */
+  inline bool isLost(int index) const { return (m_flags[index] & LOST) != 0; }
+  inline bool isDeath(int index) const { return (m_flags[index] & DEATH) != 0; }
+  inline void setLost(int index, bool lost) { setFlag(index, LOST, lost); }
+  inline void setDeath(int index, bool death) { setFlag(index, DEATH, death); }
+  /** @} */  // end of BallFlags group
+
+  /// @brief Computes position of every ball in the next tick and commits
+  /// it for balls staying within free flight region.
+  /// @param scale Factor of displacement per tick.
+  /// @param region Free flight region of ball's center.
+  /// @return Number of balls to be resolved, see needsResolve().
+  int step(GLfloat scale, const FreeFlight& region);
+  /// @brief Whether ball may collide within the step and hasn't moved.
+  inline bool needsResolve(int index) const { return (m_flags[index] & RESOLVE) != 0; }
+  /// @brief Position of ball in the next tick, computed by step().
+  inline GLfloat getNextX(int index) const { return m_next_x[index]; }
+  inline GLfloat getNextY(int index) const { return m_next_y[index]; }
+
+private:
+  enum Flag : uint8_t {
+    LOST = 1,     //!< Ball has missed the bite.
+    DEATH = 2,    //!< Ball has hit deadly block.
+    REMOVED = 4,  //!< Ball will be dropped by compact().
+    RESOLVE = 8   //!< Ball needs collisions resolved in this step.
+  };
+
+  BallDimens m_dimens;
+  int m_size;
+  int m_removed;
+  // lanes, padded to multiple of four
+  std::vector<GLfloat> m_x;
+  std::vector<GLfloat> m_y;
+  std::vector<GLfloat> m_direction_x;  //!< Unit vector along velocity, X component.
+  std::vector<GLfloat> m_direction_y;  //!< Unit vector along velocity, Y component.
+  std::vector<GLfloat> m_velocity;
+  std::vector<GLfloat> m_next_x;
+  std::vector<GLfloat> m_next_y;
+  std::vector<BallEffect> m_effect;
+  std::vector<uint8_t> m_flags;
+
+  inline void setFlag(int index, uint8_t flag, bool value) {
+    m_flags[index] = value ? (m_flags[index] | flag) : (m_flags[index] & ~flag);
+  }
+  /// @brief Moves ball from one index to another.
+  void move(int from, int to);
+};
+
+}
+
+#endif  // __ARKANOID_BALL_POOL__H__
@@ -58,6 +58,7 @@ class BlockUtils {
 public:
   constexpr static int ordinaryBlockOffset = 27;
   constexpr static int totalOrdinaryBlocks = 13;
+  constexpr static int totalBlocks = 40;  //!< Including NONE
 
   static Block charToBlock(char ch);
   static char blockToChar(Block block);
@@ -75,6 +76,7 @@ class BlockGenerator {
 public:
   BlockGenerator();
   Block generateBlock();  //!< Generates random ordinary block
+  void seed(unsigned int value);  //!< Restarts random sequence
 
 private:
   std::default_random_engine m_generator;
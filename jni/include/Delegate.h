@@ -0,0 +1,75 @@
+#ifndef SURFACE3D_DELEGATE__H__
+#define SURFACE3D_DELEGATE__H__
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+/// @class Delegate Delegate.h "include/Delegate.h"
+/// @brief Callable taking const E&, kept by value without heap: either
+/// member function of object or small callable (lambda) stored inline.
+/// @details Call goes through single function pointer to stub which has
+/// been instantiated for exact type of method or callable. Method may
+/// take E by value or by reference, or any type E converts to. Inline
+/// callable must be trivially destructible, as storage is copied bitwise.
+template <typename E>
+class Delegate {
+public:
+  /// @brief Bytes of inline storage: object pointer and member function
+  /// pointer, which is two words in Itanium and ARM ABIs, fit in.
+  static constexpr size_t storageSize = 4 * sizeof(void*);
+
+  Delegate() : m_stub(nullptr) {}
+
+  template <typename T, typename A>
+  static Delegate fromMethod(void (T::*method)(A), T* object) {
+    Delegate delegate;
+    delegate.template store<Bound<T, A>>(Bound<T, A>{object, method});
+    delegate.m_stub = &callMethod<T, A>;
+    return delegate;
+  }
+
+  template <typename F>
+  static Delegate fromCallable(F callable) {
+    static_assert(sizeof(F) <= storageSize, "Callable doesn't fit in Delegate storage");
+    static_assert(std::is_trivially_destructible<F>::value, "Callable stored in Delegate must be trivially destructible");
+    Delegate delegate;
+    delegate.template store<F>(callable);
+    delegate.m_stub = &callCallable<F>;
+    return delegate;
+  }
+
+  inline void operator()(const E& e) const { m_stub(m_storage, e); }
+  inline explicit operator bool() const { return m_stub != nullptr; }
+
+private:
+  typedef void (*Stub)(const void* storage, const E& e);
+
+  template <typename T, typename A>
+  struct Bound {
+    T* object;
+    void (T::*method)(A);
+  };
+
+  template <typename T>
+  void store(const T& value) {
+    static_assert(sizeof(T) <= storageSize, "Method doesn't fit in Delegate storage");
+    new (m_storage) T(value);
+  }
+
+  template <typename T, typename A>
+  static void callMethod(const void* storage, const E& e) {
+    const Bound<T, A>* bound = static_cast<const Bound<T, A>*>(storage);
+    (bound->object->*bound->method)(e);
+  }
+
+  template <typename F>
+  static void callCallable(const void* storage, const E& e) {
+    (*static_cast<F*>(const_cast<void*>(storage)))(e);
+  }
+
+  alignas(void*) alignas(double) unsigned char m_storage[storageSize];
+  Stub m_stub;
+};
+
+#endif  // SURFACE3D_DELEGATE__H__
@@ -31,81 +31,105 @@
 
 #pragma once
 
-#include <functional>
-#include <iostream>
-#include <memory>
-#include <mutex>
-#include <thread>
+#include <cstddef>
 #include <utility>
-#include <list>
+#include <vector>
 
+#include "Delegate.h"
 #include "EventListener.h"
 #include "ListenerBinder.h"
 #include "logger.h"
 
 
+/// @brief Notifies listeners bound to it, in order they were created.
+/// @details Listeners are kept contiguously by value, each one is called
+/// through Delegate with the same const reference to event. Nothing is
+/// allocated on notification, and listeners are only allocated for when
+/// vector grows. Notification may come from several threads at once, as
+/// long as listeners are not created or removed meanwhile.
 template <typename E>
 class Event {
 public:
-	Event() : eventListenerId(0) {}
-	virtual ~Event() {}
-
-	typename ListenerBinder<E>::Ptr createListener(std::function<void (E)> listener){
-	  typename ListenerBinder<E>::Ptr retval = std::make_shared<ListenerBinder<E>>(this, listener, eventListenerId);
-	  listeners.emplace_back(retval);
-	  eventListenerId++;
-	  return retval;
-	}
-
-	template <typename P, typename Func>
-	typename ListenerBinder<E>::Ptr createListener(Func f, P p) {
-	  std::function<void(E)> func = std::bind(f, p, std::placeholders::_1);
-	  return createListener(func);
-	}
-
-	void notifyListeners(E e){
-	  for(auto & l : listeners) {
-	    l.binder_ptr->callListenerSafe(e);
-	  }
-	}
-
-	bool removeListener(int id){
-	  auto iter = listeners.begin();
-	  while (iter != listeners.end()) {
-	    if (iter->getId() == id){
-	      listeners.erase(iter);
-	      return true;
-	    }
-	    iter++;
-	  }
-	  return false;
-	}
-
-	void clearListeners() {
-	  listeners.clear();
-	}
-
-	bool hasListeners() const {
-	  return !listeners.empty();
-	}
-
-	int getListenersCount() const {
-	  return listeners.size();
-	}
+  Event() : eventListenerId(0) {}
+  virtual ~Event() {
+    clearListeners();
+  }
+
+  Event(const Event&) = delete;
+  Event& operator=(const Event&) = delete;
+
+  /// @brief Creates listener calling small callable, like lambda.
+  template <typename Func>
+  ListenerBinder<E> createListener(Func f) {
+    return addListener(Delegate<E>::fromCallable(f));
+  }
+
+  /// @brief Creates listener calling method of object.
+  template <typename P, typename T, typename A>
+  ListenerBinder<E> createListener(void (T::*f)(A), P p) {
+    return addListener(Delegate<E>::fromMethod(f, static_cast<T*>(p)));
+  }
+
+  void notifyListeners(const E& e) {
+    // by index: listener may be created while notified
+    for (size_t i = 0; i < listeners.size(); ++i) {
+      if (listeners[i].listener != nullptr) {
+        listeners[i].delegate(e);
+      }
+    }
+  }
+
+  bool removeListener(int id) {
+    for (auto iter = listeners.begin(); iter != listeners.end(); ++iter) {
+      if (iter->id == id) {
+        listeners.erase(iter);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void clearListeners() {
+    for (auto& glue : listeners) {
+      if (glue.listener != nullptr) {
+        glue.listener->event = nullptr;
+      }
+    }
+    listeners.clear();
+  }
 
-protected:
-  struct EventGlue {
-    typename ListenerBinder<E>::Ptr binder_ptr;
+  bool hasListeners() const {
+    return !listeners.empty();
+  }
 
-    EventGlue(typename ListenerBinder<E>::Ptr binder) : binder_ptr(binder) {}
+  int getListenersCount() const {
+    return listeners.size();
+  }
 
-    ~EventGlue() {
-      binder_ptr->event = nullptr;
-    }
+protected:
+  friend class EventListener<E>;
 
-    inline const int& getId() const { return binder_ptr->getId(); }
+  struct EventGlue {
+    Delegate<E> delegate;
+    EventListener<E>* listener;  //!< Not called until bound.
+    int id;
   };
 
-  std::list<EventGlue> listeners;
-	int eventListenerId;
+  std::vector<EventGlue> listeners;
+  int eventListenerId;
+
+  ListenerBinder<E> addListener(const Delegate<E>& delegate) {
+    listeners.push_back(EventGlue{delegate, nullptr, eventListenerId});
+    return ListenerBinder<E>(this, eventListenerId++);
+  }
+
+  void bindListener(int id, EventListener<E>* listener) {
+    for (auto& glue : listeners) {
+      if (glue.id == id) {
+        glue.listener = listener;
+        return;
+      }
+    }
+    ERR("Cannot bind to event!");
+  }
 };
@@ -32,20 +32,23 @@
 #ifndef SURFACE3D_EVENTLISTENER__H__
 #define SURFACE3D_EVENTLISTENER__H__
 
-#include <iostream>
-#include <memory>
 #include "logger.h"
 
 
+template <typename E>
+class Event;
+
 template <typename E>
 class ListenerBinder;
 
+/// @brief Subscription to Event: calls are delivered while it is bound,
+/// destruction unsubscribes. Event being destroyed unbinds it in turn.
 template <typename E>
 class EventListener {
-  friend class ListenerBinder<E>;
+  friend class Event<E>;
 
 public:
-  EventListener() {}
+  EventListener() : event(nullptr), id(0) {}
 
   virtual ~EventListener() {
     unbind();
@@ -54,31 +57,28 @@ public:
   EventListener(const EventListener&) = delete;
   EventListener& operator=(const EventListener& rhs) = delete;
 
-  EventListener& operator=(std::shared_ptr<ListenerBinder<E>> el_ptr) {
+  EventListener& operator=(const ListenerBinder<E>& binder) {
     if (isBinded()) {  // unsubscribe from event
       this->unbind();
     }
-    this->binder = el_ptr;
-    el_ptr->eventListener = this;
+    event = binder.getEvent();
+    id = binder.getId();
+    event->bindListener(id, this);
     return *this;
   };
 
   bool isBinded() const {
-    std::shared_ptr<ListenerBinder<E>> my_binder(binder.lock());
-    if (my_binder) {
-      return true;
-    } else {
-      return false;
-    }
+    return event != nullptr;
   }
 
 private:
-  std::weak_ptr<ListenerBinder<E>> binder;
+  Event<E>* event;
+  int id;
 
   void unbind() {
-    std::shared_ptr<ListenerBinder<E>> my_binder(binder.lock());
-    if (my_binder) {
-      bool result = my_binder->unbindFromEvent();
+    if (event != nullptr) {
+      bool result = event->removeListener(id);
+      event = nullptr;
       if (!result) {
         ERR("Cannot unbind from event!");
       }
@@ -0,0 +1,138 @@
+/**
+ * Copyright (c) 2015, Alov Maxim <alovmax@yandex.ru>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+ * and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of
+ * conditions and the following disclaimer in the documentation and/or other materials provided with
+ * the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ * WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __ARKANOID_EVENT_QUEUE__H__
+#define __ARKANOID_EVENT_QUEUE__H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+/// @class EventQueue EventQueue.h "include/EventQueue.h"
+/// @brief Bounded lock-free multi-producer / single-consumer ring queue.
+///
+/// Each cell carries a sequence number which tells producers whether
+/// the cell is free and tells the consumer whether the cell is published.
+/// Producers race on the tail index with CAS, the only consumer owns
+/// the head index. Capacity is rounded up to a power of two.
+template <typename T>
+class EventQueue {
+public:
+  explicit EventQueue(size_t capacity)
+    : m_mask(roundUp(capacity) - 1)
+    , m_cells(new Cell[m_mask + 1])
+    , m_head(0) {
+    for (size_t i = 0; i <= m_mask; ++i) {
+      m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    m_tail.store(0, std::memory_order_relaxed);
+  }
+
+  ~EventQueue() {
+    delete [] m_cells;  m_cells = nullptr;
+  }
+
+  EventQueue(const EventQueue&) = delete;
+  EventQueue& operator = (const EventQueue&) = delete;
+
+  /// @brief Enqueues an item, may be called from any thread.
+  /// @return false if queue is full.
+  bool push(const T& item) {
+    T copy(item);
+    return push(std::move(copy));
+  }
+
+  bool push(T&& item) {
+    size_t position = m_tail.load(std::memory_order_relaxed);
+    Cell* cell = nullptr;
+    for (;;) {
+      cell = &m_cells[position & m_mask];
+      size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+      if (diff == 0) {
+        if (m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;  // full
+      } else {
+        position = m_tail.load(std::memory_order_relaxed);
+      }
+    }
+    cell->data = std::move(item);
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// @brief Dequeues an item, must be called from consumer thread only.
+  /// @return false if queue is empty.
+  bool pop(T& item) {
+    Cell* cell = &m_cells[m_head & m_mask];
+    size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(m_head + 1) < 0) {
+      return false;  // empty or not yet published
+    }
+    item = std::move(cell->data);
+    cell->data = T();  // release resources held by payload (e.g. shared_ptr)
+    cell->sequence.store(m_head + m_mask + 1, std::memory_order_release);
+    ++m_head;
+    return true;
+  }
+
+  /// @brief Whether there is no published item at the head,
+  /// must be called from consumer thread only.
+  bool empty() const {
+    const Cell* cell = &m_cells[m_head & m_mask];
+    return cell->sequence.load(std::memory_order_acquire) != m_head + 1;
+  }
+
+  size_t capacity() const { return m_mask + 1; }
+
+private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T data;
+  };
+
+  static size_t roundUp(size_t value) {
+    size_t result = 2;
+    while (result < value) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  const size_t m_mask;
+  Cell* m_cells;
+  std::atomic<size_t> m_tail;  //!< Shared among producers.
+  char m_padding[64];  //!< Keeps head and tail on different cache lines.
+  size_t m_head;  //!< Owned by consumer.
+};
+
+#endif  // __ARKANOID_EVENT_QUEUE__H__
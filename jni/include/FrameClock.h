@@ -0,0 +1,56 @@
+#ifndef __ARKANOID_FRAME_CLOCK__H__
+#define __ARKANOID_FRAME_CLOCK__H__
+
+#include <atomic>
+#include <chrono>
+
+namespace game {
+
+/// @class FrameClock FrameClock.h "include/FrameClock.h"
+/// @brief Monotonic wall clock sampled once per rendered frame.
+/// @details All animations of a frame read the same delta and absolute
+/// time, so their speed does not depend on CPU load. In fixed-step mode
+/// every frame advances time by the same step regardless of wall time,
+/// which makes animations reproducible (e.g. for replays and tests).
+/// Ticked by render thread only, fixed step may be set from any thread.
+class FrameClock {
+public:
+  typedef std::chrono::steady_clock Clock;
+
+  /// @brief Upper bound of animation delta, seconds: stalls (pause,
+  /// surface re-creation) must not make animations jump.
+  constexpr static float maxDelta = 0.1f;
+
+  FrameClock();
+
+  /// @brief Samples the clock at the start of a new frame.
+  void tick();
+  /// @brief Restarts time from zero, next tick yields zero delta.
+  void reset();
+
+  /// @brief Enables fixed-step mode with given step in seconds,
+  /// zero or negative step returns to real time.
+  void setFixedStep(float step);
+  inline bool isFixedStep() const { return m_fixed_step.load() > 0.0f; }
+
+  /// @brief Animation time passed since previous frame, seconds.
+  inline float getDelta() const { return m_delta; }
+  /// @brief Animation time passed since first frame, seconds.
+  inline double getTime() const { return m_time; }
+  /// @brief Wall time between two last frames, nanoseconds
+  /// (zero for the first frame), independent of fixed-step mode.
+  inline long long getIntervalNanos() const { return m_interval; }
+  inline long long getFrames() const { return m_frames; }
+
+private:
+  Clock::time_point m_last_tick;
+  std::atomic<float> m_fixed_step;
+  float m_delta;
+  double m_time;
+  long long m_interval;
+  long long m_frames;
+};
+
+}
+
+#endif  // __ARKANOID_FRAME_CLOCK__H__
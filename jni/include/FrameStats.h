@@ -0,0 +1,102 @@
+#ifndef __ARKANOID_FRAME_STATS__H__
+#define __ARKANOID_FRAME_STATS__H__
+
+#include <atomic>
+#include <chrono>
+
+namespace game {
+
+/// @class FrameStats FrameStats.h "include/FrameStats.h"
+/// @brief Counters of rendering cost: draw calls, texture binds, shader
+/// location lookups by name, heap allocations, CPU time per frame and wall time between frames.
+/// @details Updated by render thread only, may be read from any thread.
+class FrameStats {
+public:
+  FrameStats();
+
+  /// @brief Marks the start of frame's CPU work.
+  void beginFrame();
+  /// @brief Marks the end of frame's CPU work (before buffers swap)
+  /// and publishes counters of this frame.
+  void endFrame();
+  /// @brief Accounts single glDraw* call in current frame.
+  inline void drawCall() { ++m_current_draw_calls; }
+  /// @brief Accounts single glBindTexture() call in current frame.
+  inline void textureBind() { ++m_current_texture_binds; }
+  /// @brief Accounts shader location lookups made in current frame.
+  inline void locationLookups(int count) { m_current_location_lookups += count; }
+  /// @brief Accounts heap allocations made in current frame.
+  /// @see AllocationCounter.h
+  inline void allocations(int count) { m_current_allocations += count; }
+  /// @brief Accounts wall time since previous frame, zero if unknown.
+  /// @see FrameClock::getIntervalNanos()
+  inline void frameTime(long long nanos) { m_current_frame_time = nanos; }
+  /// @brief Accounts frames which have missed their deadlines.
+  inline void droppedFrames(int count) { m_dropped_frames.fetch_add(count); }
+
+  inline long long getFrames() const { return m_frames.load(); }
+  inline int getLastDrawCalls() const { return m_last_draw_calls.load(); }
+  inline int getLastTextureBinds() const { return m_last_texture_binds.load(); }
+  inline int getLastLocationLookups() const { return m_last_location_lookups.load(); }
+  inline int getLastAllocations() const { return m_last_allocations.load(); }
+  inline long long getLastCpuTimeMicros() const { return m_last_cpu_time.load() / 1000; }
+  inline long long getDroppedFrames() const { return m_dropped_frames.load(); }
+  /// @brief Frames rendered per second, measured over the last whole second.
+  inline float getAchievedFps() const { return m_achieved_fps.load(); }
+  /// @brief Average number of draw calls per frame.
+  double getAverageDrawCalls() const;
+  /// @brief Average number of texture binds per frame.
+  double getAverageTextureBinds() const;
+  /// @brief Average number of shader location lookups per frame.
+  double getAverageLocationLookups() const;
+  /// @brief Average number of heap allocations per frame.
+  double getAverageAllocations() const;
+  /// @brief Average CPU time per frame, microseconds.
+  double getAverageCpuTimeMicros() const;
+  /// @brief Shortest wall time between frames, microseconds.
+  double getMinFrameTimeMicros() const;
+  /// @brief Average wall time between frames, microseconds.
+  double getAverageFrameTimeMicros() const;
+  /// @brief Wall time between frames not exceeded by given fraction
+  /// of frames (e.g. 0.99), microseconds, with histogram resolution.
+  double getPercentileFrameTimeMicros(double fraction) const;
+  /// @brief Drops accumulated counters.
+  void reset();
+
+private:
+  constexpr static long long histogramStep = 250000;  //!< Nanoseconds per bucket.
+  constexpr static int histogramSize = 400;  //!< Last bucket takes all longer frames.
+
+  std::chrono::steady_clock::time_point m_frame_start;
+  int m_current_draw_calls;
+  int m_current_texture_binds;
+  int m_current_location_lookups;
+  int m_current_allocations;
+  long long m_current_frame_time;
+
+  std::atomic<long long> m_frames;
+  std::atomic<long long> m_total_draw_calls;
+  std::atomic<long long> m_total_texture_binds;
+  std::atomic<long long> m_total_location_lookups;
+  std::atomic<long long> m_total_allocations;
+  std::atomic<long long> m_total_cpu_time;  //!< Nanoseconds.
+  std::atomic<int> m_last_draw_calls;
+  std::atomic<int> m_last_texture_binds;
+  std::atomic<int> m_last_location_lookups;
+  std::atomic<int> m_last_allocations;
+  std::atomic<long long> m_last_cpu_time;  //!< Nanoseconds.
+
+  std::atomic<long long> m_timed_frames;  //!< Frames with known frame time.
+  std::atomic<long long> m_total_frame_time;  //!< Nanoseconds.
+  std::atomic<long long> m_min_frame_time;  //!< Nanoseconds.
+  std::atomic<int> m_frame_time_histogram[histogramSize];
+
+  std::atomic<long long> m_dropped_frames;
+  std::chrono::steady_clock::time_point m_fps_window_start;
+  int m_fps_window_frames;
+  std::atomic<float> m_achieved_fps;
+};
+
+}
+
+#endif  // __ARKANOID_FRAME_STATS__H__
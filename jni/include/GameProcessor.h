@@ -2,6 +2,8 @@
 #define __ARKANOID_GAMEPROCESSOR__H__
 
 #include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <random>
@@ -11,10 +13,12 @@
 
 #include "ActiveObject.h"
 #include "Ball.h"
+#include "BallPool.h"
 #include "Bite.h"
 #include "Event.h"
 #include "EventListener.h"
 #include "ExplosionPackage.h"
+#include "GameStateSnapshot.h"
 #include "LaserPackage.h"
 #include "Level.h"
 #include "LevelDimens.h"
@@ -22,13 +26,62 @@
 #include "Prize.h"
 #include "PrizePackage.h"
 #include "RowCol.h"
+#include "Sweep.h"
 #include "utils.h"
 
 namespace game {
 
+class InputRecorder;
+
+/// @brief Tagged incoming event for GameProcessor, only payload
+/// matching the kind is meaningful.
+struct GameProcessorMessage {
+  enum class Kind : int {
+    NONE = 0,
+    ASPECT_MEASURED = 1,
+    LOAD_LEVEL = 2,
+    THROW_BALL = 3,
+    INIT_BALL = 4,
+    INIT_BITE = 5,
+    LEVEL_DIMENS = 6,
+    BITE_MOVED = 7,
+    PRIZE_CAUGHT = 8,
+    LASER_BEAM = 9,
+    TICK_RATE = 10,
+    RECORDER = 11,
+    BONUS_BLOCKS = 12
+  };
+
+  GameProcessorMessage(Kind kind = Kind::NONE)
+    : kind(kind)
+    , value(0.0f)
+    , level(nullptr)
+    , ball()
+    , bite()
+    , level_dimens(0, 0, 0.0f, 0.0f, 0.0f, 0.0f)
+    , prize(Prize::NONE)
+    , laser(0.0f, 0.0f)
+    , tick_rate(0)
+    , recorder(nullptr)
+    , flag(false) {
+  }
+
+  Kind kind;
+  GLfloat value;  //!< ASPECT_MEASURED, THROW_BALL
+  Level::Ptr level;  //!< LOAD_LEVEL
+  Ball ball;  //!< INIT_BALL
+  Bite bite;  //!< INIT_BITE, BITE_MOVED
+  LevelDimens level_dimens;  //!< LEVEL_DIMENS
+  Prize prize;  //!< PRIZE_CAUGHT
+  LaserPackage laser;  //!< LASER_BEAM
+  int tick_rate;  //!< TICK_RATE
+  std::shared_ptr<InputRecorder> recorder;  //!< RECORDER
+  bool flag;  //!< BONUS_BLOCKS
+};
+
 /// @class GameProcessor GameProcessor.h "include/GameProcessor.h"
 /// @brief Standalone thread performs game logic calculations.
-class GameProcessor : public ActiveObject {
+class GameProcessor : public QueuedActiveObject<GameProcessorMessage> {
 public:
   typedef GameProcessor* Ptr;
 
@@ -42,21 +95,21 @@ public:
   /// @brief Called when aspect ratio has been measured.
   void callback_aspectMeasured(float aspect);
   /// @brief Called when user requests a level to be loaded
-  void callback_loadLevel(Level::Ptr level);
+  void callback_loadLevel(const Level::Ptr& level);
   /// @brief Called when user sends a command to throw a ball.
   void callback_throwBall(float angle);
   /// @brief Called when ball has been set to it's initial position.
-  void callback_initBall(Ball init_ball);
+  void callback_initBall(const Ball& init_ball);
   /// @brief Called when bite's dimensions have been measured.
-  void callback_initBite(Bite bite);
+  void callback_initBite(const Bite& bite);
   /// @brief Called when newly loaded level's dimensions have been measured.
-  void callback_levelDimens(LevelDimens level_dimens);
+  void callback_levelDimens(const LevelDimens& level_dimens);
   /// @brief Called when bite's location has changed.
-  void callback_biteMoved(Bite moved_bite);
+  void callback_biteMoved(const Bite& moved_bite);
   /// @brief Called when prize has been caught.
-  void callback_prizeCaught(PrizePackage package);
+  void callback_prizeCaught(const PrizePackage& package);
   /// @brief Called when laser beam has moved.
-  void callback_laserBeam(LaserPackage laser);
+  void callback_laserBeam(const LaserPackage& laser);
   /** @} */  // end of Callbacks group
 
 // ----------------------------------------------
@@ -89,9 +142,48 @@ public:
    * @{
    */
   /// @brief Forces prize generator to generate BLOCK prizes in case of TRUE passed.
+  /// @details Applied to the level loaded by previously posted messages.
   void setBonusBlocks(bool flag);
+  /// @brief Sets rate [Hz] of physics simulation, ball's speed and
+  /// durations of timed effects are preserved in real time.
+  void setTickRate(int ticks_per_second);
+  /// @brief State of simulation published once per tick, renderer
+  /// is the only reader allowed.
+  inline GameStateBuffer* getGameState() { return &m_game_state; }
+  /// @brief Starts writing processed inputs to recorder, from the next
+  /// message on, or stops it and writes state hash if nullptr passed.
+  /// @details Generators are restarted by seeds of recorder, so
+  /// recording should start before level is loaded.
+  void setRecorder(std::shared_ptr<InputRecorder> recorder);
   /** @} */  // end of LogicFunc group
 
+  /** @defgroup Headless Synchronous simulation on caller's thread,
+   *  used by host tools (benchmarks, replays).
+   * @{
+   */
+  /// @brief Restarts random sequences used by game logic, so that runs
+  /// with the same seed and input are reproducible.
+  void setSeed(unsigned int seed);
+  /// @brief Processes pending events and runs fixed ticks of simulation
+  /// on caller's thread, ignoring real time.
+  /// @param ticks Max number of ticks to simulate.
+  /// @return Number of ticks actually simulated, less than requested
+  /// if ball has stopped.
+  /// @note Processor must not be launched.
+  int advance(int ticks);
+  /// @brief Whether the ball is currently flying.
+  inline bool isBallFlying() const { return m_ball_is_flying; }
+  /// @brief Number of balls in play.
+  inline int getBallCount() const { return m_balls.alive(); }
+  /// @brief Ticks simulated since processor has been created.
+  inline long long getTickCount() const { return m_tick_count; }
+  /// @brief Queues message as if it came through a callback.
+  void inject(GameProcessorMessage message);
+  /// @brief Hash of simulation state: ball, bite, level, timers and
+  /// counters, to compare runs with each other.
+  uint64_t getStateHash() const;
+  /** @} */  // end of Headless group
+
 // ----------------------------------------------
 /* Public data-members */
 public:
@@ -117,8 +209,6 @@ public:
   /// @brief Listens for laser beam movement.
   EventListener<LaserPackage> laser_beam_listener;
 
-  /// @brief Notifies ball has moved to a new position.
-  Event<Ball> move_ball_event;
   /// @brief Notifies whether the ball has been lost.
   Event<bool> lost_ball_event;
   /// @brief Notifies whether the ball has been stopped.
@@ -177,10 +267,12 @@ private:
   GLfloat m_aspect;  //!< Measured aspect ratio.
   bool m_level_finished;  //!< Whether level has been successfully finished.
   bool m_ball_is_flying;  //!< Whether the ball is flying now or not.
-  bool m_is_ball_lost;  //!< Whether the ball has been lost or not.
-  bool m_is_ball_death;  //!< Whether the ball has been lost after DEATH block collision.
+  bool m_is_ball_lost;  //!< Whether the ball being resolved has been lost or not.
+  bool m_is_ball_death;  //!< Whether the ball being resolved has been lost after DEATH block collision.
   bool m_ball_pose_corrected;  //!< Auxiliary flag for corrected ball's pose.
-  Ball m_ball;  //!< Physical ball's representation.
+  BallPool m_balls;  //!< All balls in play.
+  Ball m_ball;  //!< Ball being resolved, the first one in play between ticks.
+  int m_ball_index;  //!< Index of m_ball in pool.
   Bite m_bite;  //!< Physical bite's representation.
   LaserPackage m_laser_beam;  //!< Laser beam package.
   GLfloat m_bite_upper_border;  //!< Upper border of bite.
@@ -192,10 +284,24 @@ private:
   int m_internal_timer_for_laser;  //!< Timer used for laser beam visibility.
   std::atomic<int> explosionID;
   std::atomic<int> prizeID;
-  long long m_next_move_iteration;
-  long long m_prev_move_iteration;
   /** @} */  // end of LogicData group
 
+  /** @defgroup Simulation Fixed-timestep simulation clock.
+   * @{
+   */
+  int m_tick_rate;  //!< Simulation ticks per second.
+  GLfloat m_tick_scale;  //!< Reference tick rate over actual one, scales per-tick displacement.
+  std::chrono::steady_clock::duration m_tick_period;  //!< Simulated time per tick.
+  std::chrono::steady_clock::duration m_wake_up_period;  //!< Time between wake-ups while ball is flying.
+  std::chrono::steady_clock::duration m_tick_accumulator;  //!< Real time not yet simulated.
+  std::chrono::steady_clock::time_point m_last_tick_time;  //!< When accumulator was last fed.
+  long long m_tick_count;  //!< Ticks simulated since processor has been created.
+  GameStateBuffer m_game_state;  //!< Latest state published for renderer.
+  std::shared_ptr<InputRecorder> m_recorder;  //!< Writes processed inputs, if any.
+  long long m_record_start_tick;  //!< Tick recording has started at.
+  int m_recorded_levels;  //!< Levels loaded since recording has started.
+  /** @} */  // end of Simulation group
+
   /** @defgroup Maths Maths auxiliary members.
    * @{
    */
@@ -209,24 +315,6 @@ private:
    * @{
    */
   std::mutex m_jnienvironment_mutex;  //!< Sentinel for thread attach to JVM.
-  std::mutex m_aspect_ratio_mutex;  //!< Sentinel for measured aspect ratio.
-  std::mutex m_load_level_mutex;  //!< Sentinel for load level user request.
-  std::mutex m_throw_ball_mutex;  //!< Sentinel for throw ball user command.
-  std::mutex m_init_ball_position_mutex;  //!< Sentinel for init ball position setting.
-  std::mutex m_init_bite_mutex;  //!< Sentinel for initial bite dimensions.
-  std::mutex m_level_dimens_mutex;  //!< Sentinel for loaded level dimensions.
-  std::mutex m_bite_location_mutex;  //!< Sentinel for bite's center location changes.
-  std::mutex m_prize_caught_mutex;  //!< Sentinel for prize has been caught.
-  std::mutex m_laser_beam_mutex;
-  std::atomic_bool m_aspect_ratio_received;  //!< Aspect ratio has been measured.
-  std::atomic_bool m_load_level_received;  //!< Load level request has been received.
-  std::atomic_bool m_throw_ball_received;  //!< Throw ball command has been received.
-  std::atomic_bool m_init_ball_position_received;  //!< Setting ball into init position received.
-  std::atomic_bool m_init_bite_received;  //!< Initial bite dimensions have been received.
-  std::atomic_bool m_level_dimens_received;  //!< Level has been loaded and it's dimens received.
-  std::atomic_bool m_bite_location_received;  //!< New bite's center location has been received.
-  std::atomic_bool m_prize_caught_received;  //!< Prize has been caught received.
-  std::atomic_bool m_laser_beam_received;
   /** @} */  // end of Mutex group
 
 // ----------------------------------------------
@@ -241,9 +329,13 @@ private:
   /// @return Whether this thread should continue sleeping (false)
   /// or working (true).
   bool checkForWakeUp() override final;
-  /// @brief Operate the data or do some job as a response of incoming
-  /// outer event.
+  /// @brief Drains incoming events and then advances simulation by as many
+  /// fixed ticks as real time has passed, sleeping till the next tick.
   void eventHandler() override final;
+  /// @brief Routes incoming message to corresponding processor.
+  void dispatch(GameProcessorMessage& message) override final;
+  /// @brief Moves of bite may be dropped, the next one supersedes them.
+  bool isCoalescable(const GameProcessorMessage& message) const override final;
   /** @} */  // end of ActiveObject group
 
   /** @defgroup Processors Actions being performed by GameProcessor when
@@ -251,41 +343,77 @@ private:
    *  @{
    */
   /// @brief Processing when aspect ratio has been measured.
-  void process_aspectMeasured();
+  void process_aspectMeasured(GLfloat aspect);
   /// @brief Processing when new level has been loaded.
-  void process_loadLevel();
+  void process_loadLevel(Level::Ptr level);
   /// @brief Throws the ball, setting it's initial speed and direction.
-  void process_throwBall();
+  void process_throwBall(GLfloat angle);
   /// @brief Sets the ball's initial position values.
-  void process_initBall();
+  void process_initBall(const Ball& init_ball);
   /// @brief Set's the bite's measured dimensions.
-  void process_initBite();
+  void process_initBite(const Bite& bite);
   /// @brief Processing when new level loaded and it's lower border received.
-  void process_levelDimens();
+  void process_levelDimens(const LevelDimens& level_dimens);
   /// @brief Processing when bite's location has changed.
-  void process_biteMoved();
+  void process_biteMoved(const Bite& moved_bite);
   /// @brief Sets effect supplied with prize.
-  void process_prizeCaught();
+  void process_prizeCaught(Prize prize);
   /// @brief Processing laser beam movement.
-  void process_laserBeam();
+  void process_laserBeam(const LaserPackage& laser);
+  /// @brief Changes rate of physics simulation.
+  void process_tickRate(int ticks_per_second);
+  /// @brief Attaches recorder of inputs or detaches the current one.
+  void process_recorder(std::shared_ptr<InputRecorder> recorder);
+  /// @brief Forces prize generator of current level to generate BLOCK prizes.
+  void process_bonusBlocks(bool flag);
   /** @} */  // end of Processors group
 
   /** @defgroup LogicFunc Game logic related member functions.
    * @{
    */
-  /// @brief Calculates new position of ball according to it's velocity
-  /// and then notifies listeners that event 'move_ball_event' occurs.
-  /// @details Calculated position is the ball's position in the next frame.
-  void moveBall();
+  /// @brief Single fixed step of simulation: moves the ball and
+  /// advances timers of timed effects.
+  void tick();
+  /// @brief Restarts simulation clock, dropping any accumulated time.
+  void resetSimulationClock();
+  /// @brief Publishes current positions of ball and bite for renderer.
+  void publishGameState();
+  /// @brief Converts duration, tuned for reference tick rate, into ticks.
+  inline int scaledTicks(int reference_ticks) const {
+    return reference_ticks * m_tick_rate / ProcessorParams::referenceTickRate;
+  }
+  /// @brief Moves all balls by one tick: balls in free flight within the
+  /// pass of BallPool::step(), then the others one by one in index order.
+  void moveBalls();
+  /// @brief Calculates new position of ball according to it's velocity,
+  /// resolving it's collisions.
+  /// @param index Index of ball in pool.
+  /// @details Calculated position is the ball's position in the next tick.
+  void moveBall(int index);
+  /// @brief Takes ball from pool to be resolved as m_ball.
+  void loadBall(int index);
+  /// @brief Puts m_ball back into pool.
+  void storeBall();
+  /// @brief Region where ball can't collide anything within a tick.
+  FreeFlight getFreeFlight() const;
+  /// @brief Removes ball being resolved, or stops flying and notifies
+  /// listeners if it was the last one in play.
+  void dropBall();
+  /// @brief Spawns offspring of every ball in play, by ZYGOTE prize.
+  void multiplyBalls();
+  /// @brief Sets effect of all balls in play.
+  void setBallsEffect(BallEffect effect);
+  /// @brief Sets speed of all balls in play.
+  void setBallsVelocity(GLfloat velocity);
   /// @brief Shift the ball into specified position.
   /// @param new_x New ball's center position along X axis.
   /// @param new_y New ball's center position along Y axis.
-  /// @note Forces ball's movement with notification, only internal uses.
+  /// @note Forces ball's movement, only internal uses.
   void shiftBall(GLfloat new_x, GLfloat new_y);
   /// @brief Shifts the ball to the center of specified block.
   /// @param row Row index of specified block.
   /// @param col Column index of specified block.
-  /// @note Forces ball's movement with notification, only internal uses.
+  /// @note Forces ball's movement, only internal uses.
   void shiftBallIntoBlock(int row, int col);
   /// @brief Teleports ball into random ordinary block if presents.
   void teleportBallIntoRandomBlock();
@@ -326,11 +454,10 @@ private:
   /// @param prize Type of prize to be spawned.
   void spawnPrizeAtBlock(int row, int col, Prize prize);
   /// @brief Performs action according to current ball's effect
-  /// at specified block.
-  /// @param row Row index of specified block.
-  /// @param col Column index of specified block.
+  /// at impacted block.
+  /// @param impact Impacted block and its surface.
   /// @return Score after effect.
-  int performBallEffectAtBlock(int row, int col);
+  int performBallEffectAtBlock(const Impact& impact);
   /// @brief Drops internal timer's value.
   inline void dropInternalTimer() { m_internal_timer = 0; }
   inline void dropInternalTimerForSpeed() { m_internal_timer_for_speed = 0; }
@@ -354,45 +481,36 @@ private:
   inline bool checkInternalTimerForLaser(int value) { return m_internal_timer_for_laser >= value; }
   /// @brief Drops any of ball's timed effects if any.
   void dropTimedEffectForBall();
-  /// @brief Increments move iteration value.
-  inline void incrementMoveIteration() { ++m_next_move_iteration; }
-  inline void dropMoveIteration() {
-    m_next_move_iteration = 0;
-    m_prev_move_iteration = 0;
-  }
-  inline void preserveMoveIteration() { m_prev_move_iteration = m_next_move_iteration; }
-  inline int diffMoveIterations() const { return m_next_move_iteration - m_prev_move_iteration; }
   /** @} */  // end of LogicFunc group
 
   /** @defgroup Collision Functions to perform various collisions.
    * @{
    */
-  /// @brief Recalculates ball's angle when it faces left border of any object.
+  /// @brief Reflects ball's velocity when it faces left border of any object.
   void collideLeftBorder();
-  /// @brief Recalculates ball's angle when it faces right border of any object.
+  /// @brief Reflects ball's velocity when it faces right border of any object.
   void collideRightBorder();
-  /// @brief Recalculates ball's angle when it faces any horizontal surface.
+  /// @brief Reflects ball's velocity when it faces any horizontal surface.
   void collideHorizontalSurface();
-  /// @brief Recalculates ball's angle when it faces the bite.
+  /// @brief Reflects ball's velocity off the bite's surface normal at point of impact.
   /// @param new_x Position of ball's center along X axis in the next frame.
   /// @return TRUE in case ball collides bite, FALSE if ball misses the bite.
   bool collideBite(GLfloat new_x);
   /// @brief Processing of collision between ball and level's block.
+  /// @details Blocks are looked up along the whole path of ball
+  /// within the tick, so fast ball never tunnels through them.
   /// @param new_x Position of ball's center along X axis in the next frame.
   /// @param new_y Position of ball's center along Y axis in the next frame.
   /// @return TRUE in case ball collides level's lower border,
   /// FALSE if ball misses such border.
   bool collideBlock(GLfloat new_x, GLfloat new_y);
-  /// @brief Performs viscous block collision from certain side of block
-  /// depending on previous ball's position.
-  /// @param top_border Top border of collided block.
-  /// @param bottom_border Bottom border of collided block.
-  /// @param left_border Left border of collided block.
-  /// @param right_border Right border of collided block.
+  /// @brief Performs viscous block collision from impacted side of block
+  /// and puts ball at the point of contact.
+  /// @param impact Impacted block and its surface.
   /// @param viscosity Percentage of viscosity (from 0 to 100)
   /// @return TRUE if block has actually been collided, FALSE otherwise.
   /// @details 0 viscosity - no disturbance, 100 - elastic collision
-  bool blockCollision(GLfloat top_border, GLfloat bottom_border, GLfloat left_border, GLfloat right_border, int viscosity);
+  bool blockCollision(const Impact& impact, int viscosity);
   /// @brief For debug purposes.
   void debugCollision(GLfloat new_x, GLfloat new_y, int row, int col, Block block);
   /** @} */  // end of Collision group
@@ -415,8 +533,6 @@ private:
   /// @param x Output X coordinate of block's center.
   /// @param y Output Y coordinate of block's center.
   void getCenterOfBlock(int row, int col, GLfloat* x, GLfloat* y);
-  /// @brief Recognizes block's collision direction.
-  void getCollisionDirection(GLfloat top_border, GLfloat bottom_border, GLfloat left_border, GLfloat right_border, Direction* vertical_direction, Direction* horizontal_direction);
   /// @brief Corrects ball's visual position after collision and notifies
   /// rendering thread.
   /// @param new_x Corrected ball's center position along X axis.
@@ -0,0 +1,48 @@
+#ifndef __ARKANOID_GAME_STATE_SNAPSHOT__H__
+#define __ARKANOID_GAME_STATE_SNAPSHOT__H__
+
+#include <algorithm>
+
+#include "Ball.h"
+#include "Params.h"
+#include "TripleBuffer.h"
+
+namespace game {
+
+/// @brief State of simulation published by GameProcessor once per
+/// physics tick and read by renderer at the start of a frame.
+/// @details Copy takes positions of balls in play only.
+struct GameStateSnapshot {
+  GameStateSnapshot()
+    : tick(0), ball(), bite_x(0.0f), ball_is_flying(false), ball_count(1) {
+    balls_x[0] = 0.0f;
+    balls_y[0] = 0.0f;
+  }
+
+  GameStateSnapshot(const GameStateSnapshot& other) { *this = other; }
+
+  GameStateSnapshot& operator = (const GameStateSnapshot& other) {
+    tick = other.tick;
+    ball = other.ball;
+    bite_x = other.bite_x;
+    ball_is_flying = other.ball_is_flying;
+    ball_count = other.ball_count;
+    std::copy(other.balls_x, other.balls_x + ball_count, balls_x);
+    std::copy(other.balls_y, other.balls_y + ball_count, balls_y);
+    return *this;
+  }
+
+  long long tick;  //!< Number of ticks simulated since processor start.
+  Ball ball;  //!< The first ball in play.
+  GLfloat bite_x;  //!< Bite's center position along X axis.
+  bool ball_is_flying;
+  int ball_count;  //!< Balls in play, the first one included.
+  GLfloat balls_x[BallParams::maxBalls];  //!< Centers of balls in play along X axis.
+  GLfloat balls_y[BallParams::maxBalls];  //!< Centers of balls in play along Y axis.
+};
+
+typedef TripleBuffer<GameStateSnapshot> GameStateBuffer;
+
+}
+
+#endif  // __ARKANOID_GAME_STATE_SNAPSHOT__H__
@@ -8,6 +8,7 @@
 #ifndef INCLUDE_LEVEL_H_
 #define INCLUDE_LEVEL_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -38,13 +39,19 @@ enum class Mode : int {
 /**
  * @class Level Level.h "include/Level.h"
  * @brief Represents game level.
+ * @details Blocks are stored in a single row-major byte grid. All cells
+ * are also kept in one array grouped by type of block, with position of
+ * every cell in it, so that lookups by type take time proportional to
+ * the number of matches. setBlock() moves the cell to its new group with
+ * at most one swap per group in between and keeps cardinality, which is
+ * the sum of cardinality costs over all blocks, so neither can drift.
+ * Swaps shuffle cells within a group, so lookups sort it back first and
+ * give cells in row-major order, as random picks among them expect.
  */
 class Level {
 public:
   typedef std::shared_ptr<Level> Ptr;
 
-  ~Level() noexcept;
-
   /** @defgroup Convert Convert functions to other data types.
    * @{
    */
@@ -59,6 +66,20 @@ public:
   /// @return Size of output array.
   size_t toStringArray(std::vector<std::string>* array) const;
 
+  /// @brief Decodes rows joined by separator, as given by toString().
+  /// @param text Input string, null-terminated.
+  /// @param separator Character between rows, empty rows are skipped.
+  /// @return Level instance.
+  static Level::Ptr fromString(const char* text, char separator);
+
+  /// @brief Converts this Level instance to rows joined by separator.
+  std::string toString(char separator) const;
+
+  /// @brief Builds level right from grid of blocks, as kept by LevelPack.
+  /// @param grid Row-major values of Block, rows * cols of them.
+  /// @return Level instance.
+  static Level::Ptr fromGrid(const uint8_t* grid, int rows, int cols);
+
   /// @brief Converts this Level instance to vertex array.
   /// @param width Width of each block to display.
   /// @param height Height of each block to display.
@@ -105,28 +126,35 @@ public:
   /// @brief Gets prize generator instance.
   inline PrizeGenerator& getPrizeGenerator() { return prize_generator; }
   /// @brief Gets block by row and column indices.
-  inline Block getBlock(int row, int col) const { return blocks[row][col]; }
+  inline Block getBlock(int row, int col) const { return static_cast<Block>(blocks[row * cols + col]); }
   /// @brief Sets the block by row and column indices.
-  inline void setBlock(int row, int col, Block value) { blocks[row][col] = value; }
+  void setBlock(int row, int col, Block value);
+  /// @brief Returns number of blocks of given type.
+  inline int countBlocks(Block type) const { return offsets[static_cast<int>(type) + 1] - offsets[static_cast<int>(type)]; }
   /// @brief Sets the block by row and column indices only
   /// in case it is vulnerable.
-  /// @note Re-calculates cardinality.
   void setVulnerableBlock(int row, int col, Block value);
   /// @brief Changes the block by row and column indices only
   /// in case it is vulnerable, according to the given mode.
-  /// @note Re-calculates cardinality.
   void changeVulnerableBlock(Mode mode, int row, int col);
   /// @brief Destroys vulnerable block.
   /// @return Score of destroyed block.
-  /// @note Re-calculates cardinality.
   int destroyVulnerableBlock(int row, int col);
-  /// @brief Gets recorded cardinality.
-  inline int getCardinality() const { return initial_cardinality; }
-  /// @brief Forced way to drop cardinality for instant victory.
-  inline void forceDropCardinality() { initial_cardinality = 1; }
-  /// @brief Decrements recorded cardinality due to impact of some block.
-  /// @return Updated cardinality.
-  inline int blockImpact() { return --initial_cardinality; }
+  /// @brief Gets cardinality: impacts left to finish the level.
+  inline int getCardinality() const { return cardinality; }
+  /// @brief Forced way to drop cardinality for instant victory:
+  /// the next blockImpact() only reports zero cardinality.
+  inline void forceDropCardinality() { cardinality_dropped = true; }
+  /// @brief Gets cardinality after impact of some block, which
+  /// setBlockImpacted() has already taken into account.
+  /// @return Updated cardinality, or zero once after forced drop.
+  inline int blockImpact() {
+    if (cardinality_dropped) {
+      cardinality_dropped = false;
+      return 0;
+    }
+    return cardinality;
+  }
   /// @brief Checks whether specified block is surrounded with 4 other blocks.
   bool isInner(int row, int col) const;
 
@@ -180,13 +208,13 @@ public:
   /// @param output Valid indices of influenced block.
   /// @return TRUE is place for near block is found, FALSE otherwise.
   bool modifyBlockNear(int row, int col, Block type, RowCol* output);
-  /// @brief Finds all blocks of given type.
+  /// @brief Finds all blocks of given type, in row-major order.
   /// @param type Type of block to be found.
   /// @param output Array of valid indices of found blocks.
   void findBlocks(Block type, std::vector<RowCol>* output);
   /// @brief Same as above, allows NONE blocks.
   void findBlocksAllowNone(Block type, std::vector<RowCol>* output);
-  /// @brief Same as above, but searches backwards.
+  /// @brief Same as above, but in reverse order.
   void findBlocksBackward(Block type, std::vector<RowCol>* output);
   /// @brief Same as above, allows NONE blocks.
   void findBlocksBackwardAllowNone(Block type, std::vector<RowCol>* output);
@@ -194,19 +222,34 @@ public:
   Block generatePresentBlock();
   /** @} */  // end of Modifiers group
 
+  /// @brief Recounts blocks and cardinality over the whole grid and
+  /// checks groups of cells against it, logging any mismatch.
+  /// @return TRUE if bookkeeping matches the grid.
+  bool verify() const;
   void print() const;
 
 private:
   Level(int rows, int cols);
 
-  /// @brief Calculates current cardinality of this Level instance.
+  /// @brief Calculates current cardinality by full scan of the grid.
   int calculateCardinality() const;
   /// @brief Checks whether there are any of ordinary blocks in current level.
   bool checkOrdinaryBlocksPresent() const;
 
+  /// @brief Groups all cells by type of block from scratch.
+  void groupCells();
+  /// @brief Restores row-major order of cells in group [begin, end).
+  void sortGroup(int begin, int end);
+  /// @brief Swaps two cells in groups, updating their positions.
+  void swapCells(int lhs, int rhs);
+
   int rows, cols;
-  int initial_cardinality;
-  Block** blocks;
+  int cardinality;  //!< Sum of cardinality costs over all blocks.
+  bool cardinality_dropped;  //!< Instant victory has been forced, until the next impact.
+  std::vector<uint8_t> blocks;  //!< Row-major grid, row stride is cols.
+  std::vector<int> cells;  //!< Cells (row * cols + col) grouped by type of block, in order of types.
+  std::vector<int> positions;  //!< Position of every cell in cells.
+  int offsets[BlockUtils::totalBlocks + 1];  //!< Start of group of every type in cells, then its end.
   BlockGenerator generator;
   PrizeGenerator prize_generator;
 };
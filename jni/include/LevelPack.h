@@ -0,0 +1,67 @@
+#ifndef __ARKANOID_LEVEL_PACK__H__
+#define __ARKANOID_LEVEL_PACK__H__
+
+#include <cstdint>
+#include <vector>
+
+#include "AssetView.h"
+#include "Level.h"
+
+namespace game {
+
+/**
+ * Level pack file: header, table of levels and their grids, integers are
+ * little endian.
+ *
+ * header:  "ARKL", version (u8), reserved (3 zero bytes), levels (u32), size of file (u32)
+ * entry:   offset of grid (u32), rows, cols (u16), cardinality (u32), checksum of grid (u32)
+ * grid:    rows * cols blocks (u8, values of Block), row-major
+ *
+ * Checksum is FNV-1a over bytes of grid. Values of Block are stored as
+ * they are, so version goes up whenever Block is renumbered.
+ */
+
+/// @brief Level of pack as it lies in file.
+struct LevelGrid {
+  int rows;
+  int cols;
+  int cardinality;
+  const uint8_t* blocks;  //!< Points into view of pack.
+};
+
+/// @class LevelPack LevelPack.h "include/LevelPack.h"
+/// @brief Many levels in one binary file, read in place.
+/// @details Header, table and grids are validated once by open(), then
+/// grids are handed out as pointers into the view, neither copied nor
+/// parsed, and Level is built right from grid by load(). Pack keeps the
+/// view, so it is movable only, and is read-only once opened.
+class LevelPack {
+public:
+  LevelPack();
+
+  /// @brief Takes view of pack file and validates its content.
+  /// @return false if view is not a pack of supported version, is
+  /// truncated or has a broken grid; pack stays empty then.
+  bool open(AssetView&& view);
+
+  inline int size() const { return m_size; }
+  inline bool empty() const { return m_size == 0; }
+
+  /// @brief Grid of level at given index, which must be in range.
+  LevelGrid getGrid(int index) const;
+
+  /// @brief Builds level at given index.
+  /// @return nullptr if index is out of range.
+  Level::Ptr load(int index) const;
+
+  /// @brief Encodes levels into contents of pack file.
+  static void write(const std::vector<Level::Ptr>& levels, std::vector<uint8_t>* output);
+
+private:
+  AssetView m_view;
+  int m_size;
+};
+
+}
+
+#endif  // __ARKANOID_LEVEL_PACK__H__
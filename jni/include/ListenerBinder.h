@@ -35,27 +35,15 @@
 template <typename E>
 class Event;
 
+/// @brief Listener just created by Event::createListener(), to be
+/// assigned to EventListener, which will be notified since then.
 template<typename E>
 class ListenerBinder {
   friend class Event<E>;
 
 public:
-  typedef std::shared_ptr<ListenerBinder<E>> Ptr;
-  EventListener<E>* eventListener;
-
-  void callListenerSafe(E e) {
-    if (eventListener != nullptr) {
-      f(e);
-    }
-  }
-
-  bool unbindFromEvent() {
-    if (event == nullptr) {
-      return false;
-    }
-    bool result = event->removeListener(id);
-    eventListener = nullptr;
-    return result;
+  inline Event<E>* getEvent() const {
+    return event;
   }
 
   inline const int& getId() const {
@@ -64,17 +52,12 @@ public:
 
 private:
   Event<E>* event;
-  std::function<void (E)> f;
   int id;
 
-public:
-  ListenerBinder(Event<E>* event_ptr, std::function<void (E)> f_in, int listener_id)
+  ListenerBinder(Event<E>* event_ptr, int listener_id)
     : event(event_ptr)
-    , f(f_in)
-    , id(listener_id)
-    , eventListener(nullptr) {
+    , id(listener_id) {
   }
-
 };
 
 #endif  // SURFACE3D_LISTENERBINDER__H__
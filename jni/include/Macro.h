@@ -4,4 +4,9 @@
 #define USE_TEXTURE 0
 #define DEBUG 0
 
+// replaces global operator new to count heap allocations per thread
+#ifndef COUNT_ALLOCATIONS
+#define COUNT_ALLOCATIONS 0
+#endif
+
 #endif  // __ARKANOID_MACRO__H__
@@ -0,0 +1,99 @@
+#ifndef __ARKANOID_MIXER__H__
+#define __ARKANOID_MIXER__H__
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "EventQueue.h"
+
+namespace native {
+namespace sound {
+
+/// @class Mixer Mixer.h "include/Mixer.h"
+/// @brief Real-time software mixer of pre-decoded 16-bit PCM voices
+/// into a single output stream.
+/// @details play() and stopAll() may be called from any thread, commands
+/// reach audio thread through lock-free queue and are applied at the start
+/// of the next rendered block. render() runs on audio thread, it neither
+/// locks nor allocates. Voices and output share the same interleaved format.
+class Mixer {
+public:
+  constexpr static int sampleRate = 44100;
+  constexpr static int channels = 2;  //!< Interleaved stereo, WAVSound converts assets into it.
+  constexpr static int blockFrames = sampleRate / 100;  //!< 10 ms
+  constexpr static int maxVoices = 32;
+
+  /// @param voices Number of voices played simultaneously, up to maxVoices.
+  explicit Mixer(int voices = maxVoices);
+
+  /// @brief Starts playback of a sound.
+  /// @param samples Interleaved 16-bit PCM, must outlive the playback.
+  /// @param length Total number of samples (frames * channels).
+  /// @param gain Volume of voice, from 0 to 1.
+  /// @param priority When all voices are busy, the voice with the lowest
+  /// priority not exceeding this one is stolen, otherwise sound is dropped.
+  /// @return FALSE if command queue is full.
+  bool play(const int16_t* samples, int length, float gain = 1.0f, int priority = 0);
+  /// @brief Silences all voices.
+  void stopAll();
+  /// @brief Mixes next frames of all active voices, must be called
+  /// from audio thread only.
+  /// @param output Interleaved output buffer of frames * channels samples.
+  /// @param frames Number of frames to render.
+  void render(int16_t* output, int frames);
+
+  /// @brief Number of voices being played, audio thread only.
+  int getActiveVoices() const;
+  inline long long getStolenVoices() const { return m_stolen_voices.load(); }
+  inline long long getDroppedSounds() const { return m_dropped_sounds.load(); }
+
+private:
+  struct Voice {
+    const int16_t* samples;  //!< nullptr if voice is free.
+    int length;
+    int position;
+    int16_t gain;  //!< Q15
+    int priority;
+  };
+
+  struct Command {
+    enum class Kind : int {
+      NONE = 0,
+      PLAY = 1,
+      STOP_ALL = 2
+    };
+
+    Command(Kind kind = Kind::NONE)
+      : kind(kind), samples(nullptr), length(0), gain(0), priority(0) {
+    }
+
+    Kind kind;
+    const int16_t* samples;  //!< PLAY
+    int length;              //!< PLAY
+    int16_t gain;            //!< PLAY
+    int priority;            //!< PLAY
+  };
+
+  constexpr static int commandsCapacity = 64;
+
+  void apply(const Command& command);
+  /// @brief Finds free voice or the one to be stolen, nullptr if none.
+  Voice* allocateVoice(int priority);
+
+  EventQueue<Command> m_commands;
+  std::vector<Voice> m_voices;
+  std::vector<int32_t> m_accumulator;  //!< One block of samples.
+  std::atomic<long long> m_stolen_voices;
+  std::atomic<long long> m_dropped_sounds;
+};
+
+/// @brief Adds samples scaled by Q15 gain to 32-bit accumulator.
+void mixSamples(int32_t* accumulator, const int16_t* samples, int count, int16_t gain);
+/// @brief Saturates 32-bit accumulator into 16-bit output.
+void saturateSamples(int16_t* output, const int32_t* accumulator, int count);
+
+}  // namespace sound
+}  // namespace native
+
+#endif  // __ARKANOID_MIXER__H__
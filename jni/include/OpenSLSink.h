@@ -0,0 +1,66 @@
+#ifndef __ARKANOID_OPENSL_SINK__H__
+#define __ARKANOID_OPENSL_SINK__H__
+
+#include <SLES/OpenSLES.h>
+#include <SLES/OpenSLES_Android.h>
+
+#include "AudioSink.h"
+#include "Mixer.h"
+
+namespace native {
+namespace sound {
+
+/// @class OpenSLSink OpenSLSink.h "include/OpenSLSink.h"
+/// @brief Single OpenSL ES player, which streams output of Mixer.
+/// @details Buffer queue is kept full with blocks of Mixer::blockFrames;
+/// each completed buffer is refilled from OpenSL callback thread.
+class OpenSLSink : public AudioSink {
+public:
+  OpenSLSink();
+  virtual ~OpenSLSink();
+
+  bool start(Mixer* mixer) override;
+  void stop() override;
+
+private:
+  /// @brief Called by OpenSL when the queued buffer has been played.
+  static void callback_bufferPlayed(SLAndroidSimpleBufferQueueItf queue, void* context);
+  /// @brief Renders next block into free buffer and enqueues it.
+  bool enqueueBlock();
+  /// @brief Releases all OpenSL objects.
+  void destroy();
+
+  SLObjectItf m_engine;
+  SLEngineItf m_interface;
+  SLObjectItf m_output_mix;
+  SLObjectItf m_player;
+  SLPlayItf m_player_interface;
+  SLAndroidSimpleBufferQueueItf m_player_queue;
+
+  Mixer* m_mixer;
+  constexpr static int buffersCount = 2;
+  int16_t m_buffers[buffersCount][Mixer::blockFrames * Mixer::channels];
+  int m_next_buffer;
+};
+
+/**
+ * Error codes (OpenSLSink)
+ *
+ * 2001 - slCreateEngine() failed
+ * 2002 - Realize() for Engine failed
+ * 2003 - GetInterface() SL_IID_ENGINE failed
+ * 2004 - CreateOutputMix() failed
+ * 2005 - Realize() for Mixer failed
+ * 2006 - CreateAudioPlayer() failed
+ * 2007 - Realize() for Player failed
+ * 2008 - GetInterface() SL_IID_PLAY failed
+ * 2009 - GetInterface() SL_IID_ANDROIDSIMPLEBUFFERQUEUE failed
+ * 2010 - SetPlayState() failed
+ * 2011 - RegisterCallback() failed
+ * 2012 - Enqueue() failed
+ */
+
+}  // namespace sound
+}  // namespace native
+
+#endif  // __ARKANOID_OPENSL_SINK__H__
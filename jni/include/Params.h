@@ -22,6 +22,9 @@ struct BallParams {
   constexpr static float ballFastSpeed = 0.003f;
   constexpr static float ballSpeed = 0.002f;   //!< Initial speed at game start
   constexpr static float ballSlowSpeed = 0.001f;
+  constexpr static int maxBalls = 64;  //!< Balls in play at once, ZYGOTE prize triples them.
+  constexpr static int zygoteOffspring = 2;  //!< Balls spawned by each one on ZYGOTE prize.
+  constexpr static float zygoteSpread = 0.3927f;  //!< Angle between offspring and parent (PI / 8).
 };
 
 struct LaserParams {
@@ -41,7 +44,11 @@ struct PrizeParams {
 };
 
 struct ProcessorParams {
-  constexpr static int milliDelay = 1;  //!< Delay between sequential frames.
+  constexpr static int defaultFrameRate = 60;  //!< Target rate [Hz] of rendered frames.
+  constexpr static int referenceTickRate = 1000;  //!< Tick rate [Hz] ball's velocity and timers are tuned for.
+  constexpr static int defaultTickRate = 1000;  //!< Rate [Hz] of fixed-timestep physics simulation.
+  constexpr static int wakeUpRate = defaultFrameRate;  //!< Rate [Hz] processor wakes up at to run accumulated ticks.
+  constexpr static int maxCatchUpTicks = 64;  //!< Max substeps per wake-up, the rest of a stall is dropped.
 };
 
 }
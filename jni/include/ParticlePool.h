@@ -0,0 +1,91 @@
+#ifndef __ARKANOID_PARTICLE_POOL__H__
+#define __ARKANOID_PARTICLE_POOL__H__
+
+#include <vector>
+
+#include <GLES/gl.h>
+
+#include "ExplosionPackage.h"
+#include "Simd.h"
+
+namespace game {
+
+/// @class ParticlePool ParticlePool.h "include/ParticlePool.h"
+/// @brief Fixed pool of slots, each holding particles of one explosion
+/// together with it's own start time, color and random layout.
+/// @details Pool is a single interleaved vertex array meant to be kept in
+/// a static VBO: a slot is written once when explosion spawns and is then
+/// animated by shader from u_time alone, so all live explosions are drawn
+/// with one call. Per-explosion parameters are replicated per vertex,
+/// since OpenGL ES 2.0 has no instanced attributes.
+class ParticlePool {
+public:
+  constexpr static int maxExplosions = 64;
+  constexpr static int particlesPerExplosion = 500;
+  constexpr static int totalParticles = maxExplosions * particlesPerExplosion;
+  /// Vertex layout: lifetime (1), start position (2), velocity (2),
+  /// center (2), start time (1), color (4), generated by
+  /// util::simd::randomAffineVertices().
+  constexpr static int vertexSize = 12;
+  constexpr static int lifetimeOffset = 0;
+  constexpr static int startPositionOffset = 1;
+  constexpr static int velocityOffset = 3;
+  constexpr static int centerOffset = 5;
+  constexpr static int startTimeOffset = 7;
+  constexpr static int colorOffset = 8;
+  constexpr static GLfloat duration = 1.0f;  //!< Max lifetime of explosion [s].
+
+  ParticlePool();
+
+  /// @brief Sets aspect ratio particles' layout is scaled by along Y axis.
+  inline void setAspect(GLfloat aspect) { m_aspect = aspect; }
+  /// @brief Places explosion into free slot, or into the oldest one
+  /// if all are busy, starting at current time of pool.
+  /// @return Index of slot taken.
+  int spawn(const ExplosionPackage& package);
+  /// @brief Advances time of pool and frees slots of finished explosions.
+  void advance(GLfloat delta);
+  /// @brief Frees all slots.
+  void clear();
+
+  /// @brief Time of pool to be passed to shader as u_time.
+  inline GLfloat getTime() const { return m_time; }
+  inline int getLiveExplosions() const { return m_live; }
+  inline bool empty() const { return m_live == 0; }
+  /// @brief Number of vertices covering all live slots, drawn at once.
+  inline int getDrawCount() const { return (m_last_live_slot + 1) * particlesPerExplosion; }
+  inline const GLfloat* getVertices() const { return &m_vertices[0]; }
+  inline int getVertexStride() const { return vertexSize * sizeof(GLfloat); }
+
+  /// @brief Takes range of slots changed since previous call, which must
+  /// be uploaded into VBO.
+  /// @param offset Offset of the first changed float in vertex array.
+  /// @param count Number of changed floats.
+  /// @return FALSE if nothing has changed.
+  bool takeDirtyRange(int* offset, int* count);
+
+private:
+  std::vector<GLfloat> m_vertices;
+  GLfloat m_start_times[maxExplosions];  //!< Start time of each slot, negative if free.
+  GLfloat m_time;
+  GLfloat m_aspect;
+  int m_live;
+  int m_last_live_slot;
+  int m_high_water_slot;  //!< Highest slot used since time has been rebased.
+  int m_dirty_first;
+  int m_dirty_last;
+  unsigned int m_spawned;  //!< Explosions spawned so far, mixed into seeds.
+  util::simd::UniformLanes m_random;
+
+  /// @brief Fills particles of slot with layout of given kind.
+  void fillSlot(int slot, const ExplosionPackage& package);
+  /// @brief Moves slot's start time far into past, so shader culls it.
+  void freeSlot(int slot);
+  /// @brief Restarts time of idle pool from zero.
+  void rebase();
+  void markDirty(int slot);
+};
+
+}
+
+#endif  // __ARKANOID_PARTICLE_POOL__H__
@@ -0,0 +1,57 @@
+#ifndef __ARKANOID_PREFIX_INDEX__H__
+#define __ARKANOID_PREFIX_INDEX__H__
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "utils.h"
+
+namespace util {
+
+/// @class PrefixIndex PrefixIndex.h "include/PrefixIndex.h"
+/// @brief Groups named items under every prefix of their names,
+/// so random item with given prefix is picked in constant time.
+/// @details Filled once while resources are loading, read-only afterwards.
+template <typename T>
+class PrefixIndex {
+public:
+  /// @brief Adds item to groups of all prefixes of its name (including empty one).
+  void add(const std::string& name, T* item) {
+    for (size_t length = 0; length <= name.length(); ++length) {
+      m_groups[name.substr(0, length)].push_back(item);
+    }
+  }
+
+  /// @brief Replaces item previously added under the same name.
+  void replace(const std::string& name, T* previous, T* item) {
+    for (size_t length = 0; length <= name.length(); ++length) {
+      std::vector<T*>& group = m_groups[name.substr(0, length)];
+      std::replace(group.begin(), group.end(), previous, item);
+    }
+  }
+
+  /// @brief Picks random item whose name starts with given prefix.
+  /// @return Item or nullptr if there is no such item.
+  T* getRandom(const std::string& prefix) const {
+    auto it = m_groups.find(prefix);
+    if (it == m_groups.end()) {
+      return nullptr;
+    }
+    return it->second[getRandomIndex(it->second.size())];
+  }
+
+  /// @brief Number of items whose names start with given prefix.
+  size_t count(const std::string& prefix) const {
+    auto it = m_groups.find(prefix);
+    return it == m_groups.end() ? 0 : it->second.size();
+  }
+
+private:
+  std::unordered_map<std::string, std::vector<T*>> m_groups;
+};
+
+}
+
+#endif  // __ARKANOID_PREFIX_INDEX__H__
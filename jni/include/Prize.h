@@ -52,6 +52,7 @@ class PrizeGenerator {
 public:
   PrizeGenerator();
   Prize generatePrize();  //!< Generates random prize of any type
+  void seed(unsigned int value);  //!< Restarts random sequence
 
   inline void setBonusBlocks(bool flag) { m_bonus_blocks = flag; }
 
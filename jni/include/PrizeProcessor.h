@@ -1,7 +1,6 @@
 #ifndef __ARKANOID_PRIZE_PROCESSOR__H__
 #define __ARKANOID_PRIZE_PROCESSOR__H__
 
-#include <atomic>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -18,9 +17,33 @@
 
 namespace game {
 
+/// @brief Tagged incoming event for PrizeProcessor, only payload
+/// matching the kind is meaningful.
+struct PrizeProcessorMessage {
+  enum class Kind : int {
+    NONE = 0,
+    ASPECT_MEASURED = 1,
+    INIT_BITE = 2,
+    BITE_MOVED = 3,
+    PRIZE_RECEIVED = 4,
+    PRIZE_LOCATED = 5,
+    PRIZE_HAS_GONE = 6
+  };
+
+  PrizeProcessorMessage(Kind kind = Kind::NONE)
+    : kind(kind), aspect(1.0f), prize_id(0), bite(), package() {
+  }
+
+  Kind kind;
+  GLfloat aspect;  //!< ASPECT_MEASURED
+  int prize_id;  //!< PRIZE_HAS_GONE
+  Bite bite;  //!< INIT_BITE, BITE_MOVED
+  PrizePackage package;  //!< PRIZE_RECEIVED, PRIZE_LOCATED
+};
+
 /// @class PrizeProcessor PrizeProcessor.h "include/PrizeProcessor.h"
 /// @brief Standalone thread performs processing catch prizes.
-class PrizeProcessor : public ActiveObject {
+class PrizeProcessor : public QueuedActiveObject<PrizeProcessorMessage> {
 public:
   typedef PrizeProcessor* Ptr;
 
@@ -34,13 +57,13 @@ public:
   /// @brief Called when aspect ratio has been measured.
   void callback_aspectMeasured(float aspect);
   /// @brief Called when bite's dimensions have been measured.
-  void callback_initBite(Bite bite);
+  void callback_initBite(const Bite& bite);
   /// @brief Called when bite's location has changed.
-  void callback_biteMoved(Bite moved_bite);
+  void callback_biteMoved(const Bite& moved_bite);
   /// @brief Called when prize has been generated.
-  void callback_prizeReceived(PrizePackage package);
+  void callback_prizeReceived(const PrizePackage& package);
   /// @brief Called when prize has been located.
-  void callback_prizeLocated(PrizePackage package);
+  void callback_prizeLocated(const PrizePackage& package);
   /// @brief Called when prize has gone.
   void callback_prizeHasGone(int prize_id);
   /** @} */  // end of Callbacks group
@@ -115,18 +138,6 @@ private:
    * @{
    */
   std::mutex m_jnienvironment_mutex;  //!< Sentinel for thread attach to JVM.
-  std::mutex m_aspect_ratio_mutex;  //!< Sentinel for measured aspect ratio.
-  std::mutex m_init_bite_mutex;  //!< Sentinel for initial bite dimensions.
-  std::mutex m_bite_location_mutex;  //!< Sentinel for bite's center location changes.
-  std::mutex m_prize_mutex;  //!< Sentinel for prize receiving.
-  std::mutex m_prize_location_mutex;  //!< Sentinel for prize location changes.
-  std::mutex m_prize_gone_mutex;  //!< Sentinel for prize has gone.
-  std::atomic_bool m_aspect_ratio_received;  //!< Aspect ratio has been measured.
-  std::atomic_bool m_init_bite_received;  //!< Initial bite dimensions have been received.
-  std::atomic_bool m_bite_location_received;  //!< New bite's center location has been received.
-  std::atomic_bool m_prize_received;  //!< Prize has been received.
-  std::atomic_bool m_prize_location_received;  //!< Prize location has been received.
-  std::atomic_bool m_prize_gone_received;  //!< Prize has gone received.
   /** @} */  // end of Mutex group
 
 // ----------------------------------------------
@@ -137,13 +148,10 @@ private:
    */
   void onStart() override final;  //!< Right after thread has been launched.
   void onStop() override final;   //!< Right before thread has been stopped.
-  /// @brief Automatic check whether this thread should continue to operate.
-  /// @return Whether this thread should continue sleeping (false)
-  /// or working (true).
-  bool checkForWakeUp() override final;
-  /// @brief Operate the data or do some job as a response of incoming
-  /// outer event.
-  void eventHandler() override final;
+  /// @brief Routes incoming message to corresponding processor.
+  void dispatch(PrizeProcessorMessage& message) override final;
+  /// @brief Moves of bite may be dropped, the next one supersedes them.
+  bool isCoalescable(const PrizeProcessorMessage& message) const override final;
   /** @} */  // end of ActiveObject group
 
   /** @defgroup Processors Actions being performed by PrizeProcessor when
@@ -151,17 +159,17 @@ private:
    *  @{
    */
   /// @brief Processing when aspect ratio has been measured.
-  void process_aspectMeasured();
+  void process_aspectMeasured(GLfloat aspect);
   /// @brief Set's the bite's measured dimensions.
-  void process_initBite();
+  void process_initBite(const Bite& bite);
   /// @brief Processing when bite's location has changed.
-  void process_biteMoved();
+  void process_biteMoved(const Bite& moved_bite);
   /// @brief Processing prize generation.
-  void process_prizeReceived();
+  void process_prizeReceived(const PrizePackage& package);
   /// @brief Processing prize relocation.
-  void process_prizeLocated();
+  void process_prizeLocated(const PrizePackage& package);
   /// @brief Processing prize has gone.
-  void process_prizeHasGone();
+  void process_prizeHasGone(int prize_id);
   /** @} */  // end of Processors group
 
   /** @defgroup LogicFunc Game logic related member functions.
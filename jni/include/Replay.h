@@ -0,0 +1,127 @@
+#ifndef __ARKANOID_REPLAY__H__
+#define __ARKANOID_REPLAY__H__
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "GameProcessor.h"
+#include "Level.h"
+
+namespace game {
+
+/**
+ * Replay file: header followed by records, integers are little endian,
+ * varints are LEB128, floats are IEEE 754 bits.
+ *
+ * header:  "ARKR", version (u8), seeds: processor, blocks, prizes, shared (u32 each)
+ * record:  ticks since previous record (varint), kind (u8), payload by kind:
+ *
+ *   ASPECT_MEASURED, THROW_BALL   value (f32)
+ *   LOAD_LEVEL                    rows (varint), each row: length (varint), chars
+ *   INIT_BALL                     width, height, x, y, angle (f32), effect (u8)
+ *   INIT_BITE, BITE_MOVED         width, height, x (f32)
+ *   LEVEL_DIMENS                  rows, cols (varint), width, height, block width, block height (f32)
+ *   PRIZE_CAUGHT                  prize (varint)
+ *   LASER_BEAM                    x, y (f32)
+ *   TICK_RATE                     ticks per second (varint)
+ *   BONUS_BLOCKS                  flag (u8)
+ *   END (0xFF)                    state hash (u64), last record of complete file
+ */
+
+/// @brief Seeds of every random sequence game logic draws from.
+struct ReplaySeeds {
+  uint32_t processor;  //!< GameProcessor::setSeed().
+  uint32_t blocks;     //!< Block generator of level, plus index of level.
+  uint32_t prizes;     //!< Prize generator of level, plus index of level.
+  uint32_t shared;     //!< std::srand(), used by util::getRandomElement().
+
+  /// @brief Seeds taken from system clock, unlike each other.
+  static ReplaySeeds fromClock();
+  /// @brief Restarts generators of level loaded as given one in a row.
+  void seedLevel(Level& level, int index) const;
+};
+
+/// @class InputRecorder Replay.h "include/Replay.h"
+/// @brief Writes inputs processed by GameProcessor to replay file,
+/// stamped with simulation tick they have been processed at.
+/// @details Attached by GameProcessor::setRecorder(), which seeds its
+/// generators and those of levels it loads by seeds of recorder, and
+/// detached by the same call with nullptr, which writes state hash.
+/// Inputs come from user (gamepad shifts, throws, levels loaded) as well
+/// as from renderer and PrizeProcessor (initial ball, caught prizes,
+/// laser beam), whose timing is not reproducible otherwise.
+/// Records go through stdio buffer, only processor thread writes.
+class InputRecorder {
+public:
+  InputRecorder(const char* filepath, const ReplaySeeds& seeds);
+  virtual ~InputRecorder();
+
+  InputRecorder(const InputRecorder&) = delete;
+  InputRecorder& operator = (const InputRecorder&) = delete;
+
+  inline bool isOpen() const { return m_file != nullptr; }
+  inline const ReplaySeeds& getSeeds() const { return m_seeds; }
+  inline long long getRecords() const { return m_records; }
+
+  /// @brief Writes incoming message processed at given tick.
+  void record(long long tick, const GameProcessorMessage& message);
+  /// @brief Writes the end of session and closes the file.
+  void finish(long long tick, uint64_t state_hash);
+
+private:
+  FILE* m_file;
+  ReplaySeeds m_seeds;
+  long long m_last_tick;
+  long long m_records;
+};
+
+/// @brief Message of replay file. Level of LOAD_LEVEL is kept as layout,
+/// as processor changes level it plays.
+struct ReplayRecord {
+  long long tick;
+  GameProcessorMessage message;
+  std::vector<std::string> level;  //!< LOAD_LEVEL
+};
+
+/// @class ReplayLog Replay.h "include/Replay.h"
+/// @brief Contents of replay file, fed back by replay().
+class ReplayLog {
+public:
+  ReplayLog();
+
+  /// @brief Reads whole replay file.
+  /// @return false if file can't be read or is malformed; records up to
+  /// the last intact one are kept then.
+  bool load(const char* filepath);
+
+  inline const ReplaySeeds& getSeeds() const { return m_seeds; }
+  inline const std::vector<ReplayRecord>& getRecords() const { return m_records; }
+  /// @brief Whether file has been finished by InputRecorder::finish().
+  inline bool isComplete() const { return m_complete; }
+  inline long long getEndTick() const { return m_end_tick; }
+  inline uint64_t getStateHash() const { return m_state_hash; }
+
+private:
+  ReplaySeeds m_seeds;
+  std::vector<ReplayRecord> m_records;
+  bool m_complete;
+  long long m_end_tick;
+  uint64_t m_state_hash;
+};
+
+/// @brief Outcome of replay.
+struct ReplayResult {
+  long long ticks;  //!< Ticks simulated.
+  uint64_t state_hash;  //!< GameProcessor::getStateHash() at the end.
+  bool diverged;  //!< Simulation could not reach tick of some record.
+};
+
+/// @brief Feeds recorded messages to newly created processor, which
+/// must not be launched, at their ticks as fast as possible.
+ReplayResult replay(const ReplayLog& log, GameProcessor* processor);
+
+}
+
+#endif  // __ARKANOID_REPLAY__H__
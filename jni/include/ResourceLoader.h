@@ -0,0 +1,101 @@
+#ifndef __ARKANOID_RESOURCE_LOADER__H__
+#define __ARKANOID_RESOURCE_LOADER__H__
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Event.h"
+#include "EventListener.h"
+#include "SoundBuffer.h"
+#include "Texture.h"
+
+namespace native {
+
+/// @brief Progress of resources requested by ResourceLoader::load().
+struct LoadProgress {
+  int loaded;  //!< Resources ready to use.
+  int failed;  //!< Resources which could not be decoded or uploaded.
+  int total;   //!< Resources requested so far.
+
+  LoadProgress(int loaded = 0, int failed = 0, int total = 0)
+    : loaded(loaded), failed(failed), total(total) {
+  }
+
+  inline bool isComplete() const { return loaded + failed == total; }
+};
+
+/// @class ResourceLoader ResourceLoader.h "include/ResourceLoader.h"
+/// @brief Pool of worker threads, which decode textures and sounds in parallel.
+/// @details Workers only decode textures: each decoded texture is passed
+/// through texture_decoded_event to the thread owning GL context, which
+/// must upload it (see Texture::upload()) and report the result back to
+/// callback_textureUploaded(). Sounds are ready once decoded. After every
+/// resource is done, progress_event is fired from the worker or GL thread,
+/// in order of completion; the last one of a batch isComplete().
+class ResourceLoader {
+public:
+  typedef ResourceLoader* Ptr;
+
+  explicit ResourceLoader(int workers = defaultWorkers());
+  virtual ~ResourceLoader();
+
+  ResourceLoader(const ResourceLoader&) = delete;
+  ResourceLoader& operator = (const ResourceLoader&) = delete;
+
+  /// @brief All cores but one, which is left for GL thread, at most 4.
+  /// @details On a single core the only worker is no faster than serial
+  /// loading (see bench_loading), yet it keeps decoding off UI thread.
+  static int defaultWorkers();
+
+  /// @brief Queues resources for decoding, returns immediately.
+  /// Textures go first, as rendering waits for them.
+  void load(const std::vector<Texture*>& textures, const std::vector<SoundBuffer*>& sounds);
+
+  /** @defgroup Callbacks These methods are responses of incoming events
+   *  which ResourceLoader subscribed on.
+   *  @{
+   */
+  /// @brief Called by GL thread when decoded texture has been uploaded.
+  void callback_textureUploaded(bool success);
+  /** @} */  // end of Callbacks group
+
+  /** @defgroup Event Outcoming events and listeners for incoming events.
+   * @{
+   */
+  /// @brief Listens for result of texture upload.
+  EventListener<bool> texture_uploaded_listener;
+
+  /// @brief Notifies texture has been decoded and must be uploaded, fired on worker.
+  Event<Texture*> texture_decoded_event;
+  /// @brief Notifies one more resource is done.
+  Event<LoadProgress> progress_event;
+  /** @} */  // end of Event group
+
+private:
+  /// @brief Either texture or sound to decode.
+  struct Job {
+    Texture* texture;
+    SoundBuffer* sound;
+  };
+
+  /// @brief Worker's loop: takes jobs until destruction.
+  void run();
+  /// @brief Counts finished resource and notifies progress.
+  void finish(bool success);
+
+  std::vector<std::thread> m_workers;
+  std::deque<Job> m_jobs;
+  std::mutex m_jobs_mutex;
+  std::condition_variable m_jobs_condition;
+  bool m_stop;
+
+  std::mutex m_progress_mutex;  //!< Also keeps progress notifications in order.
+  LoadProgress m_progress;
+};
+
+}  // namespace native
+
+#endif  // __ARKANOID_RESOURCE_LOADER__H__
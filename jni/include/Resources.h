@@ -37,6 +37,14 @@ JNIEXPORT jboolean JNICALL Java_com_orcchg_arkanoid_surface_NativeResources_read
 JNIEXPORT jboolean JNICALL Java_com_orcchg_arkanoid_surface_NativeResources_readSound
   (JNIEnv *, jobject, jlong, jstring);
 
+/*
+ * Class:     com_orcchg_arkanoid_surface_NativeResources
+ * Method:    readLevelPack
+ * Signature: (JLjava/lang/String;)Z
+ */
+JNIEXPORT jboolean JNICALL Java_com_orcchg_arkanoid_surface_NativeResources_readLevelPack
+  (JNIEnv *, jobject, jlong, jstring);
+
 /*
  * Class:     com_orcchg_arkanoid_surface_NativeResources
  * Method:    release
@@ -58,9 +66,12 @@ JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_NativeResources_release
 #include <cstdlib>
 
 #include "Level.h"
+#include "LevelPack.h"
+#include "PrefixIndex.h"
 #include "Prize.h"
 #include "SoundBuffer.h"
 #include "Texture.h"
+#include "TextureAtlas.h"
 
 namespace game {
 
@@ -78,9 +89,15 @@ public:
   typedef std::unordered_map<std::string, native::Texture*>::const_iterator const_tex_iterator;
 
   bool readTexture(jstring filename);
-  const native::Texture* const getTexture(const std::string& name) const;
-  const native::Texture* const getRandomTexture(const std::string& prefix) const;
-  const native::Texture* const getPrizeTexture(const Prize& prize) const;
+  /// @brief Region of atlas page (or whole texture) to draw image from,
+  /// missing sprite if texture has not been loaded.
+  /// @see native::TextureAtlas
+  const native::Sprite* const getTexture(const std::string& name) const;
+  /// @brief Random texture whose name starts with given prefix, missing sprite if none.
+  const native::Sprite* const getRandomTexture(const std::string& prefix) const;
+  const native::Sprite* const getPrizeTexture(const Prize& prize) const;
+  /// @brief Atlas where decoded textures are packed, used on GL thread only.
+  native::TextureAtlas* getTextureAtlas();
 
   tex_iterator beginTexture();
   tex_iterator endTexture();
@@ -96,6 +113,7 @@ public:
 
   bool readSound(jstring filename);
   const native::SoundBuffer* const getSound(const std::string& name) const;
+  /// @brief Random sound whose name starts with given prefix, nullptr if none.
   const native::SoundBuffer* const getRandomSound(const std::string& prefix) const;
 
   sound_iterator beginSound();
@@ -104,6 +122,15 @@ public:
   const_sound_iterator cendSound() const;
   /** @} */  // end of Sound group
 
+  /** @defgroup Level Access levels to play.
+   * @{
+   */
+  /// @brief Maps level pack made by tools/levels2pack, kept until release.
+  bool readLevelPack(jstring filename);
+  /// @brief Pack read last, empty if none could be read.
+  const LevelPack& getLevelPack() const;
+  /** @} */  // end of Level group
+
   Ptr getSharedPtr();
 
 private:
@@ -111,6 +138,10 @@ private:
   AssetStorage* m_assets;
   std::unordered_map<std::string, native::Texture*> m_textures;
   std::unordered_map<std::string, native::SoundBuffer*> m_sounds;
+  util::PrefixIndex<native::Texture> m_texture_index;
+  util::PrefixIndex<native::SoundBuffer> m_sound_index;
+  LevelPack m_levels;
+  native::TextureAtlas m_atlas;
 };
 
 }
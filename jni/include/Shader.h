@@ -1,6 +1,7 @@
 #ifndef __ARKANOID_SHADER__H__
 #define __ARKANOID_SHADER__H__
 
+#include <atomic>
 #include <memory>
 
 #include <GLES/gl.h>
@@ -10,6 +11,31 @@ namespace shader {
 
 struct Shader;
 
+/// @brief Attributes used across pre-made shaders.
+enum class Attribute : int {
+  POSITION = 0,        //!< a_position
+  COLOR = 1,           //!< a_color
+  TEX_COORD = 2,       //!< a_texCoord
+  LIFETIME = 3,        //!< a_lifetime
+  START_POSITION = 4,  //!< a_startPosition
+  END_POSITION = 5,    //!< a_endPosition
+  CENTER_POSITION = 6, //!< a_centerPosition
+  START_TIME = 7,      //!< a_startTime
+  COUNT = 8
+};
+
+/// @brief Uniforms used across pre-made shaders.
+enum class Uniform : int {
+  TIME = 0,             //!< u_time
+  CENTER_POSITION = 1,  //!< u_centerPosition
+  COLOR = 2,            //!< u_color
+  VELOCITY = 3,         //!< u_velocity
+  VISIBLE = 4,          //!< u_visible
+  TEXTURE = 5,          //!< s_texture
+  TEX_REGION = 6,       //!< u_texRegion
+  COUNT = 7
+};
+
 /**
  * @class ShaderHelper Shader.h "include/Shader.h"
  * @brief Helper class to load shaders and compile program object.
@@ -24,13 +50,34 @@ public:
   void useProgram() const;
   inline GLuint getProgram() const { return m_program; }
 
+  /// @brief Location of attribute, cached at link time.
+  /// @return -1 if program has no such active attribute.
+  inline GLint attribute(Attribute attribute) const { return m_attributes[static_cast<int>(attribute)]; }
+  /// @brief Location of uniform, cached at link time.
+  /// @return -1 if program has no such active uniform.
+  inline GLint uniform(Uniform uniform) const { return m_uniforms[static_cast<int>(uniform)]; }
+
+  /// @brief Looks up location of attribute by name via GL, slow.
+  GLint getAttribLocation(const char* name) const;
+  /// @brief Looks up location of uniform by name via GL, slow.
+  GLint getUniformLocation(const char* name) const;
+  /// @brief Total number of location lookups by name done via GL so far.
+  static long long getLocationLookups() { return s_location_lookups.load(); }
+
 private:
+  static std::atomic<long long> s_location_lookups;
+
   GLuint m_program;  //!< Linked program.
+  GLint m_attributes[static_cast<int>(Attribute::COUNT)];  //!< Locations of active attributes.
+  GLint m_uniforms[static_cast<int>(Uniform::COUNT)];  //!< Locations of active uniforms.
   GLuint m_vertex_location;  //!< Location of vertex attribute.
   GLuint m_color_location;  //!< Location of color attribute.
   GLuint m_texCoord_location;  //!< LocatbindColorAttribLocationion of texCoord attribute.
 
   GLuint loadShader(GLenum type, const char* shader_src);
+  /// @brief Enumerates active attributes and uniforms of linked program
+  /// and caches locations of known ones.
+  void introspect();
 };
 
 /* Pre-made shaders */
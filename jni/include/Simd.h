@@ -0,0 +1,153 @@
+#ifndef __ARKANOID_SIMD__H__
+#define __ARKANOID_SIMD__H__
+
+#include <cstdint>
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SIMD_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SIMD_SSE2 1
+#endif
+
+namespace util {
+namespace simd {
+
+/** @defgroup Float4 Four float lanes: NEON on device, SSE2 on host,
+ *  plain array elsewhere. Only operations kernels need are provided.
+ * @{
+ */
+#if SIMD_NEON
+typedef float32x4_t float4;
+typedef uint32x4_t uint4;
+
+inline float4 set(float x, float y, float z, float w) { const float v[4] = {x, y, z, w}; return vld1q_f32(v); }
+inline float4 splat(float value) { return vdupq_n_f32(value); }
+inline float4 load(const float* src) { return vld1q_f32(src); }
+inline void store(float* dst, float4 value) { vst1q_f32(dst, value); }
+inline float4 add(float4 a, float4 b) { return vaddq_f32(a, b); }
+inline float4 mul(float4 a, float4 b) { return vmulq_f32(a, b); }
+/// @brief a * b + c, rounded as separate multiply and add.
+inline float4 madd(float4 a, float4 b, float4 c) { return vaddq_f32(vmulq_f32(a, b), c); }
+
+inline uint4 loadu(const uint32_t* src) { return vld1q_u32(src); }
+inline void storeu(uint32_t* dst, uint4 value) { vst1q_u32(dst, value); }
+/// @brief One xorshift32 step (13, 17, 5) in every lane.
+inline uint4 xorshift(uint4 x) {
+  x = veorq_u32(x, vshlq_n_u32(x, 13));
+  x = veorq_u32(x, vshrq_n_u32(x, 17));
+  return veorq_u32(x, vshlq_n_u32(x, 5));
+}
+/// @brief Maps 32 random bits into [0, 1) float.
+inline float4 unitFloat(uint4 x) { return vmulq_n_f32(vcvtq_f32_u32(vshrq_n_u32(x, 8)), 1.0f / 16777216.0f); }
+
+#elif SIMD_SSE2
+typedef __m128 float4;
+typedef __m128i uint4;
+
+inline float4 set(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+inline float4 splat(float value) { return _mm_set1_ps(value); }
+inline float4 load(const float* src) { return _mm_loadu_ps(src); }
+inline void store(float* dst, float4 value) { _mm_storeu_ps(dst, value); }
+inline float4 add(float4 a, float4 b) { return _mm_add_ps(a, b); }
+inline float4 mul(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+inline float4 madd(float4 a, float4 b, float4 c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+
+inline uint4 loadu(const uint32_t* src) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src)); }
+inline void storeu(uint32_t* dst, uint4 value) { _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), value); }
+inline uint4 xorshift(uint4 x) {
+  x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+  x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+  return _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+}
+/// @note 24 bits fit signed conversion, which is the only one in SSE2.
+inline float4 unitFloat(uint4 x) { return _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(x, 8)), _mm_set1_ps(1.0f / 16777216.0f)); }
+
+#else
+struct float4 { float v[4]; };
+struct uint4 { uint32_t v[4]; };
+
+inline float4 set(float x, float y, float z, float w) { return float4{{x, y, z, w}}; }
+inline float4 splat(float value) { return float4{{value, value, value, value}}; }
+inline float4 load(const float* src) { return float4{{src[0], src[1], src[2], src[3]}}; }
+inline void store(float* dst, float4 value) { for (int i = 0; i < 4; ++i) dst[i] = value.v[i]; }
+inline float4 add(float4 a, float4 b) { for (int i = 0; i < 4; ++i) a.v[i] += b.v[i]; return a; }
+inline float4 mul(float4 a, float4 b) { for (int i = 0; i < 4; ++i) a.v[i] *= b.v[i]; return a; }
+inline float4 madd(float4 a, float4 b, float4 c) { return add(mul(a, b), c); }
+
+inline uint4 loadu(const uint32_t* src) { return uint4{{src[0], src[1], src[2], src[3]}}; }
+inline void storeu(uint32_t* dst, uint4 value) { for (int i = 0; i < 4; ++i) dst[i] = value.v[i]; }
+inline uint4 xorshift(uint4 x) {
+  for (int i = 0; i < 4; ++i) {
+    x.v[i] ^= x.v[i] << 13;  x.v[i] ^= x.v[i] >> 17;  x.v[i] ^= x.v[i] << 5;
+  }
+  return x;
+}
+inline float4 unitFloat(uint4 x) {
+  float4 result;
+  for (int i = 0; i < 4; ++i) result.v[i] = static_cast<float>(x.v[i] >> 8) * (1.0f / 16777216.0f);
+  return result;
+}
+#endif
+
+/// @brief Name of instruction set float4 is mapped onto.
+inline const char* instructionSet() {
+#if SIMD_NEON
+  return "neon";
+#elif SIMD_SSE2
+  return "sse2";
+#else
+  return "scalar";
+#endif
+}
+/** @} */  // end of Float4 group
+
+/// @class UniformLanes Simd.h "include/Simd.h"
+/// @brief Uniform random floats in [0, 1) from 8 independent xorshift32
+/// generators, stepped two vectors at once. Sequence is the same for
+/// any instruction set.
+class UniformLanes {
+public:
+  constexpr static int lanes = 8;
+
+  explicit UniformLanes(uint32_t seed = 1) { this->seed(seed); }
+
+  /// @brief Restarts all lanes from states derived from given seed.
+  void seed(uint32_t seed);
+  /// @brief Next 8 random floats, lanes 0..3 and 4..7.
+  inline void next(float4* low, float4* high) {
+    m_low = xorshift(m_low);
+    m_high = xorshift(m_high);
+    *low = unitFloat(m_low);
+    *high = unitFloat(m_high);
+  }
+  /// @brief Fills array with random floats, count must be multiple of 8.
+  void fill(float* output, int count);
+
+private:
+  uint4 m_low;
+  uint4 m_high;
+};
+
+/// @brief Generates interleaved vertices of 12 floats from random lanes:
+/// floats 0..7 are random * scale + bias, floats 8..11 are constant.
+/// @param scale,bias,tail Arrays of 8, 8 and 4 floats.
+void randomAffineVertices(float* vertices, int count, UniformLanes* random,
+                          const float* scale, const float* bias, const float* tail);
+
+/// @brief Writes vertices value(t) = coefficients * t of 4 floats
+/// for t = first, first + 1, ..., applying transform to t first.
+/// @details Used for particle layouts linear in particle's index.
+template <typename Transform>
+void linearVertices(float* vertices, int first, int count, const float* coefficients, Transform transform) {
+  float4 factor = load(coefficients);
+  for (int i = 0; i < count; ++i) {
+    store(vertices + 4 * i, mul(factor, splat(static_cast<float>(transform(first + i)))));
+  }
+}
+
+}  // namespace simd
+}  // namespace util
+
+#endif  // __ARKANOID_SIMD__H__
@@ -1,7 +1,10 @@
 #ifndef __ARKANOID_SOUND_BUFFER__H__
 #define __ARKANOID_SOUND_BUFFER__H__
 
+#include <cstdint>
+
 #include "AssetStorage.h"
+#include "AssetView.h"
 
 namespace native {
 
@@ -13,14 +16,14 @@ public:
 
   const char* getFilename() const;
   const char* getName() const;
-  uint8_t* const getData() const;
+  const uint8_t* getData() const;
   off_t getLength() const;
 
   virtual bool load();
   virtual void unload();
 
 protected:
-  virtual uint8_t* loadSound() = 0;
+  virtual const uint8_t* loadSound() = 0;
 
   enum class ReadMode : int {
     ASSETS = 0, FILESYSTEM = 1
@@ -30,19 +33,21 @@ protected:
   AssetStorage* m_assets;
   char* m_filename;
   off_t m_length;
-  uint8_t* m_data;
+  const uint8_t* m_data;  //!< points into m_view, or owned if view is empty
+  AssetView m_view;
   int m_error_code;
 };
 
 /**
  * Error codes (SoundBuffer)
  *
- * 2021 - assets->open() failed
- * 2022 - data allocation failed from assets
- * 2023 - assets->read() failed
- * 2024 - fopen() failed
- * 2025 - data allocation failed from file
- * 2026 - fread() failed
+ * 2021 - assets->map() failed
+ * 2022 - data allocation failed for copy or conversion of samples
+ * 2023 - no RIFF / WAVE header
+ * 2024 - AssetView::mapFile() failed
+ * 2025 - no "fmt " chunk or it is too short
+ * 2026 - no "data" chunk or it is truncated
+ * 2027 - samples are not 16-bit PCM of 1 or 2 channels
  */
 
 // ----------------------------------------------------------------------------
@@ -53,24 +58,28 @@ public:
   WAVSound(const char* filepath);
   virtual ~WAVSound();
 
-  struct WAVHeader{
-    char                RIFF[4];
-    unsigned long       ChunkSize;
-    char                WAVE[4];
-    char                fmt[4];
-    unsigned long       Subchunk1Size;
-    unsigned short      AudioFormat;
-    unsigned short      NumOfChan;
-    unsigned long       SamplesPerSec;
-    unsigned long       bytesPerSec;
-    unsigned short      blockAlign;
-    unsigned short      bitsPerSample;
-    char                Subchunk2ID[4];
-    unsigned long       Subchunk2Size;
+  /// @brief Content of "fmt " chunk.
+  struct WAVFormat {
+    uint16_t audio_format;  //!< 1 for PCM
+    uint16_t channels;
+    uint32_t sample_rate;
+    uint32_t byte_rate;
+    uint16_t block_align;
+    uint16_t bits_per_sample;
   };
 
+  /// @brief Walks RIFF chunks of WAV file content.
+  /// @param samples Set to the beginning of "data" chunk within content.
+  /// @param length Set to size of "data" chunk in bytes.
+  /// @return 0 on success, otherwise 3, 5 or 6 (see error codes 2023, 2025, 2026).
+  static int parse(const uint8_t* content, size_t size, WAVFormat* format,
+                   const uint8_t** samples, size_t* length);
+
 protected:
-  uint8_t* loadSound() override final;
+  /// @brief Samples of 16-bit PCM are played right from the view of file,
+  /// they are copied only when misaligned for int16_t access. Mono sounds
+  /// and other sample rates are converted into format of Mixer.
+  const uint8_t* loadSound() override final;
 };
 
 }
@@ -0,0 +1,60 @@
+#ifndef __ARKANOID_SWEEP__H__
+#define __ARKANOID_SWEEP__H__
+
+#include <GLES/gl.h>
+
+#include "Level.h"
+#include "LevelDimens.h"
+
+namespace game {
+
+/// @brief First block hit by ball moving along a straight step.
+struct Impact {
+  int row, col;
+  /// @brief DOWN if ball has hit top face of block, UP if bottom face, NONE otherwise.
+  Direction vertical;
+  /// @brief RIGHT if ball has hit left face of block, LEFT if right face, NONE otherwise.
+  Direction horizontal;
+  GLfloat time;  //!< Fraction of the step [0, 1] at the moment of contact.
+  GLfloat x, y;  //!< Ball's center at the moment of contact.
+
+  Impact()
+    : row(-1), col(-1)
+    , vertical(Direction::NONE), horizontal(Direction::NONE)
+    , time(1.0f), x(0.0f), y(0.0f) {
+  }
+
+  /// @brief Ball has hit the corner of block, both faces at once.
+  inline bool isCorner() const { return vertical != Direction::NONE && horizontal != Direction::NONE; }
+};
+
+/// @brief Traverses cells of level's grid swept by ball's bounding box
+/// moving from one position to another, and finds the first non-empty block.
+/// @details Two-axis DDA over block width and height: leading edges of the box
+/// step through grid lines in order of crossing time, so blocks are never
+/// skipped whatever the step's length. Blocks which the box overlaps at the
+/// start of the step are ignored.
+/// @param level Level to collide with.
+/// @param dimens Measured dimensions of level.
+/// @param half_width Half of ball's width.
+/// @param half_height Half of ball's height.
+/// @param from_x Ball's center along X axis at the start of the step.
+/// @param from_y Ball's center along Y axis at the start of the step.
+/// @param to_x Ball's center along X axis at the end of the step.
+/// @param to_y Ball's center along Y axis at the end of the step.
+/// @param impact Output impacted block and surface.
+/// @return TRUE if some block has been hit, FALSE otherwise.
+bool sweepBlocks(
+    const Level& level,
+    const LevelDimens& dimens,
+    GLfloat half_width,
+    GLfloat half_height,
+    GLfloat from_x,
+    GLfloat from_y,
+    GLfloat to_x,
+    GLfloat to_y,
+    Impact* impact);
+
+}
+
+#endif  // __ARKANOID_SWEEP__H__
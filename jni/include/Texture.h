@@ -33,16 +33,31 @@
 #include <GLES/gl.h>
 #include <png.h>
 
+#include <chrono>
+
 #include "AssetStorage.h"
+#include "AssetView.h"
+
+#ifndef GL_ETC1_RGB8_OES
+#define GL_ETC1_RGB8_OES 0x8D64
+#endif
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#endif
+#ifndef GL_COMPRESSED_RGBA8_ETC2_EAC
+#define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#endif
 
 namespace native {
 
 enum class ImageCode : int {
-  none = 1000, png  = 1020
+  none = 1000, png  = 1020, ktx = 1030
 };
 
-static const char* toString(ImageCode code) {
+inline const char* toString(ImageCode code) {
   switch (code) {
+    case ImageCode::ktx:
+      return "ktx";
     default:
     case ImageCode::png:
       return "png";
@@ -62,13 +77,37 @@ public:
   const char* getFilename() const;
   const char* getName() const;
   int getErrorCode() const;
-
+  /// @brief Time spent in decode(), including fallback decoding, microseconds.
+  long long getDecodeMicros() const;
+  /// @brief Time spent in upload(), microseconds.
+  long long getUploadMicros() const;
+  /// @brief Bytes of image in GL texture, as uploaded.
+  size_t getVideoMemory() const;
+
+  /// @brief Decodes and uploads texture, GL context must be current.
   virtual bool load();
   virtual void unload();
   virtual void apply() const;
 
+  /// @brief Decodes image into memory, may be called from any thread.
+  bool decode();
+  /// @brief Uploads decoded image into GL texture and frees the memory,
+  /// GL context must be current.
+  virtual bool upload();
+  /// @brief Decoded image, rows bottom up, nullptr if not decoded.
+  const uint8_t* getPixels() const;
+  /// @brief Frees decoded image without uploading it.
+  void discard();
+
 protected:
+  typedef std::chrono::steady_clock Clock;
+
   virtual const uint8_t* loadImage() = 0;
+  /// @brief Generates GL texture with sampling parameters and binds it.
+  void generateTexture();
+  /// @brief Frees decoded image, unbinds texture, checks GL error and
+  /// accounts upload started at given time.
+  bool completeUpload(Clock::time_point start, size_t video_memory);
 
   enum class ReadMode : int {
     ASSETS = 0, FILESYSTEM = 1
@@ -77,13 +116,17 @@ protected:
   ReadMode m_read_mode;
   AssetStorage* m_assets;
   char* m_filename;
-  unsigned int m_data_size;
+  const uint8_t* m_pixels;  //!< Decoded image waiting for upload.
+  unsigned int m_data_size;  //!< Bytes of compressed image in m_pixels.
   GLuint m_id;
   GLint m_format;
   GLint m_type;
   uint32_t m_width;
   uint32_t m_height;
   int m_error_code;
+  long long m_decode_micros;
+  long long m_upload_micros;
+  size_t m_video_memory;
 };
 
 // ----------------------------------------------------------------------------
@@ -94,18 +137,72 @@ public:
   virtual ~PNGTexture();
 
 protected:
+  /// @brief Decodes PNG right from the view of asset or file.
+  const uint8_t* loadImage() override;
+
+private:
+  /// @brief Position of libpng within content being decoded.
+  struct ReadCursor {
+    const uint8_t* data;
+    size_t size;
+    size_t offset;
+  };
+
+  static void callback_read_memory(png_structp png, png_bytep data, png_size_t size);
+};
+
+// ----------------------------------------------------------------------------
+/// @brief Texture pre-compressed into ETC1 or ETC2 (see tools/png2ktx),
+/// uploaded by glCompressedTexImage2D() without decoding.
+/// @details Takes single mip level of KTX file, whose rows go bottom up
+/// as PNGTexture's do. Falls back to decoding PNG, which is the name of
+/// texture, if KTX file is missing or broken, or GL does not support its
+/// format or fails to upload it.
+class KTXTexture : public PNGTexture {
+public:
+  KTXTexture(AssetStorage* assets, const char* filename, const char* compressed_filename);
+  KTXTexture(const char* filepath, const char* compressed_filepath);
+  virtual ~KTXTexture();
+
+  const char* getCompressedFilename() const;
+  /// @brief Whether image is (or has been uploaded) compressed, rather than PNG.
+  bool isCompressed() const;
+
+  bool upload() override;
+
+  /// @brief Whether current GL context can take textures in compressed format.
+  static bool isFormatSupported(GLenum format);
+
+protected:
+  /// @brief Copies compressed image out of KTX, decodes PNG if it fails.
   const uint8_t* loadImage() override final;
 
 private:
-  static void callback_read_assets(png_structp png, png_bytep data, png_size_t size);
-  static void callback_read_file(png_structp png, png_bytep data, png_size_t size);
+  char* m_compressed_filename;
+  bool m_compressed;
+
+  /// @brief Replaces compressed image by decoded PNG one.
+  bool fallback();
 };
 
+/**
+ * Error codes (KTX):
+ *
+ * 103001 - assets->map() failed
+ * 103002 - file is shorter than header of KTX file
+ * 103003 - wrong identifier or endianness of KTX file
+ * 103004 - image is not compressed by ETC1 or ETC2 (RGB8, RGBA8 EAC)
+ * 103005 - image is not single 2D texture
+ * 103006 - image size does not match its dimensions
+ * 103007 - compressed image allocation failed
+ * 103010 - AssetView::mapFile() failed
+ */
+
 /**
  * Error codes (PNG):
  *
- * 102001 - assets->open() failed
- * 102002 - assets->read() header failed
+ * 102001 - assets->map() failed
+ * 102002 - asset is shorter than header of PNG file
  * 102003 - png_sig_cmp() failed, wrong header of PNG file
  * 102004 - png_create_read_struct() failed
  * 102005 - png_create_info_struct() failed
@@ -113,8 +210,8 @@ private:
  * 102007 - png_get_rowbytes() failed
  * 102008 - image_buffer allocation failed
  * 102009 - row_ptrs allocation failed
- * 102010 - fopen() failed
- * 102011 - fread() for header of PNG file failed
+ * 102010 - AssetView::mapFile() failed
+ * 102011 - file is shorter than header of PNG file
  */
 
 }  // namespace native
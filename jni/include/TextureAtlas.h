@@ -0,0 +1,90 @@
+#ifndef __ARKANOID_TEXTURE_ATLAS__H__
+#define __ARKANOID_TEXTURE_ATLAS__H__
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Texture.h"
+
+namespace native {
+
+/// @brief Region of texture some image is drawn from.
+struct Sprite {
+  const Texture* texture;  //!< Atlas page or standalone texture, nullptr if missing.
+  int32_t x, y;            //!< Position within texture, pixels.
+  int32_t width, height;   //!< Size of image, pixels.
+  GLfloat uv[4];           //!< Texture coordinates of region: u0, v0, u1, v1.
+  /// @brief Texture coordinates of rectangle strip, in order of vertices
+  /// made by util::setRectangleVertices().
+  GLfloat tex_coords[8];
+
+  Sprite();
+  /// @brief Region of texture, texture coordinates are zero until setRegion().
+  Sprite(const Texture* texture, int32_t x, int32_t y, int32_t width, int32_t height);
+
+  /// @brief Binds texture of sprite to unit 0, or none if sprite is missing.
+  void apply() const;
+  /// @brief Fills texture coordinates from region, once texture size is known.
+  void setRegion(int32_t texture_width, int32_t texture_height);
+};
+
+/// @class TextureAtlas TextureAtlas.h "include/TextureAtlas.h"
+/// @brief Packs decoded textures into few large pages, so that sprites
+/// of different images are drawn with the same texture bound.
+/// @details Textures are packed as they come by skyline bottom-left
+/// packer into RGBA pages, each image surrounded by its edge pixels
+/// repeated @a padding times. Pages are uploaded all at once, trimmed to
+/// packed area (texture sizes need not be power of two, as Texture
+/// clamps to edge and has no mipmaps). Textures which, padded, don't fit
+/// twice along side of page (e.g. backgrounds) or are not in RGB(A) are
+/// uploaded standalone, their sprite covers whole texture. Adding texture
+/// again after upload moves its sprite to new pages, former ones are
+/// deleted once they have no sprites left.
+/// Sprites are kept by name, pointers to them stay valid.
+/// All methods must be called on thread owning GL context.
+class TextureAtlas {
+public:
+  static const int32_t defaultPageSize = 2048;  //!< Supported by any GLES 2 device in practice.
+  static const int32_t defaultPadding = 1;
+
+  explicit TextureAtlas(int32_t page_size = defaultPageSize, int32_t padding = defaultPadding);
+  virtual ~TextureAtlas();
+
+  TextureAtlas(const TextureAtlas&) = delete;
+  TextureAtlas& operator = (const TextureAtlas&) = delete;
+
+  /// @brief Packs decoded texture and frees its image, or uploads it
+  /// standalone if it doesn't fit. Sprite is keyed by Texture::getName().
+  /// @return false if texture has not been decoded or upload failed.
+  bool add(Texture* texture);
+  /// @brief Uploads pages packed since last call and deletes unused ones.
+  /// @return false if any page failed to upload.
+  bool upload();
+  /// @brief Forgets GL textures of pages without deleting them, when
+  /// they have been released along with GL context.
+  void abandon();
+
+  /// @brief Sprite by name of texture, or missing sprite without texture.
+  const Sprite* getSprite(const std::string& name) const;
+  /// @brief Whether sprite is an actual one and not missing.
+  bool contains(const std::string& name) const;
+
+  size_t getPageCount() const;
+  const Texture* getPage(size_t index) const;
+  /// @brief Pixels of images packed into pages, padding excluded.
+  long long getPackedArea() const;
+
+private:
+  class Page;
+
+  int32_t m_page_size;
+  int32_t m_padding;
+  std::vector<Page*> m_pages;
+  std::unordered_map<std::string, Sprite> m_sprites;
+  Sprite m_missing;
+};
+
+}  // namespace native
+
+#endif  // __ARKANOID_TEXTURE_ATLAS__H__
@@ -0,0 +1,62 @@
+#ifndef __ARKANOID_TRIPLE_BUFFER__H__
+#define __ARKANOID_TRIPLE_BUFFER__H__
+
+#include <atomic>
+
+/// @class TripleBuffer TripleBuffer.h "include/TripleBuffer.h"
+/// @brief Lock-free single-writer / single-reader publication of
+/// the latest value.
+///
+/// Writer fills its private back buffer and swaps it with the shared
+/// middle one; reader swaps its private front buffer with the middle one
+/// only if a newer value has been published. Neither side ever waits for
+/// the other, values published between two reads are skipped.
+template <typename T>
+class TripleBuffer {
+public:
+  TripleBuffer()
+    : m_back(0)
+    , m_middle(1)
+    , m_front(2) {
+  }
+
+  TripleBuffer(const TripleBuffer&) = delete;
+  TripleBuffer& operator = (const TripleBuffer&) = delete;
+
+  /// @brief Publishes value, must be called from writer thread only.
+  void publish(const T& value) {
+    m_buffers[m_back] = value;
+    m_back = m_middle.exchange(m_back | freshBit, std::memory_order_acq_rel) & indexMask;
+  }
+
+  /// @brief Takes the latest published value, must be called
+  /// from reader thread only.
+  /// @return false if nothing has been published since previous read,
+  /// output keeps the previous value then.
+  bool read(T* value) {
+    if (!isFresh()) {
+      return false;
+    }
+    m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & indexMask;
+    *value = m_buffers[m_front];
+    return true;
+  }
+
+  /// @brief Whether a value has been published since previous read.
+  bool isFresh() const {
+    return (m_middle.load(std::memory_order_relaxed) & freshBit) != 0;
+  }
+
+private:
+  constexpr static int indexMask = 0x3;
+  constexpr static int freshBit = 0x4;
+
+  T m_buffers[3];
+  int m_back;  //!< Owned by writer.
+  char m_back_padding[64];  //!< Keeps writer's and reader's data on different cache lines.
+  std::atomic<int> m_middle;  //!< Index of shared buffer and fresh flag.
+  char m_middle_padding[64];
+  int m_front;  //!< Owned by reader.
+};
+
+#endif  // __ARKANOID_TRIPLE_BUFFER__H__
@@ -13,7 +13,9 @@
 #include <stdio.h>
 #include <stdarg.h>
 
+#ifndef ENABLED_LOGGING
 #define ENABLED_LOGGING 1
+#endif
 
 #ifdef ANDROID
   #include <android/log.h>
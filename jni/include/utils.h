@@ -56,6 +56,9 @@ void setOctagonVertices(
     size_t rows);
 
 void rectangleIndices(GLushort* const indices, size_t size);
+/// @brief Fills indices for triangle fans of consecutive octagons,
+/// each of them having center and eight vertices.
+void octagonIndices(GLushort* const indices, size_t size);
 
 void printBuffer2D(const GLfloat* const buffer, size_t size);
 void printBuffer3D(const GLfloat* const buffer, size_t size);
@@ -66,6 +69,11 @@ size_t getRandomElement(const std::vector<T>& array) {
   return std::rand() % array.size();
 }
 
+/// @brief Uniformly distributed random index in [0, size).
+/// @details Generator is local to calling thread: it neither contends
+/// with other threads nor shifts the sequence of std::rand().
+size_t getRandomIndex(size_t size);
+
 }
 
 #endif  // __ARKANOID_UTILS__H__
@@ -0,0 +1,57 @@
+#include <cstdlib>
+#include <new>
+
+#include "AllocationCounter.h"
+
+#if COUNT_ALLOCATIONS
+
+static thread_local long long s_thread_allocations = 0;
+
+void* operator new(size_t size) {
+  ++s_thread_allocations;
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+namespace util {
+
+long long threadAllocations() {
+  return s_thread_allocations;
+}
+
+}
+
+#else
+
+namespace util {
+
+long long threadAllocations() {
+  return 0;
+}
+
+}
+
+#endif  // COUNT_ALLOCATIONS
@@ -31,6 +31,14 @@
 #include "Exceptions.h"
 #include "logger.h"
 
+namespace {
+
+void closeAsset(void* handle, const uint8_t* /* data */, size_t /* size */) {
+  AAsset_close(static_cast<AAsset*>(handle));
+}
+
+}  // namespace
+
 
 AssetStorage::AssetStorage(JNIEnv* jenv, const jobject& assetManager)
   : m_internal_file_storage(new char[256])
@@ -67,6 +75,15 @@ bool AssetStorage::open(const char* asset_filename) {
   return true;
 }
 
+bool AssetStorage::exists(const char* asset_filename) const {
+  AAsset* asset = AAssetManager_open(m_manager, asset_filename, AASSET_MODE_UNKNOWN);
+  if (asset == nullptr) {
+    return false;
+  }
+  AAsset_close(asset);
+  return true;
+}
+
 void AssetStorage::close() {
   if (m_asset != nullptr) {
     AAsset_close(m_asset);
@@ -95,9 +112,25 @@ bool AssetStorage::read(void* buffer, size_t size) {
     return false;
   }
   int32_t read_count = AAsset_read(m_asset, buffer, size);
-  if (read_count != size) {
+  if (read_count < 0 || static_cast<size_t>(read_count) != size) {
     ERR("Error during reading asset from file: %s!", m_asset_filename);
     return false;
   }
   return true;
 }
+
+AssetView AssetStorage::map(const char* asset_filename) const {
+  AAsset* asset = AAssetManager_open(m_manager, asset_filename, AASSET_MODE_BUFFER);
+  if (asset == nullptr) {
+    ERR("Failed to open asset from file: %s!", asset_filename);
+    return AssetView();
+  }
+  off_t length = AAsset_getLength(asset);
+  const void* buffer = AAsset_getBuffer(asset);
+  if (buffer == nullptr || length <= 0) {
+    ERR("Failed to get buffer of asset from file: %s!", asset_filename);
+    AAsset_close(asset);
+    return AssetView();
+  }
+  return AssetView(static_cast<const uint8_t*>(buffer), static_cast<size_t>(length), closeAsset, asset);
+}
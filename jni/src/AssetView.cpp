@@ -0,0 +1,91 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "AssetView.h"
+#include "logger.h"
+
+namespace {
+
+void unmapFile(void* /* handle */, const uint8_t* data, size_t size) {
+  munmap(const_cast<uint8_t*>(data), size);
+}
+
+}  // namespace
+
+AssetView::AssetView()
+  : m_data(nullptr)
+  , m_size(0)
+  , m_releaser(nullptr)
+  , m_handle(nullptr) {
+}
+
+AssetView::AssetView(const uint8_t* data, size_t size, Releaser releaser, void* handle)
+  : m_data(data)
+  , m_size(size)
+  , m_releaser(releaser)
+  , m_handle(handle) {
+}
+
+AssetView::AssetView(AssetView&& other)
+  : m_data(other.m_data)
+  , m_size(other.m_size)
+  , m_releaser(other.m_releaser)
+  , m_handle(other.m_handle) {
+  other.m_data = nullptr;
+  other.m_size = 0;
+  other.m_releaser = nullptr;
+  other.m_handle = nullptr;
+}
+
+AssetView& AssetView::operator = (AssetView&& other) {
+  if (this != &other) {
+    release();
+    m_data = other.m_data;
+    m_size = other.m_size;
+    m_releaser = other.m_releaser;
+    m_handle = other.m_handle;
+    other.m_data = nullptr;
+    other.m_size = 0;
+    other.m_releaser = nullptr;
+    other.m_handle = nullptr;
+  }
+  return *this;
+}
+
+AssetView::~AssetView() {
+  release();
+}
+
+AssetView AssetView::mapFile(const char* filepath) {
+  int descriptor = open(filepath, O_RDONLY);
+  if (descriptor < 0) {
+    ERR("Failed to open file: %s!", filepath);
+    return AssetView();
+  }
+  struct stat info;
+  if (fstat(descriptor, &info) != 0 || info.st_size <= 0) {
+    ERR("Failed to get size of file: %s!", filepath);
+    close(descriptor);
+    return AssetView();
+  }
+  size_t size = static_cast<size_t>(info.st_size);
+  void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+  close(descriptor);  // mapping stays valid
+  if (address == MAP_FAILED) {
+    ERR("Failed to map file: %s!", filepath);
+    return AssetView();
+  }
+  return AssetView(static_cast<const uint8_t*>(address), size, unmapFile, nullptr);
+}
+
+void AssetView::release() {
+  if (m_data != nullptr && m_releaser != nullptr) {
+    m_releaser(m_handle, m_data, m_size);
+  }
+  m_data = nullptr;
+  m_size = 0;
+  m_releaser = nullptr;
+  m_handle = nullptr;
+}
@@ -1,13 +1,16 @@
+#include <algorithm>
 #include <cmath>
 
 #include <GLES2/gl2.h>
 
+#include "AllocationCounter.h"
 #include "AsyncContext.h"
 #include "EGLConfigChooser.h"
 #include "Exceptions.h"
 #include "logger.h"
 #include "Macro.h"
 #include "Params.h"
+#include "Simd.h"
 #include "utils.h"
 
 namespace game {
@@ -28,37 +31,33 @@ AsyncContext::AsyncContext(JavaVM* jvm)
   , m_bite()
   , m_bite_effect(BiteEffect::NONE)
   , m_ball()
-  , m_impact_queue()
+  , m_ball_is_flying(false)
+  , m_ball_count(1)
+  , m_ball_colors_count(1)
   , m_bite_vertex_buffer(new GLfloat[16])
   , m_bite_color_buffer(new GLfloat[16])
-  , m_ball_vertex_buffer(new GLfloat[36])
-  , m_ball_color_buffer(new GLfloat[36])
+  , m_ball_vertex_buffer(new GLfloat[36 * BallParams::maxBalls])
+  , m_ball_color_buffer(new GLfloat[36 * BallParams::maxBalls])
   , m_bg_vertex_buffer(new GLfloat[16]{-1.0f, -1.0f, 0.0f, 1.0f, 1.0f, -1.0f, 0.0f, 1.0f, -1.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, 1.0f})
-  , m_particle_diverge_buffer(nullptr)
-  , m_particle_converge_buffer(nullptr)
   , m_particle_spiral_buffer(nullptr)
   , m_rectangle_index_buffer(new GLushort[6]{0, 3, 2, 0, 1, 3})
-  , m_octagon_index_buffer(new GLushort[24]{0, 1, 2, 0, 2, 3, 0, 3, 4, 0, 4, 5, 0, 5, 6, 0, 6, 7, 0, 7, 8, 0, 8, 1})
-  , m_rectangle_texCoord_buffer(new GLfloat[8]{1.f, 1.f, 0.f, 1.f, 1.f, 0.f, 0.f, 0.f})
+  , m_octagon_index_buffer(new GLushort[24 * BallParams::maxBalls])
   , m_level(nullptr)
   , m_level_vertex_buffer(nullptr)
   , m_level_color_buffer(nullptr)
   , m_level_index_buffer(nullptr)
-  , m_generator(std::chrono::system_clock::now().time_since_epoch().count())
-  , m_particle_distribution(0.0f, 1.0f)
-  , m_last_time(0)
-  , m_particle_time(0.0f)
-  , m_render_explosion(false)
-  , m_explosion_packages()
+  , m_level_vertex_vbo(0)
+  , m_level_color_vbo(0)
+  , m_level_index_ibo(0)
+  , m_particle_vbo(0)
+  , m_frame_clock()
+  , m_particle_pool()
   , m_prize_packages()
-  , m_prize_last_timers()
   , m_prize_timers()
   , m_removed_prizes()
-  , m_prize_catch_last_time(0)
   , m_prize_catch_time(0.0f)
   , m_render_prize_catch(false)
   , m_caught_prizes_x_coords()
-  , m_laser_last_time(0)
   , m_laser_time(0.0f)
   , m_render_laser(false)
   , m_laser_interruption(false)
@@ -69,33 +68,29 @@ AsyncContext::AsyncContext(JavaVM* jvm)
   , m_sample_shader(nullptr)
   , m_prize_shader(nullptr)
   , m_prize_catch_shader(nullptr)
-  , m_laser_shader(nullptr) {
+  , m_laser_shader(nullptr)
+  , m_frame_rate(ProcessorParams::defaultFrameRate)
+  , m_vsync(true)
+  , m_swap_interval(-1)
+  , m_next_frame_time(std::chrono::steady_clock::now())
+  , m_continuous_frames(false) {
 
   DBG("enter AsyncContext ctor");
-  m_surface_received.store(false);
-  m_load_resources_received.store(false);
-  m_shift_gamepad_received.store(false);
-  m_throw_ball_received.store(false);
-  m_load_level_received.store(false);
-  m_move_ball_received.store(false);
-  m_lost_ball_received.store(false);
-  m_stop_ball_received.store(false);
-  m_block_impact_received.store(false);
-  m_level_finished_received.store(false);
-  m_explosion_received.store(false);
-  m_prize_received.store(false);
-  m_prize_caught_received.store(false);
-  m_drop_ball_appearance_received.store(false);
-  m_bite_width_changed_received.store(false);
-  m_laser_beam_visibility_received.store(false);
-  m_laser_block_impact_received.store(false);
   m_window_set = false;
   m_resources = nullptr;
+  m_game_state = nullptr;
+  m_bg_texture = nullptr;
+  m_smoke_texture = nullptr;
+  m_spark_texture = nullptr;
+  m_laser_texture = nullptr;
+  std::fill(m_prize_textures, m_prize_textures + PrizeUtils::totalPrizes + 1, nullptr);
+  std::fill(m_block_textures, m_block_textures + BlockUtils::totalBlocks, nullptr);
+  m_resources_ready = false;
+  m_applied_texture = nullptr;
 
   setBiteBallAppearance(BallEffect::NONE);
+  util::octagonIndices(m_octagon_index_buffer, 24 * BallParams::maxBalls);
 
-  m_particle_diverge_buffer = new GLfloat[particleSize * particleSystemSize];
-  m_particle_converge_buffer = new GLfloat[particleSize * particleSystemSize];
   m_particle_spiral_buffer = new GLfloat[particleSpiralSize * particleSpiralSystemSize];
   DBG("exit AsyncContext ctor");
 }
@@ -111,12 +106,9 @@ AsyncContext::~AsyncContext() {
   delete [] m_ball_vertex_buffer; m_ball_vertex_buffer = nullptr;
   delete [] m_ball_color_buffer; m_ball_color_buffer = nullptr;
   delete [] m_bg_vertex_buffer; m_bg_vertex_buffer = nullptr;
-  delete [] m_particle_diverge_buffer; m_particle_diverge_buffer = nullptr;
-  delete [] m_particle_converge_buffer; m_particle_converge_buffer = nullptr;
   delete [] m_particle_spiral_buffer; m_particle_spiral_buffer = nullptr;
   delete [] m_rectangle_index_buffer; m_rectangle_index_buffer = nullptr;
   delete [] m_octagon_index_buffer; m_octagon_index_buffer = nullptr;
-  delete [] m_rectangle_texCoord_buffer; m_rectangle_texCoord_buffer = nullptr;
 
   m_level = nullptr;
   delete [] m_level_vertex_buffer; m_level_vertex_buffer = nullptr;
@@ -124,163 +116,100 @@ AsyncContext::~AsyncContext() {
   delete [] m_level_index_buffer; m_level_index_buffer = nullptr;
 
   m_resources = nullptr;
+  m_game_state = nullptr;
   DBG("exit AsyncContext ~dtor");
 }
 
 /* Callbacks group */
 // ----------------------------------------------------------------------------
 void AsyncContext::callback_setWindow(ANativeWindow* window) {
-  std::unique_lock<std::mutex> lock(m_surface_mutex);
-  m_surface_received.store(true);
-  m_window = window;
-  interrupt();
+  AsyncContextMessage message(AsyncContextMessage::Kind::SET_WINDOW);
+  message.window = window;
+  post(std::move(message));
 }
 
-void AsyncContext::callback_loadResources(bool /* dummy */) {
-  std::unique_lock<std::mutex> lock(m_load_resources_mutex);
-  m_load_resources_received.store(true);
-  interrupt();
+void AsyncContext::callback_textureDecoded(native::Texture* texture) {
+  AsyncContextMessage message(AsyncContextMessage::Kind::UPLOAD_TEXTURE);
+  message.texture = texture;
+  post(std::move(message));
 }
 
-void AsyncContext::callback_shiftGamepad(float position) {
-  std::unique_lock<std::mutex> lock(m_shift_gamepad_mutex);
-  m_shift_gamepad_received.store(true);
-  m_position = position;
-  interrupt();
+void AsyncContext::callback_resourcesProgress(const native::LoadProgress& progress) {
+  AsyncContextMessage message(AsyncContextMessage::Kind::RESOURCES_PROGRESS);
+  message.progress = progress;
+  post(std::move(message));
 }
 
-void AsyncContext::callback_throwBall(float angle /* dummy */) {
-  std::unique_lock<std::mutex> lock(m_throw_ball_mutex);
-  m_throw_ball_received.store(true);
-  interrupt();
+void AsyncContext::callback_shiftGamepad(float position) {
+  AsyncContextMessage message(AsyncContextMessage::Kind::SHIFT_GAMEPAD);
+  message.position = position;
+  post(std::move(message));
 }
 
-void AsyncContext::callback_loadLevel(Level::Ptr level) {
-  std::unique_lock<std::mutex> lock(m_load_level_mutex);
-  m_load_level_received.store(true);
-  m_level = level;
-  interrupt();
+void AsyncContext::callback_throwBall(float angle /* dummy */) {
+  post(AsyncContextMessage(AsyncContextMessage::Kind::THROW_BALL));
 }
 
-void AsyncContext::callback_moveBall(Ball moved_ball) {
-  std::unique_lock<std::mutex> lock(m_move_ball_mutex);
-  m_move_ball_received.store(true);
-  m_ball = moved_ball;
-  interrupt();
+void AsyncContext::callback_loadLevel(const Level::Ptr& level) {
+  AsyncContextMessage message(AsyncContextMessage::Kind::LOAD_LEVEL);
+  message.level = level;
+  post(std::move(message));
 }
 
 void AsyncContext::callback_lostBall(float is_lost) {
-  std::unique_lock<std::mutex> lock(m_lost_ball_mutex);
-  m_lost_ball_received.store(true);
-  interrupt();
+  post(AsyncContextMessage(AsyncContextMessage::Kind::LOST_BALL));
 }
 
 void AsyncContext::callback_stopBall(bool /* dummy */) {
-  std::unique_lock<std::mutex> lock(m_stop_ball_mutex);
-  m_stop_ball_received.store(true);
-  interrupt();
+  post(AsyncContextMessage(AsyncContextMessage::Kind::STOP_BALL));
 }
 
-void AsyncContext::callback_blockImpact(RowCol block) {
-  std::unique_lock<std::mutex> lock(m_block_impact_mutex);
-  m_block_impact_received.store(true);
-  m_impact_queue.push(block);
-  interrupt();
+void AsyncContext::callback_blockImpact(const RowCol& block) {
+  AsyncContextMessage message(AsyncContextMessage::Kind::BLOCK_IMPACT);
+  message.block = block;
+  post(std::move(message));
 }
 
 void AsyncContext::callback_levelFinished(bool is_finished) {
-  std::unique_lock<std::mutex> lock(m_level_finished_mutex);
-  m_level_finished_received.store(true);
-  interrupt();
+  post(AsyncContextMessage(AsyncContextMessage::Kind::LEVEL_FINISHED));
 }
 
-void AsyncContext::callback_explosion(ExplosionPackage package) {
-  std::unique_lock<std::mutex> lock(m_explosion_mutex);
-  m_explosion_received.store(true);
-  m_explosion_packages.push_back(package);
-  interrupt();
+void AsyncContext::callback_explosion(const ExplosionPackage& package) {
+  AsyncContextMessage message(AsyncContextMessage::Kind::EXPLOSION);
+  message.explosion = package;
+  post(std::move(message));
 }
 
-void AsyncContext::callback_prizeReceived(PrizePackage package) {
-  std::unique_lock<std::mutex> lock(m_prize_mutex);
-  m_prize_received.store(true);
-  m_prize_packages[package.getID()] = package;
-  m_prize_last_timers[package.getID()] = 0;
-  m_prize_timers[package.getID()] = 0.0f;
-  interrupt();
+void AsyncContext::callback_prizeReceived(const PrizePackage& package) {
+  AsyncContextMessage message(AsyncContextMessage::Kind::PRIZE_RECEIVED);
+  message.prize = package;
+  post(std::move(message));
 }
 
-void AsyncContext::callback_prizeCaught(PrizePackage package) {
-  std::unique_lock<std::mutex> lock(m_prize_caught_mutex);
-  m_prize_caught_received.store(true);
-  auto prize_id = package.getID();
-  m_caught_prizes_x_coords.push_back(m_prize_packages.at(prize_id).getX());
-  m_prize_packages.at(prize_id).setCaught(true);
-  addPrizeToRemoved(prize_id);
-
-  switch (package.getPrize()) {
-    case Prize::EASY:  // not timed, but with special appearance
-    case Prize::EASY_T:
-      setBiteBallAppearance(BallEffect::EASY);
-      break;
-    case Prize::EXPLODE:  // not timed, but with special appearance
-    case Prize::JUMP:
-      setBiteBallAppearance(BallEffect::EXPLODE);
-      break;
-    case Prize::GOO:
-      setBiteBallAppearance(BallEffect::GOO);
-      break;
-    case Prize::MIRROR:
-      setBiteBallAppearance(BallEffect::MIRROR);
-      break;
-    case Prize::PIERCE:
-      setBiteBallAppearance(BallEffect::PIERCE);
-      break;
-    case Prize::PROTECT:
-      setBiteBallAppearance(BallEffect::PROTECT);
-      break;
-    case Prize::RANDOM:
-      setBiteBallAppearance(BallEffect::RANDOM);
-      break;
-    case Prize::UPGRADE:  // not timed, but with special appearance
-      setBiteBallAppearance(BallEffect::UPGRADE);
-      break;
-    case Prize::DEGRADE:  // not timed, but with special appearance
-      setBiteBallAppearance(BallEffect::DEGRADE);
-      break;
-    default:
-      break;
-  }
-  interrupt();
+void AsyncContext::callback_prizeCaught(const PrizePackage& package) {
+  AsyncContextMessage message(AsyncContextMessage::Kind::PRIZE_CAUGHT);
+  message.prize = package;
+  post(std::move(message));
 }
 
 void AsyncContext::callback_dropBallAppearance(bool /* dummy */) {
-  std::unique_lock<std::mutex> lock(m_drop_ball_appearance_mutex);
-  m_drop_ball_appearance_received.store(true);
-  interrupt();
+  post(AsyncContextMessage(AsyncContextMessage::Kind::DROP_BALL_APPEARANCE));
 }
 
 void AsyncContext::callback_biteWidthChanged(BiteEffect effect) {
-  std::unique_lock<std::mutex> lock(m_bite_width_changed_mutex);
-  m_bite_width_changed_received.store(true);
-  m_bite_effect = effect;
-  interrupt();
+  AsyncContextMessage message(AsyncContextMessage::Kind::BITE_WIDTH_CHANGED);
+  message.bite_effect = effect;
+  post(std::move(message));
 }
 
 void AsyncContext::callback_laserBeamVisibility(bool is_visible) {
-  std::unique_lock<std::mutex> lock(m_laser_beam_visibility_mutex);
-  m_laser_beam_visibility_received.store(true);
-  m_render_laser = is_visible;
-  if (is_visible) {
-    laser_pulse_event.notifyListeners(true);  // first laser pulse
-  }
-  interrupt();
+  AsyncContextMessage message(AsyncContextMessage::Kind::LASER_BEAM_VISIBILITY);
+  message.flag = is_visible;
+  post(std::move(message));
 }
 
 void AsyncContext::callback_laserBlockImpact(bool /* dummy */) {
-  std::unique_lock<std::mutex> lock(m_laser_block_impact_mutex);
-  m_laser_block_impact_received.store(true);
-  interrupt();
+  post(AsyncContextMessage(AsyncContextMessage::Kind::LASER_BLOCK_IMPACT));
 }
 
 // ----------------------------------------------
@@ -289,10 +218,20 @@ Level::Ptr AsyncContext::getCurrentLevelState() {
   return m_level;
 }
 
+// ----------------------------------------------
+void AsyncContext::setFramePacing(int frame_rate, bool vsync) {
+  m_frame_rate.store(std::max(frame_rate, 1));
+  m_vsync.store(vsync);
+}
+
 void AsyncContext::setResourcesPtr(Resources* resources) {
   m_resources = resources;
 }
 
+void AsyncContext::setGameStatePtr(GameStateBuffer* game_state) {
+  m_game_state = game_state;
+}
+
 /* *** Private methods *** */
 /* JNIEnvironment group */
 // ----------------------------------------------------------------------------
@@ -323,108 +262,109 @@ void AsyncContext::onStop() {
 }
 
 bool AsyncContext::checkForWakeUp() {
-  return m_surface_received.load() ||
-      m_load_resources_received.load() ||
-      m_shift_gamepad_received.load() ||
-      m_throw_ball_received.load() ||
-      m_load_level_received.load() ||
-      m_move_ball_received.load() ||
-      m_lost_ball_received.load() ||
-      m_stop_ball_received.load() ||
-      m_block_impact_received.load() ||
-      m_level_finished_received.load() ||
-      m_explosion_received.load() ||
-      m_prize_received.load() ||
-      m_prize_caught_received.load() ||
-      m_drop_ball_appearance_received.load() ||
-      m_bite_width_changed_received.load() ||
-      m_laser_beam_visibility_received.load() ||
-      m_laser_block_impact_received.load();
+  return (m_window_set && isAnimating()) || QueuedActiveObject<AsyncContextMessage>::checkForWakeUp();
 }
 
 void AsyncContext::eventHandler() {
-  if (m_surface_received.load()) {
-    m_surface_received.store(false);
-    process_setWindow();
-    initGame();
+  if (m_window_set) {
+    waitForFrame();  // events arrived meanwhile are handled at frame boundary
   }
+  bool changed = hasPendingEvents();
+  QueuedActiveObject<AsyncContextMessage>::eventHandler();  // drain incoming events
   if (m_window_set) {
-    if (m_load_resources_received.load()) {
-      m_load_resources_received.store(false);
-      process_loadResources();
-    }
-    if (m_shift_gamepad_received.load()) {
-      m_shift_gamepad_received.store(false);
-      process_shiftGamepad();
-    }
-    if (m_explosion_received.load()) {
-      m_explosion_received.store(false);
-      process_explosion();
-    }
-    if (m_prize_received.load()) {
-      m_prize_received.store(false);
-      process_prizeReceived();
-    }
-    if (m_prize_caught_received.load()) {
-      m_prize_caught_received.store(false);
-      process_prizeCaught();
+    changed = readGameState() || changed;
+  }
+  if (m_window_set && (changed || isAnimating())) {
+    render();  // render frame to reflect changes occurred
+  }
+  m_continuous_frames = m_window_set && isAnimating();
+}
+
+bool AsyncContext::isCoalescable(const AsyncContextMessage& message) const {
+  return message.kind == AsyncContextMessage::Kind::SHIFT_GAMEPAD;
+}
+
+void AsyncContext::dispatch(AsyncContextMessage& message) {
+  if (message.kind == AsyncContextMessage::Kind::SET_WINDOW) {
+    process_setWindow(message.window);
+    initGame();
+    if (m_window_set) {
+      // replay events which have been received before surface was ready
+      std::vector<AsyncContextMessage> deferred_messages;
+      std::swap(deferred_messages, m_deferred_messages);
+      for (auto& item : deferred_messages) {
+        dispatch(item);
+      }
     }
-    if (m_laser_block_impact_received.load()) {
-      m_laser_block_impact_received.store(false);
+    return;
+  }
+  if (!m_window_set) {
+    // window has not been set, postpone any other events
+    m_deferred_messages.push_back(std::move(message));
+    return;
+  }
+
+  switch (message.kind) {
+    case AsyncContextMessage::Kind::UPLOAD_TEXTURE:
+      process_uploadTexture(message.texture);
+      break;
+    case AsyncContextMessage::Kind::RESOURCES_PROGRESS:
+      process_resourcesProgress(message.progress);
+      break;
+    case AsyncContextMessage::Kind::SHIFT_GAMEPAD:
+      process_shiftGamepad(message.position);
+      break;
+    case AsyncContextMessage::Kind::EXPLOSION:
+      process_explosion(message.explosion);
+      break;
+    case AsyncContextMessage::Kind::PRIZE_RECEIVED:
+      process_prizeReceived(message.prize);
+      break;
+    case AsyncContextMessage::Kind::PRIZE_CAUGHT:
+      process_prizeCaught(message.prize);
+      break;
+    case AsyncContextMessage::Kind::LASER_BLOCK_IMPACT:
       process_laserBlockImpact();
-    }
-    if (m_block_impact_received.load()) {
-      m_block_impact_received.store(false);
-      process_blockImpact();
-    }  // block impact must be processed before
-       // new level loaded to avoid crash
-    if (m_load_level_received.load()) {
-      m_load_level_received.store(false);
-      process_loadLevel();
-    }
-    if (m_throw_ball_received.load()) {
-      m_throw_ball_received.store(false);
+      break;
+    case AsyncContextMessage::Kind::BLOCK_IMPACT:
+      process_blockImpact(message.block);
+      break;
+    case AsyncContextMessage::Kind::LOAD_LEVEL:
+      process_loadLevel(message.level);
+      break;
+    case AsyncContextMessage::Kind::THROW_BALL:
       process_throwBall();
-    }
-    if (m_move_ball_received.load()) {
-      m_move_ball_received.store(false);
-      process_moveBall();
-    }
-    if (m_lost_ball_received.load()) {
-      m_lost_ball_received.store(false);
+      break;
+    case AsyncContextMessage::Kind::LOST_BALL:
       process_lostBall();
-    }
-    if (m_stop_ball_received.load()) {
-      m_stop_ball_received.store(false);
+      break;
+    case AsyncContextMessage::Kind::STOP_BALL:
       process_stopBall();
-    }
-    if (m_level_finished_received.load()) {
-      m_level_finished_received.store(false);
+      break;
+    case AsyncContextMessage::Kind::LEVEL_FINISHED:
       process_levelFinished();
-    }
-    if (m_drop_ball_appearance_received.load()) {
-      m_drop_ball_appearance_received.store(false);
+      break;
+    case AsyncContextMessage::Kind::DROP_BALL_APPEARANCE:
       process_dropBallAppearance();
-    }
-    if (m_bite_width_changed_received.load()) {
-      m_bite_width_changed_received.store(false);
-      process_biteWidthChanged();
-    }
-    if (m_laser_beam_visibility_received.load()) {
-      m_laser_beam_visibility_received.store(false);
-      process_laserBeamVisibility();
-    }
-    render();  // render frame to reflect changes occurred
-  } else {
-    // window has not been set, skip any other events
+      break;
+    case AsyncContextMessage::Kind::BITE_WIDTH_CHANGED:
+      process_biteWidthChanged(message.bite_effect);
+      break;
+    case AsyncContextMessage::Kind::LASER_BEAM_VISIBILITY:
+      process_laserBeamVisibility(message.flag);
+      break;
+    case AsyncContextMessage::Kind::SET_WINDOW:
+    case AsyncContextMessage::Kind::NONE:
+    default:
+      break;
   }
 }
 
 /* Processors group */
 // ----------------------------------------------------------------------------
-void AsyncContext::process_setWindow() {
-  std::unique_lock<std::mutex> lock(m_surface_mutex);
+void AsyncContext::process_setWindow(ANativeWindow* window) {
   DBG("enter AsyncContext::process_setWindow()");
+  m_window = window;
   if (m_window == nullptr) {
     m_window_set = false;
     ERR("Failed to set window !");
@@ -437,43 +377,71 @@ void AsyncContext::process_setWindow() {
   glOptionsConfig();
   initParticleSystem();
   m_window_set = true;
+  if (m_level != nullptr) {
+    uploadLevelBuffers();  // level survives, but buffers are new context's
+  }
   DBG("exit AsyncContext::process_setWindow()");
 }
 
-void AsyncContext::process_loadResources() {
-  std::unique_lock<std::mutex> lock(m_load_resources_mutex);
-  if (m_resources != nullptr) {
-    for (auto it = m_resources->beginTexture(); it != m_resources->endTexture(); ++it) {
-      DBG("Loading texture resources: %s %p", it->first.c_str(), it->second);
-      if (!it->second->load()) {
-        // notify Java layer about internal problem
-        m_jenv->CallVoidMethod(master_object, fireJavaEvent_errorTextureLoad_id);
-      }
-    }
-  } else {
+void AsyncContext::process_uploadTexture(native::Texture* texture) {
+  DBG("Uploading texture resource: %s", texture->getFilename());
+  if (m_resources == nullptr) {
     ERR("Resources pointer was not set !");
+    texture_uploaded_event.notifyListeners(texture->upload());
+    return;
+  }
+  texture_uploaded_event.notifyListeners(m_resources->getTextureAtlas()->add(texture));
+}
+
+void AsyncContext::process_resourcesProgress(const native::LoadProgress& progress) {
+  // notify Java layer, it decides what to do with failed resources
+  m_jenv->CallVoidMethod(master_object, fireJavaEvent_resourcesProgress_id, progress.loaded, progress.failed, progress.total);
+  if (!progress.isComplete()) {
+    return;
+  }
+  if (m_resources == nullptr) {
+    ERR("Resources pointer was not set !");
+    return;
+  }
+  if (!m_resources->getTextureAtlas()->upload()) {
+    ERR("Failed to upload texture atlas !");
   }
   m_bg_texture = m_resources->getRandomTexture("bg");
+  m_smoke_texture = m_resources->getTexture("smoke.png");
+  m_spark_texture = m_resources->getTexture("spark.png");
+  m_laser_texture = m_resources->getTexture("ef_laser.png");
+  for (int i = 0; i <= PrizeUtils::totalPrizes; ++i) {
+    m_prize_textures[i] = m_resources->getPrizeTexture(static_cast<Prize>(i));
+  }
+#if USE_TEXTURE
+  for (int i = 0; i < BlockUtils::totalBlocks; ++i) {
+    std::string name = BlockUtils::getBlockTexture(static_cast<Block>(i));
+    const native::Sprite* sprite = name.empty() ? nullptr : m_resources->getTexture(name);
+    // blocks without texture loaded are drawn in color
+    m_block_textures[i] = sprite != nullptr && sprite->texture != nullptr ? sprite : nullptr;
+  }
+#endif
+  m_resources_ready = true;
 }
 
-void AsyncContext::process_shiftGamepad() {
-  std::unique_lock<std::mutex> lock(m_shift_gamepad_mutex);
+void AsyncContext::process_shiftGamepad(GLfloat position) {
+  m_position = position;
   moveBite(m_position);
+  if (!m_ball_is_flying) {  // ball lies on the bite and follows it
+    m_ball.setXPose(m_bite.getXPose());
+    moveBall(m_ball.getPose().getX(), m_ball.getPose().getY());
+  }
 }
 
 void AsyncContext::process_throwBall() {
-  std::unique_lock<std::mutex> lock(m_throw_ball_mutex);
   INF("Ball has been thrown");
-  // no-op
+  m_ball_is_flying = true;
 }
 
-void AsyncContext::process_loadLevel() {
+void AsyncContext::process_loadLevel(Level::Ptr level) {
   std::unique_lock<std::mutex> lock(m_load_level_mutex);
+  m_level = level;
   initGame();
-  {
-    std::queue<RowCol> empty_queue;
-    std::swap(m_impact_queue, empty_queue);
-  }
 
   // release memory allocated for previous level if any
   delete [] m_level_vertex_buffer;
@@ -494,19 +462,15 @@ void AsyncContext::process_loadLevel() {
   m_level->toVertexArray(dimens.getBlockWidth(), dimens.getBlockHeight(), -1.0f, 1.0f, &m_level_vertex_buffer[0]);
   m_level->fillColorArray(&m_level_color_buffer[0]);
   util::rectangleIndices(&m_level_index_buffer[0], m_level->size() * 6);
+  uploadLevelBuffers();
 
   level_dimens_event.notifyListeners(dimens);
 }
 
-void AsyncContext::process_moveBall() {
-  std::unique_lock<std::mutex> lock(m_move_ball_mutex);
-  moveBall(m_ball.getPose().getX(), m_ball.getPose().getY());
-}
-
 void AsyncContext::process_lostBall() {
-  std::unique_lock<std::mutex> lock(m_lost_ball_mutex);
+  m_ball_is_flying = false;
   clearPrizeStructures();
-  if (m_render_explosion) {
+  if (!m_particle_pool.empty()) {
     moveBall(0.0f, 1000.f);
     delay(65);
   }
@@ -514,59 +478,90 @@ void AsyncContext::process_lostBall() {
 }
 
 void AsyncContext::process_stopBall() {
-  std::unique_lock<std::mutex> lock(m_stop_ball_mutex);
+  m_ball_is_flying = false;
   m_render_laser = false;
 }
 
-void AsyncContext::process_blockImpact() {
-  std::unique_lock<std::mutex> lock(m_block_impact_mutex);
-  while (!m_impact_queue.empty()) {
-    auto impact = m_impact_queue.front();
-    if (!checkBlockPresense(impact.row, impact.col)) {
-      WRN("Impacted block is absent in level!");
-      std::queue<RowCol> empty_queue;
-      std::swap(m_impact_queue, empty_queue);
-      return;
-    }
-    m_level->fillColorArrayAtBlock(&m_level_color_buffer[0], impact.row, impact.col);
-    m_impact_queue.pop();
+void AsyncContext::process_blockImpact(const RowCol& impact) {
+  if (!checkBlockPresense(impact.row, impact.col)) {
+    WRN("Impacted block is absent in level!");
+    return;
   }
+  m_level->fillColorArrayAtBlock(&m_level_color_buffer[0], impact.row, impact.col);
+  uploadLevelColorsAtBlock(impact.row, impact.col);
 }
 
 void AsyncContext::process_levelFinished() {
-  std::unique_lock<std::mutex> lock(m_level_finished_mutex);
+  m_ball_is_flying = false;
   clearPrizeStructures();
   m_bg_texture = m_resources->getRandomTexture("bg");
-  if (m_render_explosion) {
+  if (!m_particle_pool.empty()) {
     moveBall(0.0f, 1000.f);
     delay(65);
   }
   initGame();
 }
 
-void AsyncContext::process_explosion() {
-  std::unique_lock<std::mutex> lock(m_explosion_mutex);
-  m_last_time = 0;
-  m_render_explosion = true;
+void AsyncContext::process_explosion(const ExplosionPackage& package) {
+  m_particle_pool.spawn(package);
 }
 
-void AsyncContext::process_prizeReceived() {
-  std::unique_lock<std::mutex> lock(m_prize_mutex);
+void AsyncContext::process_prizeReceived(const PrizePackage& package) {
+  m_prize_packages[package.getID()] = package;
+  m_prize_timers[package.getID()] = 0.0f;
 }
 
-void AsyncContext::process_prizeCaught() {
-  std::unique_lock<std::mutex> lock(m_prize_caught_mutex);
-  m_prize_catch_last_time = 0;
+void AsyncContext::process_prizeCaught(const PrizePackage& package) {
+  auto prize_id = package.getID();
+  auto it = m_prize_packages.find(prize_id);
+  if (it != m_prize_packages.end()) {
+    m_caught_prizes_x_coords.push_back(it->second.getX());
+    it->second.setCaught(true);
+  }
+  addPrizeToRemoved(prize_id);
+
+  switch (package.getPrize()) {
+    case Prize::EASY:  // not timed, but with special appearance
+    case Prize::EASY_T:
+      setBiteBallAppearance(BallEffect::EASY);
+      break;
+    case Prize::EXPLODE:  // not timed, but with special appearance
+    case Prize::JUMP:
+      setBiteBallAppearance(BallEffect::EXPLODE);
+      break;
+    case Prize::GOO:
+      setBiteBallAppearance(BallEffect::GOO);
+      break;
+    case Prize::MIRROR:
+      setBiteBallAppearance(BallEffect::MIRROR);
+      break;
+    case Prize::PIERCE:
+      setBiteBallAppearance(BallEffect::PIERCE);
+      break;
+    case Prize::PROTECT:
+      setBiteBallAppearance(BallEffect::PROTECT);
+      break;
+    case Prize::RANDOM:
+      setBiteBallAppearance(BallEffect::RANDOM);
+      break;
+    case Prize::UPGRADE:  // not timed, but with special appearance
+      setBiteBallAppearance(BallEffect::UPGRADE);
+      break;
+    case Prize::DEGRADE:  // not timed, but with special appearance
+      setBiteBallAppearance(BallEffect::DEGRADE);
+      break;
+    default:
+      break;
+  }
   m_render_prize_catch = true;
 }
 
 void AsyncContext::process_dropBallAppearance() {
-  std::unique_lock<std::mutex> lock(m_drop_ball_appearance_mutex);
   setBiteBallAppearance(BallEffect::NONE);
 }
 
-void AsyncContext::process_biteWidthChanged() {
-  std::unique_lock<std::mutex> lock(m_bite_width_changed_mutex);
+void AsyncContext::process_biteWidthChanged(BiteEffect effect) {
+  m_bite_effect = effect;
   switch (m_bite_effect) {
     default:
     case BiteEffect::NONE:
@@ -586,13 +581,14 @@ void AsyncContext::process_biteWidthChanged() {
   moveBite(m_bite.getXPose());  // update bite appearance via moveBite() function
 }
 
-void AsyncContext::process_laserBeamVisibility() {
-  std::unique_lock<std::mutex> lock(m_laser_beam_visibility_mutex);
-  // no-op
+void AsyncContext::process_laserBeamVisibility(bool is_visible) {
+  m_render_laser = is_visible;
+  if (is_visible) {
+    laser_pulse_event.notifyListeners(true);  // first laser pulse
+  }
 }
 
 void AsyncContext::process_laserBlockImpact() {
-  std::unique_lock<std::mutex> lock(m_laser_block_impact_mutex);
   m_laser_interruption = true;
 }
 
@@ -600,6 +596,7 @@ void AsyncContext::process_laserBlockImpact() {
 // ----------------------------------------------------------------------------
 void AsyncContext::initGame() {
   aspect_ratio_event.notifyListeners(m_aspect);
+  m_ball_is_flying = false;
 
   // ensure correct initial location
   m_bite = Bite(BiteParams::biteWidth, BiteParams::biteHeight * m_aspect);
@@ -639,14 +636,35 @@ void AsyncContext::moveBite(float position) {
 }
 
 void AsyncContext::moveBall(float x_position, float y_position) {
+  m_ball_count = 1;
+  placeBall(0, x_position, y_position);
+}
+
+void AsyncContext::placeBall(int index, float x_position, float y_position) {
   util::setOctagonVertices(
-      &m_ball_vertex_buffer[0],
+      &m_ball_vertex_buffer[36 * index],
       m_ball.getDimens().width(), m_ball.getDimens().height(),
       -m_ball.getDimens().halfWidth() + x_position,
       m_ball.getDimens().halfHeight() + y_position,
       1, 1);
 }
 
+bool AsyncContext::readGameState() {
+  if (m_game_state == nullptr || !m_game_state->read(&m_game_state_snapshot)) {
+    return false;
+  }
+  // once ball has stopped, it's placed by this thread until next throw
+  if (m_ball_is_flying && m_game_state_snapshot.ball_is_flying) {
+    m_ball = m_game_state_snapshot.ball;
+    m_ball_count = m_game_state_snapshot.ball_count;
+    for (int i = 0; i < m_ball_count; ++i) {
+      placeBall(i, m_game_state_snapshot.balls_x[i], m_game_state_snapshot.balls_y[i]);
+    }
+    return true;
+  }
+  return false;
+}
+
 void AsyncContext::addPrizeToRemoved(int prize_id) {
   m_removed_prizes.insert(prize_id);
 }
@@ -654,25 +672,56 @@ void AsyncContext::addPrizeToRemoved(int prize_id) {
 void AsyncContext::clearRemovedPrizes() {
   for (auto& item : m_removed_prizes) {
     m_prize_packages.erase(item);
-    m_prize_last_timers.erase(item);
     m_prize_timers.erase(item);
   }
   m_removed_prizes.clear();
 }
 
 void AsyncContext::clearPrizeStructures() {
-  m_prize_catch_last_time = 0;
   m_prize_packages.clear();
-  m_prize_last_timers.clear();
   m_prize_timers.clear();
   m_removed_prizes.clear();
 }
 
+void AsyncContext::advanceAnimations(float delta) {
+  m_particle_pool.advance(delta);
+
+  for (auto& item : m_prize_timers) {
+    item.second += delta;
+    if (item.second >= 3.0f) {
+      item.second = 0.0f;
+    }
+  }
+
+  if (m_render_prize_catch) {
+    m_prize_catch_time += delta;
+    if (m_prize_catch_time >= 1.0f) {
+      m_prize_catch_time = 0.0f;
+      m_render_prize_catch = false;
+      m_caught_prizes_x_coords.clear();
+    }
+  }
+
+  if (m_render_laser) {
+    m_laser_time += delta;
+    if (m_laser_time >= 0.6f) {
+      m_laser_time = 0.0f;
+      m_laser_interruption = false;
+      laser_pulse_event.notifyListeners(true);
+    }
+  }
+}
+
+bool AsyncContext::isAnimating() const {
+  return m_ball_is_flying || !m_particle_pool.empty() || m_render_prize_catch || m_render_laser || !m_prize_packages.empty();
+}
+
 bool AsyncContext::checkBlockPresense(int row, int col) {
   return (row >= 0 && row < m_level->numRows()) && (col >= 0 && col < m_level->numCols());
 }
 
 void AsyncContext::setBiteBallAppearance(BallEffect effect) {
+  m_ball_colors_count = 1;  // other balls are colored by drawBall()
   switch (effect) {
     default:
     case BallEffect::NONE:
@@ -876,6 +925,7 @@ void AsyncContext::glOptionsConfig() {
 }
 
 void AsyncContext::destroyDisplay() {
+  m_swap_interval = -1;
   if (m_egl_display != EGL_NO_DISPLAY) {
     eglMakeCurrent(m_egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
     if (m_egl_context != EGL_NO_CONTEXT) {
@@ -888,48 +938,56 @@ void AsyncContext::destroyDisplay() {
     }
     eglTerminate (m_egl_display);
     m_egl_display = EGL_NO_DISPLAY;
+    // buffer objects are released along with context
+    m_level_vertex_vbo = 0;
+    m_level_color_vbo = 0;
+    m_level_index_ibo = 0;
+    m_particle_vbo = 0;
+    if (m_resources != nullptr) {
+      m_resources->getTextureAtlas()->abandon();  // so are textures
+    }
   }
 }
 
 void AsyncContext::render() {
-  if (m_egl_display != EGL_NO_DISPLAY) {
+  // sprites are null until textures decoded by workers are all uploaded
+  if (m_egl_display != EGL_NO_DISPLAY && m_resources_ready) {
+    m_frame_stats.beginFrame();
+    m_applied_texture = nullptr;
+    m_frame_clock.tick();
+    m_frame_stats.frameTime(m_frame_clock.getIntervalNanos());
+    advanceAnimations(m_frame_clock.getDelta());
+    long long location_lookups = shader::ShaderHelper::getLocationLookups();
+    long long allocations = util::threadAllocations();
     glClear(GL_COLOR_BUFFER_BIT);
     drawBackground();
 
+#if USE_TEXTURE
+    // absent blocks are fully transparent, so they are skipped and the
+    // others are drawn opaque
+    glDisable(GL_BLEND);
     for (int r = 0; r < m_level->numRows(); ++r) {
       for (int c = 0; c < m_level->numCols(); ++c) {
         auto block = m_level->getBlock(r, c);
-        switch (block) {
-          case Block::NONE:
-            glEnable(GL_BLEND);
-            break;
-          default:
-            glDisable(GL_BLEND);
-            break;
+        if (block == Block::NONE) {
+          continue;
         }
-#if USE_TEXTURE
-        auto texture = BlockUtils::getBlockTexture(block);
-        if (texture.empty()) {
+        const native::Sprite* sprite = m_block_textures[static_cast<int>(block)];
+        if (sprite == nullptr) {
           drawBlock(r, c);
         } else {
-          drawTexturedBlock(r, c, texture);
+          drawTexturedBlock(r, c, sprite);
         }
-#else
-        drawBlock(r, c);
-#endif
       }
     }
+#else
+    drawLevel();
+#endif
     drawBite();
     drawBall();
 
-    if (m_render_explosion) {
-      for (auto& item : m_explosion_packages) {
-        drawExplosion(
-            item.getX(),
-            item.getY(),
-            item.getColor(),
-            item.getKind());
-      }
+    if (!m_particle_pool.empty()) {
+      drawExplosions();
     }
 
     if (m_render_laser) {
@@ -947,166 +1005,155 @@ void AsyncContext::render() {
       }
     }
 
-    eglSwapInterval(m_egl_display, 0);
+    m_frame_stats.locationLookups(shader::ShaderHelper::getLocationLookups() - location_lookups);
+    m_frame_stats.allocations(util::threadAllocations() - allocations);
+    m_frame_stats.endFrame();
+    applySwapInterval();
     eglSwapBuffers(m_egl_display, m_egl_surface);
   }
 }
 
-void AsyncContext::delay(int ms) {
-  for (int i = 0; i < ms; ++i) {
-    render();
-    std::this_thread::sleep_for (std::chrono::milliseconds(ProcessorParams::milliDelay));
+void AsyncContext::uploadLevelBuffers() {
+  if (m_level_vertex_vbo == 0) {
+    GLuint buffers[3];
+    glGenBuffers(3, buffers);
+    m_level_vertex_vbo = buffers[0];
+    m_level_color_vbo = buffers[1];
+    m_level_index_ibo = buffers[2];
   }
+  GLsizeiptr array_size = m_level->size() * 16 * sizeof(GLfloat);
+  glBindBuffer(GL_ARRAY_BUFFER, m_level_vertex_vbo);
+  glBufferData(GL_ARRAY_BUFFER, array_size, &m_level_vertex_buffer[0], GL_STATIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, m_level_color_vbo);
+  glBufferData(GL_ARRAY_BUFFER, array_size, &m_level_color_buffer[0], GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_level_index_ibo);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_level->size() * 6 * sizeof(GLushort), &m_level_index_buffer[0], GL_STATIC_DRAW);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
-void AsyncContext::initParticleSystem() {
-  for (int i = 0; i < particleSystemSize; ++i) {
-    int index = i * particleSize;
-    // Lifetime of particle
-    m_particle_diverge_buffer[index + 0] = m_particle_distribution(m_generator);
-    m_particle_converge_buffer[index + 0] = m_particle_distribution(m_generator);
-    // Start position of particle
-    m_particle_diverge_buffer[index + 3] = m_particle_distribution(m_generator) * 0.25f - 0.125f;
-    m_particle_diverge_buffer[index + 4] = (m_particle_distribution(m_generator) * 0.25f - 0.125f) * m_aspect;
-    m_particle_converge_buffer[index + 3] = m_particle_distribution(m_generator) * 0.2f - 0.1f;
-    m_particle_converge_buffer[index + 4] = (m_particle_distribution(m_generator) * 0.1f - 0.05f) * m_aspect;
-    // End position of particle
-    m_particle_diverge_buffer[index + 1] = m_particle_distribution(m_generator) * 2.0f - 1.0f;
-    m_particle_diverge_buffer[index + 2] = (m_particle_distribution(m_generator) * 2.0f - 1.0f) * m_aspect;
-    m_particle_converge_buffer[index + 1] = m_particle_distribution(m_generator) * 0.1f;
-    m_particle_converge_buffer[index + 2] = m_particle_distribution(m_generator) * 0.05f * m_aspect;
+void AsyncContext::uploadLevelColorsAtBlock(int row, int col) {
+  if (m_level_color_vbo == 0) {
+    return;
   }
+  int rci = col * 16 + row * m_level->numCols() * 16;
+  glBindBuffer(GL_ARRAY_BUFFER, m_level_color_vbo);
+  glBufferSubData(GL_ARRAY_BUFFER, rci * sizeof(GLfloat), 16 * sizeof(GLfloat), &m_level_color_buffer[rci]);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void AsyncContext::waitForFrame() {
+  auto period = std::chrono::steady_clock::duration(std::chrono::seconds(1)) / std::max(m_frame_rate.load(), 1);
+  auto now = std::chrono::steady_clock::now();
+  if (now < m_next_frame_time) {
+    sleepUntil(m_next_frame_time);
+    now = m_next_frame_time;
+  } else if (m_continuous_frames) {
+    // animation was running, so every whole period of lateness is a lost frame
+    m_frame_stats.droppedFrames(static_cast<int>((now - m_next_frame_time) / period));
+  }
+  m_next_frame_time += period;
+  if (m_next_frame_time <= now) {
+    m_next_frame_time = now + period;  // resync after idle or stall
+  }
+}
 
-  // --------------------------------------------
-  GLfloat step = 0.001f;
-  GLfloat halfStep = 0.5f * step;
-  // branch 0
-  {
-    int bi = 0 * particleSpiralSize * particleSpiralSystemBranchSize;
-    int i = 0;
-    for (; i < particleSpiralSystemBranchSize >> 1; ++i) {
-      int index = i * particleSpiralSize;
-      // Start position of particle
-      m_particle_spiral_buffer[index + 2 + bi] = -halfStep * i;
-      m_particle_spiral_buffer[index + 3 + bi] = step * i;
-      // End position of particle
-      m_particle_spiral_buffer[index + 0 + bi] = step * i;
-      m_particle_spiral_buffer[index + 1 + bi] = halfStep * i;
-    }
-    GLfloat offset = 0;//-halfStep * (i - 1);
-    for (; i < particleSpiralSystemBranchSize; ++i) {
-      int index = i * particleSpiralSize;
-      int j = i - particleSpiralSystemBranchSize >> 1;
-      // Start position of particle
-      m_particle_spiral_buffer[index + 2 + bi] = offset + halfStep * j;
-      m_particle_spiral_buffer[index + 3 + bi] = step * j;
-      // End position of particle
-      m_particle_spiral_buffer[index + 0 + bi] = step * j;
-      m_particle_spiral_buffer[index + 1 + bi] = -halfStep * j;
-    }
+void AsyncContext::applySwapInterval() {
+  int interval = m_vsync.load() ? 1 : 0;
+  if (interval != m_swap_interval) {
+    eglSwapInterval(m_egl_display, interval);
+    m_swap_interval = interval;
   }
-  // branch 1
-  {
-    int bi = 1 * particleSpiralSize * particleSpiralSystemBranchSize;
-    int i = 0;
-    for (; i < particleSpiralSystemBranchSize >> 1; ++i) {
-      int index = i * particleSpiralSize;
-      // Start position of particle
-      m_particle_spiral_buffer[index + 2 + bi] = step * i;
-      m_particle_spiral_buffer[index + 3 + bi] = halfStep * i;
-      // End position of particle
-      m_particle_spiral_buffer[index + 0 + bi] = halfStep * i;
-      m_particle_spiral_buffer[index + 1 + bi] = -step * i;
-    }
-    GLfloat offset = 0;//halfStep * (i - 1);
-    for (; i < particleSpiralSystemBranchSize; ++i) {
-      int index = i * particleSpiralSize;
-      int j = i - particleSpiralSystemBranchSize >> 1;
-      // Start position of particle
-      m_particle_spiral_buffer[index + 2 + bi] = step * j;
-      m_particle_spiral_buffer[index + 3 + bi] = offset - halfStep * j;
-      // End position of particle
-      m_particle_spiral_buffer[index + 0 + bi] = -halfStep * j;
-      m_particle_spiral_buffer[index + 1 + bi] = -step * j;
-    }
+}
+
+void AsyncContext::delay(int ms) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+  m_continuous_frames = true;
+  while (m_continue_running && std::chrono::steady_clock::now() < deadline) {
+    waitForFrame();
+    render();
   }
-  // branch 2
-  {
-    int bi = 2 * particleSpiralSize * particleSpiralSystemBranchSize;
-    int i = 0;
-    for (; i < particleSpiralSystemBranchSize >> 1; ++i) {
-      int index = i * particleSpiralSize;
-      // Start position of particle
-      m_particle_spiral_buffer[index + 2 + bi] = halfStep * i;
-      m_particle_spiral_buffer[index + 3 + bi] = -step * i;
-      // End position of particle
-      m_particle_spiral_buffer[index + 0 + bi] = -step * i;
-      m_particle_spiral_buffer[index + 1 + bi] = -halfStep * i;
-    }
-    GLfloat offset = 0;//halfStep * (i - 1);
-    for (; i < particleSpiralSystemBranchSize; ++i) {
-      int index = i * particleSpiralSize;
-      int j = i - particleSpiralSystemBranchSize >> 1;
-      // Start position of particle
-      m_particle_spiral_buffer[index + 2 + bi] = offset - halfStep * j;
-      m_particle_spiral_buffer[index + 3 + bi] = -step * j;
-      // End position of particle
-      m_particle_spiral_buffer[index + 0 + bi] = -step * j;
-      m_particle_spiral_buffer[index + 1 + bi] = halfStep * j;
-    }
+}
+
+void AsyncContext::uploadParticleBuffer() {
+  int offset = 0, count = 0;
+  bool dirty = m_particle_pool.takeDirtyRange(&offset, &count);
+  if (m_particle_vbo == 0) {
+    glGenBuffers(1, &m_particle_vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, m_particle_vbo);
+    glBufferData(GL_ARRAY_BUFFER, ParticlePool::totalParticles * m_particle_pool.getVertexStride(),
+                 m_particle_pool.getVertices(), GL_DYNAMIC_DRAW);
+  } else if (dirty) {
+    glBindBuffer(GL_ARRAY_BUFFER, m_particle_vbo);
+    glBufferSubData(GL_ARRAY_BUFFER, offset * sizeof(GLfloat), count * sizeof(GLfloat),
+                    m_particle_pool.getVertices() + offset);
+  } else {
+    glBindBuffer(GL_ARRAY_BUFFER, m_particle_vbo);
   }
-  // branch 3
-  {
-    int bi = 3 * particleSpiralSize * particleSpiralSystemBranchSize;
-    int i = 0;
-    for (; i < particleSpiralSystemBranchSize >> 1; ++i) {
-      int index = i * particleSpiralSize;
-      // Start position of particle
-      m_particle_spiral_buffer[index + 2 + bi] = -step * i;
-      m_particle_spiral_buffer[index + 3 + bi] = -halfStep * i;
-      // End position of particle
-      m_particle_spiral_buffer[index + 0 + bi] = -halfStep * i;
-      m_particle_spiral_buffer[index + 1 + bi] = step * i;
-    }
-    GLfloat offset = 0;//-halfStep * (i - 1);
-    for (; i < particleSpiralSystemBranchSize; ++i) {
-      int index = i * particleSpiralSize;
-      int j = i - particleSpiralSystemBranchSize >> 1;
-      // Start position of particle
-      m_particle_spiral_buffer[index + 2 + bi] = -step * j;
-      m_particle_spiral_buffer[index + 3 + bi] = offset + halfStep * j;
-      // End position of particle
-      m_particle_spiral_buffer[index + 0 + bi] = halfStep * j;
-      m_particle_spiral_buffer[index + 1 + bi] = step * j;
-    }
+}
+
+void AsyncContext::initParticleSystem() {
+  m_particle_pool.setAspect(m_aspect);
+
+  // spiral: each branch is two segments with particle's end and start
+  // positions linear in it's index, (end x, end y, start x, start y)
+  const GLfloat s = 0.001f;
+  const GLfloat h = 0.5f * s;
+  const GLfloat segments[particeSpiralSystemBranches][2][particleSpiralSize] = {
+    {{ s,  h, -h,  s}, { s, -h,  h,  s}},
+    {{ h, -s,  s,  h}, {-h, -s,  s, -h}},
+    {{-s, -h,  h, -s}, {-s,  h, -h, -s}},
+    {{-h,  s, -s, -h}, { h,  s, -s,  h}}};
+  const int half = particleSpiralSystemBranchSize >> 1;
+  for (int b = 0; b < particeSpiralSystemBranches; ++b) {
+    GLfloat* branch = &m_particle_spiral_buffer[b * particleSpiralSize * particleSpiralSystemBranchSize];
+    util::simd::linearVertices(branch, 0, half, segments[b][0], [](int i) { return i; });
+    util::simd::linearVertices(branch + half * particleSpiralSize, half, particleSpiralSystemBranchSize - half,
+        segments[b][1], [](int i) { return (i - particleSpiralSystemBranchSize) >> 1; });
   }
 }
 
 /* Drawings group */
 // ----------------------------------------------------------------------------
 void AsyncContext::drawLevel() {
+  if (m_level_index_ibo == 0) {
+    return;  // no level has been uploaded yet
+  }
   m_level_shader->useProgram();
 
-  GLint a_position = glGetAttribLocation(m_level_shader->getProgram(), "a_position");
-  GLint a_color = glGetAttribLocation(m_level_shader->getProgram(), "a_color");
+  GLint a_position = m_level_shader->attribute(shader::Attribute::POSITION);
+  GLint a_color = m_level_shader->attribute(shader::Attribute::COLOR);
 
-  glVertexAttribPointer(a_position, 4, GL_FLOAT, GL_FALSE, 0, &m_level_vertex_buffer[0]);
-  glVertexAttribPointer(a_color, 4, GL_FLOAT, GL_FALSE, 0, &m_level_color_buffer[0]);
+  glBindBuffer(GL_ARRAY_BUFFER, m_level_vertex_vbo);
+  glVertexAttribPointer(a_position, 4, GL_FLOAT, GL_FALSE, 0, 0);
+  glBindBuffer(GL_ARRAY_BUFFER, m_level_color_vbo);
+  glVertexAttribPointer(a_color, 4, GL_FLOAT, GL_FALSE, 0, 0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_level_index_ibo);
 
   glEnableVertexAttribArray(a_position);
   glEnableVertexAttribArray(a_color);
 
-  glDrawElements(GL_TRIANGLES, m_level->size() * 6, GL_UNSIGNED_SHORT, &m_level_index_buffer[0]);
+  // absent blocks are fully transparent and the others are opaque, so alpha
+  // blending gives the same picture as toggling GL_BLEND per block did
+  glEnable(GL_BLEND);
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  glDrawElements(GL_TRIANGLES, m_level->size() * 6, GL_UNSIGNED_SHORT, 0);
+  m_frame_stats.drawCall();
 
   glDisableVertexAttribArray(a_position);
   glDisableVertexAttribArray(a_color);
+
+  // other drawings source client-side arrays
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
 void AsyncContext::drawBlock(int row, int col) {
   m_level_shader->useProgram();
 
-  GLint a_position = glGetAttribLocation(m_level_shader->getProgram(), "a_position");
-  GLint a_color = glGetAttribLocation(m_level_shader->getProgram(), "a_color");
+  GLint a_position = m_level_shader->attribute(shader::Attribute::POSITION);
+  GLint a_color = m_level_shader->attribute(shader::Attribute::COLOR);
 
   int rci = col * 16 + row * m_level->numCols() * 16;
   glVertexAttribPointer(a_position, 4, GL_FLOAT, GL_FALSE, 0, &m_level_vertex_buffer[rci]);
@@ -1116,39 +1163,49 @@ void AsyncContext::drawBlock(int row, int col) {
   glEnableVertexAttribArray(a_color);
 
   glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, &m_rectangle_index_buffer[0]);
+  m_frame_stats.drawCall();
 
   glDisableVertexAttribArray(a_position);
   glDisableVertexAttribArray(a_color);
 }
 
-void AsyncContext::drawTexturedBlock(int row, int col, const std::string& texture) {
+void AsyncContext::drawTexturedBlock(int row, int col, const native::Sprite* sprite) {
   m_sample_shader->useProgram();
 
-  GLint a_position = glGetAttribLocation(m_sample_shader->getProgram(), "a_position");
-  GLint a_texCoord = glGetAttribLocation(m_sample_shader->getProgram(), "a_texCoord");
+  GLint a_position = m_sample_shader->attribute(shader::Attribute::POSITION);
+  GLint a_texCoord = m_sample_shader->attribute(shader::Attribute::TEX_COORD);
 
   int rci = col * 16 + row * m_level->numCols() * 16;
   glVertexAttribPointer(a_position, 4, GL_FLOAT, GL_FALSE, 0, &m_level_vertex_buffer[rci]);
-  glVertexAttribPointer(a_texCoord, 2, GL_FLOAT, GL_FALSE, 0, &m_rectangle_texCoord_buffer[0]);
+  glVertexAttribPointer(a_texCoord, 2, GL_FLOAT, GL_FALSE, 0, &sprite->tex_coords[0]);
 
-  m_resources->getTexture(texture)->apply();
-  GLint sampler = glGetUniformLocation(m_sample_shader->getProgram(), "s_texture");
+  applySprite(sprite);
+  GLint sampler = m_sample_shader->uniform(shader::Uniform::TEXTURE);
   glUniform1i(sampler, 0);
 
   glEnableVertexAttribArray(a_position);
   glEnableVertexAttribArray(a_texCoord);
 
   glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+  m_frame_stats.drawCall();
 
   glDisableVertexAttribArray(a_position);
   glDisableVertexAttribArray(a_texCoord);
 }
 
+void AsyncContext::applySprite(const native::Sprite* sprite) {
+  if (sprite->texture == nullptr || sprite->texture != m_applied_texture) {
+    sprite->apply();
+    m_frame_stats.textureBind();
+    m_applied_texture = sprite->texture;
+  }
+}
+
 void AsyncContext::drawBite() {
   m_bite_shader->useProgram();
 
-  GLint a_position = glGetAttribLocation(m_bite_shader->getProgram(), "a_position");
-  GLint a_color = glGetAttribLocation(m_bite_shader->getProgram(), "a_color");
+  GLint a_position = m_bite_shader->attribute(shader::Attribute::POSITION);
+  GLint a_color = m_bite_shader->attribute(shader::Attribute::COLOR);
 
   glVertexAttribPointer(a_position, 4, GL_FLOAT, GL_FALSE, 0, &m_bite_vertex_buffer[0]);
   glVertexAttribPointer(a_color, 4, GL_FLOAT, GL_FALSE, 0, &m_bite_color_buffer[0]);
@@ -1158,6 +1215,7 @@ void AsyncContext::drawBite() {
   glDisable(GL_BLEND);
 
   glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, &m_rectangle_index_buffer[0]);
+  m_frame_stats.drawCall();
 
   glDisableVertexAttribArray(a_position);
   glDisableVertexAttribArray(a_color);
@@ -1166,8 +1224,13 @@ void AsyncContext::drawBite() {
 void AsyncContext::drawBall() {
   m_ball_shader->useProgram();
 
-  GLint a_position = glGetAttribLocation(m_ball_shader->getProgram(), "a_position");
-  GLint a_color = glGetAttribLocation(m_ball_shader->getProgram(), "a_color");
+  GLint a_position = m_ball_shader->attribute(shader::Attribute::POSITION);
+  GLint a_color = m_ball_shader->attribute(shader::Attribute::COLOR);
+
+  // all balls look the same, replicate colors of the first one
+  for (; m_ball_colors_count < m_ball_count; ++m_ball_colors_count) {
+    std::copy(&m_ball_color_buffer[0], &m_ball_color_buffer[36], &m_ball_color_buffer[36 * m_ball_colors_count]);
+  }
 
   glVertexAttribPointer(a_position, 4, GL_FLOAT, GL_FALSE, 0, &m_ball_vertex_buffer[0]);
   glVertexAttribPointer(a_color, 4, GL_FLOAT, GL_FALSE, 0, &m_ball_color_buffer[0]);
@@ -1176,101 +1239,76 @@ void AsyncContext::drawBall() {
   glEnableVertexAttribArray(a_color);
   glDisable(GL_BLEND);
 
-  glDrawElements(GL_TRIANGLES, 24, GL_UNSIGNED_SHORT, &m_octagon_index_buffer[0]);
+  glDrawElements(GL_TRIANGLES, 24 * m_ball_count, GL_UNSIGNED_SHORT, &m_octagon_index_buffer[0]);
+  m_frame_stats.drawCall();
 
   glDisableVertexAttribArray(a_position);
   glDisableVertexAttribArray(a_color);
 }
 
-void AsyncContext::drawExplosion(GLfloat x, GLfloat y, const util::BGRA<GLfloat>& bgra, Kind kind) {
+void AsyncContext::drawExplosions() {
   m_explosion_shader->useProgram();
 
-  if (m_last_time == 0) {
-    m_last_time = clock();
-  }
-  {
-    clock_t currentTime = clock();
-    float delta_elapsed = static_cast<float>(currentTime - m_last_time) / CLOCKS_PER_SEC;
-    m_last_time = currentTime;
-    m_particle_time += delta_elapsed;
-    if (m_particle_time >= 1.0f) {
-      m_particle_time = 0.0f;
-      m_render_explosion = false;
-      m_explosion_packages.clear();
-      return;
-    }
-  }
-
-  GLint u_time = glGetUniformLocation(m_explosion_shader->getProgram(), "u_time");
-  GLint u_centerPosition = glGetUniformLocation(m_explosion_shader->getProgram(), "u_centerPosition");
-  GLint u_color = glGetUniformLocation(m_explosion_shader->getProgram(), "u_color");
-
-  GLfloat* coord = new GLfloat[2]{x, y};
-  GLfloat* color = new GLfloat[4]{bgra.b, bgra.g, bgra.r, 0.5f};
-  glUniform2fv(u_centerPosition, 1, &coord[0]);
-  glUniform4fv(u_color, 1, &color[0]);
-  glUniform1f(u_time, m_particle_time);
-
-  GLint a_lifetime = glGetAttribLocation(m_explosion_shader->getProgram(), "a_lifetime");
-  GLint a_startPosition = glGetAttribLocation(m_explosion_shader->getProgram(), "a_startPosition");
-  GLint a_endPosition = glGetAttribLocation(m_explosion_shader->getProgram(), "a_endPosition");
-
-  {
-    GLfloat* lifetime_buffer = nullptr;
-    GLfloat* start_points_buffer = nullptr;
-    GLfloat* end_points_buffer = nullptr;
-
-    switch (kind) {
-      default:
-      case Kind::DIVERGE:
-        lifetime_buffer = &m_particle_diverge_buffer[0];
-        start_points_buffer = &m_particle_diverge_buffer[3];
-        end_points_buffer = &m_particle_diverge_buffer[1];
-        break;
-      case Kind::CONVERGE:
-        lifetime_buffer = &m_particle_converge_buffer[0];
-        start_points_buffer = &m_particle_converge_buffer[3];
-        end_points_buffer = &m_particle_converge_buffer[1];
-        break;
-    }
-    glVertexAttribPointer(a_lifetime, 1, GL_FLOAT, GL_FALSE, particleSize * sizeof(GLfloat), lifetime_buffer);
-    glVertexAttribPointer(a_startPosition, 2, GL_FLOAT, GL_FALSE, particleSize * sizeof(GLfloat), start_points_buffer);
-    glVertexAttribPointer(a_endPosition, 2, GL_FLOAT, GL_FALSE, particleSize * sizeof(GLfloat), end_points_buffer);
-  }
-
-  m_resources->getTexture("smoke.png")->apply();
-  GLint sampler = glGetUniformLocation(m_explosion_shader->getProgram(), "s_texture");
+  GLint u_time = m_explosion_shader->uniform(shader::Uniform::TIME);
+  glUniform1f(u_time, m_particle_pool.getTime());
+
+  GLint a_lifetime = m_explosion_shader->attribute(shader::Attribute::LIFETIME);
+  GLint a_startPosition = m_explosion_shader->attribute(shader::Attribute::START_POSITION);
+  GLint a_endPosition = m_explosion_shader->attribute(shader::Attribute::END_POSITION);
+  GLint a_centerPosition = m_explosion_shader->attribute(shader::Attribute::CENTER_POSITION);
+  GLint a_startTime = m_explosion_shader->attribute(shader::Attribute::START_TIME);
+  GLint a_color = m_explosion_shader->attribute(shader::Attribute::COLOR);
+
+  uploadParticleBuffer();  // leaves particle buffer bound
+  GLsizei stride = m_particle_pool.getVertexStride();
+  auto offset = [](int floats) { return reinterpret_cast<const GLvoid*>(floats * sizeof(GLfloat)); };
+  glVertexAttribPointer(a_lifetime, 1, GL_FLOAT, GL_FALSE, stride, offset(ParticlePool::lifetimeOffset));
+  glVertexAttribPointer(a_startPosition, 2, GL_FLOAT, GL_FALSE, stride, offset(ParticlePool::startPositionOffset));
+  glVertexAttribPointer(a_endPosition, 2, GL_FLOAT, GL_FALSE, stride, offset(ParticlePool::velocityOffset));
+  glVertexAttribPointer(a_centerPosition, 2, GL_FLOAT, GL_FALSE, stride, offset(ParticlePool::centerOffset));
+  glVertexAttribPointer(a_startTime, 1, GL_FLOAT, GL_FALSE, stride, offset(ParticlePool::startTimeOffset));
+  glVertexAttribPointer(a_color, 4, GL_FLOAT, GL_FALSE, stride, offset(ParticlePool::colorOffset));
+
+  applySprite(m_smoke_texture);
+  GLint sampler = m_explosion_shader->uniform(shader::Uniform::TEXTURE);
+  GLint u_texRegion = m_explosion_shader->uniform(shader::Uniform::TEX_REGION);
   glUniform1i(sampler, 0);
+  glUniform4fv(u_texRegion, 1, &m_smoke_texture->uv[0]);
 
   glEnableVertexAttribArray(a_lifetime);
   glEnableVertexAttribArray(a_startPosition);
   glEnableVertexAttribArray(a_endPosition);
+  glEnableVertexAttribArray(a_centerPosition);
+  glEnableVertexAttribArray(a_startTime);
+  glEnableVertexAttribArray(a_color);
 
   glEnable(GL_TEXTURE_2D);
   glEnable(GL_BLEND);
   glBlendFunc(GL_SRC_ALPHA, GL_ONE);
 
-  glDrawArrays(GL_POINTS, 0, particleSystemSize);
-
-  delete [] coord;
-  delete [] color;
+  glDrawArrays(GL_POINTS, 0, m_particle_pool.getDrawCount());
+  m_frame_stats.drawCall();
 
   glDisableVertexAttribArray(a_lifetime);
   glDisableVertexAttribArray(a_startPosition);
   glDisableVertexAttribArray(a_endPosition);
+  glDisableVertexAttribArray(a_centerPosition);
+  glDisableVertexAttribArray(a_startTime);
+  glDisableVertexAttribArray(a_color);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 void AsyncContext::drawBackground() {
   m_sample_shader->useProgram();
 
-  GLint a_position = glGetAttribLocation(m_sample_shader->getProgram(), "a_position");
-  GLint a_texCoord = glGetAttribLocation(m_sample_shader->getProgram(), "a_texCoord");
+  GLint a_position = m_sample_shader->attribute(shader::Attribute::POSITION);
+  GLint a_texCoord = m_sample_shader->attribute(shader::Attribute::TEX_COORD);
 
   glVertexAttribPointer(a_position, 4, GL_FLOAT, GL_FALSE, 0, &m_bg_vertex_buffer[0]);
-  glVertexAttribPointer(a_texCoord, 2, GL_FLOAT, GL_FALSE, 0, &m_rectangle_texCoord_buffer[0]);
+  glVertexAttribPointer(a_texCoord, 2, GL_FLOAT, GL_FALSE, 0, &m_bg_texture->tex_coords[0]);
 
-  m_bg_texture->apply();
-  GLint sampler = glGetUniformLocation(m_sample_shader->getProgram(), "s_texture");
+  applySprite(m_bg_texture);
+  GLint sampler = m_sample_shader->uniform(shader::Uniform::TEXTURE);
   glUniform1i(sampler, 0);
 
   glEnableVertexAttribArray(a_position);
@@ -1281,6 +1319,7 @@ void AsyncContext::drawBackground() {
   glBlendFunc(GL_SRC_ALPHA, GL_ONE);
 
   glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+  m_frame_stats.drawCall();
 
   glDisableVertexAttribArray(a_position);
   glDisableVertexAttribArray(a_texCoord);
@@ -1289,19 +1328,6 @@ void AsyncContext::drawBackground() {
 void AsyncContext::drawPrize(const PrizePackage& prize) {
   m_prize_shader->useProgram();
 
-  if (m_prize_last_timers.at(prize.getID()) == 0) {
-    m_prize_last_timers.at(prize.getID()) = clock();
-  }
-  {
-    clock_t currentTime = clock();
-    float delta_elapsed = static_cast<float>(currentTime - m_prize_last_timers.at(prize.getID())) / CLOCKS_PER_SEC;
-    m_prize_last_timers.at(prize.getID()) = currentTime;
-    m_prize_timers.at(prize.getID()) += delta_elapsed;
-    if (m_prize_timers.at(prize.getID()) >= 3.0f) {
-      m_prize_timers.at(prize.getID()) = 0.0f;
-      return;
-    }
-  }
   int is_visible = 1;  /* true */
   {
     GLfloat Ypath = prize.getY() - m_prize_timers.at(prize.getID()) * PrizeParams::prizeSpeed;
@@ -1317,17 +1343,17 @@ void AsyncContext::drawPrize(const PrizePackage& prize) {
     }
   }
 
-  GLint u_time = glGetUniformLocation(m_prize_shader->getProgram(), "u_time");
-  GLint u_velocity = glGetUniformLocation(m_prize_shader->getProgram(), "u_velocity");
-  GLint u_visible = glGetUniformLocation(m_prize_shader->getProgram(), "u_visible");
+  GLint u_time = m_prize_shader->uniform(shader::Uniform::TIME);
+  GLint u_velocity = m_prize_shader->uniform(shader::Uniform::VELOCITY);
+  GLint u_visible = m_prize_shader->uniform(shader::Uniform::VISIBLE);
   glUniform1f(u_time, m_prize_timers.at(prize.getID()));
   glUniform1f(u_velocity, PrizeParams::prizeSpeed);
   glUniform1i(u_visible, is_visible);
 
-  GLint a_position = glGetAttribLocation(m_prize_shader->getProgram(), "a_position");
-  GLint a_texCoord = glGetAttribLocation(m_prize_shader->getProgram(), "a_texCoord");
+  GLint a_position = m_prize_shader->attribute(shader::Attribute::POSITION);
+  GLint a_texCoord = m_prize_shader->attribute(shader::Attribute::TEX_COORD);
 
-  GLfloat* prize_vertices = new GLfloat[16];
+  GLfloat prize_vertices[16];
   util::setRectangleVertices(
       prize_vertices,
       PrizeParams::prizeWidth,
@@ -1336,11 +1362,12 @@ void AsyncContext::drawPrize(const PrizePackage& prize) {
       prize.getY() - PrizeParams::prizeHalfHeight,
       1, 1);
 
+  const native::Sprite* sprite = m_prize_textures[static_cast<int>(prize.getPrize())];
   glVertexAttribPointer(a_position, 4, GL_FLOAT, GL_FALSE, 0, &prize_vertices[0]);
-  glVertexAttribPointer(a_texCoord, 2, GL_FLOAT, GL_FALSE, 0, &m_rectangle_texCoord_buffer[0]);
+  glVertexAttribPointer(a_texCoord, 2, GL_FLOAT, GL_FALSE, 0, &sprite->tex_coords[0]);
 
-  m_resources->getPrizeTexture(prize.getPrize())->apply();
-  GLint sampler = glGetUniformLocation(m_prize_shader->getProgram(), "s_texture");
+  applySprite(sprite);
+  GLint sampler = m_prize_shader->uniform(shader::Uniform::TEXTURE);
   glUniform1i(sampler, 0);
 
   glEnableVertexAttribArray(a_position);
@@ -1351,8 +1378,7 @@ void AsyncContext::drawPrize(const PrizePackage& prize) {
   glBlendFunc(GL_SRC_ALPHA, GL_ONE);
 
   glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-
-  delete [] prize_vertices;
+  m_frame_stats.drawCall();
 
   glDisableVertexAttribArray(a_position);
   glDisableVertexAttribArray(a_texCoord);
@@ -1361,41 +1387,27 @@ void AsyncContext::drawPrize(const PrizePackage& prize) {
 void AsyncContext::drawPrizeCatch(GLfloat x, GLfloat y, const util::BGRA<GLfloat>& bgra) {
   m_prize_catch_shader->useProgram();
 
-  if (m_prize_catch_last_time == 0) {
-    m_prize_catch_last_time = clock();
-  }
-  {
-    clock_t currentTime = clock();
-    float delta_elapsed = static_cast<float>(currentTime - m_prize_catch_last_time) / CLOCKS_PER_SEC;
-    m_prize_catch_last_time = currentTime;
-    m_prize_catch_time += delta_elapsed;
-    if (m_prize_catch_time >= 1.0f) {
-      m_prize_catch_time = 0.0f;
-      m_render_prize_catch = false;
-      m_caught_prizes_x_coords.clear();
-      return;
-    }
-  }
-
-  GLint u_time = glGetUniformLocation(m_prize_catch_shader->getProgram(), "u_time");
-  GLint u_centerPosition = glGetUniformLocation(m_prize_catch_shader->getProgram(), "u_centerPosition");
-  GLint u_color = glGetUniformLocation(m_prize_catch_shader->getProgram(), "u_color");
+  GLint u_time = m_prize_catch_shader->uniform(shader::Uniform::TIME);
+  GLint u_centerPosition = m_prize_catch_shader->uniform(shader::Uniform::CENTER_POSITION);
+  GLint u_color = m_prize_catch_shader->uniform(shader::Uniform::COLOR);
 
-  GLfloat* coord = new GLfloat[2]{x, y};
-  GLfloat* color = new GLfloat[4]{bgra.b, bgra.g, bgra.r, 0.5f};
+  GLfloat coord[2] = {x, y};
+  GLfloat color[4] = {bgra.b, bgra.g, bgra.r, 0.5f};
   glUniform2fv(u_centerPosition, 1, &coord[0]);
   glUniform4fv(u_color, 1, &color[0]);
   glUniform1f(u_time, m_prize_catch_time);
 
-  GLint a_startPosition = glGetAttribLocation(m_prize_catch_shader->getProgram(), "a_startPosition");
-  GLint a_endPosition = glGetAttribLocation(m_prize_catch_shader->getProgram(), "a_endPosition");
+  GLint a_startPosition = m_prize_catch_shader->attribute(shader::Attribute::START_POSITION);
+  GLint a_endPosition = m_prize_catch_shader->attribute(shader::Attribute::END_POSITION);
 
   glVertexAttribPointer(a_startPosition, 2, GL_FLOAT, GL_FALSE, particleSpiralSize * sizeof(GLfloat), &m_particle_spiral_buffer[2]);
   glVertexAttribPointer(a_endPosition, 2, GL_FLOAT, GL_FALSE, particleSpiralSize * sizeof(GLfloat), &m_particle_spiral_buffer[0]);
 
-  m_resources->getTexture("spark.png")->apply();
-  GLint sampler = glGetUniformLocation(m_prize_catch_shader->getProgram(), "s_texture");
+  applySprite(m_spark_texture);
+  GLint sampler = m_prize_catch_shader->uniform(shader::Uniform::TEXTURE);
+  GLint u_texRegion = m_prize_catch_shader->uniform(shader::Uniform::TEX_REGION);
   glUniform1i(sampler, 0);
+  glUniform4fv(u_texRegion, 1, &m_spark_texture->uv[0]);
 
   glEnableVertexAttribArray(a_startPosition);
   glEnableVertexAttribArray(a_endPosition);
@@ -1405,9 +1417,7 @@ void AsyncContext::drawPrizeCatch(GLfloat x, GLfloat y, const util::BGRA<GLfloat
   glBlendFunc(GL_SRC_ALPHA, GL_ONE);
 
   glDrawArrays(GL_POINTS, 0, particleSpiralSystemSize);
-
-  delete [] coord;
-  delete [] color;
+  m_frame_stats.drawCall();
 
   glDisableVertexAttribArray(a_startPosition);
   glDisableVertexAttribArray(a_endPosition);
@@ -1416,21 +1426,6 @@ void AsyncContext::drawPrizeCatch(GLfloat x, GLfloat y, const util::BGRA<GLfloat
 void AsyncContext::drawLaser(GLfloat x, GLfloat y) {
   m_laser_shader->useProgram();
 
-  if (m_laser_last_time == 0) {
-    m_laser_last_time = clock();
-  }
-  {
-    clock_t currentTime = clock();
-    float delta_elapsed = static_cast<float>(currentTime - m_laser_last_time) / CLOCKS_PER_SEC;
-    m_laser_last_time = currentTime;
-    m_laser_time += delta_elapsed;
-    if (m_laser_time >= 0.6f) {
-      m_laser_time = 0.0f;
-      m_laser_interruption = false;
-      laser_pulse_event.notifyListeners(true);
-      return;
-    }
-  }
   int is_visible = 1;  /* true */
   {
     GLfloat Ypath = y + m_laser_time * LaserParams::laserSpeed;
@@ -1441,17 +1436,17 @@ void AsyncContext::drawLaser(GLfloat x, GLfloat y) {
     }
   }
 
-  GLint u_time = glGetUniformLocation(m_laser_shader->getProgram(), "u_time");
-  GLint u_velocity = glGetUniformLocation(m_laser_shader->getProgram(), "u_velocity");
-  GLint u_visible = glGetUniformLocation(m_laser_shader->getProgram(), "u_visible");
+  GLint u_time = m_laser_shader->uniform(shader::Uniform::TIME);
+  GLint u_velocity = m_laser_shader->uniform(shader::Uniform::VELOCITY);
+  GLint u_visible = m_laser_shader->uniform(shader::Uniform::VISIBLE);
   glUniform1f(u_time, m_laser_time);
   glUniform1f(u_velocity, LaserParams::laserSpeed);
   glUniform1i(u_visible, is_visible);
 
-  GLint a_position = glGetAttribLocation(m_laser_shader->getProgram(), "a_position");
-  GLint a_texCoord = glGetAttribLocation(m_laser_shader->getProgram(), "a_texCoord");
+  GLint a_position = m_laser_shader->attribute(shader::Attribute::POSITION);
+  GLint a_texCoord = m_laser_shader->attribute(shader::Attribute::TEX_COORD);
 
-  GLfloat* laser_vertices = new GLfloat[16];
+  GLfloat laser_vertices[16];
   util::setRectangleVertices(
       laser_vertices,
       LaserParams::laserWidth,
@@ -1461,10 +1456,10 @@ void AsyncContext::drawLaser(GLfloat x, GLfloat y) {
       1, 1);
 
   glVertexAttribPointer(a_position, 4, GL_FLOAT, GL_FALSE, 0, &laser_vertices[0]);
-  glVertexAttribPointer(a_texCoord, 2, GL_FLOAT, GL_FALSE, 0, &m_rectangle_texCoord_buffer[0]);
+  glVertexAttribPointer(a_texCoord, 2, GL_FLOAT, GL_FALSE, 0, &m_laser_texture->tex_coords[0]);
 
-  m_resources->getTexture("ef_laser.png")->apply();
-  GLint sampler = glGetUniformLocation(m_laser_shader->getProgram(), "s_texture");
+  applySprite(m_laser_texture);
+  GLint sampler = m_laser_shader->uniform(shader::Uniform::TEXTURE);
   glUniform1i(sampler, 0);
 
   glEnableVertexAttribArray(a_position);
@@ -1475,8 +1470,7 @@ void AsyncContext::drawLaser(GLfloat x, GLfloat y) {
   glBlendFunc(GL_SRC_ALPHA, GL_ONE);
 
   glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-
-  delete [] laser_vertices;
+  m_frame_stats.drawCall();
 
   glDisableVertexAttribArray(a_position);
   glDisableVertexAttribArray(a_texCoord);
@@ -1,7 +1,10 @@
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "AsyncContextHelper.h"
 #include "Level.h"
+#include "Replay.h"
 #include "Resources.h"
 
 static JavaVM* jvm = nullptr;
@@ -22,11 +25,11 @@ JNIEXPORT jlong JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_init
 
   /* Subscribe on events incoming from outside */
   ptr->acontext->surface_received_listener = ptr->surface_received_event.createListener(&game::AsyncContext::callback_setWindow, ptr->acontext);
-  ptr->acontext->load_resources_listener = ptr->load_resources_event.createListener(&game::AsyncContext::callback_loadResources, ptr->acontext);
+  ptr->acontext->texture_decoded_listener = ptr->resource_loader->texture_decoded_event.createListener(&game::AsyncContext::callback_textureDecoded, ptr->acontext);
+  ptr->acontext->resources_progress_listener = ptr->resource_loader->progress_event.createListener(&game::AsyncContext::callback_resourcesProgress, ptr->acontext);
   ptr->acontext->shift_gesture_listener = ptr->shift_gesture_event.createListener(&game::AsyncContext::callback_shiftGamepad, ptr->acontext);
   ptr->acontext->throw_ball_listener = ptr->throw_ball_event.createListener(&game::AsyncContext::callback_throwBall, ptr->acontext);
   ptr->acontext->load_level_listener = ptr->load_level_event.createListener(&game::AsyncContext::callback_loadLevel, ptr->acontext);
-  ptr->acontext->move_ball_listener = ptr->processor->move_ball_event.createListener(&game::AsyncContext::callback_moveBall, ptr->acontext);
   ptr->acontext->lost_ball_listener = ptr->processor->lost_ball_event.createListener(&game::AsyncContext::callback_lostBall, ptr->acontext);
   ptr->acontext->stop_ball_listener = ptr->processor->stop_ball_event.createListener(&game::AsyncContext::callback_stopBall, ptr->acontext);
   ptr->acontext->block_impact_listener = ptr->processor->block_impact_event.createListener(&game::AsyncContext::callback_blockImpact, ptr->acontext);
@@ -38,6 +41,7 @@ JNIEXPORT jlong JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_init
   ptr->acontext->bite_width_changed_listener = ptr->processor->bite_width_changed_event.createListener(&game::AsyncContext::callback_biteWidthChanged, ptr->acontext);
   ptr->acontext->laser_beam_visibility_listener = ptr->processor->laser_beam_visibility_event.createListener(&game::AsyncContext::callback_laserBeamVisibility, ptr->acontext);
   ptr->acontext->laser_block_impact_listener = ptr->processor->laser_block_impact_event.createListener(&game::AsyncContext::callback_laserBlockImpact, ptr->acontext);
+  ptr->acontext->setGameStatePtr(ptr->processor->getGameState());  // ball's pose is read per frame, not per tick
 
   ptr->processor->aspect_ratio_listener = ptr->acontext->aspect_ratio_event.createListener(&game::GameProcessor::callback_aspectMeasured, ptr->processor);
   ptr->processor->load_level_listener = ptr->load_level_event.createListener(&game::GameProcessor::callback_loadLevel, ptr->processor);
@@ -56,7 +60,7 @@ JNIEXPORT jlong JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_init
   ptr->prize_processor->prize_location_listener = ptr->acontext->prize_location_event.createListener(&game::PrizeProcessor::callback_prizeLocated, ptr->prize_processor);
   ptr->prize_processor->prize_gone_listener = ptr->acontext->prize_gone_event.createListener(&game::PrizeProcessor::callback_prizeHasGone, ptr->prize_processor);
 
-  ptr->sound_processor->load_resources_listener = ptr->load_resources_event.createListener(&native::sound::SoundProcessor::callback_loadResources, ptr->sound_processor);
+  ptr->sound_processor->resources_progress_listener = ptr->resource_loader->progress_event.createListener(&native::sound::SoundProcessor::callback_resourcesProgress, ptr->sound_processor);
   ptr->sound_processor->lost_ball_listener = ptr->processor->lost_ball_event.createListener(&native::sound::SoundProcessor::callback_lostBall, ptr->sound_processor);
   ptr->sound_processor->bite_impact_listener = ptr->processor->bite_impact_event.createListener(&native::sound::SoundProcessor::callback_biteImpact, ptr->sound_processor);
   ptr->sound_processor->block_impact_listener = ptr->processor->block_impact_event.createListener(&native::sound::SoundProcessor::callback_blockImpact, ptr->sound_processor);
@@ -69,6 +73,8 @@ JNIEXPORT jlong JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_init
   ptr->sound_processor->laser_pulse_listener = ptr->acontext->laser_pulse_event.createListener(&native::sound::SoundProcessor::callback_laserPulse, ptr->sound_processor);
   ptr->sound_processor->ball_effect_listener = ptr->processor->ball_effect_event.createListener(&native::sound::SoundProcessor::callback_ballEffect, ptr->sound_processor);
 
+  ptr->resource_loader->texture_uploaded_listener = ptr->acontext->texture_uploaded_event.createListener(&native::ResourceLoader::callback_textureUploaded, ptr->resource_loader);
+
   return descriptor;
 }
 
@@ -117,6 +123,7 @@ JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_setResource
   (JNIEnv *, jobject, jlong descriptor, jlong resources) {
   AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
   game::Resources* res_ptr = (game::Resources*) resources;
+  ptr->resources = res_ptr;
   ptr->acontext->setResourcesPtr(res_ptr);
   ptr->sound_processor->setResourcesPtr(res_ptr);
 }
@@ -124,7 +131,23 @@ JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_setResource
 JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_loadResources
   (JNIEnv *, jobject, jlong descriptor) {
   AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
-  ptr->load_resources_event.notifyListeners(true);
+  if (ptr->resources == nullptr) {
+    ERR("Resources pointer was not set !");
+    return;
+  }
+  // textures belong to GL context, which might be new, while sounds
+  // are kept once loaded, as they may be playing right now
+  std::vector<native::Texture*> textures;
+  std::vector<native::SoundBuffer*> sounds;
+  for (auto it = ptr->resources->beginTexture(); it != ptr->resources->endTexture(); ++it) {
+    textures.push_back(it->second);
+  }
+  for (auto it = ptr->resources->beginSound(); it != ptr->resources->endSound(); ++it) {
+    if (it->second->getData() == nullptr) {
+      sounds.push_back(it->second);
+    }
+  }
+  ptr->resource_loader->load(textures, sounds);
 }
 
 /* User actions */
@@ -162,28 +185,36 @@ JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_loadLevel
   ptr->load_level_event.notifyListeners(level);
 }
 
-JNIEXPORT jobjectArray JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_saveLevel
-  (JNIEnv *jenv, jobject, jlong descriptor) {
+JNIEXPORT jboolean JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_loadPackedLevel
+  (JNIEnv *, jobject, jlong descriptor, jint index) {
   AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
+  if (ptr->resources == nullptr || ptr->resources->getLevelPack().empty()) {
+    return false;  // Java falls back to textual level
+  }
+  auto level = ptr->resources->getLevelPack().load(index);
+  if (level == nullptr) {
+    return false;
+  }
+  ptr->load_level_event.notifyListeners(level);
+  return true;
+}
 
-  game::Level::Ptr level_ptr = ptr->acontext->getCurrentLevelState();
-  int size = level_ptr->numRows();
+JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_loadLevelState
+  (JNIEnv *jenv, jobject, jlong descriptor, jstring state_Java) {
+  AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
 
-  jobjectArray out_level_Java =
-      (jobjectArray) jenv->NewObjectArray(
-          (jsize) size,
-          ptr->String_clazz,
-          jenv->NewStringUTF(""));
+  const char* state = jenv->GetStringUTFChars(state_Java, nullptr);
+  auto level = game::Level::fromString(state, '!');
+  jenv->ReleaseStringUTFChars(state_Java, state);
+  ptr->load_level_event.notifyListeners(level);
+}
 
-  std::vector<std::string> array;
-  array.reserve(level_ptr->numRows());
-  level_ptr->toStringArray(&array);
+JNIEXPORT jstring JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_saveLevel
+  (JNIEnv *jenv, jobject, jlong descriptor) {
+  AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
 
-  for (jsize i = 0; i < size; ++i) {
-    jobject str = jenv->NewStringUTF(array[i].c_str());
-    jenv->SetObjectArrayElement(out_level_Java, i, str);
-  }
-  return out_level_Java;
+  game::Level::Ptr level_ptr = ptr->acontext->getCurrentLevelState();
+  return jenv->NewStringUTF(level_ptr->toString('!').c_str());
 }
 
 JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_setBonusBlocks
@@ -192,6 +223,25 @@ JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_setBonusBlo
   ptr->processor->setBonusBlocks(flag);
 }
 
+JNIEXPORT jboolean JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_startRecording
+  (JNIEnv *jenv, jobject, jlong descriptor, jstring filepath) {
+  AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
+  const char* raw_filepath = jenv->GetStringUTFChars(filepath, nullptr);
+  auto recorder = std::make_shared<game::InputRecorder>(raw_filepath, game::ReplaySeeds::fromClock());
+  jenv->ReleaseStringUTFChars(filepath, raw_filepath);
+  if (!recorder->isOpen()) {
+    return JNI_FALSE;
+  }
+  ptr->processor->setRecorder(recorder);  // closed by processor once replaced
+  return JNI_TRUE;
+}
+
+JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_stopRecording
+  (JNIEnv *jenv, jobject, jlong descriptor) {
+  AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
+  ptr->processor->setRecorder(nullptr);
+}
+
 JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_drop
   (JNIEnv *jenv, jobject, jlong descriptor) {
   AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
@@ -202,21 +252,62 @@ JNIEXPORT jint JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_getScore
   AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
 }
 
+/* Statistics */
+// ----------------------------------------------------------------------------
+JNIEXPORT jfloatArray JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_getFrameTimeStats
+  (JNIEnv *jenv, jobject, jlong descriptor) {
+  AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
+  const game::FrameStats& stats = ptr->acontext->getFrameStats();
+
+  // min, average and 99th percentile of frame time, milliseconds
+  jfloat timings[3] = {
+      static_cast<jfloat>(stats.getMinFrameTimeMicros() / 1000.0),
+      static_cast<jfloat>(stats.getAverageFrameTimeMicros() / 1000.0),
+      static_cast<jfloat>(stats.getPercentileFrameTimeMicros(0.99) / 1000.0)};
+  jfloatArray out_timings_Java = jenv->NewFloatArray(3);
+  jenv->SetFloatArrayRegion(out_timings_Java, 0, 3, timings);
+  return out_timings_Java;
+}
+
+JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_setFixedFrameStep
+  (JNIEnv *jenv, jobject, jlong descriptor, jfloat step) {
+  AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
+  ptr->acontext->setFixedFrameStep(step);
+}
+
+JNIEXPORT jfloat JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_getAchievedFps
+  (JNIEnv *jenv, jobject, jlong descriptor) {
+  AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
+  return ptr->acontext->getFrameStats().getAchievedFps();
+}
+
+JNIEXPORT jlong JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_getDroppedFrames
+  (JNIEnv *jenv, jobject, jlong descriptor) {
+  AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
+  return ptr->acontext->getFrameStats().getDroppedFrames();
+}
+
+JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_AsyncContext_setFramePacing
+  (JNIEnv *jenv, jobject, jlong descriptor, jint frame_rate, jboolean vsync) {
+  AsyncContextHelper* ptr = (AsyncContextHelper*) descriptor;
+  ptr->acontext->setFramePacing(frame_rate, vsync);
+}
+
 /* Core */
 // ----------------------------------------------------------------------------
 AsyncContextHelper::AsyncContextHelper(JNIEnv* jenv, jobject object)
   : jenv(jenv)
-  , window(nullptr) {
+  , window(nullptr)
+  , resources(nullptr) {
 
   DBG("enter AsyncContextHelper ctor");
   acontext = new game::AsyncContext(jvm);
   processor = new game::GameProcessor(jvm);
   prize_processor = new game::PrizeProcessor(jvm);
   sound_processor = new native::sound::SoundProcessor(jvm);
+  resource_loader = new native::ResourceLoader();
 
   global_object = jenv->NewGlobalRef(object);
-  jclass clazz = jenv->FindClass("java/lang/String");
-  String_clazz = (jclass) jenv->NewGlobalRef(clazz);
   jenv->DeleteLocalRef(object);
   jclass class_id = jenv->FindClass("com/orcchg/arkanoid/surface/AsyncContext");
   fireJavaEvent_lostBall_id = jenv->GetMethodID(class_id, "fireJavaEvent_lostBall", "()V");
@@ -225,12 +316,11 @@ AsyncContextHelper::AsyncContextHelper(JNIEnv* jenv, jobject object)
   fireJavaEvent_angleChanged_id = jenv->GetMethodID(class_id, "fireJavaEvent_angleChanged", "(I)V");
   fireJavaEvent_cardinalityChanged_id = jenv->GetMethodID(class_id, "fireJavaEvent_cardinalityChanged", "(I)V");
   fireJavaEvent_prizeCatch_id = jenv->GetMethodID(class_id, "fireJavaEvent_prizeCatch", "(I)V");
-  fireJavaEvent_errorTextureLoad_id = jenv->GetMethodID(class_id, "fireJavaEvent_errorTextureLoad", "()V");
-  fireJavaEvent_errorSoundLoad_id = jenv->GetMethodID(class_id, "fireJavaEvent_errorSoundLoad", "()V");
+  fireJavaEvent_resourcesProgress_id = jenv->GetMethodID(class_id, "fireJavaEvent_resourcesProgress", "(III)V");
   fireJavaEvent_debugMessage_id = jenv->GetMethodID(class_id, "fireJavaEvent_debugMessage", "(Ljava/lang/String;)V");
 
   acontext->setMasterObject(global_object);
-  acontext->setOnErrorTextureLoadMethodID(fireJavaEvent_errorTextureLoad_id);
+  acontext->setOnResourcesProgressMethodID(fireJavaEvent_resourcesProgress_id);
 
   processor->setMasterObject(global_object);
   processor->setOnLostBallMethodID(fireJavaEvent_lostBall_id);
@@ -244,19 +334,17 @@ AsyncContextHelper::AsyncContextHelper(JNIEnv* jenv, jobject object)
   prize_processor->setOnPrizeCatchMethodID(fireJavaEvent_prizeCatch_id);
 
   sound_processor->setMasterObject(global_object);
-  sound_processor->setOnErrorSoundLoadMethodID(fireJavaEvent_errorSoundLoad_id);
   DBG("exit AsyncContextHelper ctor");
 }
 
 AsyncContextHelper::~AsyncContextHelper() {
   DBG("enter AsyncContextHelper ~dtor");
+  delete resource_loader; resource_loader = nullptr;  // no more decoded resources
   delete acontext; acontext = nullptr;
   delete processor; processor = nullptr;
   delete prize_processor; prize_processor = nullptr;
   delete sound_processor; sound_processor = nullptr;
   jenv->DeleteGlobalRef(global_object);
   global_object = nullptr;
-  jenv->DeleteGlobalRef(String_clazz);
-  String_clazz = nullptr;
   DBG("exit AsyncContextHelper ~dtor");
 }
@@ -0,0 +1,125 @@
+#include "AudioSink.h"
+#include "logger.h"
+
+namespace native {
+namespace sound {
+
+/* NullSink */
+// ----------------------------------------------------------------------------
+NullSink::NullSink()
+  : AudioSink()
+  , m_mixer(nullptr)
+  , m_block(Mixer::blockFrames * Mixer::channels) {
+}
+
+NullSink::~NullSink() {
+  m_mixer = nullptr;
+}
+
+bool NullSink::start(Mixer* mixer) {
+  m_mixer = mixer;
+  return true;
+}
+
+void NullSink::stop() {
+  m_mixer = nullptr;
+}
+
+int NullSink::pump(int blocks) {
+  if (m_mixer == nullptr) {
+    return 0;
+  }
+  for (int i = 0; i < blocks; ++i) {
+    m_mixer->render(&m_block[0], Mixer::blockFrames);
+    if (!write(&m_block[0], m_block.size())) {
+      return i;
+    }
+  }
+  return blocks;
+}
+
+bool NullSink::write(const int16_t* /* samples */, int /* count */) {
+  return true;
+}
+
+/* WAVFileSink */
+// ----------------------------------------------------------------------------
+WAVFileSink::WAVFileSink(const char* filepath)
+  : NullSink()
+  , m_filepath(filepath)
+  , m_file(nullptr)
+  , m_data_length(0) {
+}
+
+WAVFileSink::~WAVFileSink() {
+  stop();
+}
+
+bool WAVFileSink::start(Mixer* mixer) {
+  m_file = std::fopen(m_filepath, "wb");
+  if (m_file == nullptr) {
+    m_error_code = 2031;
+    ERR("Error while opening WAV file %s: %i", m_filepath, m_error_code);
+    return false;
+  }
+  m_data_length = 0;
+  if (!writeHeader(m_data_length)) {
+    std::fclose(m_file);
+    m_file = nullptr;
+    return false;
+  }
+  return NullSink::start(mixer);
+}
+
+void WAVFileSink::stop() {
+  NullSink::stop();
+  if (m_file != nullptr) {
+    std::fseek(m_file, 0, SEEK_SET);
+    writeHeader(m_data_length);
+    std::fclose(m_file);
+    m_file = nullptr;
+  }
+}
+
+bool WAVFileSink::write(const int16_t* samples, int count) {
+  if (std::fwrite(samples, sizeof(int16_t), count, m_file) != static_cast<size_t>(count)) {
+    m_error_code = 2032;
+    ERR("Error while writing WAV file %s: %i", m_filepath, m_error_code);
+    return false;
+  }
+  m_data_length += count * sizeof(int16_t);
+  return true;
+}
+
+// ----------------------------------------------
+bool WAVFileSink::writeHeader(uint32_t data_length) {
+  const uint32_t bytes_per_frame = Mixer::channels * sizeof(int16_t);
+  uint8_t header[44];
+  uint8_t* ptr = header;
+  auto put = [&ptr](uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+      *ptr++ = static_cast<uint8_t>(value >> (8 * i));  // little-endian
+    }
+  };
+  auto tag = [&ptr](const char* chars) {
+    for (int i = 0; i < 4; ++i) {
+      *ptr++ = static_cast<uint8_t>(chars[i]);
+    }
+  };
+
+  tag("RIFF");  put(36 + data_length, 4);  tag("WAVE");
+  tag("fmt ");  put(16, 4);  put(1 /* PCM */, 2);  put(Mixer::channels, 2);
+  put(Mixer::sampleRate, 4);  put(Mixer::sampleRate * bytes_per_frame, 4);
+  put(bytes_per_frame, 2);  put(16, 2);
+  tag("data");  put(data_length, 4);
+
+  if (std::fwrite(header, 1, sizeof(header), m_file) != sizeof(header)) {
+    m_error_code = 2032;
+    ERR("Error while writing WAV file %s: %i", m_filepath, m_error_code);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace sound
+}  // namespace native
@@ -0,0 +1,144 @@
+#include "BallPool.h"
+#include "Simd.h"
+
+namespace game {
+
+static const int paddedBalls = (BallParams::maxBalls + 3) / 4 * 4;
+
+BallPool::BallPool()
+  : m_dimens(0.0f, 0.0f)
+  , m_size(0)
+  , m_removed(0)
+  , m_x(paddedBalls, 0.0f)
+  , m_y(paddedBalls, 0.0f)
+  , m_direction_x(paddedBalls, 0.0f)
+  , m_direction_y(paddedBalls, 0.0f)
+  , m_velocity(paddedBalls, 0.0f)
+  , m_next_x(paddedBalls, 0.0f)
+  , m_next_y(paddedBalls, 0.0f)
+  , m_effect(paddedBalls, BallEffect::NONE)
+  , m_flags(paddedBalls, 0) {
+}
+
+void BallPool::reset(const Ball& ball) {
+  m_dimens = ball.getDimens();
+  m_size = 1;
+  m_removed = 0;
+  m_flags[0] = 0;
+  set(0, ball);
+}
+
+bool BallPool::spawn(int index, GLfloat cos_turn, GLfloat sin_turn) {
+  if (m_size >= BallParams::maxBalls) {
+    return false;
+  }
+  int spawned = m_size++;
+  move(index, spawned);
+  m_flags[spawned] &= ~(REMOVED | RESOLVE);
+  m_direction_x[spawned] = m_direction_x[index] * cos_turn - m_direction_y[index] * sin_turn;
+  m_direction_y[spawned] = m_direction_x[index] * sin_turn + m_direction_y[index] * cos_turn;
+  return true;
+}
+
+void BallPool::remove(int index) {
+  if ((m_flags[index] & REMOVED) == 0) {
+    m_flags[index] |= REMOVED;
+    ++m_removed;
+  }
+}
+
+void BallPool::keepOnly(int index) {
+  for (int i = 0; i < m_size; ++i) {
+    if (i != index) {
+      remove(i);
+    }
+  }
+}
+
+void BallPool::compact() {
+  if (m_removed == 0) {
+    return;
+  }
+  int kept = 0;
+  for (int i = 0; i < m_size; ++i) {
+    if ((m_flags[i] & REMOVED) == 0) {
+      if (kept != i) {
+        move(i, kept);
+      }
+      ++kept;
+    }
+  }
+  m_size = kept;
+  m_removed = 0;
+}
+
+Ball BallPool::get(int index) const {
+  Ball ball(m_dimens.width(), m_dimens.height());
+  ball.setXPose(m_x[index]);
+  ball.setYPose(m_y[index]);
+  ball.setDirection(m_direction_x[index], m_direction_y[index]);
+  ball.setVelocity(m_velocity[index]);
+  ball.setEffect(m_effect[index]);
+  return ball;
+}
+
+void BallPool::set(int index, const Ball& ball) {
+  m_x[index] = ball.getPose().getX();
+  m_y[index] = ball.getPose().getY();
+  m_direction_x[index] = ball.getDirectionX();
+  m_direction_y[index] = ball.getDirectionY();
+  m_velocity[index] = ball.getVelocity();
+  m_effect[index] = ball.getEffect();
+}
+
+void BallPool::setEffect(BallEffect effect) {
+  for (int i = 0; i < m_size; ++i) {
+    m_effect[i] = effect;
+  }
+}
+
+void BallPool::setVelocity(GLfloat velocity) {
+  for (int i = 0; i < m_size; ++i) {
+    m_velocity[i] = velocity;
+  }
+}
+
+int BallPool::step(GLfloat scale, const FreeFlight& region) {
+  using namespace util::simd;
+  // all lanes: position in the next tick
+  const float4 factor = splat(scale);
+  for (int i = 0; i < m_size; i += 4) {
+    float4 displacement = mul(load(&m_velocity[i]), factor);
+    store(&m_next_x[i], madd(displacement, load(&m_direction_x[i]), load(&m_x[i])));
+    store(&m_next_y[i], madd(displacement, load(&m_direction_y[i]), load(&m_y[i])));
+  }
+  // commit balls staying in free flight, flag the others
+  int pending = 0;
+  for (int i = 0; i < m_size; ++i) {
+    GLfloat x = m_next_x[i], y = m_next_y[i];
+    bool free_flight = (m_flags[i] & (LOST | DEATH)) == 0 &&
+                       x > region.left && x < region.right &&
+                       y > region.bottom && y < region.top && m_y[i] < region.top;
+    if (free_flight) {
+      m_x[i] = x;
+      m_y[i] = y;
+      m_flags[i] &= ~RESOLVE;
+    } else {
+      m_flags[i] |= RESOLVE;
+      ++pending;
+    }
+  }
+  return pending;
+}
+
+void BallPool::move(int from, int to) {
+  m_x[to] = m_x[from];
+  m_y[to] = m_y[from];
+  m_direction_x[to] = m_direction_x[from];
+  m_direction_y[to] = m_direction_y[from];
+  m_velocity[to] = m_velocity[from];
+  m_effect[to] = m_effect[from];
+  m_flags[to] = m_flags[from];
+}
+
+}
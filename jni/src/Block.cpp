@@ -629,4 +629,9 @@ Block BlockGenerator::generateBlock() {
   return static_cast<Block>(value);
 }
 
+void BlockGenerator::seed(unsigned int value) {
+  m_generator.seed(value);
+  m_distribution.reset();
+}
+
 }
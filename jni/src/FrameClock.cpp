@@ -0,0 +1,43 @@
+#include <algorithm>
+
+#include "FrameClock.h"
+
+namespace game {
+
+FrameClock::FrameClock()
+  : m_last_tick()
+  , m_fixed_step(0.0f)
+  , m_delta(0.0f)
+  , m_time(0.0)
+  , m_interval(0)
+  , m_frames(0) {
+}
+
+void FrameClock::tick() {
+  Clock::time_point now = Clock::now();
+  m_interval = m_frames > 0 ?
+      std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_last_tick).count() : 0;
+  m_last_tick = now;
+
+  float step = m_fixed_step.load();
+  if (step > 0.0f) {
+    m_delta = m_frames > 0 ? step : 0.0f;
+  } else {
+    m_delta = std::min(m_interval / 1e9f, maxDelta);
+  }
+  m_time += m_delta;
+  ++m_frames;
+}
+
+void FrameClock::reset() {
+  m_delta = 0.0f;
+  m_time = 0.0;
+  m_interval = 0;
+  m_frames = 0;
+}
+
+void FrameClock::setFixedStep(float step) {
+  m_fixed_step.store(std::max(step, 0.0f));
+}
+
+}
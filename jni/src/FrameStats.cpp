@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "FrameStats.h"
+
+namespace game {
+
+FrameStats::FrameStats()
+  : m_frame_start()
+  , m_current_draw_calls(0)
+  , m_current_texture_binds(0)
+  , m_current_location_lookups(0)
+  , m_current_allocations(0)
+  , m_current_frame_time(0)
+  , m_frames(0)
+  , m_total_draw_calls(0)
+  , m_total_texture_binds(0)
+  , m_total_location_lookups(0)
+  , m_total_allocations(0)
+  , m_total_cpu_time(0)
+  , m_last_draw_calls(0)
+  , m_last_texture_binds(0)
+  , m_last_location_lookups(0)
+  , m_last_allocations(0)
+  , m_last_cpu_time(0)
+  , m_timed_frames(0)
+  , m_total_frame_time(0)
+  , m_min_frame_time(std::numeric_limits<long long>::max())
+  , m_dropped_frames(0)
+  , m_fps_window_start(std::chrono::steady_clock::now())
+  , m_fps_window_frames(0)
+  , m_achieved_fps(0.0f) {
+  for (auto& bucket : m_frame_time_histogram) {
+    bucket.store(0);
+  }
+}
+
+void FrameStats::beginFrame() {
+  m_frame_start = std::chrono::steady_clock::now();
+  m_current_draw_calls = 0;
+  m_current_texture_binds = 0;
+  m_current_location_lookups = 0;
+  m_current_allocations = 0;
+  m_current_frame_time = 0;
+}
+
+void FrameStats::endFrame() {
+  auto now = std::chrono::steady_clock::now();
+  long long elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_frame_start).count();
+  m_last_draw_calls.store(m_current_draw_calls);
+  m_last_texture_binds.store(m_current_texture_binds);
+  m_last_location_lookups.store(m_current_location_lookups);
+  m_last_allocations.store(m_current_allocations);
+  m_last_cpu_time.store(elapsed);
+  m_total_draw_calls.fetch_add(m_current_draw_calls);
+  m_total_texture_binds.fetch_add(m_current_texture_binds);
+  m_total_location_lookups.fetch_add(m_current_location_lookups);
+  m_total_allocations.fetch_add(m_current_allocations);
+  m_total_cpu_time.fetch_add(elapsed);
+  if (m_current_frame_time > 0) {
+    int bucket = static_cast<int>(std::min(m_current_frame_time / histogramStep,
+                                           static_cast<long long>(histogramSize - 1)));
+    m_frame_time_histogram[bucket].fetch_add(1);
+    m_total_frame_time.fetch_add(m_current_frame_time);
+    if (m_current_frame_time < m_min_frame_time.load()) {
+      m_min_frame_time.store(m_current_frame_time);
+    }
+    m_timed_frames.fetch_add(1);
+  }
+  ++m_fps_window_frames;
+  long long window = std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_fps_window_start).count();
+  if (window >= 1000000000LL) {
+    m_achieved_fps.store(m_fps_window_frames * 1e9f / window);
+    m_fps_window_start = now;
+    m_fps_window_frames = 0;
+  }
+  m_frames.fetch_add(1);
+}
+
+double FrameStats::getAverageDrawCalls() const {
+  long long frames = m_frames.load();
+  return frames > 0 ? static_cast<double>(m_total_draw_calls.load()) / frames : 0.0;
+}
+
+double FrameStats::getAverageTextureBinds() const {
+  long long frames = m_frames.load();
+  return frames > 0 ? static_cast<double>(m_total_texture_binds.load()) / frames : 0.0;
+}
+
+double FrameStats::getAverageLocationLookups() const {
+  long long frames = m_frames.load();
+  return frames > 0 ? static_cast<double>(m_total_location_lookups.load()) / frames : 0.0;
+}
+
+double FrameStats::getAverageAllocations() const {
+  long long frames = m_frames.load();
+  return frames > 0 ? static_cast<double>(m_total_allocations.load()) / frames : 0.0;
+}
+
+double FrameStats::getAverageCpuTimeMicros() const {
+  long long frames = m_frames.load();
+  return frames > 0 ? m_total_cpu_time.load() / 1000.0 / frames : 0.0;
+}
+
+double FrameStats::getMinFrameTimeMicros() const {
+  return m_timed_frames.load() > 0 ? m_min_frame_time.load() / 1000.0 : 0.0;
+}
+
+double FrameStats::getAverageFrameTimeMicros() const {
+  long long frames = m_timed_frames.load();
+  return frames > 0 ? m_total_frame_time.load() / 1000.0 / frames : 0.0;
+}
+
+double FrameStats::getPercentileFrameTimeMicros(double fraction) const {
+  long long counts[histogramSize];
+  long long total = 0;
+  for (int i = 0; i < histogramSize; ++i) {
+    counts[i] = m_frame_time_histogram[i].load();
+    total += counts[i];
+  }
+  if (total == 0) {
+    return 0.0;
+  }
+  long long rank = static_cast<long long>(std::ceil(fraction * total));
+  long long accumulated = 0;
+  for (int i = 0; i < histogramSize; ++i) {
+    accumulated += counts[i];
+    if (accumulated >= rank) {
+      return (i + 1) * histogramStep / 1000.0;  // upper bound of bucket
+    }
+  }
+  return histogramSize * histogramStep / 1000.0;
+}
+
+void FrameStats::reset() {
+  m_frames.store(0);
+  m_total_draw_calls.store(0);
+  m_total_texture_binds.store(0);
+  m_total_location_lookups.store(0);
+  m_total_allocations.store(0);
+  m_total_cpu_time.store(0);
+  m_timed_frames.store(0);
+  m_total_frame_time.store(0);
+  m_min_frame_time.store(std::numeric_limits<long long>::max());
+  m_dropped_frames.store(0);
+  for (auto& bucket : m_frame_time_histogram) {
+    bucket.store(0);
+  }
+}
+
+}
@@ -1,12 +1,15 @@
+#include <algorithm>
 #include <sstream>
 #include <cassert>
 #include <chrono>
 #include <cmath>
+#include <cstdlib>
 
 #include "Exceptions.h"
 #include "GameProcessor.h"
 #include "Params.h"
 #include "Prize.h"
+#include "Replay.h"
 
 namespace game {
 
@@ -17,7 +20,10 @@ GameProcessor::GameProcessor(JavaVM* jvm)
   , master_object(nullptr)
   , fireJavaEvent_lostBall_id(nullptr)
   , fireJavaEvent_levelFinished_id(nullptr)
+  , fireJavaEvent_scoreUpdated_id(nullptr)
+  , fireJavaEvent_angleChanged_id(nullptr)
   , fireJavaEvent_cardinalityChanged_id(nullptr)
+  , fireJavaEvent_debugMessage_id(nullptr)
   , m_level(nullptr)
   , m_throw_angle(60.0f)
   , m_aspect(1.0f)
@@ -26,7 +32,9 @@ GameProcessor::GameProcessor(JavaVM* jvm)
   , m_is_ball_lost(false)
   , m_is_ball_death(false)
   , m_ball_pose_corrected(false)
+  , m_balls()
   , m_ball()
+  , m_ball_index(0)
   , m_bite()
   , m_laser_beam(0.0f, 0.0f)
   , m_bite_upper_border(-BiteParams::neg_biteElevation)
@@ -38,23 +46,25 @@ GameProcessor::GameProcessor(JavaVM* jvm)
   , m_internal_timer_for_laser(0)
   , explosionID(0)
   , prizeID(0)
-  , m_next_move_iteration(0)
-  , m_prev_move_iteration(0)
+  , m_tick_rate(ProcessorParams::defaultTickRate)
+  , m_tick_scale(1.0f)
+  , m_tick_period(std::chrono::steady_clock::duration::zero())
+  , m_wake_up_period(std::chrono::steady_clock::duration::zero())
+  , m_tick_accumulator(std::chrono::steady_clock::duration::zero())
+  , m_last_tick_time(std::chrono::steady_clock::now())
+  , m_tick_count(0)
+  , m_game_state()
+  , m_recorder(nullptr)
+  , m_record_start_tick(0)
+  , m_recorded_levels(0)
   , m_generator(std::chrono::system_clock::now().time_since_epoch().count())
   , m_angle_distribution(util::PI12, util::PI30)
   , m_direction_distribution(0.25f)
   , m_viscosity_distribution(0, 100) {
 
   DBG("enter GameProcessor ctor");
-  m_aspect_ratio_received.store(false);
-  m_load_level_received.store(false);
-  m_throw_ball_received.store(false);
-  m_init_ball_position_received.store(false);
-  m_init_bite_received.store(false);
-  m_level_dimens_received.store(false);
-  m_bite_location_received.store(false);
-  m_prize_caught_received.store(false);
-  m_laser_beam_received.store(false);
+  m_balls.reset(m_ball);
+  process_tickRate(ProcessorParams::defaultTickRate);
   DBG("exit GameProcessor ctor");
 }
 
@@ -67,67 +77,57 @@ GameProcessor::~GameProcessor() {
 /* Callbacks group */
 // ----------------------------------------------------------------------------
 void GameProcessor::callback_aspectMeasured(float aspect) {
-  std::unique_lock<std::mutex> lock(m_aspect_ratio_mutex);
-  m_aspect_ratio_received.store(true);
-  m_aspect = aspect;
-  interrupt();
+  GameProcessorMessage message(GameProcessorMessage::Kind::ASPECT_MEASURED);
+  message.value = aspect;
+  post(std::move(message));
 }
 
-void GameProcessor::callback_loadLevel(Level::Ptr level) {
-  std::unique_lock<std::mutex> lock(m_load_level_mutex);
-  m_load_level_received.store(true);
-  m_level = level;
-  INF("New level loaded, initial cardinality: %i", m_level->getCardinality());
-  interrupt();
+void GameProcessor::callback_loadLevel(const Level::Ptr& level) {
+  GameProcessorMessage message(GameProcessorMessage::Kind::LOAD_LEVEL);
+  message.level = level;
+  post(std::move(message));
 }
 
 void GameProcessor::callback_throwBall(float angle) {
-  std::unique_lock<std::mutex> lock(m_throw_ball_mutex);
-  m_throw_ball_received.store(true);
-  m_throw_angle = angle;
-  interrupt();
+  GameProcessorMessage message(GameProcessorMessage::Kind::THROW_BALL);
+  message.value = angle;
+  post(std::move(message));
 }
 
-void GameProcessor::callback_initBall(Ball init_ball) {
-  std::unique_lock<std::mutex> lock(m_init_ball_position_mutex);
-  m_init_ball_position_received.store(true);
-  m_ball = init_ball;
-  interrupt();
+void GameProcessor::callback_initBall(const Ball& init_ball) {
+  GameProcessorMessage message(GameProcessorMessage::Kind::INIT_BALL);
+  message.ball = init_ball;
+  post(std::move(message));
 }
 
-void GameProcessor::callback_initBite(Bite bite) {
-  std::unique_lock<std::mutex> lock(m_init_bite_mutex);
-  m_init_bite_received.store(true);
-  m_bite = bite;
-  interrupt();
+void GameProcessor::callback_initBite(const Bite& bite) {
+  GameProcessorMessage message(GameProcessorMessage::Kind::INIT_BITE);
+  message.bite = bite;
+  post(std::move(message));
 }
 
-void GameProcessor::callback_levelDimens(LevelDimens level_dimens) {
-  std::unique_lock<std::mutex> lock(m_level_dimens_mutex);
-  m_level_dimens_received.store(true);
-  m_level_dimens = level_dimens;
-  interrupt();
+void GameProcessor::callback_levelDimens(const LevelDimens& level_dimens) {
+  GameProcessorMessage message(GameProcessorMessage::Kind::LEVEL_DIMENS);
+  message.level_dimens = level_dimens;
+  post(std::move(message));
 }
 
-void GameProcessor::callback_biteMoved(Bite moved_bite) {
-  std::unique_lock<std::mutex> lock(m_bite_location_mutex);
-  m_bite_location_received.store(true);
-  m_bite = moved_bite;
-  interrupt();
+void GameProcessor::callback_biteMoved(const Bite& moved_bite) {
+  GameProcessorMessage message(GameProcessorMessage::Kind::BITE_MOVED);
+  message.bite = moved_bite;
+  post(std::move(message));
 }
 
-void GameProcessor::callback_prizeCaught(PrizePackage package) {
-  std::unique_lock<std::mutex> lock(m_prize_caught_mutex);
-  m_prize_caught_received.store(true);
-  m_prize_caught = package.getPrize();
-  interrupt();
+void GameProcessor::callback_prizeCaught(const PrizePackage& package) {
+  GameProcessorMessage message(GameProcessorMessage::Kind::PRIZE_CAUGHT);
+  message.prize = package.getPrize();
+  post(std::move(message));
 }
 
-void GameProcessor::callback_laserBeam(LaserPackage laser) {
-  std::unique_lock<std::mutex> lock(m_laser_beam_mutex);
-  m_laser_beam_received.store(true);
-  m_laser_beam = laser;
-  interrupt();
+void GameProcessor::callback_laserBeam(const LaserPackage& laser) {
+  GameProcessorMessage message(GameProcessorMessage::Kind::LASER_BEAM);
+  message.laser = laser;
+  post(std::move(message));
 }
 
 /* *** Private methods *** */
@@ -160,98 +160,109 @@ void GameProcessor::onStop() {
 }
 
 bool GameProcessor::checkForWakeUp() {
-  return m_ball_is_flying ||
-      m_aspect_ratio_received.load() ||
-      m_load_level_received.load() ||
-      m_throw_ball_received.load() ||
-      m_init_ball_position_received.load() ||
-      m_init_bite_received.load() ||
-      m_level_dimens_received.load() ||
-      m_bite_location_received.load() ||
-      m_prize_caught_received.load() ||
-      m_laser_beam_received.load();
+  return m_ball_is_flying || QueuedActiveObject<GameProcessorMessage>::checkForWakeUp();
 }
 
-void GameProcessor::eventHandler() {
-  if (m_aspect_ratio_received.load()) {
-    m_aspect_ratio_received.store(false);
-    process_aspectMeasured();
-  }
-  if (m_load_level_received.load()) {
-    m_load_level_received.store(false);
-    process_loadLevel();
-  }
-  if (m_init_ball_position_received.load()) {
-    m_init_ball_position_received.store(false);
-    process_initBall();
-  }
-  if (m_init_bite_received.load()) {
-    m_init_bite_received.store(false);
-    process_initBite();
-  }
-  if (m_level_dimens_received.load()) {
-    m_level_dimens_received.store(false);
-    process_loadLevel();
-  }
-  if (m_bite_location_received.load()) {
-    m_bite_location_received.store(false);
-    process_biteMoved();
-  }
-  if (m_throw_ball_received.load()) {
-    m_throw_ball_received.store(false);
-    process_throwBall();
-  }
-  if (m_prize_caught_received.load()) {
-    m_prize_caught_received.store(false);
-    process_prizeCaught();
-  }
-  if (m_laser_beam_received.load()) {
-    m_laser_beam_received.store(false);
-    process_laserBeam();
+bool GameProcessor::isCoalescable(const GameProcessorMessage& message) const {
+  return message.kind == GameProcessorMessage::Kind::BITE_MOVED;
+}
+
+void GameProcessor::dispatch(GameProcessorMessage& message) {
+  if (m_recorder != nullptr && message.kind != GameProcessorMessage::Kind::RECORDER) {
+    if (message.kind == GameProcessorMessage::Kind::LOAD_LEVEL) {
+      m_recorder->getSeeds().seedLevel(*message.level, m_recorded_levels++);
+    }
+    m_recorder->record(m_tick_count - m_record_start_tick, message);
   }
 
-  // internal events
-  if (m_ball_is_flying) {
-    moveBall();
-    incrementInternalTimer();
-    incrementInternalTimerForSpeed();
-    incrementInternalTimerForWidth();
-    incrementInternalTimerForLaser();
+  switch (message.kind) {
+    case GameProcessorMessage::Kind::ASPECT_MEASURED:
+      process_aspectMeasured(message.value);
+      break;
+    case GameProcessorMessage::Kind::LOAD_LEVEL:
+      process_loadLevel(message.level);
+      break;
+    case GameProcessorMessage::Kind::THROW_BALL:
+      process_throwBall(message.value);
+      break;
+    case GameProcessorMessage::Kind::INIT_BALL:
+      process_initBall(message.ball);
+      break;
+    case GameProcessorMessage::Kind::INIT_BITE:
+      process_initBite(message.bite);
+      break;
+    case GameProcessorMessage::Kind::LEVEL_DIMENS:
+      process_levelDimens(message.level_dimens);
+      break;
+    case GameProcessorMessage::Kind::BITE_MOVED:
+      process_biteMoved(message.bite);
+      break;
+    case GameProcessorMessage::Kind::PRIZE_CAUGHT:
+      process_prizeCaught(message.prize);
+      break;
+    case GameProcessorMessage::Kind::LASER_BEAM:
+      process_laserBeam(message.laser);
+      break;
+    case GameProcessorMessage::Kind::TICK_RATE:
+      process_tickRate(message.tick_rate);
+      break;
+    case GameProcessorMessage::Kind::RECORDER:
+      process_recorder(std::move(message.recorder));
+      break;
+    case GameProcessorMessage::Kind::BONUS_BLOCKS:
+      process_bonusBlocks(message.flag);
+      break;
+    case GameProcessorMessage::Kind::NONE:
+    default:
+      break;
   }
-  if (checkInternalTimer(GameProcessor::internalTimerThreshold)) {
-    dropTimedEffectForBall();
-    dropInternalTimer();
+}
+
+void GameProcessor::eventHandler() {
+  QueuedActiveObject<GameProcessorMessage>::eventHandler();  // drain incoming events
+
+  if (!m_ball_is_flying) {
+    return;
   }
-  if (checkInternalTimerForSpeed(GameProcessor::internalTimerForSpeedThreshold)) {
-    m_ball.normalSpeed();
-    dropInternalTimerForSpeed();
+
+  // feed accumulator with real time passed, but never simulate a long stall
+  auto now = std::chrono::steady_clock::now();
+  m_tick_accumulator += now - m_last_tick_time;
+  m_last_tick_time = now;
+  auto max_catch_up = std::max(m_tick_period * ProcessorParams::maxCatchUpTicks, 2 * m_wake_up_period);
+  if (m_tick_accumulator > max_catch_up) {
+    m_tick_accumulator = max_catch_up;
   }
-  if (checkInternalTimerForWidth(GameProcessor::internalTimerForWidthThreshold)) {
-    bite_width_changed_event.notifyListeners(BiteEffect::NONE);
-    dropInternalTimerForWidth();
+
+  // internal events, all ticks due since the last wake-up
+  while (m_ball_is_flying && m_tick_accumulator >= m_tick_period) {
+    m_tick_accumulator -= m_tick_period;
+    tick();
   }
-  if (checkInternalTimerForLaser(GameProcessor::internalTimerForLaserThreshold)) {
-    laser_beam_visibility_event.notifyListeners(false);
-    dropInternalTimerForLaser();
+
+  if (m_ball_is_flying) {  // sleep till the next wake-up unless an event comes
+    waitForEvents(now + (m_wake_up_period - m_tick_accumulator));
   }
 }
 
 /* Processors group */
 // ----------------------------------------------------------------------------
-void GameProcessor::process_aspectMeasured() {
-  std::unique_lock<std::mutex> lock(m_aspect_ratio_mutex);
-  // no-op
+void GameProcessor::process_aspectMeasured(GLfloat aspect) {
+  m_aspect = aspect;
 }
 
-void GameProcessor::process_loadLevel() {
-  std::unique_lock<std::mutex> lock(m_load_level_mutex);
+void GameProcessor::process_loadLevel(Level::Ptr level) {
+  m_level = level;
+  INF("New level loaded, initial cardinality: %i", m_level->getCardinality());
   onCardinalityChanged(m_level->getCardinality());
 }
 
-void GameProcessor::process_throwBall() {
-  std::unique_lock<std::mutex> lock(m_throw_ball_mutex);
+void GameProcessor::process_throwBall(GLfloat angle) {
+  m_throw_angle = angle;
   if (!m_ball_is_flying) {
+    resetSimulationClock();
     m_ball.setAngle(m_throw_angle);
+    m_balls.reset(m_ball);
     m_level_finished = false;
     m_ball_is_flying = true;
     m_is_ball_lost = false;
@@ -262,30 +273,33 @@ void GameProcessor::process_throwBall() {
   INF("Ball has been thrown");
 }
 
-void GameProcessor::process_initBall() {
-  std::unique_lock<std::mutex> lock(m_init_ball_position_mutex);
+void GameProcessor::process_initBall(const Ball& init_ball) {
+  m_ball = init_ball;
+  m_balls.reset(m_ball);
   stopBall();
+  publishGameState();
 }
 
-void GameProcessor::process_initBite() {
-  std::unique_lock<std::mutex> lock(m_init_bite_mutex);
+void GameProcessor::process_initBite(const Bite& bite) {
+  m_bite = bite;
   m_bite_upper_border = -BiteParams::neg_biteElevation;
 }
 
-void GameProcessor::process_levelDimens() {
-  std::unique_lock<std::mutex> lock(m_level_dimens_mutex);
-  // no-op
+void GameProcessor::process_levelDimens(const LevelDimens& level_dimens) {
+  m_level_dimens = level_dimens;
 }
 
-void GameProcessor::process_biteMoved() {
-  std::unique_lock<std::mutex> lock(m_bite_location_mutex);
+void GameProcessor::process_biteMoved(const Bite& moved_bite) {
+  m_bite = moved_bite;
   if (!m_ball_is_flying) {  // move ball following the bite
     shiftBall(m_bite.getXPose(), m_ball.getPose().getY() /* unchanged */);
+    m_balls.reset(m_ball);
+    publishGameState();
   }
 }
 
-void GameProcessor::process_prizeCaught() {
-  std::unique_lock<std::mutex> lock(m_prize_caught_mutex);
+void GameProcessor::process_prizeCaught(Prize prize) {
+  m_prize_caught = prize;
   switch (m_prize_caught) {
     case Prize::BLOCK:
       {
@@ -303,34 +317,35 @@ void GameProcessor::process_prizeCaught() {
     // TODO: CLIMB
     // TODO: DRAGON
     case Prize::EASY:
-      m_ball.setEffect(BallEffect::EASY);
+      setBallsEffect(BallEffect::EASY);
       break;
     case Prize::EASY_T:  // timed effect
-      m_ball.setEffect(BallEffect::EASY_T);
+      setBallsEffect(BallEffect::EASY_T);
       dropInternalTimer();
       break;
     // TODO: EVAPORATE
     case Prize::EXPLODE:
-      m_ball.setEffect(BallEffect::EXPLODE);
+      setBallsEffect(BallEffect::EXPLODE);
       break;
     case Prize::EXTEND:  // timed effect
       bite_width_changed_event.notifyListeners(BiteEffect::EXTEND);
       dropInternalTimerForWidth();
       break;
     case Prize::FAST:  // timed effect
-      m_ball.fastSpeed();
+      setBallsVelocity(BallParams::ballFastSpeed);
       dropInternalTimerForSpeed();
       break;
     // TODO: FOG
     case Prize::GOO:  // timed effect
-      m_ball.setEffect(BallEffect::GOO);
+      setBallsEffect(BallEffect::GOO);
       dropInternalTimer();
       break;
     case Prize::HYPER:
       teleportBallIntoRandomBlock();
+      storeBall();
       break;
     case Prize::JUMP:  // timed effect
-      m_ball.setEffect(BallEffect::JUMP);
+      setBallsEffect(BallEffect::JUMP);
       dropInternalTimer();
       break;
     case Prize::LASER:
@@ -338,11 +353,11 @@ void GameProcessor::process_prizeCaught() {
       dropInternalTimerForLaser();
       break;
     case Prize::MIRROR:  // timed effect
-      m_ball.setEffect(BallEffect::MIRROR);
+      setBallsEffect(BallEffect::MIRROR);
       dropInternalTimer();
       break;
     case Prize::PIERCE:  // timed effect
-      m_ball.setEffect(BallEffect::PIERCE);
+      setBallsEffect(BallEffect::PIERCE);
       dropInternalTimer();
       break;
     case Prize::PROTECT:  // timed effect
@@ -350,7 +365,7 @@ void GameProcessor::process_prizeCaught() {
       dropInternalTimerForWidth();
       break;
     case Prize::RANDOM:  // timed effect
-      m_ball.setEffect(BallEffect::RANDOM);
+      setBallsEffect(BallEffect::RANDOM);
       dropInternalTimer();
       break;
     case Prize::SHORT:  // timed effect
@@ -358,20 +373,20 @@ void GameProcessor::process_prizeCaught() {
       dropInternalTimerForWidth();
       break;
     case Prize::SLOW:  // timed effect
-      m_ball.slowSpeed();
+      setBallsVelocity(BallParams::ballSlowSpeed);
       dropInternalTimerForSpeed();
       break;
     case Prize::UPGRADE:
-      m_ball.setEffect(BallEffect::UPGRADE);
+      setBallsEffect(BallEffect::UPGRADE);
       break;
     case Prize::DEGRADE:
-      m_ball.setEffect(BallEffect::DEGRADE);
+      setBallsEffect(BallEffect::DEGRADE);
       break;
     case Prize::WIN:  // processed in Java layer
       m_level_finished = true;
       break;
     case Prize::ZYGOTE:
-      m_ball.setEffect(BallEffect::ZYGOTE);
+      multiplyBalls();
       break;
     case Prize::DESTROY:  // fully processed in Java layer
     case Prize::INIT:     // fully processed in Java layer
@@ -382,8 +397,8 @@ void GameProcessor::process_prizeCaught() {
   }
 }
 
-void GameProcessor::process_laserBeam() {
-  std::unique_lock<std::mutex> lock(m_laser_beam_mutex);
+void GameProcessor::process_laserBeam(const LaserPackage& laser) {
+  m_laser_beam = laser;
   int row = 0, col = 0;
   if (!getImpactedBlock(m_laser_beam.getX(), m_laser_beam.getY() - LaserParams::laserHalfHeight, &row, &col)) {
     return;  // laser beam has left level boundaries
@@ -397,16 +412,45 @@ void GameProcessor::process_laserBeam() {
       Prize spawned_prize = m_level->getPrizeGenerator().generatePrize();
       spawnPrizeAtBlock(row, col, spawned_prize);
       block_impact_event.notifyListeners(RowCol(row, col, block));
-      onCardinalityChanged(m_level->getCardinality());
+      onCardinalityChanged(m_level_finished ? 0 : m_level->getCardinality());
       onScoreUpdated(score);
     }
     laser_block_impact_event.notifyListeners(true);
   }
 }
 
-/* LogicFunc group */
-// ----------------------------------------------------------------------------
-void GameProcessor::setBonusBlocks(bool flag) {
+void GameProcessor::process_tickRate(int ticks_per_second) {
+  if (ticks_per_second <= 0) {
+    WRN("Invalid tick rate %i, ignored", ticks_per_second);
+    return;
+  }
+  m_tick_rate = ticks_per_second;
+  m_tick_scale = static_cast<GLfloat>(ProcessorParams::referenceTickRate) / m_tick_rate;
+  m_tick_period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::nanoseconds(1000000000LL / m_tick_rate));
+  m_wake_up_period = std::max(m_tick_period, std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::nanoseconds(1000000000LL / ProcessorParams::wakeUpRate)));
+  resetSimulationClock();
+  DBG("Physics tick rate set to %i Hz", m_tick_rate);
+}
+
+void GameProcessor::process_recorder(std::shared_ptr<InputRecorder> recorder) {
+  if (m_recorder != nullptr) {
+    m_recorder->finish(m_tick_count - m_record_start_tick, getStateHash());
+    INF("Recording has finished: %lli inputs", m_recorder->getRecords());
+  }
+  m_recorder = std::move(recorder);
+  if (m_recorder != nullptr) {
+    const ReplaySeeds& seeds = m_recorder->getSeeds();
+    setSeed(seeds.processor);
+    std::srand(seeds.shared);
+    m_record_start_tick = m_tick_count;
+    m_recorded_levels = 0;
+    INF("Recording has started");
+  }
+}
+
+void GameProcessor::process_bonusBlocks(bool flag) {
   if (m_level != nullptr) {
     m_level->getPrizeGenerator().setBonusBlocks(flag);
     DBG("Bonus blocks set to %s", flag ? "true" : "false");
@@ -415,9 +459,137 @@ void GameProcessor::setBonusBlocks(bool flag) {
   }
 }
 
-void GameProcessor::moveBall() {
-  m_ball_pose_corrected = false;
+/* Headless group */
+// ----------------------------------------------------------------------------
+void GameProcessor::setSeed(unsigned int seed) {
+  m_generator.seed(seed);
+  m_angle_distribution.reset();
+  m_direction_distribution.reset();
+  m_viscosity_distribution.reset();
+}
+
+int GameProcessor::advance(int ticks) {
+  if (m_jenv == nullptr) {
+    attachToJVM();  // caller's thread plays processor's one
+  }
+  QueuedActiveObject<GameProcessorMessage>::eventHandler();
+  int total = 0;
+  while (m_ball_is_flying && total < ticks) {
+    tick();
+    ++total;
+    QueuedActiveObject<GameProcessorMessage>::eventHandler();
+  }
+  return total;
+}
+
+void GameProcessor::inject(GameProcessorMessage message) {
+  post(std::move(message));
+}
+
+uint64_t GameProcessor::getStateHash() const {
+  uint64_t hash = 14695981039346656037ULL;
+  auto mix = [&hash](const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+      hash = (hash ^ bytes[i]) * 1099511628211ULL;  // FNV-1a
+    }
+  };
+  const GLfloat floats[] = {m_ball.getPose().getX(), m_ball.getPose().getY(), m_ball.getDirectionX(),
+                            m_ball.getDirectionY(), m_ball.getVelocity(), m_bite.getXPose(), m_bite.getDimens().width()};
+  const long long integers[] = {m_tick_count, static_cast<long long>(m_ball.getEffect()),
+                                m_ball_is_flying, m_level_finished, explosionID.load(), prizeID.load(),
+                                m_internal_timer, m_internal_timer_for_speed, m_internal_timer_for_width,
+                                m_internal_timer_for_laser};
+  mix(floats, sizeof(floats));
+  mix(integers, sizeof(integers));
+  const int balls = m_balls.size();
+  mix(&balls, sizeof(balls));
+  for (int i = 0; i < balls; ++i) {
+    const GLfloat ball[] = {m_balls.getX(i), m_balls.getY(i), m_balls.getDirectionX(i), m_balls.getDirectionY(i),
+                            m_balls.getVelocity(i)};
+    const int effect = static_cast<int>(m_balls.getEffect(i));
+    mix(ball, sizeof(ball));
+    mix(&effect, sizeof(effect));
+  }
+  if (m_level != nullptr) {
+    for (int row = 0; row < m_level->numRows(); ++row) {
+      for (int col = 0; col < m_level->numCols(); ++col) {
+        int block = static_cast<int>(m_level->getBlock(row, col));
+        mix(&block, sizeof(block));
+      }
+    }
+  }
+  return hash;
+}
+
+/* LogicFunc group */
+// ----------------------------------------------------------------------------
+void GameProcessor::setBonusBlocks(bool flag) {
+  GameProcessorMessage message(GameProcessorMessage::Kind::BONUS_BLOCKS);
+  message.flag = flag;
+  post(std::move(message));
+}
+
+void GameProcessor::setRecorder(std::shared_ptr<InputRecorder> recorder) {
+  GameProcessorMessage message(GameProcessorMessage::Kind::RECORDER);
+  message.recorder = std::move(recorder);
+  post(std::move(message));
+}
+
+void GameProcessor::setTickRate(int ticks_per_second) {
+  GameProcessorMessage message(GameProcessorMessage::Kind::TICK_RATE);
+  message.tick_rate = ticks_per_second;
+  post(std::move(message));
+}
+
+void GameProcessor::tick() {
+  moveBalls();
+  incrementInternalTimer();
+  incrementInternalTimerForSpeed();
+  incrementInternalTimerForWidth();
+  incrementInternalTimerForLaser();
+
+  if (checkInternalTimer(scaledTicks(GameProcessor::internalTimerThreshold))) {
+    dropTimedEffectForBall();
+    dropInternalTimer();
+  }
+  if (checkInternalTimerForSpeed(scaledTicks(GameProcessor::internalTimerForSpeedThreshold))) {
+    setBallsVelocity(BallParams::ballSpeed);
+    dropInternalTimerForSpeed();
+  }
+  if (checkInternalTimerForWidth(scaledTicks(GameProcessor::internalTimerForWidthThreshold))) {
+    bite_width_changed_event.notifyListeners(BiteEffect::NONE);
+    dropInternalTimerForWidth();
+  }
+  if (checkInternalTimerForLaser(scaledTicks(GameProcessor::internalTimerForLaserThreshold))) {
+    laser_beam_visibility_event.notifyListeners(false);
+    dropInternalTimerForLaser();
+  }
+
+  ++m_tick_count;
+  publishGameState();
+}
+
+void GameProcessor::resetSimulationClock() {
+  m_tick_accumulator = std::chrono::steady_clock::duration::zero();
+  m_last_tick_time = std::chrono::steady_clock::now();
+}
 
+void GameProcessor::publishGameState() {
+  GameStateSnapshot snapshot;
+  snapshot.tick = m_tick_count;
+  snapshot.ball = m_ball;
+  snapshot.bite_x = m_bite.getXPose();
+  snapshot.ball_is_flying = m_ball_is_flying;
+  snapshot.ball_count = m_balls.size();
+  for (int i = 0; i < m_balls.size(); ++i) {
+    snapshot.balls_x[i] = m_balls.getX(i);
+    snapshot.balls_y[i] = m_balls.getY(i);
+  }
+  m_game_state.publish(snapshot);
+}
+
+void GameProcessor::moveBalls() {
   if (m_level_finished) {
     stopBall();  // stop flying before notify to avoid bugs
     level_finished_event.notifyListeners(true);
@@ -425,17 +597,30 @@ void GameProcessor::moveBall() {
     return;
   }
 
-  // ball's position in the next frame
+  if (m_balls.step(m_tick_scale, getFreeFlight()) > 0) {
+    for (int i = 0; i < m_balls.size() && m_ball_is_flying; ++i) {
+      if (m_balls.needsResolve(i)) {
+        moveBall(i);
+      }
+    }
+    m_balls.compact();
+  }
+  loadBall(0);
+}
+
+void GameProcessor::moveBall(int index) {
+  loadBall(index);
+  m_ball_pose_corrected = false;
+
+  // ball's position in the next tick
+  GLfloat step = m_ball.getVelocity() * m_tick_scale;
   GLfloat old_x = m_ball.getPose().getX();
   GLfloat old_y = m_ball.getPose().getY();
-  GLfloat new_x = m_ball.getPose().getX() + m_ball.getVelocity() * cos(m_ball.getAngle());
-  GLfloat new_y = m_ball.getPose().getY() + m_ball.getVelocity() * sin(m_ball.getAngle());
+  GLfloat new_x = m_balls.getNextX(index);
+  GLfloat new_y = m_balls.getNextY(index);
 
   if ((m_is_ball_lost && new_y <= -1.0f) || m_is_ball_death) {
-    stopBall();  // stop flying before notify to avoid bugs
-    lost_ball_event.notifyListeners(true);
-    onLostBall(true);
-    onCardinalityChanged(m_level->getCardinality());
+    dropBall();
     return;
   }
 
@@ -456,21 +641,87 @@ void GameProcessor::moveBall() {
     }
   } else if (collideBlock(new_x, new_y)) {
     m_level_finished = (m_level->blockImpact() == 0);
-    onCardinalityChanged(m_level->getCardinality());
+    onCardinalityChanged(m_level_finished ? 0 : m_level->getCardinality());
   }
 
   if (!m_ball_pose_corrected) {
-    new_x = old_x + m_ball.getVelocity() * cos(m_ball.getAngle());
-    new_y = old_y + m_ball.getVelocity() * sin(m_ball.getAngle());
+    new_x = old_x + step * m_ball.getDirectionX();
+    new_y = old_y + step * m_ball.getDirectionY();
     shiftBall(new_x, new_y);
   }
-  std::this_thread::sleep_for (std::chrono::milliseconds(ProcessorParams::milliDelay));
+  storeBall();
+}
+
+void GameProcessor::loadBall(int index) {
+  m_ball_index = index;
+  m_ball = m_balls.get(index);
+  m_is_ball_lost = m_balls.isLost(index);
+  m_is_ball_death = m_balls.isDeath(index);
+}
+
+void GameProcessor::storeBall() {
+  m_balls.set(m_ball_index, m_ball);
+  m_balls.setLost(m_ball_index, m_is_ball_lost);
+  m_balls.setDeath(m_ball_index, m_is_ball_death);
+}
+
+FreeFlight GameProcessor::getFreeFlight() const {
+  const GLfloat half_width = m_ball.getDimens().halfWidth();
+  const GLfloat half_height = m_ball.getDimens().halfHeight();
+  // lower border of level, with a margin for rounding in grid space
+  GLfloat level_bottom = 1.0f;
+  if (m_level != nullptr) {
+    level_bottom -= (m_level->numRows() + 1) * m_level_dimens.getBlockHeight();
+  }
+  FreeFlight region;
+  region.left = -1.0f + half_width;
+  region.right = 1.0f - half_width;
+  region.bottom = m_bite_upper_border + half_height;
+  region.top = std::min(level_bottom, 1.0f) - half_height;
+  return region;
+}
+
+void GameProcessor::dropBall() {
+  if (m_balls.alive() > 1) {
+    m_balls.remove(m_ball_index);
+    return;
+  }
+  stopBall();  // stop flying before notify to avoid bugs
+  lost_ball_event.notifyListeners(true);
+  onLostBall(true);
+  onCardinalityChanged(m_level->getCardinality());
+  storeBall();
+}
+
+void GameProcessor::multiplyBalls() {
+  if (!m_ball_is_flying) {
+    return;
+  }
+  const int parents = m_balls.size();
+  for (int i = 0; i < parents; ++i) {
+    for (int k = 1; k <= BallParams::zygoteOffspring; ++k) {
+      GLfloat spread = (k % 2 == 1 ? 1.0f : -1.0f) * ((k + 1) / 2) * BallParams::zygoteSpread;
+      if (!m_balls.spawn(i, std::cos(spread), std::sin(spread))) {
+        return;  // pool is full
+      }
+    }
+  }
+  INF("Balls multiplied: %i in play", m_balls.alive());
+}
+
+void GameProcessor::setBallsEffect(BallEffect effect) {
+  m_balls.setEffect(effect);
+  m_ball.setEffect(effect);
+}
+
+void GameProcessor::setBallsVelocity(GLfloat velocity) {
+  m_balls.setVelocity(velocity);
+  m_ball.setVelocity(velocity);
 }
 
 void GameProcessor::shiftBall(GLfloat new_x, GLfloat new_y) {
   m_ball.setXPose(new_x);
   m_ball.setYPose(new_y);
-  move_ball_event.notifyListeners(m_ball);
 }
 
 void GameProcessor::shiftBallIntoBlock(int row, int col) {
@@ -515,6 +766,11 @@ void GameProcessor::onAngleChanged() {
 }
 
 void GameProcessor::onCardinalityChanged(int new_cardinality) {
+#if DEBUG
+  if (!m_level->verify()) {
+    ERR("Level bookkeeping differs from full recount");
+  }
+#endif  // DEBUG
   m_jenv->CallVoidMethod(master_object, fireJavaEvent_cardinalityChanged_id, new_cardinality);
 }
 
@@ -551,7 +807,8 @@ void GameProcessor::spawnPrizeAtBlock(int row, int col, Prize prize) {
   }
 }
 
-int GameProcessor::performBallEffectAtBlock(int row, int col) {
+int GameProcessor::performBallEffectAtBlock(const Impact& impact) {
+  int row = impact.row, col = impact.col;
   int score = 0;
   Prize spawned_prize = Prize::NONE;
   std::vector<RowCol> affected_blocks_effect;
@@ -574,12 +831,7 @@ int GameProcessor::performBallEffectAtBlock(int row, int col) {
       break;
     case BallEffect::PIERCE:
       {
-        GLfloat top_border = 0.0f, bottom_border = 0.0f, left_border = 0.0f, right_border = 0.0f;
-        m_level_dimens.getBlockDimens(row, col, &top_border, &bottom_border, &left_border, &right_border);
-        Direction vertical_direction = Direction::NONE;
-        Direction horizontal_direction = Direction::NONE;
-        getCollisionDirection(top_border, bottom_border, left_border, right_border, &vertical_direction, &horizontal_direction);
-        Direction result_direction = (vertical_direction != Direction::NONE ? vertical_direction : (horizontal_direction != Direction::NONE ? horizontal_direction : Direction::UP));
+        Direction result_direction = (impact.vertical != Direction::NONE ? impact.vertical : (impact.horizontal != Direction::NONE ? impact.horizontal : Direction::UP));
 
         RowCol rowcol(-1, -1);
         score += m_level->destroyOneBlockBehind(row, col, result_direction, &rowcol);
@@ -626,50 +878,47 @@ int GameProcessor::performBallEffectAtBlock(int row, int col) {
 }
 
 void GameProcessor::dropTimedEffectForBall() {
-  switch (m_ball.getEffect()) {
-    case BallEffect::EASY_T:
-    case BallEffect::GOO:
-    case BallEffect::JUMP:
-    case BallEffect::MIRROR:
-    case BallEffect::PIERCE:
-    case BallEffect::PROTECT:
-    case BallEffect::RANDOM:
-      m_ball.setEffect(BallEffect::NONE);
-      drop_ball_appearance_event.notifyListeners(true);
-      break;
-    default:
-      break;
+  bool dropped = false;
+  for (int i = 0; i < m_balls.size(); ++i) {
+    switch (m_balls.getEffect(i)) {
+      case BallEffect::EASY_T:
+      case BallEffect::GOO:
+      case BallEffect::JUMP:
+      case BallEffect::MIRROR:
+      case BallEffect::PIERCE:
+      case BallEffect::PROTECT:
+      case BallEffect::RANDOM:
+        m_balls.setEffect(i, BallEffect::NONE);
+        dropped = true;
+        break;
+      default:
+        break;
+    }
+  }
+  if (dropped) {
+    m_ball.setEffect(m_balls.getEffect(m_ball_index));
+    drop_ball_appearance_event.notifyListeners(true);
   }
 }
 
 /* Collision group */
 // ----------------------------------------------------------------------------
 void GameProcessor::collideLeftBorder() {
-  if (m_ball.getAngle() >= util::PI) {
-    m_ball.setAngle(util::_3PI - m_ball.getAngle());
-  } else if (m_ball.getAngle() >= util::PI2) {
-    m_ball.setAngle(util::PI - m_ball.getAngle());
+  if (m_ball.getDirectionX() < 0.0f) {
+    m_ball.reflect(1.0f, 0.0f);
   }
-  GLfloat sign = m_ball.getAngle() >= 0.0f ? 1.0f : -1.0f;
-  m_ball.setAngle(sign * std::fmod(std::fabs(m_ball.getAngle()), util::_2PI));
   onAngleChanged();
 }
 
 void GameProcessor::collideRightBorder() {
-  if (m_ball.getAngle() <= util::PI2) {
-    m_ball.setAngle(util::PI - m_ball.getAngle());
-  } else if (m_ball.getAngle() >= util::_3PI2) {
-    m_ball.setAngle(util::_3PI - m_ball.getAngle());
+  if (m_ball.getDirectionX() > 0.0f) {
+    m_ball.reflect(-1.0f, 0.0f);
   }
-  GLfloat sign = m_ball.getAngle() >= 0.0f ? 1.0f : -1.0f;
-  m_ball.setAngle(sign * std::fmod(std::fabs(m_ball.getAngle()), util::_2PI));
   onAngleChanged();
 }
 
 void GameProcessor::collideHorizontalSurface() {
-  m_ball.setAngle(util::_2PI - m_ball.getAngle());
-  GLfloat sign = m_ball.getAngle() >= 0.0f ? 1.0f : -1.0f;
-  m_ball.setAngle(sign * std::fmod(std::fabs(m_ball.getAngle()), util::_2PI));
+  m_ball.reflect(0.0f, 1.0f);
   onAngleChanged();
 }
 
@@ -684,66 +933,29 @@ bool GameProcessor::collideBite(GLfloat new_x) {
       randomAngle();
       smallAngleAvoid();
 
-    } else if (m_ball.getEffect() == BallEffect::GOO) {
-      stopBall();  // glues ball to bite
+    } else if (m_ball.getEffect() == BallEffect::GOO && m_balls.alive() == 1) {
+      stopBall();  // glues the last ball to bite
       bite_impact_event.notifyListeners(true);
       return true;
 
     } else {
-      GLfloat distance = std::fabs(new_x - m_bite.getXPose());
-      GLfloat beta = std::fabs(std::atan(distance / m_bite.getRadius()));
-
-      if (new_x >= m_bite.getXPose() + m_bite.getDimens().quarterWidth()) {
-        GLfloat normal = std::fabs(util::PI2 - beta);
-        if (m_ball.getAngle() >= util::_3PI2) {
-          collideHorizontalSurface();
-          if (m_ball.getAngle() >= beta) {
-            m_ball.setAngle(m_ball.getAngle() - beta);
-          } else {
-            m_ball.setAngle(m_ball.getAngle() + beta);
-          }
-          smallAngleAvoid();
-        } else if (m_ball.getAngle() >= util::PI) {
-          GLfloat gamma = util::_3PI2 - m_ball.getAngle();
-          if (gamma <= beta) {
-            GLfloat delta = std::fabs(gamma - 2 * beta + util::PI2);
-            m_ball.setAngle(delta);
-            smallAngleAvoid();
-          } else {
-            gamma = m_ball.getAngle() - util::PI;
-            GLfloat delta = std::fabs(gamma + 2 * beta - util::PI2);
-            m_ball.setAngle(util::PI2 - delta);
-            smallAngleAvoid();
-          }
+      GLfloat distance = new_x - m_bite.getXPose();
+      if (std::fabs(distance) >= m_bite.getDimens().quarterWidth()) {
+        // rounded end of bite, normal turns away from vertical by atan(distance / radius)
+        GLfloat radius = m_bite.getRadius();
+        GLfloat length = std::sqrt(distance * distance + radius * radius);
+        GLfloat normal_x = distance / length, normal_y = radius / length;
+        if (m_ball.getDirectionX() * normal_x + m_ball.getDirectionY() * normal_y < 0.0f) {
+          m_ball.reflect(normal_x, normal_y);
         }
-      } else if (new_x <= m_bite.getXPose() - m_bite.getDimens().quarterWidth()) {
-        GLfloat normal = std::fabs(util::PI2 + beta);
-        if (m_ball.getAngle() >= util::_3PI2) {
-          GLfloat gamma = m_ball.getAngle() - util::_3PI2;
-          if (gamma <= beta) {
-            GLfloat delta = std::fabs(gamma - 2 * beta + util::PI2);
-            m_ball.setAngle(util::PI - delta);
-            smallAngleAvoid();
-          } else {
-            gamma = util::_2PI - m_ball.getAngle();
-            GLfloat delta = std::fabs(gamma + 2 * beta - util::PI2);
-            m_ball.setAngle(util::PI2 + delta);
-            smallAngleAvoid();
-          }
-        } else if (m_ball.getAngle() >= util::PI) {
-          collideHorizontalSurface();
-          if (m_ball.getAngle() >= beta + util::PI2) {
-            m_ball.setAngle(m_ball.getAngle() - beta);
-          } else {
-            m_ball.setAngle(m_ball.getAngle() + beta);
-          }
-          smallAngleAvoid();
+        if (m_ball.getDirectionY() < 0.0f) {  // grazing hit, keep ball above bite
+          m_ball.setDirection(m_ball.getDirectionX(), -m_ball.getDirectionY());
         }
+        smallAngleAvoid();
       } else {
         collideHorizontalSurface();
       }
     }
-    m_ball.setAngle(std::fmod(std::fabs(m_ball.getAngle()), util::_2PI));
     onAngleChanged();
 
   } else {
@@ -754,78 +966,13 @@ bool GameProcessor::collideBite(GLfloat new_x) {
 }
 
 bool GameProcessor::collideBlock(GLfloat new_x, GLfloat new_y) {
-  if (new_y >= 1.0f - m_ball.getDimens().halfHeight() - m_level_dimens.getHeight() &&
-      new_y < 1.0f - m_ball.getDimens().halfHeight()) {
-    int row = 0, col = 0;
-    if (!getImpactedBlock(new_x, new_y, &row, &col)) {
-      return false;  // ball has left level boundaries
-    }
-
-    GLfloat top_border = 0.0f, bottom_border = 0.0f, left_border = 0.0f, right_border = 0.0f;
-    m_level_dimens.getBlockDimens(row, col, &top_border, &bottom_border, &left_border, &right_border);
-
-    // inner block collision correction
-    if (m_ball.getPose().getY() + 1.0f >= 2.0f - top_border - m_ball.getDimens().halfWidth()) {
-      if (m_ball.getPose().getX() + 1.0f <= left_border - m_ball.getDimens().halfWidth()) {
-        // upper left quadrant
-        Block top = row - 1 >= 0 ? m_level->getBlock(row - 1, col) : Block::TITAN;
-        Block left = col - 1 >= 0 ? m_level->getBlock(row, col - 1) : Block::TITAN;
-        if (top != Block::NONE && left != Block::NONE) {
-          auto top_distance = std::fabs(1.0f - top_border - m_ball.getPose().getY());
-          auto left_distance = std::fabs(left_border - m_ball.getPose().getX() - 1.0f);
-          if (top_distance <= left_distance && row - 1 >= 0) {
-            row -= 1;
-          } else if (top_distance > left_distance && col - 1 >= 0) {
-            col -= 1;
-          }
-        }
-      } else if (m_ball.getPose().getX() + 1.0f >= right_border + m_ball.getDimens().halfWidth()) {
-        // upper right quadrant
-        Block top = row - 1 >= 0 ? m_level->getBlock(row - 1, col) : Block::TITAN;
-        Block right = col + 1 < m_level->numCols() ? m_level->getBlock(row, col + 1) : Block::TITAN;
-        if (top != Block::NONE && right != Block::NONE) {
-          auto top_distance = std::fabs(1.0f - top_border - m_ball.getPose().getY());
-          auto right_distance = std::fabs(right_border - m_ball.getPose().getX() - 1.0f);
-          if (top_distance <= right_distance && row - 1 >= 0) {
-            row -= 1;
-          } else if (top_distance > right_distance && col + 1 < m_level->numCols()) {
-            col += 1;
-          }
-        }
-      }
-    } else if (m_ball.getPose().getY() + 1.0f <= 2.0f - bottom_border + m_ball.getDimens().halfWidth()) {
-      if (m_ball.getPose().getX() + 1.0f <= left_border - m_ball.getDimens().halfWidth()) {
-        // lower left quadrant
-        Block bottom = row + 1 < m_level->numRows() ? m_level->getBlock(row + 1, col) : Block::TITAN;
-        Block left = col - 1 >= 0 ? m_level->getBlock(row, col - 1) : Block::TITAN;
-        if (bottom != Block::NONE && left != Block::NONE) {
-          auto bottom_distance = std::fabs(1.0f - bottom_border - m_ball.getPose().getY());
-          auto left_distance = std::fabs(left_border - m_ball.getPose().getX() - 1.0f);
-          if (bottom_distance <= left_distance && row + 1 < m_level->numRows()) {
-            row += 1;
-          } else if (bottom_distance > left_distance && col - 1 >= 0) {
-            col -= 1;
-          }
-        }
-      } else if (m_ball.getPose().getX() + 1.0f >= right_border + m_ball.getDimens().halfWidth()) {
-        // lower right quadrant
-        Block bottom = row + 1 < m_level->numRows() ? m_level->getBlock(row + 1, col) : Block::TITAN;
-        Block right = col + 1 < m_level->numCols() ? m_level->getBlock(row, col + 1) : Block::TITAN;
-        if (bottom != Block::NONE && right != Block::NONE) {
-          auto bottom_distance = std::fabs(1.0f - bottom_border - m_ball.getPose().getY());
-          auto right_distance = std::fabs(right_border - m_ball.getPose().getX() - 1.0f);
-          if (bottom_distance <= right_distance && row + 1 < m_level->numRows()) {
-            row += 1;
-          } else if (bottom_distance > right_distance && col + 1 < m_level->numCols()) {
-            col += 1;
-          }
-        }
-      }
-    }  // end of inner block collision correction
-
-    Direction vertical_direction = Direction::NONE;
-    Direction horizontal_direction = Direction::NONE;
-    getCollisionDirection(top_border, bottom_border, left_border, right_border, &vertical_direction, &horizontal_direction);
+  Impact impact;
+  if (sweepBlocks(*m_level, m_level_dimens,
+                  m_ball.getDimens().halfWidth(), m_ball.getDimens().halfHeight(),
+                  m_ball.getPose().getX(), m_ball.getPose().getY(), new_x, new_y, &impact)) {
+    int row = impact.row, col = impact.col;
+    Direction vertical_direction = impact.vertical;
+    Direction horizontal_direction = impact.horizontal;
 
     std::vector<RowCol> affected_blocks;
     std::vector<RowCol> network_blocks;
@@ -865,7 +1012,7 @@ bool GameProcessor::collideBlock(GLfloat new_x, GLfloat new_y) {
         break;
       // --------------------
       case Block::ELECTRO:
-        external_collision = blockCollision(top_border, bottom_border, left_border, right_border, 100 /* elastic */);
+        external_collision = blockCollision(impact, 100 /* elastic */);
         score += m_level->destroyBlocksAround(row, col, &affected_blocks);
         explodeBlock(row, col, BlockUtils::getBlockColor(Block::ELECTRO), Kind::DIVERGE);
         for (auto& item : affected_blocks) {
@@ -875,7 +1022,7 @@ bool GameProcessor::collideBlock(GLfloat new_x, GLfloat new_y) {
         }
         break;
       case Block::KNOCK_VERTICAL:
-        external_collision = blockCollision(top_border, bottom_border, left_border, right_border, 100 /* elastic */);
+        external_collision = blockCollision(impact, 100 /* elastic */);
         score += m_level->destroyBlocksBehind(row, col, vertical_direction, &affected_blocks);
         if (vertical_direction != Direction::NONE) {
           explodeBlock(row, col, BlockUtils::getBlockColor(Block::KNOCK_VERTICAL), Kind::DIVERGE);
@@ -888,7 +1035,7 @@ bool GameProcessor::collideBlock(GLfloat new_x, GLfloat new_y) {
         }
         break;
       case Block::KNOCK_HORIZONTAL:
-        external_collision = blockCollision(top_border, bottom_border, left_border, right_border, 100 /* elastic */);
+        external_collision = blockCollision(impact, 100 /* elastic */);
         score += m_level->destroyBlocksBehind(row, col, horizontal_direction, &affected_blocks);
         if (horizontal_direction != Direction::NONE) {
           explodeBlock(row, col, BlockUtils::getBlockColor(Block::KNOCK_HORIZONTAL), Kind::DIVERGE);
@@ -901,7 +1048,7 @@ bool GameProcessor::collideBlock(GLfloat new_x, GLfloat new_y) {
         }
         break;
       case Block::MIDAS:
-        external_collision = blockCollision(top_border, bottom_border, left_border, right_border, 100 /* elastic */);
+        external_collision = blockCollision(impact, 100 /* elastic */);
         score += m_level->modifyBlocksAround(row, col, Block::TITAN, false, &affected_blocks);
         explodeBlock(row, col, BlockUtils::getBlockColor(Block::MIDAS), Kind::DIVERGE);
         for (auto& item : affected_blocks) {
@@ -911,7 +1058,7 @@ bool GameProcessor::collideBlock(GLfloat new_x, GLfloat new_y) {
         m_is_ball_death = true;
         break;
       case Block::NETWORK:
-        external_collision = blockCollision(top_border, bottom_border, left_border, right_border, 100 /* elastic */);
+        external_collision = blockCollision(impact, 100 /* elastic */);
         m_level->findBlocks(Block::NETWORK, &network_blocks);
         explodeBlock(row, col, BlockUtils::getBlockColor(Block::NETWORK), Kind::DIVERGE);
         spawnPrizeAtBlock(row, col, spawned_prize);
@@ -922,20 +1069,21 @@ bool GameProcessor::collideBlock(GLfloat new_x, GLfloat new_y) {
         break;
       // --------------------
       case Block::HYPER:
-        external_collision = blockCollision(top_border, bottom_border, left_border, right_border, 100 /* elastic */);
+        external_collision = blockCollision(impact, 100 /* elastic */);
         explodeBlock(row, col, BlockUtils::getBlockColor(Block::HYPER), Kind::CONVERGE);
         teleportBallIntoRandomBlock();
         break;
       case Block::ORIGIN:
-        external_collision = blockCollision(top_border, bottom_border, left_border, right_border, 100 /* elastic */);
+        external_collision = blockCollision(impact, 100 /* elastic */);
         explodeBlock(row, col, BlockUtils::getBlockColor(Block::ORIGIN), Kind::CONVERGE);
         stopBall();
+        m_balls.keepOnly(m_ball_index);
         correctBallPosition(m_bite.getXPose(), m_bite_upper_border + m_ball.getDimens().halfHeight());
         break;
       // --------------------
       case Block::ROLLING:
         viscosity = m_viscosity_distribution(m_generator);
-        external_collision = blockCollision(top_border, bottom_border, left_border, right_border, viscosity);
+        external_collision = blockCollision(impact, viscosity);
         spawnPrizeAtBlock(row, col, spawned_prize);
         break;
       // --------------------
@@ -953,12 +1101,12 @@ bool GameProcessor::collideBlock(GLfloat new_x, GLfloat new_y) {
         // intend no break
       case Block::CLAY:
         viscosity += 10;
-        external_collision = blockCollision(top_border, bottom_border, left_border, right_border, viscosity);
+        external_collision = blockCollision(impact, viscosity);
         spawnPrizeAtBlock(row, col, spawned_prize);
         break;
       // --------------------
       case Block::MAGIC:
-        external_collision = blockCollision(top_border, bottom_border, left_border, right_border, 100 /* elastic */);
+        external_collision = blockCollision(impact, 100 /* elastic */);
         score += m_level->modifyBlocksAround(row, col, generated_block, false, &affected_blocks);
         explodeBlock(row, col, BlockUtils::getBlockColor(generated_block), Kind::DIVERGE);
         for (auto& item : affected_blocks) {
@@ -966,7 +1114,7 @@ bool GameProcessor::collideBlock(GLfloat new_x, GLfloat new_y) {
         }
         break;
       case Block::QUICK_1:
-        external_collision = blockCollision(top_border, bottom_border, left_border, right_border, 100 /* elastic */);
+        external_collision = blockCollision(impact, 100 /* elastic */);
         score += m_level->changeBlocksAround(row, col, mode, &affected_blocks);
         explodeBlock(row, col, BlockUtils::getBlockColor(Block::QUICK_1), Kind::DIVERGE);
         spawnPrizeAtBlock(row, col, spawned_prize);
@@ -975,7 +1123,7 @@ bool GameProcessor::collideBlock(GLfloat new_x, GLfloat new_y) {
         }
         break;
       case Block::YOGURT:
-        external_collision = blockCollision(top_border, bottom_border, left_border, right_border, 50);
+        external_collision = blockCollision(impact, 50);
         score += m_level->modifyBlocksAround(row, col, Block::YOGURT_1, false, &affected_blocks);
         explodeBlock(row, col, BlockUtils::getBlockColor(Block::YOGURT), Kind::DIVERGE);
         spawnPrizeAtBlock(row, col, spawned_prize);
@@ -984,7 +1132,7 @@ bool GameProcessor::collideBlock(GLfloat new_x, GLfloat new_y) {
         }
         break;
       case Block::ZYGOTE_1:
-        external_collision = blockCollision(top_border, bottom_border, left_border, right_border, 100 /* elastic */);
+        external_collision = blockCollision(impact, 100 /* elastic */);
         if (m_level->modifyBlockNear(row, col, Block::ZYGOTE_SPAWN, &single_affected)) {
           explodeBlock(single_affected.row, single_affected.col, BlockUtils::getBlockColor(Block::ZYGOTE_SPAWN), Kind::CONVERGE);
           spawnPrizeAtBlock(row, col, spawned_prize);
@@ -997,11 +1145,11 @@ bool GameProcessor::collideBlock(GLfloat new_x, GLfloat new_y) {
         // intend no break
       case Block::TITAN:
       case Block::INVUL:
-        external_collision = blockCollision(top_border, bottom_border, left_border, right_border, 100 /* elastic */);
+        external_collision = blockCollision(impact, 100 /* elastic */);
         break;
     }  // end of block collision effect
 
-    score += performBallEffectAtBlock(row, col);
+    score += performBallEffectAtBlock(impact);
 #if DEBUG
     debugCollision(new_x, new_y, row, col, block);
 #endif  // DEBUG
@@ -1017,45 +1165,21 @@ bool GameProcessor::collideBlock(GLfloat new_x, GLfloat new_y) {
   return false;
 }
 
-bool GameProcessor::blockCollision(
-    GLfloat top_border,
-    GLfloat bottom_border,
-    GLfloat left_border,
-    GLfloat right_border,
-    int viscosity) {
-
-//  if (m_ball.getPose().getX() + 1.0f >= left_border + m_ball.getDimens().halfWidth() &&
-//      m_ball.getPose().getX() + 1.0f <= right_border - m_ball.getDimens().halfWidth() &&
-//      m_ball.getPose().getY() + 1.0f <= 2.0f - top_border + m_ball.getDimens().halfWidth() &&
-//      m_ball.getPose().getY() + 1.0f >= 2.0f - bottom_border - m_ball.getDimens().halfWidth()) {
-//    // inside block collision is erroneous
-//    WRN("Erroneous inside block collision detected! Cardinality not affected twice");
-//    return false;
-//  }
-
-  // surface collision
-  if (m_ball.getPose().getX() + 1.0f > left_border - m_ball.getDimens().halfWidth() &&
-      m_ball.getPose().getX() + 1.0f < right_border + m_ball.getDimens().halfWidth() &&
-      (m_ball.getPose().getY() + 1.0f >= 2.0f - top_border - m_ball.getDimens().halfWidth() ||
-       m_ball.getPose().getY() + 1.0f <= 2.0f - bottom_border + m_ball.getDimens().halfWidth())) {
+bool GameProcessor::blockCollision(const Impact& impact, int viscosity) {
+  if (impact.isCorner()) {
+    INF("Corner collision");
+    randomAngle();
+  } else if (impact.vertical != Direction::NONE) {  // surface collision
     collideHorizontalSurface();
     viscousAngleDisturbance(viscosity);
-    return true;
-  }
-  // right border collision from left direction
-  if (m_ball.getPose().getX() + 1.0f <= left_border - m_ball.getDimens().halfWidth()) {
+  } else if (impact.horizontal == Direction::RIGHT) {  // right border collision from left direction
     collideRightBorder();
     viscousAngleDisturbance(viscosity);
-    return true;
-  }
-  // left border collision from right direction
-  if (m_ball.getPose().getX() + 1.0f >= right_border + m_ball.getDimens().halfWidth()) {
+  } else {  // left border collision from right direction
     collideLeftBorder();
     viscousAngleDisturbance(viscosity);
-    return true;
   }
-  INF("Corner collision");
-  randomAngle();
+  correctBallPosition(impact.x, impact.y);
   return true;
 }
 
@@ -1209,71 +1333,36 @@ void GameProcessor::getCenterOfBlock(int row, int col, GLfloat* x, GLfloat* y) {
   *y = -0.5f * (bottom_border + top_border) + 1.0f;
 }
 
-void GameProcessor::getCollisionDirection(
-    GLfloat top_border,
-    GLfloat bottom_border,
-    GLfloat left_border,
-    GLfloat right_border,
-    Direction* vertical_direction,
-    Direction* horizontal_direction) {
-
-  *vertical_direction = Direction::NONE;
-  *horizontal_direction = Direction::NONE;
-  if (m_ball.getPose().getX() + 1.0f > left_border &&
-      m_ball.getPose().getX() + 1.0f < right_border) {
-    if (m_ball.getPose().getY() >= 1.0f - top_border) {
-      *vertical_direction = Direction::DOWN;
-    } else if (m_ball.getPose().getY() <= 1.0f - bottom_border) {
-      *vertical_direction = Direction::UP;
-    }
-  }
-  if (m_ball.getPose().getX() + 1.0f <= left_border) {
-    *horizontal_direction = Direction::RIGHT;
-  } else if (m_ball.getPose().getX() + 1.0f >= right_border) {
-    *horizontal_direction = Direction::LEFT;
-  }
-}
-
 void GameProcessor::correctBallPosition(GLfloat new_x, GLfloat new_y) {
   shiftBall(new_x, new_y);
   m_ball_pose_corrected = true;
 }
 
 void GameProcessor::smallAngleAvoid() {
-  if (m_ball.getAngle() <= util::PI16) {
-    m_ball.setAngle(m_ball.getAngle() + util::PI16);
-  } else if (m_ball.getAngle() >= util::_2PI - util::PI16) {
-    m_ball.setAngle(m_ball.getAngle() - util::PI16);
-  } else if (m_ball.getAngle() >= util::PI - util::PI16 && m_ball.getAngle() <= util::PI) {
-    m_ball.setAngle(m_ball.getAngle() - util::PI16);
-  } else if (m_ball.getAngle() > util::PI && m_ball.getAngle() <= util::PI + util::PI16) {
-    m_ball.setAngle(m_ball.getAngle() + util::PI16);
-  } else if (m_ball.getAngle() <= util::PI2 + util::PI16 && m_ball.getAngle() >= util::PI2) {
-    m_ball.setAngle(m_ball.getAngle() + util::PI16);
-  } else if (m_ball.getAngle() >= util::PI2 - util::PI16 && m_ball.getAngle() < util::PI2) {
-    m_ball.setAngle(m_ball.getAngle() - util::PI16);
-  } else if (m_ball.getAngle() >= util::_3PI2 && m_ball.getAngle() <= util::_3PI2 + util::PI16) {
-    m_ball.setAngle(m_ball.getAngle() + util::PI16);
-  } else if (m_ball.getAngle() < util::_3PI2 && m_ball.getAngle() >= util::_3PI2 - util::PI16) {
-    m_ball.setAngle(m_ball.getAngle() - util::PI16);
+  // direction within PI / 16 of either axis is turned away from it by PI / 16
+  constexpr GLfloat sin_turn = 0.19509032f;
+  constexpr GLfloat cos_turn = 0.98078528f;
+  bool same_signs = (m_ball.getDirectionX() >= 0.0f) == (m_ball.getDirectionY() >= 0.0f);
+  if (std::fabs(m_ball.getDirectionY()) <= sin_turn) {  // nearly horizontal
+    m_ball.rotate(cos_turn, same_signs ? sin_turn : -sin_turn);
+  } else if (std::fabs(m_ball.getDirectionX()) <= sin_turn) {  // nearly vertical
+    m_ball.rotate(cos_turn, same_signs ? -sin_turn : sin_turn);
   }
   onAngleChanged();
 }
 
 void GameProcessor::randomAngle() {
   std::normal_distribution<float> init_angle_distribution(util::PI4, util::PI12);
-  m_ball.setAngle(init_angle_distribution(m_generator));
-  m_ball.setAngle(m_ball.getAngle() + (m_direction_distribution(m_generator) ? 0.0f : util::PI2));
-  m_ball.setAngle(std::fmod(m_ball.getAngle(), util::_2PI));
+  GLfloat angle = init_angle_distribution(m_generator);
+  m_ball.setAngle(angle + (m_direction_distribution(m_generator) ? 0.0f : util::PI2));
   onAngleChanged();
 }
 
 void GameProcessor::viscousAngleDisturbance(int viscosity) {
   if (viscosity != 0 && viscosity != 100) {
     GLfloat direction = m_direction_distribution(m_generator) ? 1.0f : -1.0f;
-    m_ball.setAngle(m_ball.getAngle() + (direction * m_angle_distribution(m_generator) / 100.0f * viscosity));
-    GLfloat sign = m_ball.getAngle() >= 0.0f ? 1.0f : -1.0f;
-    m_ball.setAngle(sign * std::fmod(std::fabs(m_ball.getAngle()), util::_2PI));
+    GLfloat turn = direction * m_angle_distribution(m_generator) / 100.0f * viscosity;
+    m_ball.rotate(std::cos(turn), std::sin(turn));
     smallAngleAvoid();
     onAngleChanged();
   }
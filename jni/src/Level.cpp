@@ -16,29 +16,22 @@
 namespace game {
 
 Level::Ptr Level::fromStringArray(const std::vector<std::string>& array, size_t length) {
-  size_t* widths = new size_t[length];
-  for (size_t i = 0; i < length; ++i) {
-    widths[i] = array[i].length();
-  }
   // all strings which are less than the longer one will be populated
   // with blank characters
-  size_t max_width = *std::max_element(widths, widths + length);
+  size_t max_width = 0;
+  for (size_t i = 0; i < length; ++i) {
+    max_width = std::max(max_width, array[i].length());
+  }
 
   Level::Ptr level = std::shared_ptr<Level>(new Level(length, max_width));
   for (int r = 0; r < level->rows; ++r) {
-    for (int c = 0; c < level->cols; ++c) {
-      if (c < widths[r]) {
-        level->blocks[r][c] = BlockUtils::charToBlock(array[r][c]);
-      } else {
-        level->blocks[r][c] = Block::NONE;
-      }
+    const std::string& line = array[r];
+    uint8_t* row = &level->blocks[r * level->cols];
+    for (size_t c = 0; c < line.length(); ++c) {
+      row[c] = static_cast<uint8_t>(BlockUtils::charToBlock(line[c]));
     }
   }
-  level->initial_cardinality = level->calculateCardinality();
-
-  delete [] widths;
-  widths = nullptr;
-
+  level->groupCells();
   return level;
 }
 
@@ -46,13 +39,67 @@ size_t Level::toStringArray(std::vector<std::string>* array) const {
   for (int r = 0; r < rows; ++r) {
     std::string line = "";
     for (int c = 0; c < cols; ++c) {
-      line += BlockUtils::blockToChar(blocks[r][c]);
+      line += BlockUtils::blockToChar(getBlock(r, c));
     }
     array->emplace_back(line);
   }
   return rows;
 }
 
+Level::Ptr Level::fromString(const char* text, char separator) {
+  // first pass measures rows, second one decodes them in place
+  int length = 0, max_width = 0, width = 0;
+  for (const char* it = text; ; ++it) {
+    if (*it == separator || *it == '\0') {
+      if (width > 0) {
+        ++length;
+        max_width = std::max(max_width, width);
+      }
+      width = 0;
+      if (*it == '\0') {
+        break;
+      }
+    } else {
+      ++width;
+    }
+  }
+
+  Level::Ptr level = std::shared_ptr<Level>(new Level(length, max_width));
+  uint8_t* row = level->blocks.data();
+  width = 0;
+  for (const char* it = text; *it != '\0'; ++it) {
+    if (*it != separator) {
+      row[width++] = static_cast<uint8_t>(BlockUtils::charToBlock(*it));
+    } else if (width > 0) {
+      row += level->cols;
+      width = 0;
+    }
+  }
+  level->groupCells();
+  return level;
+}
+
+std::string Level::toString(char separator) const {
+  std::string text;
+  text.reserve(rows * (cols + 1));
+  for (int r = 0; r < rows; ++r) {
+    if (r > 0) {
+      text += separator;
+    }
+    for (int c = 0; c < cols; ++c) {
+      text += BlockUtils::blockToChar(getBlock(r, c));
+    }
+  }
+  return text;
+}
+
+Level::Ptr Level::fromGrid(const uint8_t* grid, int rows, int cols) {
+  Level::Ptr level = std::shared_ptr<Level>(new Level(rows, cols));
+  std::copy(grid, grid + rows * cols, level->blocks.begin());
+  level->groupCells();
+  return level;
+}
+
 void Level::toVertexArray(
     GLfloat width,
     GLfloat height,
@@ -77,8 +124,9 @@ void Level::fillColorArrayAtBlock(GLfloat* const array, int row, int col) const
   int lower_left_i  = 8  + 16 * (row * cols + col);
   int lower_right_i = 12 + 16 * (row * cols + col);
 
-  util::BGRA<GLfloat> bgra = BlockUtils::getBlockColor(blocks[row][col]);
-  util::BGRA<GLfloat> bgra_edge = BlockUtils::getBlockEdgeColor(blocks[row][col]);
+  Block block = getBlock(row, col);
+  util::BGRA<GLfloat> bgra = BlockUtils::getBlockColor(block);
+  util::BGRA<GLfloat> bgra_edge = BlockUtils::getBlockEdgeColor(block);
 
   util::setColor(bgra, &array[upper_left_i], 4);
   util::setColor(bgra_edge, &array[upper_right_i], 4);
@@ -86,83 +134,90 @@ void Level::fillColorArrayAtBlock(GLfloat* const array, int row, int col) const
   util::setColor(bgra_edge, &array[lower_right_i], 4);
 }
 
+void Level::setBlock(int row, int col, Block value) {
+  int index = row * cols + col;
+  int previous = blocks[index];
+  int next = static_cast<int>(value);
+  if (previous == next) {
+    return;
+  }
+  blocks[index] = static_cast<uint8_t>(next);
+  cardinality += BlockUtils::getCardinalityCost(value) - BlockUtils::getCardinalityCost(static_cast<Block>(previous));
+  // move cell across boundaries of groups in between, one swap per group
+  for (int type = previous; type < next; ++type) {
+    swapCells(positions[index], --offsets[type + 1]);
+  }
+  for (int type = previous; type > next; --type) {
+    swapCells(positions[index], offsets[type]++);
+  }
+}
+
 void Level::setVulnerableBlock(int row, int col, Block value) {
-  if (blocks[row][col] != Block::TITAN &&
-      blocks[row][col] != Block::INVUL) {
+  Block block = getBlock(row, col);
+  if (block != Block::TITAN &&
+      block != Block::INVUL) {
     setBlock(row, col, value);
-    initial_cardinality += BlockUtils::getCardinalityCost(value);
   }
 }
 
 void Level::changeVulnerableBlock(Mode mode, int row, int col) {
+  Block block = getBlock(row, col);
   switch (mode) {
     case Mode::UPGRADE:
-      switch (blocks[row][col]) {
+      switch (block) {
         case Block::ALUMINIUM:
         case Block::CLAY:
         case Block::SIMPLE:
         case Block::ZYGOTE_SPAWN:
           setBlock(row, col, Block::BRICK);
-          initial_cardinality += BlockUtils::getCardinalityCost(Block::BRICK);
           break;
         case Block::FOG:
           setBlock(row, col, Block::GLASS);
-          initial_cardinality += BlockUtils::getCardinalityCost(Block::GLASS);
           break;
         case Block::BRICK:
           setBlock(row, col, Block::IRON);
-          initial_cardinality += BlockUtils::getCardinalityCost(Block::IRON);
           break;
         case Block::IRON:
         case Block::STEEL:
           setBlock(row, col, Block::PLUMBUM);
-          initial_cardinality += BlockUtils::getCardinalityCost(Block::PLUMBUM);
           break;
         case Block::WATER:
           setBlock(row, col, Block::JELLY);
-          initial_cardinality += BlockUtils::getCardinalityCost(Block::JELLY);
           break;
         case Block::JELLY:
           setBlock(row, col, Block::ROLLING);
-          initial_cardinality += BlockUtils::getCardinalityCost(Block::ROLLING);
           break;
         default:
-          initial_cardinality += BlockUtils::getCardinalityCost(blocks[row][col]);
           break;
       }
       break;
       case Mode::DEGRADE:
-        switch (blocks[row][col]) {
+        switch (block) {
           case Block::GLASS:
             setBlock(row, col, Block::FOG);
-            initial_cardinality += BlockUtils::getCardinalityCost(Block::FOG);
             break;
           case Block::BRICK:
             setBlock(row, col, Block::SIMPLE);
-            initial_cardinality += BlockUtils::getCardinalityCost(Block::SIMPLE);
             break;
           case Block::IRON:
           case Block::STEEL:
             setBlock(row, col, Block::BRICK);
-            initial_cardinality += BlockUtils::getCardinalityCost(Block::BRICK);
             break;
           case Block::PLUMBUM:
             setBlock(row, col, Block::IRON);
-            initial_cardinality += BlockUtils::getCardinalityCost(Block::IRON);
             break;
           case Block::ROLLING:
             setBlock(row, col, Block::JELLY);
-            initial_cardinality += BlockUtils::getCardinalityCost(Block::JELLY);
             break;
           case Block::JELLY:
             setBlock(row, col, Block::WATER);
-            initial_cardinality += BlockUtils::getCardinalityCost(Block::WATER);
             break;
           default:
-            initial_cardinality += BlockUtils::getCardinalityCost(blocks[row][col]);
             break;
         }
         break;
+      case Mode::NONE:
+        break;
   }
 }
 
@@ -171,7 +226,6 @@ int Level::destroyVulnerableBlock(int row, int col) {
   Block block = getBlock(row, col);
   if (block != Block::TITAN && block != Block::INVUL) {
     score += BlockUtils::getCardinalityCost(block);
-    initial_cardinality -= BlockUtils::getCardinalityCost(block);
     setBlock(row, col, Block::NONE);
   }
   return score;
@@ -308,7 +362,6 @@ int Level::modifyBlocksAround(int row, int col, Block type, bool ignoreNone, std
   int score = 0;
   if (row - 2 >= 0) {
     Block block = getBlock(row - 2, col);
-    initial_cardinality -= BlockUtils::getCardinalityCost(block);
     score += BlockUtils::getBlockScore(block);
     setVulnerableBlock(row - 2, col, type);
     if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
@@ -318,7 +371,6 @@ int Level::modifyBlocksAround(int row, int col, Block type, bool ignoreNone, std
 
   if (row - 1 >= 0) {
     Block block = getBlock(row - 1, col);
-    initial_cardinality -= BlockUtils::getCardinalityCost(block);
     score += BlockUtils::getBlockScore(block);
     setVulnerableBlock(row - 1, col, type);
     if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
@@ -326,7 +378,6 @@ int Level::modifyBlocksAround(int row, int col, Block type, bool ignoreNone, std
     }
     if (col - 1 >= 0) {
       Block block = getBlock(row - 1, col - 1);
-      initial_cardinality -= BlockUtils::getCardinalityCost(block);
       score += BlockUtils::getBlockScore(block);
       setVulnerableBlock(row - 1, col - 1, type);
       if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
@@ -335,7 +386,6 @@ int Level::modifyBlocksAround(int row, int col, Block type, bool ignoreNone, std
     }
     if (col + 1 < cols) {
       Block block = getBlock(row - 1, col + 1);
-      initial_cardinality -= BlockUtils::getCardinalityCost(block);
       score += BlockUtils::getBlockScore(block);
       setVulnerableBlock(row - 1, col + 1, type);
       if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
@@ -346,7 +396,6 @@ int Level::modifyBlocksAround(int row, int col, Block type, bool ignoreNone, std
 
   if (row + 1 < rows) {
     Block block = getBlock(row + 1, col);
-    initial_cardinality -= BlockUtils::getCardinalityCost(block);
     score += BlockUtils::getBlockScore(block);
     setVulnerableBlock(row + 1, col, type);
     if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
@@ -354,7 +403,6 @@ int Level::modifyBlocksAround(int row, int col, Block type, bool ignoreNone, std
     }
     if (col - 1 >= 0) {
       Block block = getBlock(row + 1, col - 1);
-      initial_cardinality -= BlockUtils::getCardinalityCost(block);
       score += BlockUtils::getBlockScore(block);
       setVulnerableBlock(row + 1, col - 1, type);
       if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
@@ -363,7 +411,6 @@ int Level::modifyBlocksAround(int row, int col, Block type, bool ignoreNone, std
     }
     if (col + 1 < cols) {
       Block block = getBlock(row + 1, col + 1);
-      initial_cardinality -= BlockUtils::getCardinalityCost(block);
       score += BlockUtils::getBlockScore(block);
       setVulnerableBlock(row + 1, col + 1, type);
       if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
@@ -374,7 +421,6 @@ int Level::modifyBlocksAround(int row, int col, Block type, bool ignoreNone, std
 
   if (row + 2 < rows) {
     Block block = getBlock(row + 2, col);
-    initial_cardinality -= BlockUtils::getCardinalityCost(block);
     score += BlockUtils::getBlockScore(block);
     setVulnerableBlock(row + 2, col, type);
     if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
@@ -385,7 +431,6 @@ int Level::modifyBlocksAround(int row, int col, Block type, bool ignoreNone, std
   // ------------------------
   if (col - 2 >= 0) {
     Block block = getBlock(row, col - 2);
-    initial_cardinality -= BlockUtils::getCardinalityCost(block);
     score += BlockUtils::getBlockScore(block);
     setVulnerableBlock(row, col - 2, type);
     if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
@@ -394,7 +439,6 @@ int Level::modifyBlocksAround(int row, int col, Block type, bool ignoreNone, std
   }
   if (col - 1 >= 0) {
     Block block = getBlock(row, col - 1);
-    initial_cardinality -= BlockUtils::getCardinalityCost(block);
     score += BlockUtils::getBlockScore(block);
     setVulnerableBlock(row, col - 1, type);
     if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
@@ -403,7 +447,6 @@ int Level::modifyBlocksAround(int row, int col, Block type, bool ignoreNone, std
   }
   if (col + 1 < cols) {
     Block block = getBlock(row, col + 1);
-    initial_cardinality -= BlockUtils::getCardinalityCost(block);
     score += BlockUtils::getBlockScore(block);
     setVulnerableBlock(row, col + 1, type);
     if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
@@ -412,7 +455,6 @@ int Level::modifyBlocksAround(int row, int col, Block type, bool ignoreNone, std
   }
   if (col + 2 < cols) {
     Block block = getBlock(row, col + 2);
-    initial_cardinality -= BlockUtils::getCardinalityCost(block);
     score += BlockUtils::getBlockScore(block);
     setVulnerableBlock(row, col + 2, type);
     if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
@@ -426,7 +468,6 @@ int Level::changeBlocksAround(int row, int col, Mode mode, std::vector<RowCol>*
   int score = 0;
   if (row - 2 >= 0) {
     Block block = getBlock(row - 2, col);
-    initial_cardinality -= BlockUtils::getCardinalityCost(block);
     score += BlockUtils::getBlockScore(block);
     changeVulnerableBlock(mode, row - 2, col);
     output->emplace_back(row - 2, col);
@@ -434,20 +475,17 @@ int Level::changeBlocksAround(int row, int col, Mode mode, std::vector<RowCol>*
 
   if (row - 1 >= 0) {
     Block block = getBlock(row - 1, col);
-    initial_cardinality -= BlockUtils::getCardinalityCost(block);
     score += BlockUtils::getBlockScore(block);
     changeVulnerableBlock(mode, row - 1, col);
     output->emplace_back(row - 1, col);
     if (col - 1 >= 0) {
       Block block = getBlock(row - 1, col - 1);
-      initial_cardinality -= BlockUtils::getCardinalityCost(block);
       score += BlockUtils::getBlockScore(block);
       changeVulnerableBlock(mode, row - 1, col - 1);
       output->emplace_back(row - 1, col - 1);
     }
     if (col + 1 < cols) {
       Block block = getBlock(row - 1, col + 1);
-      initial_cardinality -= BlockUtils::getCardinalityCost(block);
       score += BlockUtils::getBlockScore(block);
       changeVulnerableBlock(mode, row - 1, col + 1);
       output->emplace_back(row - 1, col + 1);
@@ -456,20 +494,17 @@ int Level::changeBlocksAround(int row, int col, Mode mode, std::vector<RowCol>*
 
   if (row + 1 < rows) {
     Block block = getBlock(row + 1, col);
-    initial_cardinality -= BlockUtils::getCardinalityCost(block);
     score += BlockUtils::getBlockScore(block);
     changeVulnerableBlock(mode, row + 1, col);
     output->emplace_back(row + 1, col);
     if (col - 1 >= 0) {
       Block block = getBlock(row + 1, col - 1);
-      initial_cardinality -= BlockUtils::getCardinalityCost(block);
       score += BlockUtils::getBlockScore(block);
       changeVulnerableBlock(mode, row + 1, col - 1);
       output->emplace_back(row + 1, col - 1);
     }
     if (col + 1 < cols) {
       Block block = getBlock(row + 1, col + 1);
-      initial_cardinality -= BlockUtils::getCardinalityCost(block);
       score += BlockUtils::getBlockScore(block);
       changeVulnerableBlock(mode, row + 1, col + 1);
       output->emplace_back(row + 1, col + 1);
@@ -478,7 +513,6 @@ int Level::changeBlocksAround(int row, int col, Mode mode, std::vector<RowCol>*
 
   if (row + 2 < rows) {
     Block block = getBlock(row + 2, col);
-    initial_cardinality -= BlockUtils::getCardinalityCost(block);
     score += BlockUtils::getBlockScore(block);
     changeVulnerableBlock(mode, row + 2, col);
     output->emplace_back(row + 2, col);
@@ -487,28 +521,24 @@ int Level::changeBlocksAround(int row, int col, Mode mode, std::vector<RowCol>*
   // ------------------------
   if (col - 2 >= 0) {
     Block block = getBlock(row, col - 2);
-    initial_cardinality -= BlockUtils::getCardinalityCost(block);
     score += BlockUtils::getBlockScore(block);
     changeVulnerableBlock(mode, row, col - 2);
     output->emplace_back(row, col - 2);
   }
   if (col - 1 >= 0) {
     Block block = getBlock(row, col - 1);
-    initial_cardinality -= BlockUtils::getCardinalityCost(block);
     score += BlockUtils::getBlockScore(block);
     changeVulnerableBlock(mode, row, col - 1);
     output->emplace_back(row, col - 1);
   }
   if (col + 1 < cols) {
     Block block = getBlock(row, col + 1);
-    initial_cardinality -= BlockUtils::getCardinalityCost(block);
     score += BlockUtils::getBlockScore(block);
     changeVulnerableBlock(mode, row, col + 1);
     output->emplace_back(row, col + 1);
   }
   if (col + 2 < cols) {
     Block block = getBlock(row, col + 2);
-    initial_cardinality -= BlockUtils::getCardinalityCost(block);
     score += BlockUtils::getBlockScore(block);
     changeVulnerableBlock(mode, row, col + 2);
     output->emplace_back(row, col + 2);
@@ -527,7 +557,6 @@ int Level::modifyBlocksBehind(int row, int col, Block type, bool ignoreNone, Dir
       --row;
       while (row >= 0) {
         Block block = getBlock(row, col);
-        initial_cardinality -= BlockUtils::getCardinalityCost(block);
         score += BlockUtils::getBlockScore(block);
         setVulnerableBlock(row, col, type);
         if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
@@ -540,7 +569,6 @@ int Level::modifyBlocksBehind(int row, int col, Block type, bool ignoreNone, Dir
       ++row;
       while (row < rows) {
         Block block = getBlock(row, col);
-        initial_cardinality -= BlockUtils::getCardinalityCost(block);
         score += BlockUtils::getBlockScore(block);
         setVulnerableBlock(row, col, type);
         if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
@@ -553,7 +581,6 @@ int Level::modifyBlocksBehind(int row, int col, Block type, bool ignoreNone, Dir
       ++col;
       while (col < cols) {
         Block block = getBlock(row, col);
-        initial_cardinality -= BlockUtils::getCardinalityCost(block);
         score += BlockUtils::getBlockScore(block);
         setVulnerableBlock(row, col, type);
         if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
@@ -566,7 +593,6 @@ int Level::modifyBlocksBehind(int row, int col, Block type, bool ignoreNone, Dir
       --col;
       while (col >= 0) {
         Block block = getBlock(row, col);
-        initial_cardinality -= BlockUtils::getCardinalityCost(block);
         score += BlockUtils::getBlockScore(block);
         setVulnerableBlock(row, col, type);
         if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
@@ -589,7 +615,6 @@ int Level::modifyOneBlockBehind(int row, int col, Block type, bool ignoreNone, D
       --row;
       if (row >= 0) {
         Block block = getBlock(row, col);
-        initial_cardinality -= BlockUtils::getCardinalityCost(block);
         score += BlockUtils::getBlockScore(block);
         setVulnerableBlock(row, col, type);
         if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
@@ -601,7 +626,6 @@ int Level::modifyOneBlockBehind(int row, int col, Block type, bool ignoreNone, D
       ++row;
       if (row < rows) {
         Block block = getBlock(row, col);
-        initial_cardinality -= BlockUtils::getCardinalityCost(block);
         score += BlockUtils::getBlockScore(block);
         setVulnerableBlock(row, col, type);
         if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
@@ -613,7 +637,6 @@ int Level::modifyOneBlockBehind(int row, int col, Block type, bool ignoreNone, D
       ++col;
       if (col < cols) {
         Block block = getBlock(row, col);
-        initial_cardinality -= BlockUtils::getCardinalityCost(block);
         score += BlockUtils::getBlockScore(block);
         setVulnerableBlock(row, col, type);
         if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
@@ -625,7 +648,6 @@ int Level::modifyOneBlockBehind(int row, int col, Block type, bool ignoreNone, D
       --col;
       if (col >= 0) {
         Block block = getBlock(row, col);
-        initial_cardinality -= BlockUtils::getCardinalityCost(block);
         score += BlockUtils::getBlockScore(block);
         setVulnerableBlock(row, col, type);
         if (!(ignoreNone && (block == Block::NONE || block == Block::TITAN || block == Block::INVUL))) {
@@ -727,12 +749,12 @@ void Level::findBlocks(Block type, std::vector<RowCol>* output) {
 }
 
 void Level::findBlocksAllowNone(Block type, std::vector<RowCol>* output) {
-  for (int r = 0; r < rows; ++r) {
-    for (int c = 0; c < cols; ++c) {
-      if (blocks[r][c] == type) {
-        output->emplace_back(r, c);
-      }
-    }
+  int begin = offsets[static_cast<int>(type)];
+  int end = offsets[static_cast<int>(type) + 1];
+  sortGroup(begin, end);
+  output->reserve(output->size() + end - begin);
+  for (int i = begin; i < end; ++i) {
+    output->emplace_back(cells[i] / cols, cells[i] % cols);
   }
 }
 
@@ -743,12 +765,12 @@ void Level::findBlocksBackward(Block type, std::vector<RowCol>* output) {
 }
 
 void Level::findBlocksBackwardAllowNone(Block type, std::vector<RowCol>* output) {
-  for (int r = rows - 1; r >= 0; --r) {
-    for (int c = cols - 1; c >= 0; --c) {
-      if (blocks[r][c] == type) {
-        output->emplace_back(r, c);
-      }
-    }
+  int begin = offsets[static_cast<int>(type)];
+  int end = offsets[static_cast<int>(type) + 1];
+  sortGroup(begin, end);
+  output->reserve(output->size() + end - begin);
+  for (int i = end - 1; i >= begin; --i) {
+    output->emplace_back(cells[i] / cols, cells[i] % cols);
   }
 }
 
@@ -758,20 +780,37 @@ Block Level::generatePresentBlock() {
     return block;
   }
 
-  bool is_present = false;
   do {
     block = generator.generateBlock();
-    for (int r = 0; r < rows; ++r) {
-      for (int c = 0; c < cols; ++c) {
-        if (blocks[r][c] == block) {
-          is_present = true;
-        }
-      }
-    }
-  } while (!is_present);
+  } while (countBlocks(block) == 0);
   return block;
 }
 
+bool Level::verify() const {
+  int recount[BlockUtils::totalBlocks] = {0};
+  bool valid = true;
+  for (int index = 0; index < rows * cols; ++index) {
+    int type = blocks[index];
+    ++recount[type];
+    int position = positions[index];
+    if (cells[position] != index || position < offsets[type] || position >= offsets[type + 1]) {
+      ERR("Cell %i of block %i is misplaced in group of cells", index, type);
+      valid = false;
+    }
+  }
+  for (int type = 0; type < BlockUtils::totalBlocks; ++type) {
+    if (recount[type] != countBlocks(static_cast<Block>(type))) {
+      ERR("Block %i: %i cells recounted, %i recorded", type, recount[type], countBlocks(static_cast<Block>(type)));
+      valid = false;
+    }
+  }
+  if (calculateCardinality() != cardinality) {
+    ERR("Cardinality %i recounted, %i recorded", calculateCardinality(), cardinality);
+    valid = false;
+  }
+  return valid;
+}
+
 void Level::print() const {
   std::vector<std::string> array;
   array.reserve(rows);
@@ -786,40 +825,66 @@ void Level::print() const {
 Level::Level(int rows, int cols)
   : rows(rows)
   , cols(cols)
-  , initial_cardinality(0)
-  , blocks(new Block*[rows])
+  , cardinality(0)
+  , cardinality_dropped(false)
+  , blocks(rows * cols, static_cast<uint8_t>(Block::NONE))
+  , cells(rows * cols)
+  , positions(rows * cols)
   , generator()
   , prize_generator() {
-  for (int r = 0; r < rows; ++r) {
-    blocks[r] = new Block[cols];
+  // cells are grouped by factories, once blocks are filled
+}
+
+int Level::calculateCardinality() const {
+  int cardinality = 0;
+  for (int index = 0; index < rows * cols; ++index) {
+    cardinality += BlockUtils::getCardinalityCost(static_cast<Block>(blocks[index]));
   }
+  return cardinality;
 }
 
-Level::~Level() {
-  for (int r = 0; r < rows; ++r) {
-    delete [] blocks[r];
-    blocks[r] = nullptr;
+void Level::groupCells() {
+  // counting sort of cells by type, row-major within every group
+  std::fill(offsets, offsets + BlockUtils::totalBlocks + 1, 0);
+  for (int index = 0; index < rows * cols; ++index) {
+    ++offsets[blocks[index] + 1];
+  }
+  for (int type = 0; type < BlockUtils::totalBlocks; ++type) {
+    offsets[type + 1] += offsets[type];
+  }
+  int next[BlockUtils::totalBlocks];
+  std::copy(offsets, offsets + BlockUtils::totalBlocks, next);
+  for (int index = 0; index < rows * cols; ++index) {
+    int position = next[blocks[index]]++;
+    cells[position] = index;
+    positions[index] = position;
+  }
+  cardinality = 0;
+  for (int type = 0; type < BlockUtils::totalBlocks; ++type) {
+    cardinality += countBlocks(static_cast<Block>(type)) * BlockUtils::getCardinalityCost(static_cast<Block>(type));
   }
-  delete [] blocks;
-  blocks = nullptr;
 }
 
-int Level::calculateCardinality() const {
-  int cardinality = 0;
-  for (int r = 0; r < rows; ++r) {
-    for (int c = 0; c < cols; ++c) {
-      cardinality += BlockUtils::getCardinalityCost(blocks[r][c]);
+void Level::sortGroup(int begin, int end) {
+  // swaps of setBlock() shuffle a group, lookups give row-major order back
+  if (!std::is_sorted(cells.begin() + begin, cells.begin() + end)) {
+    std::sort(cells.begin() + begin, cells.begin() + end);
+    for (int i = begin; i < end; ++i) {
+      positions[cells[i]] = i;
     }
   }
-  return cardinality;
+}
+
+void Level::swapCells(int lhs, int rhs) {
+  std::swap(cells[lhs], cells[rhs]);
+  positions[cells[lhs]] = lhs;
+  positions[cells[rhs]] = rhs;
 }
 
 bool Level::checkOrdinaryBlocksPresent() const {
-  for (int r = 0; r < rows; ++r) {
-    for (int c = 0; c < cols; ++c) {
-      if (BlockUtils::isOrdinaryBlock(blocks[r][c])) {
-        return true;
-      }
+  for (int type = 0; type < BlockUtils::totalBlocks; ++type) {
+    if (countBlocks(static_cast<Block>(type)) > 0 && BlockUtils::isOrdinaryBlock(static_cast<Block>(type))) {
+      return true;
     }
   }
   return false;
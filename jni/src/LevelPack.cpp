@@ -0,0 +1,138 @@
+#include <cstring>
+
+#include "LevelPack.h"
+#include "logger.h"
+
+namespace game {
+
+namespace {
+
+const char packMagic[4] = {'A', 'R', 'K', 'L'};
+const uint8_t packVersion = 1;
+const size_t headerSize = 16;
+const size_t entrySize = 16;
+
+uint16_t readU16(const uint8_t* data) {
+  return static_cast<uint16_t>(data[0] | (data[1] << 8));
+}
+
+uint32_t readU32(const uint8_t* data) {
+  return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+      (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+
+void writeU16(uint16_t value, std::vector<uint8_t>* output) {
+  for (int i = 0; i < 2; ++i) { output->push_back(value >> (8 * i)); }
+}
+
+void writeU32(uint32_t value, std::vector<uint8_t>* output) {
+  for (int i = 0; i < 4; ++i) { output->push_back(value >> (8 * i)); }
+}
+
+uint32_t checksum(const uint8_t* data, size_t size) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ data[i]) * 16777619u;
+  }
+  return hash;
+}
+
+}  // namespace
+
+LevelPack::LevelPack()
+  : m_view()
+  , m_size(0) {
+}
+
+bool LevelPack::open(AssetView&& view) {
+  m_view.release();
+  m_size = 0;
+  const uint8_t* data = view.data();
+  size_t size = view.size();
+  if (size < headerSize || std::memcmp(data, packMagic, 4) != 0 || data[4] != packVersion) {
+    ERR("Not a level pack of version %i", packVersion);
+    return false;
+  }
+  uint32_t levels = readU32(data + 8);
+  if (readU32(data + 12) != size || levels > (size - headerSize) / entrySize) {
+    ERR("Level pack is truncated: %zu bytes", size);
+    return false;
+  }
+  // grids are checked once here, so that load() trusts them
+  for (uint32_t i = 0; i < levels; ++i) {
+    const uint8_t* entry = data + headerSize + i * entrySize;
+    size_t offset = readU32(entry);
+    size_t cells = static_cast<size_t>(readU16(entry + 4)) * readU16(entry + 6);
+    if (offset > size || cells > size - offset) {
+      ERR("Level %u lies out of pack", i);
+      return false;
+    }
+    const uint8_t* grid = data + offset;
+    if (checksum(grid, cells) != readU32(entry + 12)) {
+      ERR("Level %u is broken in pack", i);
+      return false;
+    }
+    for (size_t cell = 0; cell < cells; ++cell) {
+      if (grid[cell] >= BlockUtils::totalBlocks) {
+        ERR("Level %u has unknown block %i", i, grid[cell]);
+        return false;
+      }
+    }
+  }
+  m_view = std::move(view);
+  m_size = static_cast<int>(levels);
+  DBG("Opened level pack of %i levels", m_size);
+  return true;
+}
+
+LevelGrid LevelPack::getGrid(int index) const {
+  const uint8_t* entry = m_view.data() + headerSize + index * entrySize;
+  return LevelGrid {
+    readU16(entry + 4),
+    readU16(entry + 6),
+    static_cast<int>(readU32(entry + 8)),
+    m_view.data() + readU32(entry)};
+}
+
+Level::Ptr LevelPack::load(int index) const {
+  if (index < 0 || index >= m_size) {
+    ERR("No level %i in pack of %i levels", index, m_size);
+    return nullptr;
+  }
+  LevelGrid grid = getGrid(index);
+  return Level::fromGrid(grid.blocks, grid.rows, grid.cols);
+}
+
+void LevelPack::write(const std::vector<Level::Ptr>& levels, std::vector<uint8_t>* output) {
+  size_t total = headerSize + levels.size() * entrySize;
+  for (const Level::Ptr& level : levels) {
+    total += level->numRows() * level->numCols();
+  }
+  output->clear();
+  output->reserve(total);
+  for (char ch : packMagic) { output->push_back(ch); }
+  output->push_back(packVersion);
+  for (int i = 0; i < 3; ++i) { output->push_back(0); }  // reserved
+  writeU32(levels.size(), output);
+  writeU32(total, output);
+
+  std::vector<uint8_t> grids;
+  grids.reserve(total - output->size() - levels.size() * entrySize);
+  size_t offset = headerSize + levels.size() * entrySize;
+  for (const Level::Ptr& level : levels) {
+    size_t begin = grids.size();
+    for (int r = 0; r < level->numRows(); ++r) {
+      for (int c = 0; c < level->numCols(); ++c) {
+        grids.push_back(static_cast<uint8_t>(level->getBlock(r, c)));
+      }
+    }
+    writeU32(offset + begin, output);
+    writeU16(level->numRows(), output);
+    writeU16(level->numCols(), output);
+    writeU32(level->getCardinality(), output);
+    writeU32(checksum(grids.data() + begin, grids.size() - begin), output);
+  }
+  output->insert(output->end(), grids.begin(), grids.end());
+}
+
+}
@@ -0,0 +1,193 @@
+#include <algorithm>
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define MIXER_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define MIXER_SSE2 1
+#endif
+
+#include "logger.h"
+#include "Mixer.h"
+
+namespace native {
+namespace sound {
+
+Mixer::Mixer(int voices)
+  : m_commands(commandsCapacity)
+  , m_voices(std::max(1, std::min(voices, maxVoices)))
+  , m_accumulator(blockFrames * channels)
+  , m_stolen_voices(0)
+  , m_dropped_sounds(0) {
+  for (auto& voice : m_voices) {
+    voice.samples = nullptr;
+    voice.length = 0;
+    voice.position = 0;
+    voice.gain = 0;
+    voice.priority = 0;
+  }
+}
+
+bool Mixer::play(const int16_t* samples, int length, float gain, int priority) {
+  if (samples == nullptr || length <= 0) {
+    return false;
+  }
+  Command command(Command::Kind::PLAY);
+  command.samples = samples;
+  command.length = length;
+  command.gain = static_cast<int16_t>(std::max(0.0f, std::min(gain, 1.0f)) * 32767);
+  command.priority = priority;
+  if (!m_commands.push(command)) {
+    WRN("Mixer command queue is full, sound dropped");
+    ++m_dropped_sounds;
+    return false;
+  }
+  return true;
+}
+
+void Mixer::stopAll() {
+  m_commands.push(Command(Command::Kind::STOP_ALL));
+}
+
+void Mixer::render(int16_t* output, int frames) {
+  Command command;
+  while (m_commands.pop(command)) {
+    apply(command);
+  }
+
+  while (frames > 0) {
+    int chunk = std::min(frames, static_cast<int>(blockFrames));
+    int count = chunk * channels;
+    int32_t* accumulator = &m_accumulator[0];
+    std::fill(accumulator, accumulator + count, 0);
+    for (auto& voice : m_voices) {
+      if (voice.samples == nullptr) {
+        continue;
+      }
+      int mixed = std::min(count, voice.length - voice.position);
+      mixSamples(accumulator, voice.samples + voice.position, mixed, voice.gain);
+      voice.position += mixed;
+      if (voice.position >= voice.length) {
+        voice.samples = nullptr;  // sound is over
+      }
+    }
+    saturateSamples(output, accumulator, count);
+    output += count;
+    frames -= chunk;
+  }
+}
+
+int Mixer::getActiveVoices() const {
+  int active = 0;
+  for (auto& voice : m_voices) {
+    active += voice.samples != nullptr ? 1 : 0;
+  }
+  return active;
+}
+
+// ----------------------------------------------
+void Mixer::apply(const Command& command) {
+  switch (command.kind) {
+    case Command::Kind::PLAY:
+      {
+        Voice* voice = allocateVoice(command.priority);
+        if (voice == nullptr) {
+          ++m_dropped_sounds;
+          break;
+        }
+        voice->samples = command.samples;
+        voice->length = command.length;
+        voice->position = 0;
+        voice->gain = command.gain;
+        voice->priority = command.priority;
+      }
+      break;
+    case Command::Kind::STOP_ALL:
+      for (auto& voice : m_voices) {
+        voice.samples = nullptr;
+      }
+      break;
+    case Command::Kind::NONE:
+    default:
+      break;
+  }
+}
+
+Mixer::Voice* Mixer::allocateVoice(int priority) {
+  Voice* victim = nullptr;
+  for (auto& voice : m_voices) {
+    if (voice.samples == nullptr) {
+      return &voice;
+    }
+    if (voice.priority > priority) {
+      continue;  // never steal more important sound
+    }
+    // lowest priority first, then the one closest to its end
+    if (victim == nullptr || voice.priority < victim->priority ||
+        (voice.priority == victim->priority &&
+         voice.length - voice.position < victim->length - victim->position)) {
+      victim = &voice;
+    }
+  }
+  if (victim != nullptr) {
+    ++m_stolen_voices;
+  }
+  return victim;
+}
+
+/* Kernels */
+// ----------------------------------------------------------------------------
+void mixSamples(int32_t* accumulator, const int16_t* samples, int count, int16_t gain) {
+  int i = 0;
+#if MIXER_NEON
+  int16x4_t gains = vdup_n_s16(gain);
+  for (; i + 8 <= count; i += 8) {
+    int16x8_t input = vld1q_s16(samples + i);
+    int32x4_t low = vld1q_s32(accumulator + i);
+    int32x4_t high = vld1q_s32(accumulator + i + 4);
+    low = vsraq_n_s32(low, vmull_s16(vget_low_s16(input), gains), 15);
+    high = vsraq_n_s32(high, vmull_s16(vget_high_s16(input), gains), 15);
+    vst1q_s32(accumulator + i, low);
+    vst1q_s32(accumulator + i + 4, high);
+  }
+#elif MIXER_SSE2
+  __m128i gains = _mm_set1_epi16(gain);
+  for (; i + 8 <= count; i += 8) {
+    __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+    __m128i product_low = _mm_mullo_epi16(input, gains);
+    __m128i product_high = _mm_mulhi_epi16(input, gains);
+    __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(product_low, product_high), 15);
+    __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(product_low, product_high), 15);
+    __m128i* output = reinterpret_cast<__m128i*>(accumulator + i);
+    _mm_storeu_si128(output, _mm_add_epi32(_mm_loadu_si128(output), low));
+    _mm_storeu_si128(output + 1, _mm_add_epi32(_mm_loadu_si128(output + 1), high));
+  }
+#endif
+  for (; i < count; ++i) {
+    accumulator[i] += (static_cast<int32_t>(samples[i]) * gain) >> 15;
+  }
+}
+
+void saturateSamples(int16_t* output, const int32_t* accumulator, int count) {
+  int i = 0;
+#if MIXER_NEON
+  for (; i + 8 <= count; i += 8) {
+    int16x4_t low = vqmovn_s32(vld1q_s32(accumulator + i));
+    int16x4_t high = vqmovn_s32(vld1q_s32(accumulator + i + 4));
+    vst1q_s16(output + i, vcombine_s16(low, high));
+  }
+#elif MIXER_SSE2
+  for (; i + 8 <= count; i += 8) {
+    __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(accumulator + i));
+    __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(accumulator + i + 4));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_packs_epi32(low, high));
+  }
+#endif
+  for (; i < count; ++i) {
+    output[i] = static_cast<int16_t>(std::max(-32768, std::min(accumulator[i], 32767)));
+  }
+}
+
+}  // namespace sound
+}  // namespace native
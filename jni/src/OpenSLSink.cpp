@@ -0,0 +1,144 @@
+#include "logger.h"
+#include "OpenSLSink.h"
+
+namespace native {
+namespace sound {
+
+OpenSLSink::OpenSLSink()
+  : AudioSink()
+  , m_engine(nullptr)
+  , m_interface(nullptr)
+  , m_output_mix(nullptr)
+  , m_player(nullptr)
+  , m_player_interface(nullptr)
+  , m_player_queue(nullptr)
+  , m_mixer(nullptr)
+  , m_next_buffer(0) {
+}
+
+OpenSLSink::~OpenSLSink() {
+  stop();
+}
+
+bool OpenSLSink::start(Mixer* mixer) {
+  const SLInterfaceID ids[1] {SL_IID_ENGINE};
+  const SLboolean required[1] {SL_BOOLEAN_TRUE};
+  const SLInterfaceID mix_ids[] {};
+  const SLboolean mix_required[] {};
+
+  SLDataLocator_AndroidSimpleBufferQueue data_locator_in {
+    SL_DATALOCATOR_ANDROIDSIMPLEBUFFERQUEUE,
+    OpenSLSink::buffersCount
+  };
+
+  SLDataFormat_PCM data_format {
+    SL_DATAFORMAT_PCM,
+    Mixer::channels,
+    SL_SAMPLINGRATE_44_1,
+    SL_PCMSAMPLEFORMAT_FIXED_16,
+    SL_PCMSAMPLEFORMAT_FIXED_16,
+    SL_SPEAKER_FRONT_LEFT | SL_SPEAKER_FRONT_RIGHT,
+    SL_BYTEORDER_LITTLEENDIAN
+  };
+
+  SLDataSource data_source {
+    &data_locator_in,
+    &data_format
+  };
+
+  SLDataLocator_OutputMix data_locator_out {
+    SL_DATALOCATOR_OUTPUTMIX,
+    nullptr
+  };
+
+  SLDataSink data_sink {
+    &data_locator_out,
+    nullptr
+  };
+
+  const SLInterfaceID player_ids[2] { SL_IID_PLAY, SL_IID_ANDROIDSIMPLEBUFFERQUEUE };
+  const SLboolean player_required[2] { SL_BOOLEAN_TRUE, SL_BOOLEAN_TRUE };
+
+  m_mixer = mixer;
+  m_next_buffer = 0;
+  int error_code = 0;
+
+  SLresult result = slCreateEngine(&m_engine, 0, nullptr, 1, ids, required);
+  if (result != SL_RESULT_SUCCESS) { error_code = 1; goto ERROR_SINK; }
+  result = (*m_engine)->Realize(m_engine, SL_BOOLEAN_FALSE);
+  if (result != SL_RESULT_SUCCESS) { error_code = 2; goto ERROR_SINK; }
+  result = (*m_engine)->GetInterface(m_engine, SL_IID_ENGINE, &m_interface);
+  if (result != SL_RESULT_SUCCESS) { error_code = 3; goto ERROR_SINK; }
+  result = (*m_interface)->CreateOutputMix(m_interface, &m_output_mix, 0, mix_ids, mix_required);
+  if (result != SL_RESULT_SUCCESS) { error_code = 4; goto ERROR_SINK; }
+  result = (*m_output_mix)->Realize(m_output_mix, SL_BOOLEAN_FALSE);
+  if (result != SL_RESULT_SUCCESS) { error_code = 5; goto ERROR_SINK; }
+
+  data_locator_out.outputMix = m_output_mix;
+  result = (*m_interface)->CreateAudioPlayer(m_interface, &m_player, &data_source, &data_sink, 2, player_ids, player_required);
+  if (result != SL_RESULT_SUCCESS) { error_code = 6; goto ERROR_SINK; }
+  result = (*m_player)->Realize(m_player, SL_BOOLEAN_FALSE);
+  if (result != SL_RESULT_SUCCESS) { error_code = 7; goto ERROR_SINK; }
+  result = (*m_player)->GetInterface(m_player, SL_IID_PLAY, &m_player_interface);
+  if (result != SL_RESULT_SUCCESS) { error_code = 8; goto ERROR_SINK; }
+  result = (*m_player)->GetInterface(m_player, SL_IID_ANDROIDSIMPLEBUFFERQUEUE, &m_player_queue);
+  if (result != SL_RESULT_SUCCESS) { error_code = 9; goto ERROR_SINK; }
+  result = (*m_player_queue)->RegisterCallback(m_player_queue, &OpenSLSink::callback_bufferPlayed, this);
+  if (result != SL_RESULT_SUCCESS) { error_code = 11; goto ERROR_SINK; }
+
+  // prime the queue, afterwards each played buffer is refilled in callback
+  for (int i = 0; i < OpenSLSink::buffersCount; ++i) {
+    if (!enqueueBlock()) { error_code = 12; goto ERROR_SINK; }
+  }
+  result = (*m_player_interface)->SetPlayState(m_player_interface, SL_PLAYSTATE_PLAYING);
+  if (result != SL_RESULT_SUCCESS) { error_code = 10; goto ERROR_SINK; }
+  return true;
+
+  ERROR_SINK:
+    m_error_code = 2000 + error_code;
+    ERR("Error while initializing sound output: %i", m_error_code);
+    destroy();
+    return false;
+}
+
+void OpenSLSink::stop() {
+  if (m_player_interface != nullptr) {
+    (*m_player_interface)->SetPlayState(m_player_interface, SL_PLAYSTATE_STOPPED);
+  }
+  destroy();
+}
+
+// ----------------------------------------------
+void OpenSLSink::callback_bufferPlayed(SLAndroidSimpleBufferQueueItf /* queue */, void* context) {
+  static_cast<OpenSLSink*>(context)->enqueueBlock();
+}
+
+bool OpenSLSink::enqueueBlock() {
+  int16_t* buffer = m_buffers[m_next_buffer];
+  m_next_buffer = (m_next_buffer + 1) % OpenSLSink::buffersCount;
+  m_mixer->render(buffer, Mixer::blockFrames);
+  SLresult result = (*m_player_queue)->Enqueue(m_player_queue, buffer, sizeof(m_buffers[0]));
+  return result == SL_RESULT_SUCCESS;
+}
+
+void OpenSLSink::destroy() {
+  if (m_player != nullptr) {
+    (*m_player)->Destroy(m_player);  // waits for callback in progress
+    m_player = nullptr;
+    m_player_interface = nullptr;
+    m_player_queue = nullptr;
+  }
+  if (m_output_mix != nullptr) {
+    (*m_output_mix)->Destroy(m_output_mix);
+    m_output_mix = nullptr;
+  }
+  if (m_engine != nullptr) {
+    (*m_engine)->Destroy(m_engine);
+    m_engine = nullptr;
+    m_interface = nullptr;
+  }
+  m_mixer = nullptr;
+}
+
+}  // namespace sound
+}  // namespace native
@@ -0,0 +1,154 @@
+#include <algorithm>
+
+#include "ParticlePool.h"
+
+namespace game {
+
+constexpr int ParticlePool::maxExplosions;
+constexpr int ParticlePool::particlesPerExplosion;
+constexpr int ParticlePool::vertexSize;
+constexpr GLfloat ParticlePool::duration;
+
+static const GLfloat freeSlotStartTime = -1000.0f;
+static const GLfloat rebaseTime = 100.0f;  //!< Time of idle pool restarted from zero.
+
+ParticlePool::ParticlePool()
+  : m_vertices(totalParticles * vertexSize, 0.0f)
+  , m_time(0.0f)
+  , m_aspect(1.0f)
+  , m_live(0)
+  , m_last_live_slot(-1)
+  , m_high_water_slot(-1)
+  , m_dirty_first(maxExplosions)
+  , m_dirty_last(-1)
+  , m_spawned(0)
+  , m_random() {
+  for (int slot = 0; slot < maxExplosions; ++slot) {
+    freeSlot(slot);
+  }
+  markDirty(0);
+  markDirty(maxExplosions - 1);
+}
+
+int ParticlePool::spawn(const ExplosionPackage& package) {
+  int slot = 0;
+  for (int i = 0; i < maxExplosions; ++i) {
+    if (m_start_times[i] < 0.0f) {  // free slot
+      slot = i;
+      break;
+    }
+    if (m_start_times[i] < m_start_times[slot]) {
+      slot = i;  // the oldest one, recycled if pool is full
+    }
+  }
+  if (m_start_times[slot] < 0.0f) {
+    ++m_live;
+  }
+  m_start_times[slot] = m_time;
+  m_last_live_slot = std::max(m_last_live_slot, slot);
+  m_high_water_slot = std::max(m_high_water_slot, slot);
+  fillSlot(slot, package);
+  ++m_spawned;
+  return slot;
+}
+
+void ParticlePool::advance(GLfloat delta) {
+  if (m_live == 0) {
+    if (m_time > rebaseTime) {
+      rebase();  // keep time small for shader's precision
+    }
+    return;
+  }
+  m_time += delta;
+  for (int slot = 0; slot <= m_last_live_slot; ++slot) {
+    if (m_start_times[slot] >= 0.0f && m_time - m_start_times[slot] > duration) {
+      freeSlot(slot);
+      --m_live;
+    }
+  }
+  while (m_last_live_slot >= 0 && m_start_times[m_last_live_slot] < 0.0f) {
+    --m_last_live_slot;
+  }
+}
+
+void ParticlePool::clear() {
+  for (int slot = 0; slot <= m_last_live_slot; ++slot) {
+    if (m_start_times[slot] >= 0.0f) {
+      freeSlot(slot);
+    }
+  }
+  m_live = 0;
+  m_last_live_slot = -1;
+  rebase();
+}
+
+bool ParticlePool::takeDirtyRange(int* offset, int* count) {
+  if (m_dirty_last < m_dirty_first) {
+    return false;
+  }
+  *offset = m_dirty_first * particlesPerExplosion * vertexSize;
+  *count = (m_dirty_last - m_dirty_first + 1) * particlesPerExplosion * vertexSize;
+  m_dirty_first = maxExplosions;
+  m_dirty_last = -1;
+  return true;
+}
+
+// ----------------------------------------------
+void ParticlePool::fillSlot(int slot, const ExplosionPackage& package) {
+  // own random sequence per explosion, so overlapping ones differ
+  m_random.seed(static_cast<unsigned int>(package.getID()) * 2654435761u + m_spawned);
+
+  // vertex = random * scale + bias, see layout of vertex
+  const GLfloat a = m_aspect;
+  const GLfloat* scale = nullptr;
+  const GLfloat* bias = nullptr;
+  const GLfloat diverge_scale[8] = {1.0f, 0.25f, 0.25f * a, 2.0f, 2.0f * a, 0.0f, 0.0f, 0.0f};
+  const GLfloat diverge_bias[8] = {0.0f, -0.125f, -0.125f * a, -1.0f, -a, package.getX(), package.getY(), m_start_times[slot]};
+  const GLfloat converge_scale[8] = {1.0f, 0.2f, 0.1f * a, 0.1f, 0.05f * a, 0.0f, 0.0f, 0.0f};
+  const GLfloat converge_bias[8] = {0.0f, -0.1f, -0.05f * a, 0.0f, 0.0f, package.getX(), package.getY(), m_start_times[slot]};
+  switch (package.getKind()) {
+    default:
+    case Kind::DIVERGE:
+      scale = diverge_scale;
+      bias = diverge_bias;
+      break;
+    case Kind::CONVERGE:
+      scale = converge_scale;
+      bias = converge_bias;
+      break;
+  }
+  const util::BGRA<GLfloat>& color = package.getColor();
+  const GLfloat tail[4] = {color.b, color.g, color.r, 0.5f};
+
+  GLfloat* vertices = &m_vertices[slot * particlesPerExplosion * vertexSize];
+  util::simd::randomAffineVertices(vertices, particlesPerExplosion, &m_random, scale, bias, tail);
+  markDirty(slot);
+}
+
+void ParticlePool::freeSlot(int slot) {
+  // shader culls expired particles by their age, so GPU copy of the slot
+  // is left as is until time is rebased
+  m_start_times[slot] = freeSlotStartTime;
+  GLfloat* vertex = &m_vertices[slot * particlesPerExplosion * vertexSize];
+  for (int i = 0; i < particlesPerExplosion; ++i, vertex += vertexSize) {
+    vertex[startTimeOffset] = freeSlotStartTime;
+  }
+}
+
+void ParticlePool::rebase() {
+  // freed slots keep their old start times on GPU, which could come
+  // to life again once time restarts from zero
+  m_time = 0.0f;
+  if (m_high_water_slot >= 0) {
+    markDirty(0);
+    markDirty(m_high_water_slot);
+    m_high_water_slot = -1;
+  }
+}
+
+void ParticlePool::markDirty(int slot) {
+  m_dirty_first = std::min(m_dirty_first, slot);
+  m_dirty_last = std::max(m_dirty_last, slot);
+}
+
+}
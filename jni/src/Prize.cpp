@@ -22,4 +22,11 @@ Prize PrizeGenerator::generatePrize() {
   return static_cast<Prize>(value);
 }
 
+void PrizeGenerator::seed(unsigned int value) {
+  m_generator.seed(value);
+  m_distribution.reset();
+  m_success_distribution.reset();
+  m_win_distribution.reset();
+}
+
 }
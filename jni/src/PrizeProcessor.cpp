@@ -15,13 +15,6 @@ PrizeProcessor::PrizeProcessor(JavaVM* jvm)
   , m_removed_prizes() {
 
   DBG("enter PrizeProcessor ctor");
-  m_aspect_ratio_received.store(false);
-  m_init_bite_received.store(false);
-  m_bite_location_received.store(false);
-  m_prize_received.store(false);
-  m_prize_location_received.store(false);
-  m_prize_gone_received.store(false);
-
   m_removed_prizes.reserve(24);
   DBG("exit PrizeProcessor ctor");
 }
@@ -35,46 +28,39 @@ PrizeProcessor::~PrizeProcessor() {
 /* Callbacks group */
 // ----------------------------------------------------------------------------
 void PrizeProcessor::callback_aspectMeasured(float aspect) {
-  std::unique_lock<std::mutex> lock(m_aspect_ratio_mutex);
-  m_aspect_ratio_received.store(true);
-  m_aspect = aspect;
-  interrupt();
+  PrizeProcessorMessage message(PrizeProcessorMessage::Kind::ASPECT_MEASURED);
+  message.aspect = aspect;
+  post(std::move(message));
 }
 
-void PrizeProcessor::callback_initBite(Bite bite) {
-  std::unique_lock<std::mutex> lock(m_init_bite_mutex);
-  m_init_bite_received.store(true);
-  m_bite = bite;
-  interrupt();
+void PrizeProcessor::callback_initBite(const Bite& bite) {
+  PrizeProcessorMessage message(PrizeProcessorMessage::Kind::INIT_BITE);
+  message.bite = bite;
+  post(std::move(message));
 }
 
-void PrizeProcessor::callback_biteMoved(Bite moved_bite) {
-  std::unique_lock<std::mutex> lock(m_bite_location_mutex);
-  m_bite_location_received.store(true);
-  m_bite = moved_bite;
-  interrupt();
+void PrizeProcessor::callback_biteMoved(const Bite& moved_bite) {
+  PrizeProcessorMessage message(PrizeProcessorMessage::Kind::BITE_MOVED);
+  message.bite = moved_bite;
+  post(std::move(message));
 }
 
-void PrizeProcessor::callback_prizeReceived(PrizePackage package) {
-  std::unique_lock<std::mutex> lock(m_prize_mutex);
-  m_prize_received.store(true);
-  m_prize_packages[package.getID()] = package;
-  interrupt();
+void PrizeProcessor::callback_prizeReceived(const PrizePackage& package) {
+  PrizeProcessorMessage message(PrizeProcessorMessage::Kind::PRIZE_RECEIVED);
+  message.package = package;
+  post(std::move(message));
 }
 
-void PrizeProcessor::callback_prizeLocated(PrizePackage package) {
-  std::unique_lock<std::mutex> lock(m_prize_location_mutex);
-  m_prize_location_received.store(true);
-  m_prize_packages[package.getID()] = package;
-  interrupt();
+void PrizeProcessor::callback_prizeLocated(const PrizePackage& package) {
+  PrizeProcessorMessage message(PrizeProcessorMessage::Kind::PRIZE_LOCATED);
+  message.package = package;
+  post(std::move(message));
 }
 
 void PrizeProcessor::callback_prizeHasGone(int prize_id) {
-  std::unique_lock<std::mutex> lock(m_prize_gone_mutex);
-  m_prize_gone_received.store(true);
-  m_prize_packages[prize_id].setGone(true);
-  addPrizeToRemoved(prize_id);
-  interrupt();
+  PrizeProcessorMessage message(PrizeProcessorMessage::Kind::PRIZE_HAS_GONE);
+  message.prize_id = prize_id;
+  post(std::move(message));
 }
 
 /* *** Private methods *** */
@@ -106,62 +92,57 @@ void PrizeProcessor::onStop() {
   detachFromJVM();
 }
 
-bool PrizeProcessor::checkForWakeUp() {
-  return m_aspect_ratio_received.load()||
-         m_init_bite_received.load() ||
-         m_bite_location_received.load() ||
-         m_prize_received.load() ||
-         m_prize_location_received.load() ||
-         m_prize_gone_received.load();
-}
-
-void PrizeProcessor::eventHandler() {
-  if (m_aspect_ratio_received.load()) {
-    m_aspect_ratio_received.store(false);
-    process_aspectMeasured();
-  }
-  if (m_init_bite_received.load()) {
-    m_init_bite_received.store(false);
-    process_initBite();
-  }
-  if (m_bite_location_received.load()) {
-    m_bite_location_received.store(false);
-    process_biteMoved();
-  }
-  if (m_prize_received.load()) {
-    m_prize_received.store(false);
-    process_prizeReceived();
-  }
-  if (m_prize_location_received.load()) {
-    m_prize_location_received.store(false);
-    process_prizeLocated();
+bool PrizeProcessor::isCoalescable(const PrizeProcessorMessage& message) const {
+  return message.kind == PrizeProcessorMessage::Kind::BITE_MOVED;
+}
+
+void PrizeProcessor::dispatch(PrizeProcessorMessage& message) {
+  switch (message.kind) {
+    case PrizeProcessorMessage::Kind::ASPECT_MEASURED:
+      process_aspectMeasured(message.aspect);
+      break;
+    case PrizeProcessorMessage::Kind::INIT_BITE:
+      process_initBite(message.bite);
+      break;
+    case PrizeProcessorMessage::Kind::BITE_MOVED:
+      process_biteMoved(message.bite);
+      break;
+    case PrizeProcessorMessage::Kind::PRIZE_RECEIVED:
+      process_prizeReceived(message.package);
+      break;
+    case PrizeProcessorMessage::Kind::PRIZE_LOCATED:
+      process_prizeLocated(message.package);
+      break;
+    case PrizeProcessorMessage::Kind::PRIZE_HAS_GONE:
+      process_prizeHasGone(message.prize_id);
+      break;
+    case PrizeProcessorMessage::Kind::NONE:
+    default:
+      break;
   }
 }
 
 /* Processors group */
 // ----------------------------------------------------------------------------
-void PrizeProcessor::process_aspectMeasured() {
-  std::unique_lock<std::mutex> lock(m_aspect_ratio_mutex);
-  // no-op
+void PrizeProcessor::process_aspectMeasured(GLfloat aspect) {
+  m_aspect = aspect;
 }
 
-void PrizeProcessor::process_initBite() {
-  std::unique_lock<std::mutex> lock(m_init_bite_mutex);
+void PrizeProcessor::process_initBite(const Bite& bite) {
+  m_bite = bite;
   m_bite_upper_border = -BiteParams::neg_biteElevation;
 }
 
-void PrizeProcessor::process_biteMoved() {
-  std::unique_lock<std::mutex> lock(m_bite_location_mutex);
-  // no-op
+void PrizeProcessor::process_biteMoved(const Bite& moved_bite) {
+  m_bite = moved_bite;
 }
 
-void PrizeProcessor::process_prizeReceived() {
-  std::unique_lock<std::mutex> lock(m_prize_mutex);
-  // no-op
+void PrizeProcessor::process_prizeReceived(const PrizePackage& package) {
+  m_prize_packages[package.getID()] = package;
 }
 
-void PrizeProcessor::process_prizeLocated() {
-  std::unique_lock<std::mutex> lock(m_prize_location_mutex);
+void PrizeProcessor::process_prizeLocated(const PrizePackage& package) {
+  m_prize_packages[package.getID()] = package;
   clearRemovedPrizes();
   for (auto& item : m_prize_packages) {
     if (!item.second.hasGone() &&
@@ -177,12 +158,9 @@ void PrizeProcessor::process_prizeLocated() {
   }
 }
 
-void PrizeProcessor::process_prizeHasGone() {
-  std::unique_lock<std::mutex> lock(m_prize_gone_mutex);
-  for (auto& item : m_removed_prizes) {
-    m_prize_packages.erase(item);
-  }
-  m_removed_prizes.clear();
+void PrizeProcessor::process_prizeHasGone(int prize_id) {
+  m_prize_packages[prize_id].setGone(true);
+  addPrizeToRemoved(prize_id);
 }
 
 /* LogicFunc group */
@@ -0,0 +1,386 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+#include "AssetView.h"
+#include "logger.h"
+#include "Replay.h"
+
+namespace game {
+
+namespace {
+
+const char replayMagic[4] = {'A', 'R', 'K', 'R'};
+const uint8_t replayVersion = 1;
+const uint8_t endKind = 0xFF;
+
+/// @brief Little endian encoding of record into fixed buffer.
+class Writer {
+public:
+  Writer() : m_size(0) {}
+
+  void u8(uint8_t value) { m_buffer[m_size++] = value; }
+  void u32(uint32_t value) { for (int i = 0; i < 4; ++i) { u8(value >> (8 * i)); } }
+  void u64(uint64_t value) { for (int i = 0; i < 8; ++i) { u8(value >> (8 * i)); } }
+  void f32(float value) { uint32_t bits; std::memcpy(&bits, &value, 4); u32(bits); }
+  void varint(uint64_t value) {
+    do {
+      u8((value & 0x7F) | (value > 0x7F ? 0x80 : 0));
+      value >>= 7;
+    } while (value > 0);
+  }
+
+  /// @brief Writes and empties buffer.
+  bool flush(FILE* file) {
+    bool written = std::fwrite(m_buffer, 1, m_size, file) == m_size;
+    m_size = 0;
+    return written;
+  }
+
+private:
+  uint8_t m_buffer[64];  //!< Enough for any record but level's rows, which are written directly.
+  size_t m_size;
+};
+
+/// @brief Decoding of records, fails once data is exhausted.
+class Reader {
+public:
+  Reader(const uint8_t* data, size_t size) : m_data(data), m_size(size), m_offset(0), m_failed(false) {}
+
+  uint8_t u8() {
+    if (m_offset >= m_size) { m_failed = true; return 0; }
+    return m_data[m_offset++];
+  }
+  uint32_t u32() { uint32_t value = 0; for (int i = 0; i < 4; ++i) { value |= static_cast<uint32_t>(u8()) << (8 * i); } return value; }
+  uint64_t u64() { uint64_t value = 0; for (int i = 0; i < 8; ++i) { value |= static_cast<uint64_t>(u8()) << (8 * i); } return value; }
+  float f32() { uint32_t bits = u32(); float value; std::memcpy(&value, &bits, 4); return value; }
+  uint64_t varint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64 && !m_failed; shift += 7) {
+      uint8_t byte = u8();
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) {
+        return value;
+      }
+    }
+    m_failed = true;
+    return 0;
+  }
+  std::string string(size_t length) {
+    if (length > m_size - m_offset) { m_failed = true; m_offset = m_size; return std::string(); }
+    std::string value(reinterpret_cast<const char*>(m_data + m_offset), length);
+    m_offset += length;
+    return value;
+  }
+
+  inline bool failed() const { return m_failed; }
+  inline bool atEnd() const { return m_offset >= m_size; }
+
+private:
+  const uint8_t* m_data;
+  size_t m_size;
+  size_t m_offset;
+  bool m_failed;
+};
+
+}  // namespace
+
+/* Seeds */
+// ----------------------------------------------------------------------------
+ReplaySeeds ReplaySeeds::fromClock() {
+  uint64_t value = std::chrono::system_clock::now().time_since_epoch().count();
+  ReplaySeeds seeds;
+  uint32_t* fields[] = {&seeds.processor, &seeds.blocks, &seeds.prizes, &seeds.shared};
+  for (uint32_t* field : fields) {
+    value = value * 6364136223846793005ULL + 1442695040888963407ULL;  // LCG step per seed
+    *field = static_cast<uint32_t>(value >> 32);
+  }
+  return seeds;
+}
+
+void ReplaySeeds::seedLevel(Level& level, int index) const {
+  level.getGenerator().seed(blocks + index);
+  level.getPrizeGenerator().seed(prizes + index);
+}
+
+/* Recorder */
+// ----------------------------------------------------------------------------
+InputRecorder::InputRecorder(const char* filepath, const ReplaySeeds& seeds)
+  : m_file(std::fopen(filepath, "wb"))
+  , m_seeds(seeds)
+  , m_last_tick(0)
+  , m_records(0) {
+  if (m_file == nullptr) {
+    ERR("Failed to open replay file %s", filepath);
+    return;
+  }
+  Writer writer;
+  for (char c : replayMagic) {
+    writer.u8(c);
+  }
+  writer.u8(replayVersion);
+  writer.u32(seeds.processor);
+  writer.u32(seeds.blocks);
+  writer.u32(seeds.prizes);
+  writer.u32(seeds.shared);
+  if (!writer.flush(m_file)) {
+    ERR("Failed to write replay file %s", filepath);
+  }
+}
+
+InputRecorder::~InputRecorder() {
+  if (m_file != nullptr) {
+    WRN("Replay file has not been finished, state hash is missing");
+    std::fclose(m_file);
+    m_file = nullptr;
+  }
+}
+
+void InputRecorder::record(long long tick, const GameProcessorMessage& message) {
+  if (m_file == nullptr) {
+    return;
+  }
+  Writer writer;
+  writer.varint(tick - m_last_tick);
+  writer.u8(static_cast<uint8_t>(message.kind));
+  switch (message.kind) {
+    case GameProcessorMessage::Kind::ASPECT_MEASURED:
+    case GameProcessorMessage::Kind::THROW_BALL:
+      writer.f32(message.value);
+      break;
+    case GameProcessorMessage::Kind::LOAD_LEVEL:
+      {
+        std::vector<std::string> rows;
+        message.level->toStringArray(&rows);
+        writer.varint(rows.size());
+        writer.flush(m_file);
+        for (const std::string& row : rows) {
+          writer.varint(row.size());
+          writer.flush(m_file);
+          std::fwrite(row.data(), 1, row.size(), m_file);
+        }
+      }
+      break;
+    case GameProcessorMessage::Kind::INIT_BALL:
+      writer.f32(message.ball.getDimens().width());
+      writer.f32(message.ball.getDimens().height());
+      writer.f32(message.ball.getPose().getX());
+      writer.f32(message.ball.getPose().getY());
+      writer.f32(message.ball.getAngle());
+      writer.u8(static_cast<uint8_t>(message.ball.getEffect()));
+      break;
+    case GameProcessorMessage::Kind::INIT_BITE:
+    case GameProcessorMessage::Kind::BITE_MOVED:
+      writer.f32(message.bite.getDimens().width());
+      writer.f32(message.bite.getDimens().height());
+      writer.f32(message.bite.getXPose());
+      break;
+    case GameProcessorMessage::Kind::LEVEL_DIMENS:
+      writer.varint(message.level_dimens.getRows());
+      writer.varint(message.level_dimens.getCols());
+      writer.f32(message.level_dimens.getWidth());
+      writer.f32(message.level_dimens.getHeight());
+      writer.f32(message.level_dimens.getBlockWidth());
+      writer.f32(message.level_dimens.getBlockHeight());
+      break;
+    case GameProcessorMessage::Kind::PRIZE_CAUGHT:
+      writer.varint(static_cast<uint32_t>(message.prize));
+      break;
+    case GameProcessorMessage::Kind::LASER_BEAM:
+      writer.f32(message.laser.getX());
+      writer.f32(message.laser.getY());
+      break;
+    case GameProcessorMessage::Kind::TICK_RATE:
+      writer.varint(message.tick_rate);
+      break;
+    case GameProcessorMessage::Kind::BONUS_BLOCKS:
+      writer.u8(message.flag ? 1 : 0);
+      break;
+    case GameProcessorMessage::Kind::RECORDER:
+    case GameProcessorMessage::Kind::NONE:
+    default:
+      return;  // not an input
+  }
+  writer.flush(m_file);
+  m_last_tick = tick;
+  ++m_records;
+}
+
+void InputRecorder::finish(long long tick, uint64_t state_hash) {
+  if (m_file == nullptr) {
+    return;
+  }
+  Writer writer;
+  writer.varint(tick - m_last_tick);
+  writer.u8(endKind);
+  writer.u64(state_hash);
+  bool written = writer.flush(m_file);
+  if (std::fclose(m_file) != 0 || !written) {
+    ERR("Failed to finish replay file");
+  }
+  m_file = nullptr;
+}
+
+/* Log */
+// ----------------------------------------------------------------------------
+ReplayLog::ReplayLog()
+  : m_seeds{0, 0, 0, 0}
+  , m_records()
+  , m_complete(false)
+  , m_end_tick(0)
+  , m_state_hash(0) {
+}
+
+bool ReplayLog::load(const char* filepath) {
+  m_records.clear();
+  m_complete = false;
+  AssetView view = AssetView::mapFile(filepath);
+  if (view.empty()) {
+    ERR("Failed to open replay file %s", filepath);
+    return false;
+  }
+  Reader reader(view.data(), view.size());
+  std::string magic = reader.string(4);
+  uint8_t version = reader.u8();
+  if (reader.failed() || magic.compare(0, 4, replayMagic, 4) != 0 || version != replayVersion) {
+    ERR("File %s is not a replay of version %i", filepath, replayVersion);
+    return false;
+  }
+  m_seeds.processor = reader.u32();
+  m_seeds.blocks = reader.u32();
+  m_seeds.prizes = reader.u32();
+  m_seeds.shared = reader.u32();
+
+  long long tick = 0;
+  while (!reader.atEnd() && !reader.failed()) {
+    tick += reader.varint();
+    uint8_t kind = reader.u8();
+    if (kind == endKind) {
+      m_state_hash = reader.u64();
+      m_end_tick = tick;
+      m_complete = !reader.failed();
+      break;
+    }
+
+    ReplayRecord record {tick, GameProcessorMessage(static_cast<GameProcessorMessage::Kind>(kind)), {}};
+    GameProcessorMessage& message = record.message;
+    switch (message.kind) {
+      case GameProcessorMessage::Kind::ASPECT_MEASURED:
+      case GameProcessorMessage::Kind::THROW_BALL:
+        message.value = reader.f32();
+        break;
+      case GameProcessorMessage::Kind::LOAD_LEVEL:
+        {
+          size_t rows = reader.varint();
+          for (size_t row = 0; row < rows && !reader.failed(); ++row) {
+            record.level.push_back(reader.string(reader.varint()));
+          }
+        }
+        break;
+      case GameProcessorMessage::Kind::INIT_BALL:
+        {
+          GLfloat width = reader.f32();
+          GLfloat height = reader.f32();
+          message.ball = Ball(width, height);
+          message.ball.setXPose(reader.f32());
+          message.ball.setYPose(reader.f32());
+          message.ball.setAngle(reader.f32());
+          message.ball.setEffect(static_cast<BallEffect>(reader.u8()));
+        }
+        break;
+      case GameProcessorMessage::Kind::INIT_BITE:
+      case GameProcessorMessage::Kind::BITE_MOVED:
+        {
+          GLfloat width = reader.f32();
+          GLfloat height = reader.f32();
+          message.bite = Bite(width, height);
+          message.bite.setXPose(reader.f32());
+        }
+        break;
+      case GameProcessorMessage::Kind::LEVEL_DIMENS:
+        {
+          int rows = reader.varint();
+          int cols = reader.varint();
+          GLfloat width = reader.f32();
+          GLfloat height = reader.f32();
+          GLfloat block_width = reader.f32();
+          GLfloat block_height = reader.f32();
+          message.level_dimens = LevelDimens(rows, cols, width, height, block_width, block_height);
+        }
+        break;
+      case GameProcessorMessage::Kind::PRIZE_CAUGHT:
+        message.prize = static_cast<Prize>(reader.varint());
+        break;
+      case GameProcessorMessage::Kind::LASER_BEAM:
+        {
+          GLfloat x = reader.f32();
+          GLfloat y = reader.f32();
+          message.laser = LaserPackage(x, y);
+        }
+        break;
+      case GameProcessorMessage::Kind::TICK_RATE:
+        message.tick_rate = reader.varint();
+        break;
+      case GameProcessorMessage::Kind::BONUS_BLOCKS:
+        message.flag = reader.u8() != 0;
+        break;
+      default:
+        ERR("Unknown record %i in replay file %s", kind, filepath);
+        return false;
+    }
+    if (!reader.failed()) {
+      m_records.push_back(std::move(record));
+    }
+  }
+  if (reader.failed()) {
+    ERR("Replay file %s is truncated after %zu records", filepath, m_records.size());
+    return false;
+  }
+  if (!m_complete) {
+    WRN("Replay file %s has not been finished, state hash is missing", filepath);
+  }
+  return true;
+}
+
+/* Driver */
+// ----------------------------------------------------------------------------
+ReplayResult replay(const ReplayLog& log, GameProcessor* processor) {
+  ReplayResult result {0, 0, false};
+  const long long start_tick = processor->getTickCount();
+  const ReplaySeeds& seeds = log.getSeeds();
+  processor->setSeed(seeds.processor);
+  std::srand(seeds.shared);
+
+  // brings processor to given tick, unless ball stops earlier than it did
+  auto advanceTo = [processor, start_tick](long long tick) {
+    while (processor->getTickCount() - start_tick < tick) {
+      if (processor->advance(tick - (processor->getTickCount() - start_tick)) == 0) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  int levels = 0;
+  for (const ReplayRecord& record : log.getRecords()) {
+    if (!advanceTo(record.tick)) {
+      result.diverged = true;
+      break;
+    }
+    GameProcessorMessage message = record.message;
+    if (message.kind == GameProcessorMessage::Kind::LOAD_LEVEL) {
+      message.level = Level::fromStringArray(record.level, record.level.size());
+      seeds.seedLevel(*message.level, levels++);
+    }
+    processor->inject(std::move(message));
+  }
+  processor->advance(0);  // process the last records
+  if (!result.diverged && log.isComplete() && !advanceTo(log.getEndTick())) {
+    result.diverged = true;
+  }
+  result.ticks = processor->getTickCount() - start_tick;
+  result.state_hash = processor->getStateHash();
+  return result;
+}
+
+}
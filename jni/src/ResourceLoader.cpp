@@ -0,0 +1,92 @@
+#include <algorithm>
+
+#include "logger.h"
+#include "ResourceLoader.h"
+
+namespace native {
+
+ResourceLoader::ResourceLoader(int workers)
+  : m_stop(false)
+  , m_progress() {
+  for (int i = 0; i < std::max(1, workers); ++i) {
+    m_workers.emplace_back(&ResourceLoader::run, this);
+  }
+}
+
+ResourceLoader::~ResourceLoader() {
+  {
+    std::lock_guard<std::mutex> lock(m_jobs_mutex);
+    m_stop = true;
+    m_jobs.clear();
+  }
+  m_jobs_condition.notify_all();
+  for (std::thread& worker : m_workers) {
+    worker.join();
+  }
+}
+
+int ResourceLoader::defaultWorkers() {
+  int cores = static_cast<int>(std::thread::hardware_concurrency());
+  return std::max(1, std::min(cores - 1, 4));
+}
+
+void ResourceLoader::load(const std::vector<Texture*>& textures, const std::vector<SoundBuffer*>& sounds) {
+  {
+    std::lock_guard<std::mutex> lock(m_progress_mutex);
+    if (m_progress.isComplete()) {
+      m_progress = LoadProgress();
+    }
+    m_progress.total += textures.size() + sounds.size();
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_jobs_mutex);
+    for (Texture* texture : textures) {
+      m_jobs.push_back(Job {texture, nullptr});
+    }
+    for (SoundBuffer* sound : sounds) {
+      m_jobs.push_back(Job {nullptr, sound});
+    }
+  }
+  m_jobs_condition.notify_all();
+}
+
+// ----------------------------------------------
+void ResourceLoader::callback_textureUploaded(bool success) {
+  finish(success);
+}
+
+// ----------------------------------------------
+void ResourceLoader::run() {
+  for (;;) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(m_jobs_mutex);
+      m_jobs_condition.wait(lock, [this]() { return m_stop || !m_jobs.empty(); });
+      if (m_stop) {
+        return;
+      }
+      job = m_jobs.front();
+      m_jobs.pop_front();
+    }
+
+    if (job.texture != nullptr) {
+      DBG("Decoding texture resource: %s", job.texture->getFilename());
+      if (job.texture->decode()) {
+        texture_decoded_event.notifyListeners(job.texture);  // finished once uploaded
+      } else {
+        finish(false);
+      }
+    } else {
+      DBG("Loading sound resource: %s", job.sound->getFilename());
+      finish(job.sound->load());
+    }
+  }
+}
+
+void ResourceLoader::finish(bool success) {
+  std::lock_guard<std::mutex> lock(m_progress_mutex);
+  ++(success ? m_progress.loaded : m_progress.failed);
+  progress_event.notifyListeners(m_progress);
+}
+
+}  // namespace native
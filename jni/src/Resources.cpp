@@ -22,6 +22,12 @@ JNIEXPORT jboolean JNICALL Java_com_orcchg_arkanoid_surface_NativeResources_read
   return ptr->readSound(filename);
 }
 
+JNIEXPORT jboolean JNICALL Java_com_orcchg_arkanoid_surface_NativeResources_readLevelPack
+  (JNIEnv *, jobject, jlong descriptor, jstring filename) {
+  game::Resources* ptr = reinterpret_cast<game::Resources*>(descriptor);
+  return ptr->readLevelPack(filename);
+}
+
 JNIEXPORT void JNICALL Java_com_orcchg_arkanoid_surface_NativeResources_release
   (JNIEnv *, jobject, jlong descriptor) {
   game::Resources* ptr = reinterpret_cast<game::Resources*>(descriptor);
@@ -64,34 +70,43 @@ bool Resources::readTexture(jstring filename) {
   native::Texture* texture = nullptr;
   {
     std::string prefix = "texture/" + std::string(raw_name);
-    texture = new native::PNGTexture(m_assets, prefix.c_str());
+    std::string name = raw_name;
+    // pre-compressed copy made by tools/png2ktx, PNG stays as fallback
+    std::string compressed = "texture_ktx/" + name.substr(0, name.rfind('.')) + ".ktx";
+    if (m_assets->exists(compressed.c_str())) {
+      texture = new native::KTXTexture(m_assets, prefix.c_str(), compressed.c_str());
+    } else {
+      texture = new native::PNGTexture(m_assets, prefix.c_str());
+    }
     DBG("Read texture resource: %s", raw_name);
   }
-  m_textures[raw_name] = texture;
+  native::Texture*& item = m_textures[raw_name];
+  if (item == nullptr) {
+    m_texture_index.add(raw_name, texture);
+  } else {
+    m_texture_index.replace(raw_name, item, texture);
+  }
+  item = texture;
   m_jenv->ReleaseStringUTFChars(filename, raw_name);
   return true;
 }
 
-const native::Texture* const Resources::getTexture(const std::string& name) const {
-  return m_textures.at(name);
+const native::Sprite* const Resources::getTexture(const std::string& name) const {
+  if (!m_atlas.contains(name)) {
+    ERR("No texture loaded with name: %s", name.c_str());
+  }
+  return m_atlas.getSprite(name);
 }
 
-const native::Texture* const Resources::getRandomTexture(const std::string& prefix) const {
-  native::Texture* texture = nullptr;
-  bool success = false;
-  do {
-    size_t random_index = std::rand() % m_textures.size();
-    auto shift = m_textures.begin();
-    for (int i = 0; i < random_index; ++i) {
-      ++shift;
-    }
-    success = (shift->first.find(prefix) == 0);
-    texture = shift->second;
-  } while (!success);
-  return texture;
+const native::Sprite* const Resources::getRandomTexture(const std::string& prefix) const {
+  native::Texture* texture = m_texture_index.getRandom(prefix);
+  if (texture == nullptr) {
+    ERR("No texture with prefix: %s", prefix.c_str());
+  }
+  return m_atlas.getSprite(texture != nullptr ? texture->getName() : "");
 }
 
-const native::Texture* const Resources::getPrizeTexture(const Prize& prize) const {
+const native::Sprite* const Resources::getPrizeTexture(const Prize& prize) const {
   switch (prize) {
     case Prize::BLOCK:     return getTexture("pr_brick.png");
     case Prize::CLIMB:     return getTexture("pr_earth.png");
@@ -132,6 +147,10 @@ const native::Texture* const Resources::getPrizeTexture(const Prize& prize) cons
   return nullptr;
 }
 
+native::TextureAtlas* Resources::getTextureAtlas() {
+  return &m_atlas;
+}
+
 Resources::tex_iterator Resources::beginTexture() { return m_textures.begin(); }
 Resources::tex_iterator Resources::endTexture() { return m_textures.end(); }
 Resources::const_tex_iterator Resources::cbeginTexture() const { return m_textures.cbegin(); }
@@ -151,7 +170,13 @@ bool Resources::readSound(jstring filename) {
     sound = new native::WAVSound(m_assets, prefix.c_str());
     DBG("Read sound resource: %s", raw_name);
   }
-  m_sounds[raw_name] = sound;
+  native::SoundBuffer*& item = m_sounds[raw_name];
+  if (item == nullptr) {
+    m_sound_index.add(raw_name, sound);
+  } else {
+    m_sound_index.replace(raw_name, item, sound);
+  }
+  item = sound;
   m_jenv->ReleaseStringUTFChars(filename, raw_name);
   return true;
 }
@@ -161,17 +186,10 @@ const native::SoundBuffer* const Resources::getSound(const std::string& name) co
 }
 
 const native::SoundBuffer* const Resources::getRandomSound(const std::string& prefix) const {
-  native::SoundBuffer* sound = nullptr;
-  bool success = false;
-  do {
-    size_t random_index = std::rand() % m_sounds.size();
-    auto shift = m_sounds.begin();
-    for (int i = 0; i < random_index; ++i) {
-      ++shift;
-    }
-    success = (shift->first.find(prefix) == 0);
-    sound = shift->second;
-  } while (!success);
+  native::SoundBuffer* sound = m_sound_index.getRandom(prefix);
+  if (sound == nullptr) {
+    ERR("No sound with prefix: %s", prefix.c_str());
+  }
   return sound;
 }
 
@@ -180,4 +198,25 @@ Resources::sound_iterator Resources::endSound() { return m_sounds.end(); }
 Resources::const_sound_iterator Resources::cbeginSound() const { return m_sounds.cbegin(); }
 Resources::const_sound_iterator Resources::cendSound() const { return m_sounds.cend(); }
 
+/* Level group */
+// ----------------------------------------------------------------------------
+bool Resources::readLevelPack(jstring filename) {
+  const char* raw_name = m_jenv->GetStringUTFChars(filename, nullptr);
+  std::string prefix = "level/" + std::string(raw_name);
+  bool result = false;
+  if (m_assets->exists(prefix.c_str())) {
+    result = m_levels.open(m_assets->map(prefix.c_str()));
+    DBG("Read level pack resource: %s, %i levels", raw_name, m_levels.size());
+  } else {
+    // levels still come as strings from Levels.java then
+    WRN("No level pack resource: %s", raw_name);
+  }
+  m_jenv->ReleaseStringUTFChars(filename, raw_name);
+  return result;
+}
+
+const LevelPack& Resources::getLevelPack() const {
+  return m_levels;
+}
+
 }
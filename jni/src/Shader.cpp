@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 #include <GLES2/gl2.h>
 
 #include "Exceptions.h"
@@ -6,6 +10,18 @@
 
 namespace shader {
 
+static const char* const attributeNames[] = {
+  "a_position", "a_color", "a_texCoord", "a_lifetime", "a_startPosition", "a_endPosition",
+  "a_centerPosition", "a_startTime"
+};
+
+static const char* const uniformNames[] = {
+  "u_time", "u_centerPosition", "u_color", "u_velocity", "u_visible", "s_texture",
+  "u_texRegion"
+};
+
+std::atomic<long long> ShaderHelper::s_location_lookups(0);
+
 ShaderHelper::ShaderHelper(const Shader& shader)
   : m_program(0)
   , m_vertex_location(0)
@@ -13,6 +29,8 @@ ShaderHelper::ShaderHelper(const Shader& shader)
   , m_texCoord_location(2) {
 
   DBG("enter ShaderHelper::ctor");
+  std::fill(m_attributes, m_attributes + static_cast<int>(Attribute::COUNT), -1);
+  std::fill(m_uniforms, m_uniforms + static_cast<int>(Uniform::COUNT), -1);
   GLuint vertex_shader = loadShader(GL_VERTEX_SHADER, shader.vertex);
   GLuint fragment_shader = loadShader(GL_FRAGMENT_SHADER, shader.fragment);
 
@@ -47,6 +65,7 @@ ShaderHelper::ShaderHelper(const Shader& shader)
       if (strcmp(infoLog, "--From Vertex Shader:\n--From Fragment Shader:\nLink was successful.")) {
         INF("No linker error !");
         delete [] infoLog;
+        introspect();
         return;
       }
       delete [] infoLog;
@@ -54,6 +73,7 @@ ShaderHelper::ShaderHelper(const Shader& shader)
     glDeleteProgram(m_program);
     throw ShaderException("Error linking program");
   }
+  introspect();
   DBG("exit ShaderHelper::ctor");
 }
 
@@ -69,6 +89,48 @@ void ShaderHelper::useProgram() const {
   glUseProgram(m_program);
 }
 
+GLint ShaderHelper::getAttribLocation(const char* name) const {
+  s_location_lookups.fetch_add(1);
+  return glGetAttribLocation(m_program, name);
+}
+
+GLint ShaderHelper::getUniformLocation(const char* name) const {
+  s_location_lookups.fetch_add(1);
+  return glGetUniformLocation(m_program, name);
+}
+
+void ShaderHelper::introspect() {
+  GLint total = 0, max_length = 0;
+  GLint size = 0;
+  GLenum type = 0;
+
+  glGetProgramiv(m_program, GL_ACTIVE_ATTRIBUTES, &total);
+  glGetProgramiv(m_program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &max_length);
+  std::vector<char> name(max_length + 1, '\0');
+  for (GLint i = 0; i < total; ++i) {
+    glGetActiveAttrib(m_program, i, name.size(), nullptr, &size, &type, &name[0]);
+    for (int a = 0; a < static_cast<int>(Attribute::COUNT); ++a) {
+      if (strcmp(&name[0], attributeNames[a]) == 0) {
+        m_attributes[a] = glGetAttribLocation(m_program, &name[0]);
+        break;
+      }
+    }
+  }
+
+  glGetProgramiv(m_program, GL_ACTIVE_UNIFORMS, &total);
+  glGetProgramiv(m_program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length);
+  name.assign(max_length + 1, '\0');
+  for (GLint i = 0; i < total; ++i) {
+    glGetActiveUniform(m_program, i, name.size(), nullptr, &size, &type, &name[0]);
+    for (int u = 0; u < static_cast<int>(Uniform::COUNT); ++u) {
+      if (strcmp(&name[0], uniformNames[u]) == 0) {
+        m_uniforms[u] = glGetUniformLocation(m_program, &name[0]);
+        break;
+      }
+    }
+  }
+}
+
 GLuint ShaderHelper::loadShader(GLenum type, const char* shader_src) {
   DBG("enter ShaderHelper::loadShader()");
   INF("GL version: %s", glGetString(GL_VERSION));
@@ -171,38 +233,47 @@ void SimpleTextureShader::bindTexCoordAttribLocation(GLuint program, GLuint texC
 ParticleSystemShader::ParticleSystemShader()
   : Shader(
       "  uniform float u_time;                                                 \n"
-      "  uniform vec2 u_centerPosition;                                        \n"
       "                                                                        \n"
       "  attribute float a_lifetime;                                           \n"
       "  attribute vec2 a_startPosition;                                       \n"
       "  attribute vec2 a_endPosition;                                         \n"
+      "  attribute vec2 a_centerPosition;                                      \n"
+      "  attribute float a_startTime;                                          \n"
+      "  attribute vec4 a_color;                                               \n"
       "                                                                        \n"
       "  varying float v_lifetime;                                             \n"
+      "  varying vec4 v_color;                                                 \n"
       "                                                                        \n"
       "  void main() {                                                         \n"
-      "    if (u_time <= a_lifetime) {                                         \n"
-      "      gl_Position.xy = a_startPosition + (u_time * a_endPosition);      \n"
-      "      gl_Position.xy += u_centerPosition;                               \n"
+      "    float time = u_time - a_startTime;                                  \n"
+      "    if (time >= 0.0 && time <= a_lifetime) {                            \n"
+      "      gl_Position.xy = a_startPosition + (time * a_endPosition);        \n"
+      "      gl_Position.xy += a_centerPosition;                               \n"
       "      gl_Position.z = 0.0;                                              \n"
       "      gl_Position.w = 1.0;                                              \n"
       "    } else {                                                            \n"
       "      gl_Position = vec4(-1000, -1000, 0, 0);                           \n"
       "    }                                                                   \n"
-      "    v_lifetime = 1.0 - (u_time / a_lifetime);                           \n"
+      "    v_lifetime = 1.0 - (time / a_lifetime);                             \n"
       "    v_lifetime = clamp(v_lifetime, 0.0, 1.0);                           \n"
+      "    v_color = a_color;                                                  \n"
       "    gl_PointSize = (v_lifetime * v_lifetime) * 40.0;                    \n"
       "  }                                                                     \n"
       ,
       "  precision mediump float;                            \n"
       "                                                      \n"
-      "  uniform vec4 u_color;                               \n"
       "  varying float v_lifetime;                           \n"
+      "  varying vec4 v_color;                               \n"
       "  uniform sampler2D s_texture;                        \n"
+      "  uniform vec4 u_texRegion;                           \n"
       "                                                      \n"
       "  void main() {                                       \n"
+      "    vec2 texCoord;                                    \n"
       "    vec4 texColor;                                    \n"
-      "    texColor = texture2D(s_texture, gl_PointCoord);   \n"
-      "    gl_FragColor = vec4(u_color) * texColor;          \n"
+      "    texCoord = mix(u_texRegion.xy, u_texRegion.zw,    \n"
+      "                   gl_PointCoord);                    \n"
+      "    texColor = texture2D(s_texture, texCoord);        \n"
+      "    gl_FragColor = v_color * texColor;                \n"
       "    gl_FragColor.a *= v_lifetime;                     \n"
       "  }                                                   \n") {
 }
@@ -317,10 +388,13 @@ ParticleMoveShader::ParticleMoveShader()
       "                                                                        \n"
       "  uniform vec4 u_color;                                                 \n"
       "  uniform sampler2D s_texture;                                          \n"
+      "  uniform vec4 u_texRegion;                                             \n"
       "                                                                        \n"
       "  void main() {                                                         \n"
+      "    vec2 texCoord;                                                      \n"
       "    vec4 texColor;                                                      \n"
-      "    texColor = texture2D(s_texture, gl_PointCoord);                     \n"
+      "    texCoord = mix(u_texRegion.xy, u_texRegion.zw, gl_PointCoord);      \n"
+      "    texColor = texture2D(s_texture, texCoord);                          \n"
       "    gl_FragColor = vec4(u_color) * texColor;                            \n"
       "  }                                                                     \n") {
 }
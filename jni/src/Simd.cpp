@@ -0,0 +1,48 @@
+#include "Simd.h"
+
+namespace util {
+namespace simd {
+
+constexpr int UniformLanes::lanes;
+
+void UniformLanes::seed(uint32_t seed) {
+  uint32_t states[lanes];
+  uint32_t value = seed;
+  for (int i = 0; i < lanes; ++i) {
+    // splitmix-like scrambling, so that close seeds give unrelated lanes
+    value += 0x9E3779B9u;
+    uint32_t state = value;
+    state = (state ^ (state >> 16)) * 0x85EBCA6Bu;
+    state = (state ^ (state >> 13)) * 0xC2B2AE35u;
+    state ^= state >> 16;
+    states[i] = state != 0 ? state : 0x6D2B79F5u;  // xorshift never leaves zero
+  }
+  m_low = loadu(states);
+  m_high = loadu(states + 4);
+}
+
+void UniformLanes::fill(float* output, int count) {
+  float4 low, high;
+  for (int i = 0; i + lanes <= count; i += lanes) {
+    next(&low, &high);
+    store(output + i, low);
+    store(output + i + 4, high);
+  }
+}
+
+void randomAffineVertices(float* vertices, int count, UniformLanes* random,
+                          const float* scale, const float* bias, const float* tail) {
+  float4 scale_low = load(scale), scale_high = load(scale + 4);
+  float4 bias_low = load(bias), bias_high = load(bias + 4);
+  float4 constant = load(tail);
+  float4 low, high;
+  for (int i = 0; i < count; ++i, vertices += 12) {
+    random->next(&low, &high);
+    store(vertices + 0, madd(low, scale_low, bias_low));
+    store(vertices + 4, madd(high, scale_high, bias_high));
+    store(vertices + 8, constant);
+  }
+}
+
+}  // namespace simd
+}  // namespace util
@@ -1,19 +1,68 @@
-#include <algorithm>
-#include <cstdio>
 #include <cstring>
-#include <libgen.h>
+#include <new>
 
 #include "logger.h"
+#include "Mixer.h"
 #include "SoundBuffer.h"
 
 namespace native {
 
+namespace {
+
+/// @brief Fields of RIFF are little-endian.
+inline uint16_t readUint16(const uint8_t* bytes) {
+  return static_cast<uint16_t>(bytes[0] | bytes[1] << 8);
+}
+
+inline uint32_t readUint32(const uint8_t* bytes) {
+  return static_cast<uint32_t>(bytes[0]) | static_cast<uint32_t>(bytes[1]) << 8 |
+         static_cast<uint32_t>(bytes[2]) << 16 | static_cast<uint32_t>(bytes[3]) << 24;
+}
+
+/// @brief Resamples 16-bit PCM of one or two channels into interleaved
+/// stereo at rate of Mixer, interpolating linearly between frames.
+/// @return Converted samples, owned by caller, or nullptr if allocation fails.
+uint8_t* convertToMixerFormat(const uint8_t* samples, size_t length,
+                              const WAVSound::WAVFormat& format, size_t* converted_length) {
+  typedef sound::Mixer Mixer;
+  size_t frames = length / format.block_align;
+  size_t converted_frames = static_cast<size_t>(
+      static_cast<uint64_t>(frames) * Mixer::sampleRate / format.sample_rate);
+  size_t converted_size = converted_frames * Mixer::channels * sizeof(int16_t);
+  uint8_t* buffer = new (std::nothrow) uint8_t[converted_size];  // released as bytes by unload()
+  if (buffer == nullptr) {
+    return nullptr;
+  }
+  int16_t* converted = reinterpret_cast<int16_t*>(buffer);
+  auto sample = [samples, &format](size_t frame, int channel) -> int {
+    const uint8_t* bytes = samples + frame * format.block_align + (channel % format.channels) * 2;
+    return static_cast<int16_t>(readUint16(bytes));
+  };
+  for (size_t i = 0; i < converted_frames; ++i) {
+    uint64_t position = static_cast<uint64_t>(i) * format.sample_rate;
+    size_t frame = static_cast<size_t>(position / Mixer::sampleRate);
+    size_t next = frame + 1 < frames ? frame + 1 : frame;
+    int fraction = static_cast<int>(position % Mixer::sampleRate);
+    for (int channel = 0; channel < Mixer::channels; ++channel) {
+      int from = sample(frame, channel);
+      int to = sample(next, channel);
+      converted[i * Mixer::channels + channel] = static_cast<int16_t>(
+          from + static_cast<int64_t>(to - from) * fraction / Mixer::sampleRate);
+    }
+  }
+  *converted_length = converted_size;
+  return buffer;
+}
+
+}  // namespace
+
 SoundBuffer::SoundBuffer(AssetStorage* assets, const char* filename)
   : m_read_mode(ReadMode::ASSETS)
   , m_assets(assets)
   , m_filename(new char[128])
   , m_length(0)
   , m_data(nullptr)
+  , m_view()
   , m_error_code(0) {
   strcpy(m_filename, filename);
 }
@@ -24,6 +73,7 @@ SoundBuffer::SoundBuffer(const char* filepath)
   , m_filename(new char[128])
   , m_length(0)
   , m_data(nullptr)
+  , m_view()
   , m_error_code(0) {
   strcpy(m_filename, filepath);
 }
@@ -38,14 +88,13 @@ const char* SoundBuffer::getFilename() const { return m_filename; }
 
 const char* SoundBuffer::getName() const {
   if (m_filename != nullptr) {
-    std::string lower = m_filename;
-    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
-    return basename(lower.c_str());
+    const char* separator = std::strrchr(m_filename, '/');
+    return separator != nullptr ? separator + 1 : m_filename;
   }
   return nullptr;
 }
 
-uint8_t* const SoundBuffer::getData() const { return m_data; }
+const uint8_t* SoundBuffer::getData() const { return m_data; }
 off_t SoundBuffer::getLength() const { return m_length; }
 
 bool SoundBuffer::load() {
@@ -58,7 +107,11 @@ bool SoundBuffer::load() {
 }
 
 void SoundBuffer::unload() {
-  delete [] m_data;  m_data = nullptr;
+  if (m_view.empty()) {
+    delete [] m_data;
+  }
+  m_data = nullptr;
+  m_view.release();
   m_length = 0;
 }
 
@@ -74,54 +127,101 @@ WAVSound::WAVSound(const char* filepath)
 WAVSound::~WAVSound() {
 }
 
-uint8_t* WAVSound::loadSound() {
-  WAVHeader* header = new WAVHeader();
-  uint8_t* data = nullptr;
-  FILE* file_descriptor = nullptr;
+const uint8_t* WAVSound::loadSound() {
+  WAVFormat format;
+  const uint8_t* samples = nullptr;
+  size_t length = 0;
+  size_t converted_length = 0;
+  uint8_t* copy = nullptr;
   int error_code = 0;
 
   switch (m_read_mode) {
     case ReadMode::ASSETS:
-      if (!m_assets->open(m_filename)) { error_code = 1; goto ERROR_SOUND; }
-      m_length = m_assets->length() - sizeof(WAVHeader);
-      data = new (std::nothrow) uint8_t[m_length];
-      if (data == nullptr) { error_code = 2; goto ERROR_SOUND; }
-      m_assets->read(header, sizeof(WAVHeader));
-      if (!m_assets->read(data, m_length)) { error_code = 3; goto ERROR_SOUND; }
-      m_assets->close();
+      m_view = m_assets->map(m_filename);
+      if (m_view.empty()) { error_code = 1; goto ERROR_SOUND; }
       break;
     case ReadMode::FILESYSTEM:
-      file_descriptor = std::fopen(m_filename, "rb");
-      if (file_descriptor == nullptr) { error_code = 4; goto ERROR_SOUND; }
-      fseek(file_descriptor, 0, SEEK_END);
-      m_length = ftell(file_descriptor) - sizeof(WAVHeader);
-      rewind(file_descriptor);
-      data = new (std::nothrow) uint8_t(m_length);
-      if (data == nullptr) { error_code = 5; goto ERROR_SOUND; }
-      std::fread(header, 1, sizeof(WAVHeader), file_descriptor);
-      if (m_length != std::fread(data, 1, m_length, file_descriptor)) { error_code = 6; goto ERROR_SOUND; }
-      std::fclose(file_descriptor);
+      m_view = AssetView::mapFile(m_filename);
+      if (m_view.empty()) { error_code = 4; goto ERROR_SOUND; }
       break;
   }
-  delete header;
-  return data;
+  error_code = parse(m_view.data(), m_view.size(), &format, &samples, &length);
+  if (error_code != 0) { goto ERROR_SOUND; }
+  if (format.audio_format != 1 || format.bits_per_sample != 16 ||
+      format.channels < 1 || format.channels > 2 || format.sample_rate == 0 ||
+      format.block_align != format.channels * 2) {
+    ERR("Sound %s is not 16-bit PCM of 1 or 2 channels: format %i, %i bits, %i channels",
+        m_filename, format.audio_format, format.bits_per_sample, format.channels);
+    error_code = 7; goto ERROR_SOUND;
+  }
+  if (format.channels != sound::Mixer::channels || format.sample_rate != sound::Mixer::sampleRate) {
+    // mixer plays voices as they are, so they are brought to its format once here
+    copy = convertToMixerFormat(samples, length, format, &converted_length);
+    if (copy == nullptr) { error_code = 2; goto ERROR_SOUND; }
+    DBG("Sound %s converted from %u Hz, %i channels", m_filename, format.sample_rate, format.channels);
+    m_length = converted_length;
+    m_view.release();
+    return copy;
+  }
+  m_length = length;
+
+  if (reinterpret_cast<uintptr_t>(samples) % alignof(int16_t) == 0) {
+    return samples;  // played right from view
+  }
+  copy = new (std::nothrow) uint8_t[length];
+  if (copy == nullptr) { error_code = 2; goto ERROR_SOUND; }
+  std::memcpy(copy, samples, length);
+  m_view.release();
+  return copy;
 
   ERROR_SOUND:
     m_error_code = 2020 + error_code;
     ERR("Error while reading raw sound: %i", m_error_code);
-    switch (m_read_mode) {
-      case ReadMode::ASSETS:
-        m_assets->close();
-        break;
-      case ReadMode::FILESYSTEM:
-        std::fclose(file_descriptor);
-        break;
+    m_view.release();
+    m_length = 0;
+    return nullptr;
+}
+
+int WAVSound::parse(const uint8_t* content, size_t size, WAVFormat* format,
+                    const uint8_t** samples, size_t* length) {
+  if (size < 12 || std::memcmp(content, "RIFF", 4) != 0 || std::memcmp(content + 8, "WAVE", 4) != 0) {
+    return 3;
+  }
+  bool has_format = false;
+  size_t offset = 12;
+  while (size - offset >= 8) {
+    const uint8_t* chunk = content + offset;
+    const uint8_t* body = chunk + 8;
+    size_t chunk_size = readUint32(chunk + 4);
+    size_t available = size - offset - 8;
+    if (std::memcmp(chunk, "fmt ", 4) == 0) {
+      if (chunk_size < 16 || chunk_size > available) {
+        return 5;
+      }
+      format->audio_format = readUint16(body);
+      format->channels = readUint16(body + 2);
+      format->sample_rate = readUint32(body + 4);
+      format->byte_rate = readUint32(body + 8);
+      format->block_align = readUint16(body + 12);
+      format->bits_per_sample = readUint16(body + 14);
+      has_format = true;
+    } else if (std::memcmp(chunk, "data", 4) == 0) {
+      if (!has_format) {
+        return 5;
+      }
+      if (chunk_size > available) {
+        return 6;
+      }
+      *samples = body;
+      *length = chunk_size;
+      return 0;
     }
-    if (data != nullptr) {
-      delete [] data;  data = nullptr;
+    if (chunk_size >= available) {
+      break;
     }
-    delete header;
-    return nullptr;
+    offset += 8 + chunk_size + (chunk_size & 1);  // chunks are word-aligned
+  }
+  return has_format ? 6 : 5;
 }
 
 }
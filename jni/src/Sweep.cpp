@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Sweep.h"
+
+namespace game {
+
+namespace {
+
+/// @brief Gap left between ball and impacted face at contact, so the next
+/// step doesn't start inside the block.
+constexpr GLfloat contactGap = 1e-5f;
+
+/// @brief Crossings of grid lines by leading edge of box along single axis.
+struct Axis {
+  int next;       //!< Index of cell to be entered by leading edge.
+  int step;       //!< Direction of motion: +1, -1 or 0.
+  GLfloat time;   //!< Fraction of the step when next grid line is crossed.
+  GLfloat delta;  //!< Fraction of the step between adjacent grid lines.
+
+  Axis(GLfloat center, GLfloat half, GLfloat motion, GLfloat cell)
+    : next(0), step(0)
+    , time(std::numeric_limits<GLfloat>::infinity())
+    , delta(std::numeric_limits<GLfloat>::infinity()) {
+    if (motion > 0.0f) {
+      GLfloat edge = center + half;
+      step = 1;
+      next = static_cast<int>(std::ceil(edge / cell));
+      time = (next * cell - edge) / motion;
+      delta = cell / motion;
+    } else if (motion < 0.0f) {
+      GLfloat edge = center - half;
+      step = -1;
+      next = static_cast<int>(std::floor(edge / cell)) - 1;
+      time = ((next + 1) * cell - edge) / motion;
+      delta = -cell / motion;
+    }
+  }
+
+  /// @brief Coordinate of ball's center touching the next grid line.
+  inline GLfloat contact(GLfloat half, GLfloat cell) const {
+    return step > 0 ? next * cell - half - contactGap : (next + 1) * cell + half + contactGap;
+  }
+
+  inline void advance() {
+    next += step;
+    time += delta;
+  }
+};
+
+/// @brief Range of cells covered by segment [center - half, center + half).
+inline void span(GLfloat center, GLfloat half, GLfloat cell, int* first, int* last) {
+  *first = static_cast<int>(std::floor((center - half) / cell));
+  *last = static_cast<int>(std::ceil((center + half) / cell)) - 1;
+}
+
+/// @brief Looks for non-empty block among cells [first, last] of a single
+/// row or column, the cell under ball's center is tried first.
+/// @return Index of cell or -1 if all cells are empty.
+template <typename Blocks>
+int findBlock(Blocks blocks, int first, int last, int center, int size) {
+  first = std::max(first, 0);
+  last = std::min(last, size - 1);
+  if (center >= first && center <= last && blocks(center) != Block::NONE) {
+    return center;
+  }
+  for (int index = first; index <= last; ++index) {
+    if (index != center && blocks(index) != Block::NONE) {
+      return index;
+    }
+  }
+  return -1;
+}
+
+}
+
+bool sweepBlocks(
+    const Level& level,
+    const LevelDimens& dimens,
+    GLfloat half_width,
+    GLfloat half_height,
+    GLfloat from_x,
+    GLfloat from_y,
+    GLfloat to_x,
+    GLfloat to_y,
+    Impact* impact) {
+
+  const GLfloat block_width = dimens.getBlockWidth();
+  const GLfloat block_height = dimens.getBlockHeight();
+  const int rows = level.numRows();
+  const int cols = level.numCols();
+
+  // grid space: origin at level's top-left corner, Y axis points down
+  const GLfloat x0 = from_x + 1.0f;
+  const GLfloat y0 = 1.0f - from_y;
+  const GLfloat dx = to_x - from_x;
+  const GLfloat dy = from_y - to_y;
+
+  Axis horizontal(x0, half_width, dx, block_width);
+  Axis vertical(y0, half_height, dy, block_height);
+
+  while (std::min(horizontal.time, vertical.time) <= 1.0f) {
+    bool cross_column = horizontal.time <= vertical.time;
+    bool cross_both = horizontal.time == vertical.time;
+    GLfloat time = cross_column ? horizontal.time : vertical.time;
+    GLfloat x = x0 + dx * time;
+    GLfloat y = y0 + dy * time;
+    int first = 0, last = 0, row = -1, col = -1;
+
+    if (cross_column) {
+      // column is entered: check rows covered by the box at this moment
+      col = horizontal.next;
+      if (col >= 0 && col < cols) {
+        span(y, half_height, block_height, &first, &last);
+        if (cross_both) {  // diagonal cell is entered as well
+          first = std::min(first, vertical.next);
+          last = std::max(last, vertical.next);
+        }
+        row = findBlock([&level, col](int r) { return level.getBlock(r, col); },
+                        first, last, static_cast<int>(std::floor(y / block_height)), rows);
+      }
+    } else {
+      // row is entered: check columns covered by the box at this moment
+      row = vertical.next;
+      if (row >= 0 && row < rows) {
+        span(x, half_width, block_width, &first, &last);
+        col = findBlock([&level, row](int c) { return level.getBlock(row, c); },
+                        first, last, static_cast<int>(std::floor(x / block_width)), cols);
+      }
+    }
+
+    if (row >= 0 && col >= 0) {
+      impact->row = row;
+      impact->col = col;
+      impact->vertical = Direction::NONE;
+      impact->horizontal = Direction::NONE;
+      impact->time = time;
+      if (cross_column) {
+        impact->horizontal = horizontal.step > 0 ? Direction::RIGHT : Direction::LEFT;
+        x = horizontal.contact(half_width, block_width);
+      }
+      if (!cross_column || (cross_both && row == vertical.next)) {
+        impact->vertical = vertical.step > 0 ? Direction::DOWN : Direction::UP;
+        y = vertical.contact(half_height, block_height);
+      }
+      impact->x = x - 1.0f;
+      impact->y = 1.0f - y;
+      return true;
+    }
+
+    if (cross_column) {
+      horizontal.advance();
+    } else {
+      vertical.advance();
+    }
+  }
+  return false;
+}
+
+}
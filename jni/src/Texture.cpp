@@ -27,8 +27,9 @@
  */
 
 #include <algorithm>
-#include <cstdio>
 #include <cstring>
+#include <new>
+#include <vector>
 
 #include "logger.h"
 #include "Texture.h"
@@ -36,16 +37,37 @@
 
 namespace native {
 
+namespace {
+
+long long microsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+size_t bytesPerPixel(GLint format) {
+  switch (format) {
+    case GL_RGBA:             return 4;
+    case GL_RGB:              return 3;
+    case GL_LUMINANCE_ALPHA:  return 2;
+    default:                  return 1;
+  }
+}
+
+}  // namespace
+
 Texture::Texture(AssetStorage* assets, const char* filename)
   : m_read_mode(ReadMode::ASSETS)
   , m_assets(assets)
   , m_filename(new char[128])
+  , m_pixels(nullptr)
   , m_data_size(0)
   , m_id(0)
   , m_format(0)
   , m_width(0)
   , m_height(0)
-  , m_error_code(0) {
+  , m_error_code(0)
+  , m_decode_micros(0)
+  , m_upload_micros(0)
+  , m_video_memory(0) {
   strcpy(m_filename, filename);
 }
 
@@ -53,12 +75,16 @@ Texture::Texture(const char* filepath)
   : m_read_mode(ReadMode::FILESYSTEM)
   , m_assets(nullptr)
   , m_filename(new char[128])
+  , m_pixels(nullptr)
   , m_data_size(0)
   , m_id(0)
   , m_format(0)
   , m_width(0)
   , m_height(0)
-  , m_error_code(0) {
+  , m_error_code(0)
+  , m_decode_micros(0)
+  , m_upload_micros(0)
+  , m_video_memory(0) {
   strcpy(m_filename, filepath);
 }
 
@@ -74,23 +100,47 @@ int32_t Texture::getWidth() const { return m_width; }
 int32_t Texture::getHeight() const { return m_height; }
 const char* Texture::getFilename() const { return m_filename; }
 int Texture::getErrorCode() const { return m_error_code; }
+long long Texture::getDecodeMicros() const { return m_decode_micros; }
+long long Texture::getUploadMicros() const { return m_upload_micros; }
+size_t Texture::getVideoMemory() const { return m_video_memory; }
 
 const char* Texture::getName() const {
   if (m_filename != nullptr) {
-    std::string lower = m_filename;
-    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
-    return basename(lower.c_str());
+    const char* separator = std::strrchr(m_filename, '/');
+    return separator != nullptr ? separator + 1 : m_filename;
   }
   return nullptr;
 }
 
 bool Texture::load() {
-  const uint8_t* image_buffer = loadImage();
-  if (image_buffer == nullptr) {
+  return decode() && upload();
+}
+
+bool Texture::decode() {
+  Clock::time_point start = Clock::now();
+  delete [] m_pixels;
+  m_pixels = loadImage();
+  m_decode_micros = microsSince(start);
+  if (m_pixels == nullptr) {
     ERR("Internal error during loading texture! Code: %i", m_error_code);
     return false;
   }
+  return true;
+}
 
+bool Texture::upload() {
+  if (m_pixels == nullptr) {
+    ERR("Texture %s has not been decoded!", m_filename);
+    return false;
+  }
+
+  Clock::time_point start = Clock::now();
+  generateTexture();
+  glTexImage2D(GL_TEXTURE_2D, 0, m_format, m_width, m_height, 0, m_format, m_type, m_pixels);
+  return completeUpload(start, static_cast<size_t>(m_width) * m_height * bytesPerPixel(m_format));
+}
+
+void Texture::generateTexture() {
   glGenTextures(1, &m_id);
   glBindTexture(GL_TEXTURE_2D, m_id);
 //  glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE);
@@ -98,21 +148,36 @@ bool Texture::load() {
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-  glTexImage2D(GL_TEXTURE_2D, 0, m_format, m_width, m_height, 0, m_format, m_type, image_buffer);
-  delete [] image_buffer;  image_buffer = nullptr;
+}
+
+bool Texture::completeUpload(Clock::time_point start, size_t video_memory) {
+  delete [] m_pixels;  m_pixels = nullptr;
   glBindTexture(GL_TEXTURE_2D, 0);
 
   GLenum glerror = glGetError();
   if (glerror != GL_NO_ERROR) {
-    ERR("Error loading texture %s into OpenGL, gl error %zu, Details: fmt=%i, w=%zu h=%zu, type=%i",
+    ERR("Error loading texture %s into OpenGL, gl error %u, Details: fmt=%i, w=%u h=%u, type=%i",
         m_filename, glerror, m_format, m_width, m_height, m_type);
     unload();
     return false;
   }
+  m_upload_micros = microsSince(start);
+  m_video_memory = video_memory;
+  INF("Texture %s: %ix%i, decoded in %.2f ms, uploaded in %.2f ms, %zu KB of video memory",
+      getName(), m_width, m_height, m_decode_micros / 1000.0, m_upload_micros / 1000.0, m_video_memory / 1024);
   return true;
 }
 
+const uint8_t* Texture::getPixels() const {
+  return m_pixels;
+}
+
+void Texture::discard() {
+  delete [] m_pixels;  m_pixels = nullptr;
+}
+
 void Texture::unload() {
+  delete [] m_pixels;  m_pixels = nullptr;
   glBindTexture(GL_TEXTURE_2D, 0);
   if (m_id != 0) {
     glDeleteTextures(1, &m_id);
@@ -121,6 +186,7 @@ void Texture::unload() {
   m_format = 0;
   m_width = 0;
   m_height = 0;
+  m_video_memory = 0;
 }
 
 void Texture::apply() const {
@@ -141,8 +207,8 @@ PNGTexture::~PNGTexture() {
 }
 
 const uint8_t* PNGTexture::loadImage() {
-  FILE* file_descriptor = nullptr;
-  png_byte header[8];
+  AssetView view;
+  ReadCursor cursor {nullptr, 0, 0};
   png_structp png_ptr = nullptr;
   png_infop info_ptr = nullptr;
   png_byte* image_buffer = nullptr;
@@ -151,33 +217,28 @@ const uint8_t* PNGTexture::loadImage() {
   bool transparency = false;
   int error_code = 0;
 
-  size_t header_size = sizeof(header);
+  const size_t header_size = 8;
   switch (m_read_mode) {
     case ReadMode::ASSETS:
-      if (!m_assets->open(m_filename)) { error_code = 1; goto ERROR_PNG; }
-      if (!m_assets->read(header, header_size)) { error_code = 2; goto ERROR_PNG; }
+      view = m_assets->map(m_filename);
+      if (view.empty()) { error_code = 1; goto ERROR_PNG; }
+      if (view.size() < header_size) { error_code = 2; goto ERROR_PNG; }
       break;
     case ReadMode::FILESYSTEM:
-      file_descriptor = std::fopen(m_filename, "rb");
-      if (file_descriptor == nullptr) { error_code = 10; goto ERROR_PNG; }
-      if (header_size != std::fread(header, 1, header_size, file_descriptor)) { error_code = 11; goto ERROR_PNG; }
+      view = AssetView::mapFile(m_filename);
+      if (view.empty()) { error_code = 10; goto ERROR_PNG; }
+      if (view.size() < header_size) { error_code = 11; goto ERROR_PNG; }
       break;
   }
-  if (png_sig_cmp(header, 0, 8) != 0) { error_code = 3; goto ERROR_PNG; }
+  if (png_sig_cmp(view.data(), 0, header_size) != 0) { error_code = 3; goto ERROR_PNG; }
 
   png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
   if (png_ptr == nullptr) { error_code = 4; goto ERROR_PNG; }
   info_ptr = png_create_info_struct(png_ptr);
   if (info_ptr == nullptr) { error_code = 5; goto ERROR_PNG; }
 
-  switch (m_read_mode) {
-    case ReadMode::ASSETS:
-      png_set_read_fn(png_ptr, m_assets, callback_read_assets);
-      break;
-    case ReadMode::FILESYSTEM:
-      png_set_read_fn(png_ptr, file_descriptor, callback_read_file);
-      break;
-  }
+  cursor = ReadCursor {view.data(), view.size(), header_size};
+  png_set_read_fn(png_ptr, &cursor, callback_read_memory);
   {
     int jump_code = 0;
     if ( (jump_code = setjmp(png_jmpbuf(png_ptr))) != 0) {
@@ -186,7 +247,7 @@ const uint8_t* PNGTexture::loadImage() {
     }
   }
 
-  png_set_sig_bytes(png_ptr, 8);
+  png_set_sig_bytes(png_ptr, header_size);
   png_read_info(png_ptr, info_ptr);
 
   png_int_32 depth, color_type;
@@ -226,6 +287,7 @@ const uint8_t* PNGTexture::loadImage() {
       break;
   }
   m_type = GL_UNSIGNED_BYTE;
+  png_set_interlace_handling(png_ptr);  // png_read_image() de-interlaces whole image
   png_read_update_info(png_ptr, info_ptr);
 
   row_size = png_get_rowbytes(png_ptr, info_ptr);
@@ -235,19 +297,12 @@ const uint8_t* PNGTexture::loadImage() {
 
   row_ptrs = new (std::nothrow) png_bytep[height];
   if (row_ptrs == nullptr) { error_code = 9; goto ERROR_PNG; }
-  for (int32_t i = 0; i < height; ++i) {
+  for (png_uint_32 i = 0; i < height; ++i) {
     row_ptrs[height - (i + 1)] = image_buffer + i * row_size;
   }
   png_read_image(png_ptr, row_ptrs);
 
-  switch (m_read_mode) {
-    case ReadMode::ASSETS:
-      m_assets->close();
-      break;
-    case ReadMode::FILESYSTEM:
-      std::fclose(file_descriptor);
-      break;
-  }
+  view.release();
   png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
   delete [] row_ptrs;
   return image_buffer;
@@ -255,14 +310,7 @@ const uint8_t* PNGTexture::loadImage() {
   ERROR_PNG:
     m_error_code = static_cast<int>(ImageCode::png) * 100 + error_code;
     ERR("Error while reading PNG file: %s, code %i", m_filename, m_error_code);
-    switch (m_read_mode) {
-      case ReadMode::ASSETS:
-        m_assets->close();
-        break;
-      case ReadMode::FILESYSTEM:
-        std::fclose(file_descriptor);
-        break;
-    }
+    view.release();
     delete [] image_buffer;  image_buffer = nullptr;
     delete [] row_ptrs;  row_ptrs = nullptr;
     if (png_ptr != nullptr) {
@@ -272,20 +320,154 @@ const uint8_t* PNGTexture::loadImage() {
     return nullptr;
 }
 
-void PNGTexture::callback_read_assets(png_structp io, png_bytep data, png_size_t size) {
-  AssetStorage* assets = (AssetStorage*) png_get_io_ptr(io);
-  if (!assets->read(data, size)) {
-    assets->close();
-    png_error(io, "Error while reading PNG file (from callback_read_assets()) !");
+void PNGTexture::callback_read_memory(png_structp io, png_bytep data, png_size_t size) {
+  ReadCursor* cursor = static_cast<ReadCursor*>(png_get_io_ptr(io));
+  if (size > cursor->size - cursor->offset) {
+    png_error(io, "Error while reading PNG file (from callback_read_memory()) !");
   }
+  std::memcpy(data, cursor->data + cursor->offset, size);
+  cursor->offset += size;
+}
+
+// ----------------------------------------------------------------------------
+KTXTexture::KTXTexture(AssetStorage* assets, const char* filename, const char* compressed_filename)
+  : PNGTexture(assets, filename)
+  , m_compressed_filename(new char[std::strlen(compressed_filename) + 1])
+  , m_compressed(false) {
+  std::strcpy(m_compressed_filename, compressed_filename);
 }
 
-void PNGTexture::callback_read_file(png_structp io, png_bytep data, png_size_t size) {
-  FILE* file = (FILE*) png_get_io_ptr(io);
-  if (size != std::fread(data, 1, size, file)) {
-    std::fclose(file);
-    png_error(io, "Error while reading PNG file (from callback_read_file()) !");
+KTXTexture::KTXTexture(const char* filepath, const char* compressed_filepath)
+  : PNGTexture(filepath)
+  , m_compressed_filename(new char[std::strlen(compressed_filepath) + 1])
+  , m_compressed(false) {
+  std::strcpy(m_compressed_filename, compressed_filepath);
+}
+
+KTXTexture::~KTXTexture() {
+  delete [] m_compressed_filename;  m_compressed_filename = nullptr;
+}
+
+const char* KTXTexture::getCompressedFilename() const { return m_compressed_filename; }
+bool KTXTexture::isCompressed() const { return m_compressed; }
+
+bool KTXTexture::isFormatSupported(GLenum format) {
+  GLint count = 0;
+  glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count);
+  if (count <= 0) {
+    return false;
+  }
+  std::vector<GLint> formats(count);
+  glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, &formats[0]);
+  return std::find(formats.begin(), formats.end(), static_cast<GLint>(format)) != formats.end();
+}
+
+bool KTXTexture::upload() {
+  if (!m_compressed) {
+    return Texture::upload();
+  }
+  if (m_pixels == nullptr) {
+    ERR("Texture %s has not been decoded!", m_compressed_filename);
+    return false;
+  }
+  if (!isFormatSupported(m_format)) {
+    WRN("Compressed format 0x%x of texture %s is not supported, decoding PNG", m_format, m_compressed_filename);
+    return fallback() && Texture::upload();
+  }
+
+  Clock::time_point start = Clock::now();
+  generateTexture();
+  glCompressedTexImage2D(GL_TEXTURE_2D, 0, m_format, m_width, m_height, 0, m_data_size, m_pixels);
+  if (completeUpload(start, m_data_size)) {
+    return true;
+  }
+  WRN("Failed to upload compressed texture %s, decoding PNG", m_compressed_filename);
+  return fallback() && Texture::upload();
+}
+
+bool KTXTexture::fallback() {
+  Clock::time_point start = Clock::now();
+  delete [] m_pixels;
+  m_compressed = false;
+  m_pixels = PNGTexture::loadImage();
+  m_decode_micros += microsSince(start);
+  if (m_pixels == nullptr) {
+    ERR("Internal error during loading texture! Code: %i", m_error_code);
+    return false;
   }
+  return true;
+}
+
+const uint8_t* KTXTexture::loadImage() {
+  static const uint8_t identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'};
+  AssetView view;
+  uint32_t header[13];  // endianness, glType, glTypeSize, glFormat, glInternalFormat, glBaseInternalFormat,
+                        // width, height, depth, array elements, faces, mip levels, bytes of key/value data
+  uint32_t image_size = 0;
+  size_t offset = 0;
+  size_t block_size = 0;
+  GLenum format = 0;
+  uint8_t* image = nullptr;
+  int error_code = 0;
+
+  const size_t header_size = sizeof(identifier) + sizeof(header);
+  switch (m_read_mode) {
+    case ReadMode::ASSETS:
+      view = m_assets->map(m_compressed_filename);
+      if (view.empty()) { error_code = 1; goto ERROR_KTX; }
+      break;
+    case ReadMode::FILESYSTEM:
+      view = AssetView::mapFile(m_compressed_filename);
+      if (view.empty()) { error_code = 10; goto ERROR_KTX; }
+      break;
+  }
+  if (view.size() < header_size + sizeof(image_size)) { error_code = 2; goto ERROR_KTX; }
+  std::memcpy(header, view.data() + sizeof(identifier), sizeof(header));
+  if (std::memcmp(view.data(), identifier, sizeof(identifier)) != 0 || header[0] != 0x04030201) {
+    error_code = 3; goto ERROR_KTX;
+  }
+
+  format = header[4];
+  switch (format) {
+    case GL_ETC1_RGB8_OES:
+    case GL_COMPRESSED_RGB8_ETC2:
+      block_size = 8;
+      break;
+    case GL_COMPRESSED_RGBA8_ETC2_EAC:
+      block_size = 16;
+      break;
+  }
+  if (header[1] != 0 || header[3] != 0 || block_size == 0) { error_code = 4; goto ERROR_KTX; }
+  if (header[8] > 1 || header[9] != 0 || header[10] != 1) { error_code = 5; goto ERROR_KTX; }
+
+  offset = header_size + header[12];  // key/value data is skipped, orientation is known
+  if (offset + sizeof(image_size) > view.size()) { error_code = 6; goto ERROR_KTX; }
+  std::memcpy(&image_size, view.data() + offset, sizeof(image_size));
+  offset += sizeof(image_size);
+  if (image_size != ((header[6] + 3) / 4) * ((header[7] + 3) / 4) * block_size ||
+      offset + image_size > view.size()) {
+    error_code = 6; goto ERROR_KTX;
+  }
+
+  image = new (std::nothrow) uint8_t[image_size];
+  if (image == nullptr) { error_code = 7; goto ERROR_KTX; }
+  std::memcpy(image, view.data() + offset, image_size);
+  view.release();
+
+  m_width = header[6];
+  m_height = header[7];
+  m_format = format;
+  m_type = 0;
+  m_data_size = image_size;
+  m_compressed = true;
+  return image;
+
+  ERROR_KTX:
+    m_error_code = static_cast<int>(ImageCode::ktx) * 100 + error_code;
+    WRN("Error while reading KTX file: %s, code %i, decoding PNG", m_compressed_filename, m_error_code);
+    view.release();
+    m_compressed = false;
+    return PNGTexture::loadImage();
 }
 
 }  // namespace native
@@ -0,0 +1,343 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <unordered_set>
+
+#include "logger.h"
+#include "TextureAtlas.h"
+
+namespace native {
+
+/* Sprite */
+// ----------------------------------------------------------------------------
+Sprite::Sprite()
+  : Sprite(nullptr, 0, 0, 0, 0) {
+}
+
+Sprite::Sprite(const Texture* texture, int32_t x, int32_t y, int32_t width, int32_t height)
+  : texture(texture)
+  , x(x)
+  , y(y)
+  , width(width)
+  , height(height)
+  , uv()
+  , tex_coords() {
+}
+
+void Sprite::apply() const {
+  if (texture != nullptr) {
+    texture->apply();
+  } else {
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+  }
+}
+
+void Sprite::setRegion(int32_t texture_width, int32_t texture_height) {
+  GLfloat u0 = static_cast<GLfloat>(x) / texture_width;
+  GLfloat v0 = static_cast<GLfloat>(y) / texture_height;
+  GLfloat u1 = static_cast<GLfloat>(x + width) / texture_width;
+  GLfloat v1 = static_cast<GLfloat>(y + height) / texture_height;
+  uv[0] = u0;  uv[1] = v0;  uv[2] = u1;  uv[3] = v1;
+  GLfloat strip[8] = {u1, v1, u0, v1, u1, v0, u0, v0};
+  std::copy(strip, strip + 8, tex_coords);
+}
+
+/* Page */
+// ----------------------------------------------------------------------------
+/// @brief Texture composed of images, packed by skyline of their tops.
+class TextureAtlas::Page : public Texture {
+public:
+  Page(const char* name, int32_t size, int32_t padding);
+  virtual ~Page();
+
+  /// @brief Finds the lowest place for image, then the leftmost one.
+  /// @return false if there is no room or page has been uploaded.
+  bool insert(int32_t width, int32_t height, int32_t* x, int32_t* y);
+  /// @brief Copies decoded image to given place and repeats its edges
+  /// over padding around.
+  void blit(const Texture& texture, int32_t x, int32_t y);
+
+  /// @brief Whether image has been handed over to upload.
+  inline bool isSealed() const { return m_canvas == nullptr; }
+  inline void abandon() { m_id = 0; }
+
+protected:
+  /// @brief Trims canvas to packed area and hands it over.
+  const uint8_t* loadImage() override final;
+
+private:
+  /// @brief Top of images packed in range [x, x + width).
+  struct Segment {
+    int32_t x;
+    int32_t y;
+    int32_t width;
+  };
+
+  /// @brief Lowest position of image placed on top of segment at index.
+  bool fit(size_t index, int32_t width, int32_t height, int32_t* y) const;
+
+  int32_t m_size;
+  int32_t m_padding;
+  uint8_t* m_canvas;  //!< RGBA, m_size x m_size, until uploaded.
+  std::vector<Segment> m_skyline;  //!< Covers whole width, ordered by x.
+  int32_t m_used_width;
+  int32_t m_used_height;
+};
+
+TextureAtlas::Page::Page(const char* name, int32_t size, int32_t padding)
+  : Texture(name)
+  , m_size(size)
+  , m_padding(padding)
+  , m_canvas(new (std::nothrow) uint8_t[size * size * 4]())
+  , m_skyline{Segment {0, 0, size}}
+  , m_used_width(0)
+  , m_used_height(0) {
+  if (m_canvas == nullptr) {
+    ERR("Failed to allocate atlas page %s of size %i", name, size);
+  }
+}
+
+TextureAtlas::Page::~Page() {
+  delete [] m_canvas;  m_canvas = nullptr;
+}
+
+bool TextureAtlas::Page::fit(size_t index, int32_t width, int32_t height, int32_t* y) const {
+  if (m_skyline[index].x + width > m_size) {
+    return false;
+  }
+  int32_t top = 0;
+  for (int32_t left = width; left > 0; left -= m_skyline[index++].width) {
+    top = std::max(top, m_skyline[index].y);
+    if (top + height > m_size) {
+      return false;
+    }
+  }
+  *y = top;
+  return true;
+}
+
+bool TextureAtlas::Page::insert(int32_t width, int32_t height, int32_t* x, int32_t* y) {
+  if (isSealed()) {
+    return false;
+  }
+  width += 2 * m_padding;
+  height += 2 * m_padding;
+
+  size_t best = m_skyline.size();
+  int32_t best_y = m_size;
+  for (size_t i = 0; i < m_skyline.size(); ++i) {
+    int32_t top = 0;
+    if (fit(i, width, height, &top) && top < best_y) {
+      best = i;
+      best_y = top;
+    }
+  }
+  if (best == m_skyline.size()) {
+    return false;
+  }
+
+  Segment segment {m_skyline[best].x, best_y + height, width};
+  m_skyline.insert(m_skyline.begin() + best, segment);
+  // cut segments now covered by the new one
+  int32_t right = segment.x + segment.width;
+  for (size_t i = best + 1; i < m_skyline.size() && m_skyline[i].x < right; ) {
+    int32_t covered = right - m_skyline[i].x;
+    if (covered >= m_skyline[i].width) {
+      m_skyline.erase(m_skyline.begin() + i);
+    } else {
+      m_skyline[i].x += covered;
+      m_skyline[i].width -= covered;
+      break;
+    }
+  }
+  for (size_t i = 0; i + 1 < m_skyline.size(); ) {
+    if (m_skyline[i].y == m_skyline[i + 1].y) {
+      m_skyline[i].width += m_skyline[i + 1].width;
+      m_skyline.erase(m_skyline.begin() + i + 1);
+    } else {
+      ++i;
+    }
+  }
+
+  m_used_width = std::max(m_used_width, right);
+  m_used_height = std::max(m_used_height, segment.y);
+  *x = segment.x + m_padding;
+  *y = best_y + m_padding;
+  return true;
+}
+
+void TextureAtlas::Page::blit(const Texture& texture, int32_t x, int32_t y) {
+  const int channels = texture.getFormat() == GL_RGBA ? 4 : 3;
+  const int32_t width = texture.getWidth();
+  const int32_t height = texture.getHeight();
+  const uint8_t* pixels = texture.getPixels();
+
+  for (int32_t row = -m_padding; row < height + m_padding; ++row) {
+    const uint8_t* source = pixels + std::min(std::max(row, 0), height - 1) * width * channels;
+    uint8_t* target = m_canvas + ((y + row) * m_size + x) * 4;
+    if (channels == 4) {
+      std::memcpy(target, source, width * 4);
+    } else {
+      for (int32_t col = 0; col < width; ++col) {
+        std::memcpy(target + col * 4, source + col * 3, 3);
+        target[col * 4 + 3] = 255;
+      }
+    }
+    for (int32_t i = 1; i <= m_padding; ++i) {
+      std::memcpy(target - i * 4, target, 4);
+      std::memcpy(target + (width - 1 + i) * 4, target + (width - 1) * 4, 4);
+    }
+  }
+}
+
+const uint8_t* TextureAtlas::Page::loadImage() {
+  uint8_t* canvas = m_canvas;
+  m_canvas = nullptr;
+  if (canvas == nullptr) {
+    return nullptr;
+  }
+  // rows of trimmed image are contiguous, each moves towards the start
+  for (int32_t row = 1; row < m_used_height; ++row) {
+    std::memmove(canvas + row * m_used_width * 4, canvas + row * m_size * 4, m_used_width * 4);
+  }
+  m_width = m_used_width;
+  m_height = m_used_height;
+  m_format = GL_RGBA;
+  m_type = GL_UNSIGNED_BYTE;
+  return canvas;
+}
+
+/* Atlas */
+// ----------------------------------------------------------------------------
+TextureAtlas::TextureAtlas(int32_t page_size, int32_t padding)
+  : m_page_size(page_size)
+  , m_padding(padding)
+  , m_missing(nullptr, 0, 0, 1, 1) {
+  m_missing.setRegion(1, 1);
+}
+
+TextureAtlas::~TextureAtlas() {
+  for (Page* page : m_pages) {
+    delete page;
+  }
+  m_pages.clear();
+}
+
+bool TextureAtlas::add(Texture* texture) {
+  if (texture->getPixels() == nullptr) {
+    ERR("Texture %s has not been decoded!", texture->getFilename());
+    return false;
+  }
+  const int32_t width = texture->getWidth();
+  const int32_t height = texture->getHeight();
+  const GLint format = texture->getFormat();
+  Sprite& sprite = m_sprites[texture->getName()];
+
+  const int32_t half_page = m_page_size / 2 - 2 * m_padding;
+  if ((format != GL_RGB && format != GL_RGBA) || width > half_page || height > half_page) {
+    sprite = Sprite(texture, 0, 0, width, height);
+    if (!texture->upload()) {
+      sprite.texture = nullptr;
+      return false;
+    }
+    sprite.setRegion(width, height);
+    return true;
+  }
+
+  int32_t x = 0, y = 0;
+  Page* page = nullptr;
+  for (Page* candidate : m_pages) {
+    if (candidate->insert(width, height, &x, &y)) {
+      page = candidate;
+      break;
+    }
+  }
+  if (page == nullptr) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "atlas_%zu", m_pages.size());
+    page = new Page(name, m_page_size, m_padding);
+    m_pages.push_back(page);
+    if (!page->insert(width, height, &x, &y)) {
+      ERR("Texture %s does not fit into empty atlas page!", texture->getFilename());
+      texture->discard();
+      sprite.texture = nullptr;
+      return false;
+    }
+  }
+  page->blit(*texture, x, y);
+  texture->discard();
+  sprite = Sprite(page, x, y, width, height);  // regions are set on upload
+  DBG("Packed texture %s into %s at (%i, %i)", texture->getName(), page->getFilename(), x, y);
+  return true;
+}
+
+bool TextureAtlas::upload() {
+  bool success = true;
+  for (Page* page : m_pages) {
+    if (page->isSealed()) {
+      continue;
+    }
+    if (!page->load()) {
+      ERR("Failed to upload atlas page %s", page->getFilename());
+      success = false;
+      continue;
+    }
+    INF("Uploaded atlas page %s of size %ix%i", page->getFilename(), page->getWidth(), page->getHeight());
+  }
+
+  std::unordered_set<const Texture*> used;
+  for (auto& item : m_sprites) {
+    Sprite& sprite = item.second;
+    if (sprite.texture != nullptr && sprite.texture->getWidth() > 0 && sprite.texture->getHeight() > 0) {
+      sprite.setRegion(sprite.texture->getWidth(), sprite.texture->getHeight());
+    }
+    used.insert(sprite.texture);
+  }
+  for (auto it = m_pages.begin(); it != m_pages.end(); ) {
+    if (used.find(*it) == used.end()) {
+      delete *it;
+      it = m_pages.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  return success;
+}
+
+void TextureAtlas::abandon() {
+  for (Page* page : m_pages) {
+    page->abandon();
+  }
+}
+
+const Sprite* TextureAtlas::getSprite(const std::string& name) const {
+  auto it = m_sprites.find(name);
+  return it != m_sprites.end() ? &it->second : &m_missing;
+}
+
+bool TextureAtlas::contains(const std::string& name) const {
+  return m_sprites.find(name) != m_sprites.end();
+}
+
+size_t TextureAtlas::getPageCount() const {
+  return m_pages.size();
+}
+
+const Texture* TextureAtlas::getPage(size_t index) const {
+  return m_pages.at(index);
+}
+
+long long TextureAtlas::getPackedArea() const {
+  std::unordered_set<const Texture*> pages(m_pages.begin(), m_pages.end());
+  long long area = 0;
+  for (auto& item : m_sprites) {
+    if (pages.find(item.second.texture) != pages.end()) {
+      area += static_cast<long long>(item.second.width) * item.second.height;
+    }
+  }
+  return area;
+}
+
+}  // namespace native
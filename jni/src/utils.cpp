@@ -1,3 +1,7 @@
+#include <chrono>
+#include <cstdint>
+
+#include "Simd.h"
 #include "utils.h"
 
 namespace util {
@@ -11,6 +15,42 @@ void setColor(const GLfloat* const bgra, GLfloat* const color_buffer, size_t siz
   }
 }
 
+/// @brief Writes cells of a grid, vertex k of cell (r, c) is
+/// (x_offset + x_shifts[k] + width * (c + col_shifts[k]), y(r, k), 0, 1),
+/// negative column shift makes vertex independent of column.
+/// @details Vertices along a row differ only by X, so each one is a
+/// single multiply-add of column index against per-row base vector.
+template <int Vertices, typename RowY>
+static void setGridVertices(
+    GLfloat* const array,
+    GLfloat width,
+    GLfloat x_offset,
+    const GLfloat (&x_shifts)[Vertices],
+    const int (&col_shifts)[Vertices],
+    size_t cols,
+    size_t rows,
+    RowY row_y) {
+
+  using namespace simd;
+  float4 steps[Vertices];
+  float4 bases[Vertices];
+  for (int k = 0; k < Vertices; ++k) {
+    steps[k] = set(col_shifts[k] < 0 ? 0.0f : width, 0.0f, 0.0f, 0.0f);
+  }
+  GLfloat* vertex = array;
+  for (size_t r = 0; r < rows; ++r) {
+    for (int k = 0; k < Vertices; ++k) {
+      bases[k] = set(x_offset + x_shifts[k], row_y(r, k), 0.0f, 1.0f);
+    }
+    for (size_t c = 0; c < cols; ++c) {
+      for (int k = 0; k < Vertices; ++k, vertex += 4) {
+        GLfloat col = static_cast<GLfloat>(c + (col_shifts[k] > 0 ? col_shifts[k] : 0));
+        store(vertex, madd(splat(col), steps[k], bases[k]));
+      }
+    }
+  }
+}
+
 void setRectangleVertices(
     GLfloat* const array,
     GLfloat width,
@@ -57,57 +97,23 @@ void setOctagonVertices(
     size_t cols,
     size_t rows) {
 
-  int cols36 = cols * 36;
   GLfloat w2 = width * 0.5f;
   GLfloat h2 = height * 0.5f;
   GLfloat w4 = width * 0.25f;
   GLfloat h4 = height * 0.25f;
-  for (size_t r = 0; r < rows; ++r) {
-    for (size_t c = 0; c < cols; ++c) {
-      int index = (c * 36) + (r * cols36);
-      // center
-      array[index + 0] = x_offset + w2;
-      array[index + 1] = y_offset - h2;
-      array[index + 2] = 0.0f;
-      array[index + 3] = 1.0f;
-      // upper left corner
-      array[index + 4] = x_offset + width * c;
-      array[index + 5] = y_offset - height * r - h4;
-      array[index + 6] = 0.0f;
-      array[index + 7] = 1.0f;
-      array[index + 8] = x_offset + width * c + w4;
-      array[index + 9] = y_offset - height * r;
-      array[index + 10] = 0.0f;
-      array[index + 11] = 1.0f;
-      // upper right corner
-      array[index + 12] = x_offset + width * (c + 1) - w4;
-      array[index + 13] = y_offset - height * r;
-      array[index + 14] = 0.0f;
-      array[index + 15] = 1.0f;
-      array[index + 16] = x_offset + width * (c + 1);
-      array[index + 17] = y_offset - height * r - h4;
-      array[index + 18] = 0.0f;
-      array[index + 19] = 1.0f;
-      // lower right corner
-      array[index + 20] = x_offset + width * (c + 1);
-      array[index + 21] = y_offset - height * (r + 1) + h4;
-      array[index + 22] = 0.0f;
-      array[index + 23] = 1.0f;
-      array[index + 24] = x_offset + width * (c + 1) - w4;
-      array[index + 25] = y_offset - height * (r + 1);
-      array[index + 26] = 0.0f;
-      array[index + 27] = 1.0f;
-      // lower left corner
-      array[index + 28] = x_offset + width * c + w4;
-      array[index + 29] = y_offset - height * (r + 1);
-      array[index + 30] = 0.0f;
-      array[index + 31] = 1.0f;
-      array[index + 32] = x_offset + width * c;
-      array[index + 33] = y_offset - height * (r + 1) + h4;
-      array[index + 34] = 0.0f;
-      array[index + 35] = 1.0f;
-    }
-  }
+  // center, then two vertices per corner: upper left, upper right, lower right, lower left
+  const GLfloat x_shifts[9] = {w2, 0.0f, w4, -w4, 0.0f, 0.0f, -w4, w4, 0.0f};
+  static const int col_shifts[9] = {-1, 0, 0, 1, 1, 1, 1, 0, 0};
+  setGridVertices(array, width, x_offset, x_shifts, col_shifts, cols, rows,
+      [=](size_t r, int k) -> GLfloat {
+        switch (k) {
+          case 0: return y_offset - h2;
+          case 1: case 4: return y_offset - height * r - h4;
+          case 2: case 3: return y_offset - height * r;
+          case 5: case 8: return y_offset - height * (r + 1) + h4;
+          default: return y_offset - height * (r + 1);  // 6, 7
+        }
+      });
 }
 
 void rectangleIndices(GLushort* const indices, size_t size) {
@@ -122,22 +128,50 @@ void rectangleIndices(GLushort* const indices, size_t size) {
   }
 }
 
+void octagonIndices(GLushort* const indices, size_t size) {
+  size_t j = 0;
+  for (size_t i = 0; i < size; i += 24, ++j) {
+    for (size_t k = 0; k < 8; ++k) {
+      indices[i + 3 * k + 0] = 0 + 9 * j;
+      indices[i + 3 * k + 1] = 1 + k + 9 * j;
+      indices[i + 3 * k + 2] = 1 + (k + 1) % 8 + 9 * j;
+    }
+  }
+}
+
 void printBuffer2D(const GLfloat* const buffer, size_t size) {
+  (void) buffer;  // unused when logging is disabled
   for (size_t i = 0; i < size; i += 2) {
     MSG("%lf %lf", buffer[i], buffer[i + 1]);
   }
 }
 
 void printBuffer3D(const GLfloat* const buffer, size_t size) {
+  (void) buffer;  // unused when logging is disabled
   for (size_t i = 0; i < size; i += 3) {
     MSG("%lf %lf %lf", buffer[i], buffer[i + 1], buffer[i + 2]);
   }
 }
 
 void printBuffer4D(const GLfloat* const buffer, size_t size) {
+  (void) buffer;  // unused when logging is disabled
   for (size_t i = 0; i < size; i += 4) {
     MSG("%lf %lf %lf %lf", buffer[i], buffer[i + 1], buffer[i + 2], buffer[i + 3]);
   }
 }
 
+size_t getRandomIndex(size_t size) {
+  static thread_local uint64_t s_state = 0;
+  if (s_state == 0) {
+    s_state = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()) ^
+              reinterpret_cast<uintptr_t>(&s_state) ^ 0x9E3779B97F4A7C15ULL;
+  }
+  // xorshift64*
+  s_state ^= s_state >> 12;
+  s_state ^= s_state << 25;
+  s_state ^= s_state >> 27;
+  uint32_t random = static_cast<uint32_t>((s_state * 0x2545F4914F6CDD1DULL) >> 32);
+  return static_cast<size_t>((static_cast<uint64_t>(random) * size) >> 32);
+}
+
 }
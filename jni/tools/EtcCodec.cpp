@@ -0,0 +1,317 @@
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+#include "EtcCodec.h"
+
+namespace etc {
+
+namespace {
+
+/// @brief Modifiers of ETC1 color tables, in order of pixel index values.
+const int kColorTables[8][4] = {
+  {2, 8, -2, -8},      {5, 17, -5, -17},    {9, 29, -9, -29},    {13, 42, -13, -42},
+  {18, 60, -18, -60},  {24, 80, -24, -80},  {33, 106, -33, -106}, {47, 183, -47, -183}};
+
+/// @brief Modifiers of EAC alpha tables, in order of pixel index values.
+const int kAlphaTables[16][8] = {
+  {-3, -6, -9, -15, 2, 5, 8, 14},   {-3, -7, -10, -13, 2, 6, 9, 12},
+  {-2, -5, -8, -13, 1, 4, 7, 12},   {-2, -4, -6, -13, 1, 3, 5, 12},
+  {-3, -6, -8, -12, 2, 5, 7, 11},   {-3, -7, -9, -11, 2, 6, 8, 10},
+  {-4, -7, -8, -11, 3, 6, 7, 10},   {-3, -5, -8, -11, 2, 4, 7, 10},
+  {-2, -6, -8, -10, 1, 5, 7, 9},    {-2, -5, -8, -10, 1, 4, 7, 9},
+  {-2, -4, -8, -10, 1, 3, 7, 9},    {-2, -5, -7, -10, 1, 4, 6, 9},
+  {-3, -4, -7, -10, 2, 3, 6, 9},    {-1, -2, -3, -10, 0, 1, 2, 9},
+  {-4, -6, -8, -9, 3, 5, 7, 8},     {-3, -5, -7, -9, 2, 4, 6, 8}};
+
+/// @brief Table whose index 4 is modifier 0, for blocks of constant alpha.
+const int kFlatAlphaTable = 13;
+
+inline int clamp255(int value) { return std::min(std::max(value, 0), 255); }
+inline int expand4(int value) { return (value << 4) | value; }
+inline int expand5(int value) { return (value << 3) | (value >> 2); }
+
+/// @brief Half of block pixel at index (x * 4 + y) belongs to: left / right
+/// ones unless flipped, top / bottom ones otherwise.
+inline int halfOf(int index, bool flip) {
+  return flip ? (index % 4) / 2 : (index / 4) / 2;
+}
+
+inline uint64_t readBigEndian(const uint8_t* bytes) {
+  uint64_t value = 0;
+  for (int i = 0; i < 8; ++i) {
+    value = (value << 8) | bytes[i];
+  }
+  return value;
+}
+
+inline void writeBigEndian(uint64_t value, uint8_t* bytes) {
+  for (int i = 7; i >= 0; --i) {
+    bytes[i] = static_cast<uint8_t>(value & 0xFF);
+    value >>= 8;
+  }
+}
+
+/// @brief Picks table and pixel indices of half of block around base color.
+/// @return Squared error of half.
+long encodeHalf(const uint8_t* pixels, int half, bool flip, const int base[3], int* table, int selectors[16]) {
+  long best_error = LONG_MAX;
+  for (int t = 0; t < 8; ++t) {
+    long error = 0;
+    int chosen[16];
+    for (int i = 0; i < 16 && error < best_error; ++i) {
+      if (halfOf(i, flip) != half) {
+        continue;
+      }
+      const uint8_t* pixel = pixels + i * 4;
+      long best_pixel = LONG_MAX;
+      for (int s = 0; s < 4; ++s) {
+        long pixel_error = 0;
+        for (int c = 0; c < 3; ++c) {
+          long delta = clamp255(base[c] + kColorTables[t][s]) - pixel[c];
+          pixel_error += delta * delta;
+        }
+        if (pixel_error < best_pixel) {
+          best_pixel = pixel_error;
+          chosen[i] = s;
+        }
+      }
+      error += best_pixel;
+    }
+    if (error < best_error) {
+      best_error = error;
+      *table = t;
+      for (int i = 0; i < 16; ++i) {
+        if (halfOf(i, flip) == half) {
+          selectors[i] = chosen[i];
+        }
+      }
+    }
+  }
+  return best_error;
+}
+
+/// @brief Encodes color of 16 RGBA pixels, in order of block indices.
+uint64_t encodeColor(const uint8_t* pixels) {
+  uint64_t best_bits = 0;
+  long best_error = LONG_MAX;
+  for (int flip = 0; flip < 2; ++flip) {
+    float average[2][3] = {{0, 0, 0}, {0, 0, 0}};
+    for (int i = 0; i < 16; ++i) {
+      for (int c = 0; c < 3; ++c) {
+        average[halfOf(i, flip)][c] += pixels[i * 4 + c] / 8.0f;
+      }
+    }
+
+    for (int differential = 0; differential < 2; ++differential) {
+      const int levels = differential ? 31 : 15;
+      int quantized[2][3];
+      int base[2][3];
+      bool overflow = false;
+      for (int h = 0; h < 2; ++h) {
+        for (int c = 0; c < 3; ++c) {
+          quantized[h][c] = std::min(std::max(static_cast<int>(std::lround(average[h][c] * levels / 255.0f)), 0), levels);
+          base[h][c] = differential ? expand5(quantized[h][c]) : expand4(quantized[h][c]);
+        }
+      }
+      for (int c = 0; c < 3 && differential; ++c) {
+        int delta = quantized[1][c] - quantized[0][c];
+        overflow = overflow || delta < -4 || delta > 3;
+      }
+      if (overflow) {
+        continue;  // would not fit, and overflowing blocks mean T or H mode in ETC2
+      }
+
+      int tables[2] = {0, 0};
+      int selectors[16] = {0};
+      long error = encodeHalf(pixels, 0, flip, base[0], &tables[0], selectors) +
+                   encodeHalf(pixels, 1, flip, base[1], &tables[1], selectors);
+      if (error >= best_error) {
+        continue;
+      }
+      best_error = error;
+
+      uint64_t bits = 0;
+      for (int c = 0; c < 3; ++c) {
+        if (differential) {
+          bits |= static_cast<uint64_t>(quantized[0][c]) << (59 - 8 * c);
+          bits |= static_cast<uint64_t>((quantized[1][c] - quantized[0][c]) & 7) << (56 - 8 * c);
+        } else {
+          bits |= static_cast<uint64_t>(quantized[0][c]) << (60 - 8 * c);
+          bits |= static_cast<uint64_t>(quantized[1][c]) << (56 - 8 * c);
+        }
+      }
+      bits |= static_cast<uint64_t>(tables[0]) << 37 | static_cast<uint64_t>(tables[1]) << 34;
+      bits |= static_cast<uint64_t>(differential) << 33 | static_cast<uint64_t>(flip) << 32;
+      for (int i = 0; i < 16; ++i) {
+        bits |= static_cast<uint64_t>(selectors[i] >> 1) << (16 + i) | static_cast<uint64_t>(selectors[i] & 1) << i;
+      }
+      best_bits = bits;
+    }
+  }
+  return best_bits;
+}
+
+void decodeColor(uint64_t bits, uint8_t* pixels) {
+  const bool differential = (bits >> 33) & 1;
+  const bool flip = (bits >> 32) & 1;
+  int base[2][3];
+  for (int c = 0; c < 3; ++c) {
+    if (differential) {
+      int first = (bits >> (59 - 8 * c)) & 31;
+      int delta = (bits >> (56 - 8 * c)) & 7;
+      base[0][c] = expand5(first);
+      base[1][c] = expand5(first + (delta >= 4 ? delta - 8 : delta));
+    } else {
+      base[0][c] = expand4((bits >> (60 - 8 * c)) & 15);
+      base[1][c] = expand4((bits >> (56 - 8 * c)) & 15);
+    }
+  }
+  const int tables[2] = {static_cast<int>((bits >> 37) & 7), static_cast<int>((bits >> 34) & 7)};
+  for (int i = 0; i < 16; ++i) {
+    int half = halfOf(i, flip);
+    int selector = static_cast<int>(((bits >> (16 + i)) & 1) << 1 | ((bits >> i) & 1));
+    for (int c = 0; c < 3; ++c) {
+      pixels[i * 4 + c] = clamp255(base[half][c] + kColorTables[tables[half]][selector]);
+    }
+  }
+}
+
+/// @brief Squared error of alpha of pixels encoded by base, multiplier and
+/// table, stops once it exceeds limit.
+long alphaError(const uint8_t* pixels, int base, int multiplier, int table, long limit, int indices[16]) {
+  long error = 0;
+  for (int i = 0; i < 16 && error < limit; ++i) {
+    long best = LONG_MAX;
+    for (int k = 0; k < 8; ++k) {
+      long delta = clamp255(base + kAlphaTables[table][k] * multiplier) - pixels[i * 4 + 3];
+      if (delta * delta < best) {
+        best = delta * delta;
+        indices[i] = k;
+      }
+    }
+    error += best;
+  }
+  return error;
+}
+
+/// @brief Encodes alpha of 16 RGBA pixels into EAC block.
+uint64_t encodeAlpha(const uint8_t* pixels) {
+  int low = 255, high = 0;
+  for (int i = 0; i < 16; ++i) {
+    low = std::min(low, static_cast<int>(pixels[i * 4 + 3]));
+    high = std::max(high, static_cast<int>(pixels[i * 4 + 3]));
+  }
+
+  int best_base = low, best_multiplier = 1, best_table = kFlatAlphaTable;
+  int best_indices[16];
+  std::fill(best_indices, best_indices + 16, 4);
+  if (low != high) {
+    long best_error = LONG_MAX;
+    for (int t = 0; t < 16; ++t) {
+      const int lowest = kAlphaTables[t][3], highest = kAlphaTables[t][7];
+      const int guess = static_cast<int>(std::lround(static_cast<float>(high - low) / (highest - lowest)));
+      for (int m = std::max(1, guess - 1); m <= std::min(15, guess + 1); ++m) {
+        const int center = static_cast<int>(std::lround((low + high) / 2.0f - (lowest + highest) * m / 2.0f));
+        for (int b = std::max(0, center - 1); b <= std::min(255, center + 1); ++b) {
+          int indices[16];
+          long error = alphaError(pixels, b, m, t, best_error, indices);
+          if (error < best_error) {
+            best_error = error;
+            best_base = b;
+            best_multiplier = m;
+            best_table = t;
+            std::copy(indices, indices + 16, best_indices);
+          }
+        }
+      }
+    }
+  }
+
+  uint64_t bits = static_cast<uint64_t>(best_base) << 56 | static_cast<uint64_t>(best_multiplier) << 52 |
+                  static_cast<uint64_t>(best_table) << 48;
+  for (int i = 0; i < 16; ++i) {
+    bits |= static_cast<uint64_t>(best_indices[i]) << (45 - 3 * i);
+  }
+  return bits;
+}
+
+void decodeAlpha(uint64_t bits, uint8_t* pixels) {
+  const int base = static_cast<int>(bits >> 56);
+  const int multiplier = static_cast<int>((bits >> 52) & 15);
+  const int table = static_cast<int>((bits >> 48) & 15);
+  for (int i = 0; i < 16; ++i) {
+    pixels[i * 4 + 3] = clamp255(base + kAlphaTables[table][(bits >> (45 - 3 * i)) & 7] * multiplier);
+  }
+}
+
+size_t blockSize(GLenum format) {
+  switch (format) {
+    case GL_ETC1_RGB8_OES:
+    case GL_COMPRESSED_RGB8_ETC2:
+      return 8;
+    case GL_COMPRESSED_RGBA8_ETC2_EAC:
+      return 16;
+    default:
+      return 0;
+  }
+}
+
+}  // namespace
+
+size_t compressedSize(int32_t width, int32_t height, GLenum format) {
+  return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * blockSize(format);
+}
+
+std::vector<uint8_t> compress(const uint8_t* rgba, int32_t width, int32_t height, GLenum format) {
+  const size_t block_size = blockSize(format);
+  std::vector<uint8_t> blocks(compressedSize(width, height, format));
+  uint8_t* output = blocks.empty() ? nullptr : &blocks[0];
+  for (int32_t by = 0; by < height; by += 4) {
+    for (int32_t bx = 0; bx < width; bx += 4) {
+      uint8_t pixels[16 * 4];
+      for (int i = 0; i < 16; ++i) {
+        int32_t x = std::min(bx + i / 4, width - 1);
+        int32_t y = std::min(by + i % 4, height - 1);
+        std::copy(rgba + (y * width + x) * 4, rgba + (y * width + x) * 4 + 4, pixels + i * 4);
+      }
+      if (block_size == 16) {
+        writeBigEndian(encodeAlpha(pixels), output);
+        output += 8;
+      }
+      writeBigEndian(encodeColor(pixels), output);
+      output += 8;
+    }
+  }
+  return blocks;
+}
+
+std::vector<uint8_t> decompress(const uint8_t* blocks, int32_t width, int32_t height, GLenum format) {
+  const size_t block_size = blockSize(format);
+  std::vector<uint8_t> rgba(block_size > 0 ? static_cast<size_t>(width) * height * 4 : 0);
+  if (rgba.empty()) {
+    return rgba;
+  }
+  for (int32_t by = 0; by < height; by += 4) {
+    for (int32_t bx = 0; bx < width; bx += 4) {
+      uint8_t pixels[16 * 4];
+      std::fill(pixels, pixels + sizeof(pixels), 255);
+      if (block_size == 16) {
+        decodeAlpha(readBigEndian(blocks), pixels);
+        blocks += 8;
+      }
+      decodeColor(readBigEndian(blocks), pixels);
+      blocks += 8;
+      for (int i = 0; i < 16; ++i) {
+        int32_t x = bx + i / 4;
+        int32_t y = by + i % 4;
+        if (x < width && y < height) {
+          std::copy(pixels + i * 4, pixels + i * 4 + 4, &rgba[(y * width + x) * 4]);
+        }
+      }
+    }
+  }
+  return rgba;
+}
+
+}  // namespace etc
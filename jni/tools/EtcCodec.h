@@ -0,0 +1,35 @@
+#ifndef __ARKANOID_ETC_CODEC__H__
+#define __ARKANOID_ETC_CODEC__H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Texture.h"
+
+namespace etc {
+
+/** @defgroup EtcCodec ETC1 / ETC2 block compression, host side only.
+ * @details Color blocks are encoded in individual or differential mode
+ * of ETC1, differential one only when its colors don't overflow, so the
+ * same blocks are valid ETC2 RGB8 ones. Alpha of ETC2 RGBA8 goes in EAC
+ * blocks ahead of color ones. Images are RGBA, rows in any order, and
+ * blocks follow the rows; pixels beyond edges repeat the last ones.
+ * @{
+ */
+/// @brief Bytes of image compressed into format, 0 if format is unknown.
+size_t compressedSize(int32_t width, int32_t height, GLenum format);
+
+/// @brief Compresses RGBA image by exhaustive search of tables and indices.
+/// @return Blocks, empty if format is not ETC1, ETC2 RGB8 or RGBA8 EAC.
+std::vector<uint8_t> compress(const uint8_t* rgba, int32_t width, int32_t height, GLenum format);
+
+/// @brief Decompresses blocks made by compress() into RGBA image,
+/// alpha is 255 unless format has it. T, H and planar modes of ETC2
+/// are never made, hence not decoded.
+std::vector<uint8_t> decompress(const uint8_t* blocks, int32_t width, int32_t height, GLenum format);
+/** @} */  // end of EtcCodec group
+
+}  // namespace etc
+
+#endif  // __ARKANOID_ETC_CODEC__H__
@@ -0,0 +1,12 @@
+# Fails the build when asset shipped in ../assets differs from the one just
+# generated from its sources, so that the APK never lags behind them.
+#
+# Usage: cmake -DGENERATED=<file> -DSHIPPED=<file> -DSTAMP=<file> -P check_asset.cmake
+
+execute_process(
+  COMMAND ${CMAKE_COMMAND} -E compare_files ${GENERATED} ${SHIPPED}
+  RESULT_VARIABLE differs)
+if(differs)
+  message(FATAL_ERROR "${SHIPPED} is out of date, run: cmake --build <build dir> --target update_assets")
+endif()
+file(WRITE ${STAMP} "")
@@ -0,0 +1,152 @@
+/**
+ * Host tool: converts textual levels into level pack for LevelPack.
+ *
+ * Reads Levels.java, where every level is an array of strings, one per
+ * row, and levels are listed in order of play by array `levels`. Levels
+ * commented out are skipped. Decodes every level as the game does with
+ * Level::fromStringArray() and writes them all into single pack file.
+ * Prints number of levels and sizes of text and pack.
+ *
+ * Usage: levels2pack Levels.java output.arkl
+ */
+
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Level.h"
+#include "LevelPack.h"
+
+namespace {
+
+/// @brief Java source split into identifiers, string literals and
+/// punctuation, without comments and whitespace.
+struct Token {
+  enum class Kind { NAME, STRING, SYMBOL } kind;
+  std::string text;
+};
+
+std::vector<Token> tokenize(const std::string& source) {
+  std::vector<Token> tokens;
+  size_t i = 0;
+  while (i < source.size()) {
+    char ch = source[i];
+    if (source.compare(i, 2, "//") == 0) {
+      i = source.find('\n', i);
+    } else if (source.compare(i, 2, "/*") == 0) {
+      i = source.find("*/", i);
+      i = i == std::string::npos ? i : i + 2;
+    } else if (ch == '"') {
+      std::string text;
+      for (++i; i < source.size() && source[i] != '"'; ++i) {
+        if (source[i] == '\\' && i + 1 < source.size()) {
+          ++i;
+        }
+        text += source[i];
+      }
+      ++i;  // closing quote
+      tokens.push_back(Token {Token::Kind::STRING, text});
+    } else if (std::isalnum(static_cast<unsigned char>(ch)) || ch == '_') {
+      size_t begin = i;
+      while (i < source.size() && (std::isalnum(static_cast<unsigned char>(source[i])) || source[i] == '_')) {
+        ++i;
+      }
+      tokens.push_back(Token {Token::Kind::NAME, source.substr(begin, i - begin)});
+    } else {
+      if (!std::isspace(static_cast<unsigned char>(ch))) {
+        tokens.push_back(Token {Token::Kind::SYMBOL, std::string(1, ch)});
+      }
+      ++i;
+    }
+  }
+  return tokens;
+}
+
+/// @brief Collects arrays initialized by braces, `name = ... { items }`,
+/// items being string literals or names.
+std::map<std::string, std::vector<Token>> collectArrays(const std::vector<Token>& tokens) {
+  std::map<std::string, std::vector<Token>> arrays;
+  for (size_t i = 0; i + 1 < tokens.size(); ++i) {
+    if (tokens[i].kind != Token::Kind::NAME || tokens[i + 1].text != "=") {
+      continue;
+    }
+    size_t open = i + 2;
+    while (open < tokens.size() && tokens[open].text != "{" && tokens[open].text != ";") {
+      ++open;
+    }
+    if (open == tokens.size() || tokens[open].text != "{") {
+      continue;
+    }
+    std::vector<Token>& items = arrays[tokens[i].text];
+    size_t close = open + 1;
+    for (; close < tokens.size() && tokens[close].text != "}"; ++close) {
+      if (tokens[close].kind != Token::Kind::SYMBOL) {
+        items.push_back(tokens[close]);
+      }
+    }
+    i = close;
+  }
+  return arrays;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    fprintf(stderr, "Usage: %s Levels.java output.arkl\n", argv[0]);
+    return 1;
+  }
+  const char* input = argv[1];
+  const char* output = argv[2];
+
+  std::ifstream file(input);
+  if (!file) {
+    fprintf(stderr, "Failed to read %s\n", input);
+    return 1;
+  }
+  std::stringstream source;
+  source << file.rdbuf();
+
+  auto arrays = collectArrays(tokenize(source.str()));
+  auto order = arrays.find("levels");
+  if (order == arrays.end()) {
+    fprintf(stderr, "No array of levels in %s\n", input);
+    return 1;
+  }
+
+  std::vector<game::Level::Ptr> levels;
+  size_t text_size = 0;
+  for (const Token& name : order->second) {
+    auto level = arrays.find(name.text);
+    if (name.kind != Token::Kind::NAME || level == arrays.end()) {
+      fprintf(stderr, "Level %s is not defined in %s\n", name.text.c_str(), input);
+      return 1;
+    }
+    std::vector<std::string> rows;
+    for (const Token& row : level->second) {
+      rows.push_back(row.text);
+      text_size += row.text.size();
+    }
+    if (rows.empty()) {
+      fprintf(stderr, "Level %s has no rows\n", name.text.c_str());
+      return 1;
+    }
+    levels.push_back(game::Level::fromStringArray(rows, rows.size()));
+  }
+
+  std::vector<uint8_t> pack;
+  game::LevelPack::write(levels, &pack);
+  FILE* out = fopen(output, "wb");
+  bool written = out != nullptr && fwrite(pack.data(), 1, pack.size(), out) == pack.size();
+  written = out != nullptr && fclose(out) == 0 && written;
+  if (!written) {
+    fprintf(stderr, "Failed to write %s\n", output);
+    return 1;
+  }
+  printf("%s: %zu levels, %zu chars of text -> %zu bytes of pack\n", output, levels.size(), text_size, pack.size());
+  return 0;
+}
@@ -0,0 +1,142 @@
+/**
+ * Host tool: compresses PNG texture into KTX file for KTXTexture.
+ *
+ * Decodes PNG as the game does (rows bottom up), compresses it into ETC1
+ * if it is opaque or ETC2 RGBA8 EAC otherwise, unless format is given,
+ * and writes single level KTX file. Prints sizes and PSNR of compressed
+ * image against the decoded one.
+ *
+ * Usage: png2ktx [-f auto|etc1|etc2|etc2a] input.png output.ktx
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "EtcCodec.h"
+#include "Texture.h"
+
+namespace {
+
+const char* formatName(GLenum format) {
+  switch (format) {
+    case GL_ETC1_RGB8_OES:             return "ETC1";
+    case GL_COMPRESSED_RGB8_ETC2:      return "ETC2 RGB8";
+    case GL_COMPRESSED_RGBA8_ETC2_EAC: return "ETC2 RGBA8 EAC";
+    default:                           return "unknown";
+  }
+}
+
+/// @brief Peak signal to noise ratio over given channels, dB.
+double psnr(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b, int first, int count) {
+  double sum = 0;
+  size_t samples = 0;
+  for (size_t i = 0; i + 3 < a.size(); i += 4) {
+    for (int c = first; c < first + count; ++c) {
+      double delta = static_cast<double>(a[i + c]) - b[i + c];
+      sum += delta * delta;
+      ++samples;
+    }
+  }
+  if (sum == 0) {
+    return INFINITY;
+  }
+  return 10.0 * std::log10(255.0 * 255.0 / (sum / samples));
+}
+
+/// @brief Writes KTX 1.1 file of single 2D level, rows bottom up.
+bool writeKTX(const char* path, GLenum format, int32_t width, int32_t height, const std::vector<uint8_t>& blocks) {
+  static const uint8_t identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'};
+  static const char orientation[] = "KTXorientation\0S=r,T=u";  // both terminated
+
+  std::vector<uint8_t> key_value(sizeof(uint32_t) + sizeof(orientation));
+  uint32_t key_value_size = sizeof(orientation);
+  std::memcpy(&key_value[0], &key_value_size, sizeof(key_value_size));
+  std::memcpy(&key_value[sizeof(uint32_t)], orientation, sizeof(orientation));
+  key_value.resize((key_value.size() + 3) / 4 * 4, 0);
+
+  const uint32_t base_format = format == GL_COMPRESSED_RGBA8_ETC2_EAC ? GL_RGBA : GL_RGB;
+  const uint32_t header[13] = {0x04030201, 0, 1, 0, format, base_format, static_cast<uint32_t>(width),
+      static_cast<uint32_t>(height), 0, 0, 1, 1, static_cast<uint32_t>(key_value.size())};
+  const uint32_t image_size = blocks.size();
+
+  FILE* file = std::fopen(path, "wb");
+  if (file == nullptr) {
+    return false;
+  }
+  bool written = std::fwrite(identifier, sizeof(identifier), 1, file) == 1 &&
+                 std::fwrite(header, sizeof(header), 1, file) == 1 &&
+                 std::fwrite(&key_value[0], key_value.size(), 1, file) == 1 &&
+                 std::fwrite(&image_size, sizeof(image_size), 1, file) == 1 &&
+                 std::fwrite(&blocks[0], blocks.size(), 1, file) == 1;
+  return std::fclose(file) == 0 && written;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string mode = "auto";
+  int arg = 1;
+  if (argc > 2 && std::strcmp(argv[1], "-f") == 0) {
+    mode = argv[2];
+    arg = 3;
+  }
+  if (argc - arg != 2 || (mode != "auto" && mode != "etc1" && mode != "etc2" && mode != "etc2a")) {
+    fprintf(stderr, "Usage: %s [-f auto|etc1|etc2|etc2a] input.png output.ktx\n", argv[0]);
+    return 2;
+  }
+  const char* input = argv[arg];
+  const char* output = argv[arg + 1];
+
+  native::PNGTexture texture(input);
+  if (!texture.decode()) {
+    fprintf(stderr, "Failed to decode %s, code %i\n", input, texture.getErrorCode());
+    return 1;
+  }
+  const int32_t width = texture.getWidth();
+  const int32_t height = texture.getHeight();
+  const int channels = texture.getFormat() == GL_RGBA ? 4 : texture.getFormat() == GL_RGB ? 3 : 0;
+  if (channels == 0) {
+    fprintf(stderr, "%s is neither RGB nor RGBA\n", input);
+    return 1;
+  }
+
+  std::vector<uint8_t> rgba(static_cast<size_t>(width) * height * 4, 255);
+  const uint8_t* pixels = texture.getPixels();
+  bool opaque = true;
+  for (size_t i = 0; i < static_cast<size_t>(width) * height; ++i) {
+    std::memcpy(&rgba[i * 4], pixels + i * channels, channels);
+    opaque = opaque && rgba[i * 4 + 3] == 255;
+  }
+  texture.discard();
+
+  GLenum format = opaque ? GL_ETC1_RGB8_OES : GL_COMPRESSED_RGBA8_ETC2_EAC;
+  if (mode == "etc1") {
+    format = GL_ETC1_RGB8_OES;
+  } else if (mode == "etc2") {
+    format = GL_COMPRESSED_RGB8_ETC2;
+  } else if (mode == "etc2a") {
+    format = GL_COMPRESSED_RGBA8_ETC2_EAC;
+  }
+  if (!opaque && format != GL_COMPRESSED_RGBA8_ETC2_EAC) {
+    fprintf(stderr, "Warning: alpha of %s is dropped by %s\n", input, formatName(format));
+  }
+
+  std::vector<uint8_t> blocks = etc::compress(&rgba[0], width, height, format);
+  if (!writeKTX(output, format, width, height, blocks)) {
+    fprintf(stderr, "Failed to write %s\n", output);
+    return 1;
+  }
+
+  std::vector<uint8_t> decoded = etc::decompress(&blocks[0], width, height, format);
+  printf("%s: %ix%i %s, %zu KB -> %zu KB, PSNR rgb %.2f dB", input, width, height, formatName(format),
+      rgba.size() / 4 * channels / 1024, blocks.size() / 1024, psnr(rgba, decoded, 0, 3));
+  if (format == GL_COMPRESSED_RGBA8_ETC2_EAC) {
+    printf(", alpha %.2f dB", psnr(rgba, decoded, 3, 1));
+  }
+  printf("\n");
+  return 0;
+}
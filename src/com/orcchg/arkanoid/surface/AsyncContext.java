@@ -18,8 +18,7 @@ class AsyncContext {
     void onAngleChanged(int angle);
     void onCardinalityChanged(int new_cardinality);
     void onPrizeCatch(Prize prize);
-    void onErrorTextureLoad();
-    void onErrorSoundLoad();
+    void onResourcesProgress(int loaded, int failed, int total);
     void onDebugMessage(String message);
   }
   
@@ -43,20 +42,33 @@ class AsyncContext {
   void throwBall(float angle) { throwBall(descriptor, angle); }
 
   /* Tools */
-  void loadLevel(final String[] level) { loadLevel(descriptor, level); }
-  void setBonusBlocks(boolean flag) { setBonusBlocks(descriptor, flag); }
-  
-  String saveLevel() {
-    String[] tokens = saveLevel(descriptor);
-    StringBuilder builder = new StringBuilder();
-    String delim = "";
-    for (String token : tokens) {
-      builder.append(delim);
-      delim = "!";
-      builder.append(token);
+  /** Loads saved state of level if any, otherwise level of given index from pack, or from text without pack. */
+  void loadLevel(int index, String state) {
+    if (!state.isEmpty()) {
+      loadLevelState(descriptor, state);
+    } else if (!loadPackedLevel(descriptor, index)) {
+      loadLevel(descriptor, Levels.get(index));
     }
-    return builder.toString();
   }
+  void setBonusBlocks(boolean flag) { setBonusBlocks(descriptor, flag); }
+  /** Records seeds and inputs of game logic to file, until stopped, to be replayed on host. */
+  boolean startRecording(String path) { return startRecording(descriptor, path); }
+  void stopRecording() { stopRecording(descriptor); }
+  
+  /* Statistics */
+  /** Minimum, average and 99th percentile of time between frames, ms. */
+  float[] getFrameTimeStats() { return getFrameTimeStats(descriptor); }
+  /** Fixed animation step per frame in seconds for reproducible runs, 0 for real time. */
+  void setFixedFrameStep(float step) { setFixedFrameStep(descriptor, step); }
+  /** Frames rendered per second, measured over the last whole second. */
+  float getAchievedFps() { return getAchievedFps(descriptor); }
+  /** Frames which have missed their deadlines while animating. */
+  long getDroppedFrames() { return getDroppedFrames(descriptor); }
+  /** Target frame rate and whether buffers swap waits for vertical sync. */
+  void setFramePacing(int frame_rate, boolean vsync) { setFramePacing(descriptor, frame_rate, vsync); }
+  
+  /** Rows of current level joined by '!'. */
+  String saveLevel() { return saveLevel(descriptor); }
   
   /* Events coming from native Core */
   void setCoreEventListener(CoreEventListener listener) {
@@ -123,15 +135,9 @@ class AsyncContext {
     }
   }
   
-  void fireJavaEvent_errorTextureLoad() {
-    if (mListener != null) {
-      mListener.onErrorTextureLoad();
-    }
-  }
-  
-  void fireJavaEvent_errorSoundLoad() {
+  void fireJavaEvent_resourcesProgress(int loaded, int failed, int total) {
     if (mListener != null) {
-      mListener.onErrorSoundLoad();
+      mListener.onResourcesProgress(loaded, failed, total);
     }
   }
   
@@ -157,8 +163,19 @@ class AsyncContext {
   
   /* Tools */
   private native void loadLevel(long descriptor, String[] in_level);
-  private native String[] saveLevel(long descriptor);
+  private native boolean loadPackedLevel(long descriptor, int index);
+  private native void loadLevelState(long descriptor, String state);
+  private native String saveLevel(long descriptor);
   private native void setBonusBlocks(long descriptor, boolean flag);
+  private native boolean startRecording(long descriptor, String path);
+  private native void stopRecording(long descriptor);
   private native void drop(long descriptor);
   private native int getScore(long descriptor);
+  
+  /* Statistics */
+  private native float[] getFrameTimeStats(long descriptor);
+  private native void setFixedFrameStep(long descriptor, float step);
+  private native float getAchievedFps(long descriptor);
+  private native long getDroppedFrames(long descriptor);
+  private native void setFramePacing(long descriptor, int frame_rate, boolean vsync);
 }
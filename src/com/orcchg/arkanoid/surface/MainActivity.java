@@ -86,6 +86,7 @@ public class MainActivity extends FragmentActivity {
 //        Log.d(TAG, "Sound asset: " + sound);
         mNativeResources.readSound(sound);
       }
+      mNativeResources.readLevelPack("levels.arkl");
     } catch (IOException e) {
       e.printStackTrace();
     }
@@ -125,7 +126,7 @@ public class MainActivity extends FragmentActivity {
       mAsyncContext.fireJavaEvent_refreshLevel();
       mAsyncContext.fireJavaEvent_refreshScore();
     }
-    mAsyncContext.loadLevel(Levels.get(currentLevel, level_state));
+    mAsyncContext.loadLevel(currentLevel, level_state);
     setBonusBlocks();
     super.onResume();
   }
@@ -185,7 +186,7 @@ public class MainActivity extends FragmentActivity {
         mAsyncContext.fireJavaEvent_refreshLives();
         mAsyncContext.fireJavaEvent_refreshLevel();
         mAsyncContext.fireJavaEvent_refreshScore();
-        mAsyncContext.loadLevel(Levels.get(currentLevel));
+        mAsyncContext.loadLevel(currentLevel, "");
         setBonusBlocks();
         break;
     }
@@ -198,7 +199,7 @@ public class MainActivity extends FragmentActivity {
     Log.i(TAG, "Game is lost!");
     setLives(INITIAL_LIVES);
     mAsyncContext.fireJavaEvent_refreshLives();
-    mAsyncContext.loadLevel(Levels.get(currentLevel, ""));
+    mAsyncContext.loadLevel(currentLevel, "");
     setBonusBlocks();
   }
   
@@ -385,7 +386,7 @@ public class MainActivity extends FragmentActivity {
           currentLevel = INITIAL_LEVEL;
         }
         activity.setLevel(currentLevel);
-        activity.mAsyncContext.loadLevel(Levels.get(currentLevel));
+        activity.mAsyncContext.loadLevel(currentLevel, "");
         activity.setBonusBlocks();
         activity.levelFinishedAdditional();
       }
@@ -461,7 +462,7 @@ public class MainActivity extends FragmentActivity {
         case INIT:
           final MainActivity activity = activityRef.get();
           if (activity != null) {
-            activity.mAsyncContext.loadLevel(Levels.get(currentLevel, ""));
+            activity.mAsyncContext.loadLevel(currentLevel, "");
             activity.setBonusBlocks();
           }
           break;
@@ -505,13 +506,10 @@ public class MainActivity extends FragmentActivity {
     }
     
     @Override
-    public void onErrorTextureLoad() {
-      warningDialog();
-    }
-    
-    @Override
-    public void onErrorSoundLoad() {
-      warningDialog();
+    public void onResourcesProgress(int loaded, int failed, int total) {
+      if (failed > 0 && loaded + failed == total) {
+        warningDialog();
+      }
     }
     
     @Override
@@ -17,6 +17,8 @@ public class NativeResources {
   // --------------------------------------------------------------------------
   boolean readTexture(String filename) { return readTexture(descriptor, filename); }
   boolean readSound(String filename) { return readSound(descriptor, filename); }
+  /** Maps binary pack of all levels, made from {@link Levels} by levels2pack. */
+  boolean readLevelPack(String filename) { return readLevelPack(descriptor, filename); }
   void release() { release(descriptor); }
   
   /* Private methods */
@@ -24,5 +26,6 @@ public class NativeResources {
   private native long init(AssetManager assets, String internal_storage);
   private native boolean readTexture(long descriptor, String filename);
   private native boolean readSound(long descriptor, String filename);
+  private native boolean readLevelPack(long descriptor, String filename);
   private native void release(long descriptor);
 }